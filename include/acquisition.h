@@ -0,0 +1,88 @@
+/**
+ * @file acquisition.h
+ * @brief Unified continuous-mode (DMA) ADC acquisition engine
+ *
+ * Samples every analog input on the board from a single ESP32-S3 ADC
+ * digital-controller pattern, so readings are taken by hardware at a fixed,
+ * jitter-free rate instead of whenever loop() happens to call analogRead():
+ *
+ *   Channel     | Pin                 | Consumer
+ *   ------------|---------------------|-----------------------------------
+ *   DacVoltage  | DAC_VOLTAGE_PIN     | dac::getReadback()
+ *   Current     | ACS712_CURRENT_PIN  | rms (raw sample sink → RMS window)
+ *   Rail12V     | VOLTAGE_12_TEST_PIN | getFiltered(Channel::Rail12V)
+ *
+ * Each channel is converted at AD9833_FREQ_HZ × ACS712_SAMPLES_PER_CYCLE.
+ * The DMA driver fills frames of one drive cycle per channel; its pool holds
+ * two frames so one fills while the reader task demultiplexes the other.
+ * Each demultiplexed sample is pushed through a per-channel EMA filter and,
+ * if registered, handed to a raw sample sink.
+ *
+ * In a network build (NET_ENABLED) the radio owns ADC2, so channels on ADC2
+ * pins (Current and Rail12V on this board, pin_config.h) leave the DMA
+ * pattern and are polled at the same rate with arbitrated adc2_get_raw()
+ * from an esp_timer; a read the radio wins repeats the previous sample.
+ *
+ * Sinks run in the acquisition task, or for a polled channel in the
+ * esp_timer task, both on core 0 — keep them O(1).
+ */
+
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdint.h>
+
+namespace acquisition {
+
+/** Analog inputs handled by the engine. */
+enum class Channel : uint8_t {
+    DacVoltage = 0,
+    Current    = 1,
+    Rail12V    = 2,
+};
+
+/** Number of entries in Channel. */
+static constexpr uint8_t CHANNEL_COUNT = 3;
+
+/** Raw sample callback, invoked once per conversion of its channel. */
+using SampleSink = void (*)(uint16_t raw);
+
+/**
+ * Configure the ADC pattern and DMA driver and start the reader task.
+ * Must be called once in setup() before any consumer init().
+ */
+void init();
+
+/**
+ * Register (or clear, with nullptr) the raw sample sink for @p ch.
+ * Only one sink per channel is supported.
+ */
+void setSampleSink(Channel ch, SampleSink sink);
+
+/**
+ * Return the EMA-filtered reading for @p ch in raw ADC counts.
+ * Returns 0 before the first conversion.
+ */
+uint16_t getFiltered(Channel ch);
+
+/** Return the number of conversions received for @p ch since init(). */
+uint32_t getSampleCount(Channel ch);
+
+/** Return the per-channel conversion rate in Hz. */
+float getSampleRateHz();
+
+/**
+ * Return the number of times the DMA pool overflowed (conversions lost
+ * because the reader task fell behind).
+ */
+uint32_t getOverrunCount();
+
+/**
+ * Return the number of polled ADC2 conversions the Wi-Fi arbiter refused
+ * (each repeated the previous sample).  Always 0 in a USB-only build.
+ */
+uint32_t getPollMissCount();
+
+} // namespace acquisition
+
+#endif // ACQUISITION_H
@@ -0,0 +1,30 @@
+/**
+ * @file app.h
+ * @brief Firmware bring-up, shared by setup() and the on-target soak
+ *        benchmark
+ *
+ * Defined in main.cpp.  setup() is init() followed by startTasks(); the
+ * soak benchmark (test/test_embedded_soak) calls the same two, so it
+ * measures the production task layout rather than a copy of it.
+ */
+
+#ifndef APP_H
+#define APP_H
+
+namespace sched { class Scheduler; }
+
+namespace app {
+
+/** Serial, parameters, peripherals, state machine, run log, warm restart
+ *  and console locking: everything setup() does before the tasks. */
+void init();
+
+/** Create the telemetry, console and control tasks (see main.cpp). */
+void startTasks();
+
+/** The control-core scheduler, for its per-job statistics. */
+sched::Scheduler& getScheduler();
+
+} // namespace app
+
+#endif // APP_H
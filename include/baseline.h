@@ -0,0 +1,283 @@
+/**
+ * @file baseline.h
+ * @brief Streaming baseline fingerprint and deviation detector
+ *        (no hardware dependencies)
+ *
+ * The Baseline state learns what "normal" looks like for a few signals;
+ * Operating then checks each tick against it:
+ *
+ *   learn()   Baseline   Welford running mean / variance per channel, the
+ *                        linear trend across the samples, and a fixed-range
+ *                        histogram of where the values fell
+ *   freeze()  → Operating  mean and σ are fixed, but only once every channel
+ *                        is stationary: a trend of more than its maxDrift
+ *                        over the learning window means the loop is still
+ *                        moving, and freeze() refuses
+ *   check()   Operating  z = (x − mean) / σ per channel:
+ *                          |z| > zWarn       → warning bit for that channel
+ *                          two-sided CUSUM  → alarm once either sum > cusumH
+ *                        (the CUSUM starts after the first `warmup` checks)
+ *
+ * CUSUM (g⁺ = max(0, g⁺ + z − k), g⁻ = max(0, g⁻ − z − k)) accumulates
+ * small persistent shifts that never reach zWarn on a single tick, while
+ * the slack k keeps ordinary noise from adding up.
+ *
+ * σ is floored twice: at minSigma, so a very quiet baseline does not make
+ * every wobble an outlier, and at maxDrift / k, so the slow wander the loop
+ * is allowed (ambient, integrator) stays inside the slack and never
+ * accumulates.  A five-minute learning window cannot see that wander.
+ *
+ * Every call is O(CHANNEL_COUNT) with no allocation: the whole engine is a
+ * few hundred bytes, so it runs inside the control tick.
+ *
+ * Header-only so it can be unit-tested natively.
+ */
+
+#ifndef BASELINE_H
+#define BASELINE_H
+
+#include <math.h>
+#include <stdint.h>
+
+namespace baseline {
+
+/** Signals fingerprinted during Baseline. */
+enum class Channel : uint8_t {
+    TempK    = 0,   ///< cold-stage temperature
+    CurrentA = 1,   ///< ACS712 RMS current
+    Dac      = 2,   ///< DAC output actually applied (counts)
+    RmsV     = 3,   ///< drive RMS voltage
+};
+
+static constexpr uint8_t CHANNEL_COUNT  = 4;
+static constexpr uint8_t HISTOGRAM_BINS = 16;
+
+/** One tick's worth of channel values, indexed by Channel. */
+struct Sample {
+    float values[CHANNEL_COUNT];
+};
+
+/** Welford running mean and variance. */
+struct RunningStats {
+    uint32_t n    = 0;
+    float    mean = 0.0f;
+    float    m2   = 0.0f;   ///< Σ(x − mean)²
+
+    void reset() { n = 0; mean = 0.0f; m2 = 0.0f; }
+
+    void push(float x) {
+        ++n;
+        const float d = x - mean;
+        mean += d / static_cast<float>(n);
+        m2   += d * (x - mean);
+    }
+
+    /** Sample variance; 0 with fewer than two values. */
+    float variance() const { return (n < 2) ? 0.0f : m2 / static_cast<float>(n - 1u); }
+    float stddev() const   { return sqrtf(variance()); }
+};
+
+/** Fixed-range histogram with under/overflow counts (saturating). */
+struct Histogram {
+    float    lo = 0.0f;
+    float    hi = 1.0f;
+    uint16_t bins[HISTOGRAM_BINS] = {};
+    uint16_t under = 0;
+    uint16_t over  = 0;
+
+    void reset(float rangeLo, float rangeHi) {
+        lo = rangeLo;
+        hi = (rangeHi > rangeLo) ? rangeHi : rangeLo + 1.0f;
+        for (uint16_t& b : bins) b = 0;
+        under = 0;
+        over  = 0;
+    }
+
+    void push(float x) {
+        if (x < lo)  { bump(under); return; }
+        if (x >= hi) { bump(over);  return; }
+        const uint32_t i = static_cast<uint32_t>((x - lo) / (hi - lo) * HISTOGRAM_BINS);
+        bump(bins[(i < HISTOGRAM_BINS) ? i : HISTOGRAM_BINS - 1u]);
+    }
+
+private:
+    static void bump(uint16_t& c) { if (c < 0xFFFFu) ++c; }
+};
+
+/** Two-sided tabular CUSUM on standardised values. */
+struct Cusum {
+    float up   = 0.0f;   ///< g⁺: evidence of an upward shift
+    float down = 0.0f;   ///< g⁻: evidence of a downward shift
+
+    void reset() { up = 0.0f; down = 0.0f; }
+
+    void push(float z, float k) {
+        up   = fmaxf(0.0f, up + z - k);
+        down = fmaxf(0.0f, down - z - k);
+    }
+
+    float peak() const { return fmaxf(up, down); }
+};
+
+/** Detector thresholds, all in units of σ. */
+struct Limits {
+    float    zWarn;        ///< instantaneous |z| that raises a warning bit
+    float    cusumK;       ///< CUSUM slack per tick
+    float    cusumH;       ///< CUSUM decision threshold
+    uint16_t warmup = 0;   ///< checks before the CUSUM starts accumulating
+};
+
+/** Per-channel fingerprint, histogram range, σ floor and drift allowance. */
+struct ChannelConfig {
+    float histLo;
+    float histHi;
+    float minSigma;
+    float maxDrift = 0.0f;   ///< trend allowed over the learning window (0 = any)
+};
+
+class Engine {
+public:
+    enum class Phase : uint8_t { Idle = 0, Learning = 1, Monitoring = 2 };
+
+    /** Discard everything and start learning a new baseline. */
+    void begin(const ChannelConfig (&channels)[CHANNEL_COUNT], const Limits& limits) {
+        _limits = limits;
+        for (uint8_t c = 0; c < CHANNEL_COUNT; ++c) {
+            _minSigma[c] = channels[c].minSigma;
+            _maxDrift[c] = channels[c].maxDrift;
+            _trend[c]    = 0.0f;
+            _stats[c].reset();
+            _hist[c].reset(channels[c].histLo, channels[c].histHi);
+            _cusum[c].reset();
+            _sigma[c] = 0.0f;
+            _z[c]     = 0.0f;
+        }
+        _warnMask  = 0;
+        _alarmMask = 0;
+        _checks    = 0;
+        _phase     = Phase::Learning;
+    }
+
+    /** Add one Baseline sample.  Ignored unless learning. */
+    void learn(const Sample& s) {
+        if (_phase != Phase::Learning) return;
+        for (uint8_t c = 0; c < CHANNEL_COUNT; ++c) {
+            // Sample index t = n: Welford co-moment Σ(t − t̄)(x − x̄)
+            const float dt = 0.5f * static_cast<float>(_stats[c].n + 1u);   // t − t̄ before push
+            _stats[c].push(s.values[c]);
+            _trend[c] += dt * (s.values[c] - _stats[c].mean);
+            _hist[c].push(s.values[c]);
+        }
+    }
+
+    /**
+     * Least-squares change of channel @p c across the samples learnt so far
+     * (slope per sample × sample count); 0 with fewer than two.
+     */
+    float drift(Channel c) const {
+        const RunningStats& st = _stats[idx(c)];
+        if (st.n < 2) return 0.0f;
+        const float n   = static_cast<float>(st.n);
+        const float stt = n * (n * n - 1.0f) / 12.0f;   // Σ(t − t̄)² for t = 0 .. n−1
+        return _trend[idx(c)] / stt * n;
+    }
+
+    /** True if no channel has drifted more than its maxDrift while learning. */
+    bool stationary() const {
+        for (uint8_t c = 0; c < CHANNEL_COUNT; ++c) {
+            if (_maxDrift[c] > 0.0f && fabsf(drift(static_cast<Channel>(c))) > _maxDrift[c]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Fix the fingerprint and start monitoring.
+     *
+     * @return false, still learning, if not stationary() (or not learning)
+     */
+    bool freeze() {
+        if (_phase != Phase::Learning || !stationary()) return false;
+        for (uint8_t c = 0; c < CHANNEL_COUNT; ++c) {
+            float lo = _minSigma[c];
+            if (_limits.cusumK > 0.0f && _maxDrift[c] / _limits.cusumK > lo) {
+                lo = _maxDrift[c] / _limits.cusumK;
+            }
+            const float sd = _stats[c].stddev();
+            _sigma[c] = (sd > lo) ? sd : lo;
+        }
+        _checks = 0;
+        _phase  = Phase::Monitoring;
+        return true;
+    }
+
+    /** Stop learning / monitoring; the last fingerprint stays readable. */
+    void stop() { _phase = Phase::Idle; }
+
+    /**
+     * Score one Operating sample.  Updates z, CUSUM, the warning mask
+     * (this tick) and the alarm mask (latched until begin()).
+     *
+     * @return  Warning mask: bit c set when |z[c]| > zWarn
+     */
+    uint8_t check(const Sample& s) {
+        if (_phase != Phase::Monitoring) return 0;
+        const bool warm = _checks >= _limits.warmup;
+        if (!warm) ++_checks;
+        uint8_t warn = 0;
+        for (uint8_t c = 0; c < CHANNEL_COUNT; ++c) {
+            const float z = (s.values[c] - _stats[c].mean) / _sigma[c];
+            _z[c] = z;
+            if (warm) _cusum[c].push(z, _limits.cusumK);
+            if (fabsf(z) > _limits.zWarn)          warn       |= bit(c);
+            if (_cusum[c].peak() > _limits.cusumH) _alarmMask |= bit(c);
+        }
+        _warnMask = warn;
+        return warn;
+    }
+
+    Phase   phase() const     { return _phase; }
+    uint8_t warnMask() const  { return _warnMask; }
+    uint8_t alarmMask() const { return _alarmMask; }
+
+    const RunningStats& stats(Channel c) const     { return _stats[idx(c)]; }
+    const Histogram&    histogram(Channel c) const { return _hist[idx(c)]; }
+    const Cusum&        cusum(Channel c) const     { return _cusum[idx(c)]; }
+    float               sigma(Channel c) const     { return _sigma[idx(c)]; }
+    float               z(Channel c) const         { return _z[idx(c)]; }
+
+    static constexpr uint8_t bit(uint8_t c) { return static_cast<uint8_t>(1u << c); }
+
+private:
+    static uint8_t idx(Channel c) { return static_cast<uint8_t>(c); }
+
+    RunningStats _stats[CHANNEL_COUNT];
+    Histogram    _hist[CHANNEL_COUNT];
+    Cusum        _cusum[CHANNEL_COUNT];
+    float        _minSigma[CHANNEL_COUNT] = {};
+    float        _maxDrift[CHANNEL_COUNT] = {};
+    float        _trend[CHANNEL_COUNT]    = {};   // Σ(t − t̄)(x − x̄), see drift()
+    float        _sigma[CHANNEL_COUNT]    = {};
+    float        _z[CHANNEL_COUNT]        = {};
+    Limits       _limits{4.0f, 0.5f, 8.0f, 0};
+    uint8_t      _warnMask  = 0;
+    uint8_t      _alarmMask = 0;
+    uint16_t     _checks    = 0;   // check() calls while warming up
+    Phase        _phase     = Phase::Idle;
+};
+
+/** Return a short ASCII name for a channel. */
+inline const char* channelName(Channel c) {
+    switch (c) {
+        case Channel::TempK:    return "tempK";
+        case Channel::CurrentA: return "currentA";
+        case Channel::Dac:      return "dac";
+        case Channel::RmsV:     return "rmsV";
+    }
+    return "?";
+}
+
+} // namespace baseline
+
+#endif // BASELINE_H
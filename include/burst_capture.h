@@ -0,0 +1,133 @@
+/**
+ * @file burst_capture.h
+ * @brief Pre/post-trigger sample capture ring (no hardware dependencies)
+ *
+ * Behaves like a single-shot oscilloscope acquisition:
+ *
+ *   Armed      every push() overwrites the oldest sample
+ *   Triggered  trigger() accepted; postSamples more pushes are recorded
+ *   Frozen     the ring holds N samples around the trigger and ignores
+ *              push() until the consumer calls rearm()
+ *
+ * One task pushes and triggers (the sampler); another reads the frozen
+ * window and rearms it.  The producer owns the ring and its counters and
+ * publishes Frozen with a release store.  rearm() only posts a request,
+ * which the producer applies at its next push() or trigger() — in any
+ * phase, since the consumer may rearm while a capture is still filling —
+ * so the consumer never writes producer state.  phase() reads Armed while
+ * the request is pending.  After a rearm, trigger() is refused until the
+ * pre-trigger part of the ring has been refilled, so a window never
+ * contains stale data.
+ *
+ * N must be a power of two.  Header-only so it can be unit-tested natively.
+ */
+
+#ifndef BURST_CAPTURE_H
+#define BURST_CAPTURE_H
+
+#include <atomic>
+#include <stdint.h>
+
+template <uint32_t N>
+class BurstCapture {
+    static_assert(N >= 2 && (N & (N - 1u)) == 0, "BurstCapture size must be a power of two");
+
+public:
+    enum class Phase : uint8_t { Armed = 0, Triggered = 1, Frozen = 2 };
+
+    /** @param postSamples  Samples recorded after the trigger (clamped to N - 1). */
+    explicit BurstCapture(uint32_t postSamples = N / 4u) { reset(postSamples); }
+
+    /** Discard everything and re-arm.  Only safe while the producer is idle. */
+    void reset(uint32_t postSamples) {
+        _post      = (postSamples >= N) ? N - 1u : postSamples;
+        _head      = 0;
+        _filled    = 0;
+        _remaining = 0;
+        _rearmRequested.store(false, std::memory_order_relaxed);
+        _phase.store(Phase::Armed, std::memory_order_release);
+    }
+
+    // ---- Producer side ----------------------------------------------------
+
+    /** Record one sample.  O(1); ignored while Frozen. */
+    void push(uint16_t sample) {
+        applyRearm();
+        const Phase ph = _phase.load(std::memory_order_acquire);
+        if (ph == Phase::Frozen) return;
+
+        _buf[_head & (N - 1u)] = sample;
+        ++_head;
+        if (_filled < N) ++_filled;
+
+        if (ph == Phase::Triggered && --_remaining == 0) {
+            _phase.store(Phase::Frozen, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Mark the most recent push() as the trigger point.  Refused unless
+     * Armed with a full pre-trigger history.  With postSamples == 0 the
+     * window freezes immediately.
+     *
+     * @return true if the trigger was accepted
+     */
+    bool trigger() {
+        applyRearm();
+        if (_phase.load(std::memory_order_acquire) != Phase::Armed) return false;
+        if (_filled < N - _post) return false;
+        _remaining = _post;
+        _phase.store(_post == 0 ? Phase::Frozen : Phase::Triggered,
+                     std::memory_order_release);
+        return true;
+    }
+
+    // ---- Consumer side ----------------------------------------------------
+
+    Phase phase() const {
+        if (_rearmRequested.load(std::memory_order_acquire)) return Phase::Armed;
+        return _phase.load(std::memory_order_acquire);
+    }
+
+    bool isFrozen() const { return phase() == Phase::Frozen; }
+
+    /**
+     * Sample @p i of the frozen window, 0 = oldest.  Only meaningful while
+     * isFrozen().  Indices below triggerIndex() precede the trigger.
+     */
+    uint16_t at(uint32_t i) const {
+        return _buf[(_head + i) & (N - 1u)];
+    }
+
+    /** Index of the first post-trigger sample in the frozen window. */
+    uint32_t triggerIndex() const { return N - _post; }
+
+    /**
+     * Release the window (frozen or still filling) and start recording
+     * again.  Posts a request; the producer applies it.
+     */
+    void rearm() { _rearmRequested.store(true, std::memory_order_release); }
+
+    static constexpr uint32_t size() { return N; }
+
+private:
+    /** Apply a pending rearm() on the producer side. */
+    void applyRearm() {
+        if (_rearmRequested.load(std::memory_order_relaxed) &&
+            _rearmRequested.exchange(false, std::memory_order_acq_rel)) {
+            _filled    = 0;
+            _remaining = 0;
+            _phase.store(Phase::Armed, std::memory_order_release);
+        }
+    }
+
+    uint16_t           _buf[N] = {};
+    uint32_t           _post;
+    uint32_t           _head;        // producer-owned
+    uint32_t           _filled;      // producer-owned
+    uint32_t           _remaining;   // producer-owned post-trigger countdown
+    std::atomic<Phase> _phase{Phase::Armed};
+    std::atomic<bool>  _rearmRequested{false};   // consumer → producer
+};
+
+#endif // BURST_CAPTURE_H
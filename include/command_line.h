@@ -0,0 +1,102 @@
+/**
+ * @file command_line.h
+ * @brief Console line tokenizer and typed argument parsing (no hardware
+ *        dependencies)
+ *
+ * tokenize() splits a mutable line in place at spaces and tabs; tokens are
+ * pointers into the line, so nothing is copied or allocated.  Args is the
+ * view a command handler receives: the tokens after the command name, with
+ * typed accessors that reject anything not wholly a number in range.
+ *
+ * Header-only so it can be unit-tested natively.
+ */
+
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace cmdline {
+
+/** Most tokens kept from one line; further tokens set Tokens::overflow. */
+static constexpr uint8_t MAX_TOKENS = 24;
+
+struct Tokens {
+    const char* v[MAX_TOKENS];
+    uint8_t     count;
+    bool        overflow;
+};
+
+/** Split @p line in place (separators are overwritten with '\\0'). */
+inline Tokens tokenize(char* line) {
+    Tokens t{};
+    char* p = line;
+    for (;;) {
+        while (*p == ' ' || *p == '\t') ++p;
+        if (*p == '\0') break;
+        if (t.count == MAX_TOKENS) { t.overflow = true; break; }
+        t.v[t.count++] = p;
+        while (*p != '\0' && *p != ' ' && *p != '\t') ++p;
+        if (*p == '\0') break;
+        *p++ = '\0';
+    }
+    return t;
+}
+
+/**
+ * Parse @p s as an unsigned integer (decimal, or 0x-prefixed hex) no
+ * greater than @p maxValue.
+ */
+inline bool parseUint(const char* s, uint32_t maxValue, uint32_t& value) {
+    if (s == nullptr || *s == '\0' || *s == '-' || *s == '+') return false;
+    char* end = nullptr;
+    const unsigned long v = strtoul(s, &end, 0);
+    if (end == s || *end != '\0' || v > maxValue) return false;
+    value = static_cast<uint32_t>(v);
+    return true;
+}
+
+/** Parse @p s as a finite decimal number. */
+inline bool parseFloat(const char* s, float& value) {
+    if (s == nullptr || *s == '\0') return false;
+    char* end = nullptr;
+    const float v = strtof(s, &end);
+    if (end == s || *end != '\0' || !(v == v) || v > 3.4e38f || v < -3.4e38f) return false;
+    value = v;
+    return true;
+}
+
+/** The arguments after a command name. */
+class Args {
+public:
+    Args(const char* const* v, uint8_t count) : _v(v), _count(count) {}
+
+    uint8_t count() const { return _count; }
+    bool    empty() const { return _count == 0; }
+
+    /** Token @p i, or "" past the end. */
+    const char* operator[](uint8_t i) const { return i < _count ? _v[i] : ""; }
+
+    /** True if there is exactly one argument and it is @p word. */
+    bool is(const char* word) const { return _count == 1 && strcmp(_v[0], word) == 0; }
+
+    /** Argument @p i as an unsigned integer no greater than @p maxValue. */
+    bool uintAt(uint8_t i, uint32_t maxValue, uint32_t& value) const {
+        return i < _count && parseUint(_v[i], maxValue, value);
+    }
+
+    /** Argument @p i as a number. */
+    bool floatAt(uint8_t i, float& value) const {
+        return i < _count && parseFloat(_v[i], value);
+    }
+
+private:
+    const char* const* _v;
+    uint8_t            _count;
+};
+
+} // namespace cmdline
+
+#endif // COMMAND_LINE_H
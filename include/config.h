@@ -37,9 +37,53 @@
 // Use 100.0 for PT100, 1000.0 for PT1000.
 #define RTD_RNOMINAL      100.0f
 
+// Calibration curve used to build the RTD lookup table (rtd_curves.h).
+// rtd::CvdCurve{RTD_RNOMINAL} covers PT100 / PT1000 via RTD_RNOMINAL; a
+// vendor-calibrated unit names its rtd::TableCurve here instead.
+#define RTD_CURVE         rtd::CvdCurve{RTD_RNOMINAL}
+
 // Wire configuration: MAX31865_2WIRE, MAX31865_3WIRE, or MAX31865_4WIRE
 #define RTD_WIRE_CONFIG   MAX31865_2WIRE
 
+// Range of the compile-time code → temperature table (see rtd_lut.h).
+// Codes outside it clamp to the end values.
+#define RTD_LUT_MIN_K     40.0
+#define RTD_LUT_MAX_K     300.0
+
+// true:  the MAX31865 free-runs (bias on, auto-convert).  read() fetches
+//        the latest code in one short SPI transaction, gated by DRDY when
+//        MAX31865_DRDY is wired, so the RTD can be sampled at 20 Hz.
+// false: every read() is an Adafruit one-shot conversion (~75 ms of
+//        blocking delay for bias settle + conversion).
+#define RTD_AUTO_CONVERT  true
+
+// Notch of the MAX31865 input filter: 50 Hz or 60 Hz.  Matched to the drive
+// frequency, which is the dominant interferer on the cold-stage wiring.
+// Auto-convert delivers a code every 20 ms (50 Hz) or 16.7 ms (60 Hz).
+#define RTD_FILTER_50HZ   (AD9833_FREQ_HZ == 50)
+
+// With MAX31865_DRDY wired: if DRDY has not fallen this many conversion
+// times after the last fetch (line stuck high, broken trace), read() fetches
+// the latest code anyway and reports it once on Serial, so the RTD keeps
+// being sampled at the conversion rate instead of going silent.
+#define RTD_DRDY_TIMEOUT_CONVERSIONS  static_cast<uint32_t>(3)
+
+// MAX31865 register access (up to 5 MHz, SPI mode 1 or 3).
+#define MAX31865_SPI_SPEED  static_cast<uint32_t>(1000000)
+
+// =============================================================================
+// Ambient Sensor (DS18B20)
+// =============================================================================
+
+// Interval between ambient conversions (milliseconds).  Ambient drifts over
+// minutes, so one conversion every couple of seconds is plenty and keeps the
+// 1-Wire bus quiet.  Conversions run asynchronously; see temperature.cpp.
+#define AMBIENT_READ_INTERVAL_MS       static_cast<uint32_t>(2000)
+
+// Abandon an in-flight conversion that has not completed after this long.
+// A 12-bit DS18B20 conversion nominally takes 750 ms.
+#define AMBIENT_CONVERSION_TIMEOUT_MS  static_cast<uint32_t>(1500)
+
 // =============================================================================
 // AD9833 Waveform Generator
 // =============================================================================
@@ -47,6 +91,9 @@
 // Output frequency in Hz.
 #define AD9833_FREQ_HZ    static_cast<uint16_t>(60)
 
+// SPI clock for the AD9833 (max 40 MHz, SPI mode 2), matching MD_AD9833.
+#define AD9833_SPI_SPEED  static_cast<uint32_t>(8000000)
+
 // =============================================================================
 // MCP4921 12-bit DAC
 // =============================================================================
@@ -71,15 +118,26 @@
 // ADC readings below this value are treated as 0 (noise floor / off).
 #define ADC_MIN_VOLTAGE   static_cast<uint8_t>(15)
 
-// SmoothADC: sample the DAC voltage pin every this many milliseconds.
-#define DAC_VOLTAGE_ADC_SMOOTH_PERIOD_MS  static_cast<uint32_t>(5)
-
-// SmoothADC: number of priming samples at boot to seed the filter.
-#define DAC_VOLTAGE_ADC_SMOOTH_PRIME_SAMPLES  static_cast<uint8_t>(8)
-
 // DAC voltage ADC readings below this are treated as zero (output off).
 #define DAC_MIN_VOLTAGE   static_cast<uint16_t>(15)
 
+// Acquisition engine (continuous-mode DMA, see acquisition.h).
+// Every channel is converted at AD9833_FREQ_HZ × ACS712_SAMPLES_PER_CYCLE.
+
+// EMA filter strength per channel, as a right shift (α = 1 / 2^shift).
+// At 1920 Hz a shift of 5 settles in ~17 ms; 8 in ~130 ms.
+#define ADC_DAC_VOLTAGE_FILTER_SHIFT  static_cast<uint8_t>(5)
+#define ADC_CURRENT_FILTER_SHIFT      static_cast<uint8_t>(8)
+#define ADC_RAIL_12V_FILTER_SHIFT     static_cast<uint8_t>(8)
+
+// Drive cycles per DMA frame.  The driver pool holds two frames.
+#define ADC_FRAME_CYCLES              static_cast<uint8_t>(1)
+
+// Reader task placement.  Core 0 keeps the control core free.
+#define ADC_TASK_CORE                 0
+#define ADC_TASK_PRIORITY             static_cast<uint8_t>(10)
+#define ADC_TASK_STACK_BYTES          static_cast<uint32_t>(4096)
+
 // =============================================================================
 // RMS Voltage Safety
 // =============================================================================
@@ -114,9 +172,39 @@
 // =============================================================================
 
 // Maximum allowable cooling rate: 10 °C per 10 min → 1 K per minute.
-// If the measured rate exceeds this value the DAC is held (not incremented).
+// The cooldown rate loop tracks COOLDOWN_RATE_TARGET_K_PER_MIN, kept below it,
+// and never adds drive while the filtered rate is above it ("maxrate").
 #define MAX_COOLDOWN_RATE_K_PER_MIN   1.0f
 
+// =============================================================================
+// DAC Controller (see pid_controller.h)
+// =============================================================================
+
+// Cooldown runs a PI loop on cooling rate, feed-forward from the linear
+// AMBIENT_START_K → SETPOINT_K map.  The rate target sits a margin below
+// MAX_COOLDOWN_RATE_K_PER_MIN; in FineCooldown it also tapers as
+// (tempK − SETPOINT_K) / FINE_APPROACH_TAU_MIN for an exponential approach.
+#define COOLDOWN_RATE_TARGET_K_PER_MIN  0.9f
+#define FINE_APPROACH_TAU_MIN           5.0f
+
+// Low-pass time constant applied to the measured cooling rate (seconds).
+#define CTRL_RATE_FILTER_TAU_S          10.0f
+
+// Gain schedule.  Rate loops: counts per K/min of error; temperature loops:
+// counts per K.  KI is per second, KD in seconds.
+#define CTRL_COARSE_KP                  300.0f
+#define CTRL_COARSE_KI                    5.0f
+#define CTRL_FINE_KP                    200.0f
+#define CTRL_FINE_KI                      3.0f
+// Overshoot / Settle: recover to the setpoint band quickly
+#define CTRL_SETTLE_KP                  400.0f
+#define CTRL_SETTLE_KI                    4.0f
+#define CTRL_SETTLE_KD                    0.0f
+// Baseline / Operating: gentle hold so the fingerprint sees a quiet loop
+#define CTRL_HOLD_KP                    200.0f
+#define CTRL_HOLD_KI                      1.0f
+#define CTRL_HOLD_KD                      0.0f
+
 // =============================================================================
 // Temperature Stall Detection
 // =============================================================================
@@ -129,9 +217,40 @@
 // Minimum temperature drop required within STALL_DETECT_WINDOW_MS.
 #define STALL_MIN_DROP_K             2.0f
 
-// Number of (timestamp, temperature) samples retained in the ring buffer
-// used for cooling-rate and stall calculations.  Must be >= 2.
-#define TEMP_HISTORY_SIZE            static_cast<uint8_t>(20)
+// Span of the full-rate ring the cooling rate is computed over.
+#define COOLING_RATE_WINDOW_MS       static_cast<uint32_t>(4000)
+
+// Number of full-rate (timestamp, temperature) samples retained for the
+// cooling-rate calculation: one window at RTD_READ_INTERVAL_MS.  Must be >= 2.
+#define TEMP_HISTORY_SIZE            static_cast<uint8_t>(COOLING_RATE_WINDOW_MS / RTD_READ_INTERVAL_MS)
+
+// Stall detection looks back over per-bucket mean temperatures rather than
+// raw samples: one bucket per STALL_BUCKET_MS, enough buckets to span
+// STALL_DETECT_WINDOW_MS (see temp_history.h).
+#define STALL_BUCKET_MS            static_cast<uint32_t>(10000)   // 10 s
+#define STALL_HISTORY_BUCKETS      static_cast<uint16_t>(STALL_DETECT_WINDOW_MS / STALL_BUCKET_MS + 1u)
+
+// Ambient (DS18B20) history: one sample per AMBIENT_HISTORY_INTERVAL_MS
+// kept in its own ring, 4 bytes per entry.  Interval must be <= 65535 ms.
+#define AMBIENT_HISTORY_INTERVAL_MS static_cast<uint32_t>(60000)  // 1 minute
+#define AMBIENT_HISTORY_SIZE        static_cast<uint16_t>(240)    // 4 hours
+
+// =============================================================================
+// Cooldown ETA (see cooldown_eta.h)
+// =============================================================================
+
+// One RLS step per ETA_SAMPLE_MS bucket mean of the cold-stage readings.
+#define ETA_SAMPLE_MS               static_cast<uint32_t>(10000)  // 10 s
+
+// Forgetting factor per step: memory of ~1/(1-λ) = 50 steps (~8 minutes),
+// short enough to follow the bend from rate-limited to exponential cooldown.
+#define ETA_FORGETTING              0.98f
+
+// Steps before the first estimate is published (2 minutes).
+#define ETA_MIN_SAMPLES             static_cast<uint16_t>(12)
+
+// Longer estimates are reported as unknown.
+#define ETA_MAX_S                   static_cast<uint32_t>(48u * 3600u)
 
 // =============================================================================
 // Settling / Baseline Timing
@@ -141,10 +260,55 @@
 // before the state machine advances from Settle (5) → Baseline (6).
 #define SETTLE_DURATION_MS   static_cast<uint32_t>(60000)    // 60 s
 
+// ... with the loop settled: over those SETTLE_DURATION_MS the temperature
+// and the applied DAC may span at most these amounts (a few RTD codes and
+// DAC ramp steps).  A larger move restarts the timer, so Baseline never
+// learns the tail of the approach.
+#define SETTLE_MAX_TEMP_SPAN_K        0.1f
+#define SETTLE_MAX_DAC_SPAN           static_cast<uint16_t>(16)
+
 // Duration of the Baseline (6) data-collection state before advancing to
 // Operating (7).
 #define BASELINE_DURATION_MS static_cast<uint32_t>(300000)   // 5 minutes
 
+// Baseline fingerprint (see baseline.h).  Deviation thresholds are in units
+// of the σ learned during Baseline.  With k = 0.5 and h = 12 the
+// false-alarm interval on pure noise is about 10^6 ticks (~2 days at
+// LOOP_INTERVAL_MS = 200), while a sustained 1 σ shift alarms in under 30
+// ticks.  The CUSUM only starts BASELINE_WARMUP_CHECKS ticks into Operating.
+#define BASELINE_WARN_Z               4.0f
+#define BASELINE_CUSUM_K              0.5f
+#define BASELINE_CUSUM_H             12.0f
+#define BASELINE_WARMUP_CHECKS        static_cast<uint16_t>(300)   // 60 s
+
+// The wander each channel is allowed while the loop holds the setpoint.
+// It is both the stationarity gate, because Baseline only freezes once no
+// channel has trended further over BASELINE_DURATION_MS and re-learns
+// otherwise, and a σ floor of drift / BASELINE_CUSUM_K, so that wander
+// never accumulates.  Sized from the plant simulation's hold loop, which
+// wanders about ±0.05 K and ±25 DAC counts over hours.
+#define BASELINE_DRIFT_TEMP_K         0.1f
+#define BASELINE_DRIFT_CURRENT_A      0.1f
+#define BASELINE_DRIFT_DAC            40.0f
+#define BASELINE_DRIFT_RMS_V          0.2f
+
+// Quantisation floors on σ (a few RTD codes / ADC LSBs / DAC counts)
+#define BASELINE_MIN_SIGMA_TEMP_K     0.05f
+#define BASELINE_MIN_SIGMA_CURRENT_A  0.02f
+#define BASELINE_MIN_SIGMA_DAC        4.0f
+#define BASELINE_MIN_SIGMA_RMS_V      0.05f
+
+// Histogram range for the ACS712 current channel (temperature uses the
+// setpoint band, DAC its full scale, RMS 0 .. RMS_MAX_VOLTAGE_VDC).
+#define BASELINE_HIST_MAX_CURRENT_A   5.0f
+
+// true:  a CUSUM alarm in Operating faults with BaselineDeviation.
+// false: it is only reported (alarm mask of the "baseline" command).
+// Warning-only until the thresholds are tuned against real units.
+#ifndef BASELINE_DEVIATION_FAULT
+#define BASELINE_DEVIATION_FAULT      false
+#endif
+
 // =============================================================================
 // Timing
 // =============================================================================
@@ -152,6 +316,236 @@
 // Main loop read/update interval (milliseconds).
 #define LOOP_INTERVAL_MS  static_cast<uint32_t>(200)
 
+// =============================================================================
+// Control-Core Scheduler (see scheduler.h and main.cpp)
+// =============================================================================
+
+// The control task runs each subsystem at its own period.  Phases stagger
+// the releases so jobs that share a period do not all land on one tick.
+//
+//   job        period                       what
+//   current    one drive cycle (~16.7 ms)   ACS712 window RMS + spike check
+//   dac        DAC_RAMP_INTERVAL_MS          one fine slew step
+//   rtd        RTD_READ_INTERVAL_MS          MAX31865 read → history, faults
+//   control    LOOP_INTERVAL_MS              state machine, relays, indicators
+//   telemetry  TELEMETRY_EMIT_INTERVAL_MS    snapshot a frame into the ring
+//   ambient    AMBIENT_SERVICE_INTERVAL_MS   DS18B20 conversion state machine
+//                                           (a new result every
+//                                           AMBIENT_READ_INTERVAL_MS, 0.5 Hz)
+//   log        RUN_LOG_SAMPLE_INTERVAL_MS    queue a run-log sample record
+//
+// With RTD_AUTO_CONVERT the RTD job only fetches a finished code, so it runs
+// at 20 Hz; a one-shot readRTD() blocks for ~75 ms and stays at the control
+// period.
+#define CURRENT_READ_INTERVAL_US      (static_cast<uint32_t>(1000000) / AD9833_FREQ_HZ)
+#define DAC_RAMP_INTERVAL_MS          static_cast<uint32_t>(20)     // 50 Hz
+#if RTD_AUTO_CONVERT
+#define RTD_READ_INTERVAL_MS          static_cast<uint32_t>(50)     // 20 Hz
+#else
+#define RTD_READ_INTERVAL_MS          LOOP_INTERVAL_MS
+#endif
+#define TELEMETRY_EMIT_INTERVAL_MS    LOOP_INTERVAL_MS
+#define AMBIENT_SERVICE_INTERVAL_MS   static_cast<uint32_t>(250)
+
+// Release offsets within each period.  The RTD read lands before the
+// control step that consumes it, and telemetry after.
+#define RTD_READ_PHASE_MS             static_cast<uint32_t>(0)
+#define CONTROL_PHASE_MS              static_cast<uint32_t>(100)
+#define TELEMETRY_EMIT_PHASE_MS       static_cast<uint32_t>(110)
+#define AMBIENT_SERVICE_PHASE_MS      static_cast<uint32_t>(50)
+
+// =============================================================================
+// FreeRTOS Tasks (see main.cpp)
+// =============================================================================
+
+// Control task: sensors → state machine → actuators every LOOP_INTERVAL_MS.
+// Pinned to core 1 at a priority above everything on the comms core.
+#define CONTROL_TASK_CORE            1
+#define CONTROL_TASK_PRIORITY        static_cast<uint8_t>(20)
+#define CONTROL_TASK_STACK_BYTES     static_cast<uint32_t>(8192)
+
+// Telemetry and console tasks share core 0 with the acquisition engine.
+#define COMMS_TASK_CORE              0
+#define TELEMETRY_TASK_PRIORITY      static_cast<uint8_t>(3)
+#define TELEMETRY_TASK_STACK_BYTES   static_cast<uint32_t>(6144)
+#define CONSOLE_TASK_PRIORITY        static_cast<uint8_t>(2)
+#define CONSOLE_TASK_STACK_BYTES     static_cast<uint32_t>(6144)
+
+// Console task poll period: serial input and run-log flash writes.
+#define CONSOLE_POLL_INTERVAL_MS     static_cast<uint32_t>(10)
+
+// Telemetry frames buffered between the control and telemetry tasks
+// (see telemetry.h).  Must be a power of two.  A full ring drops the newest
+// frame; 16 frames cover 3.2 s of host stall at LOOP_INTERVAL_MS = 200.
+#define TELEMETRY_RING_DEPTH         static_cast<uint32_t>(16)
+
+// Telemetry decimation in steady states (Off, Idle, Baseline, Operating):
+// keep every Nth control tick.  1 = every tick.  See telemetry.h.
+#define TELEMETRY_STEADY_DIVISOR     static_cast<uint8_t>(1)
+
+// CSV delta mode: full keyframe every K frames (0 = only on schedule change).
+#define TELEMETRY_KEYFRAME_INTERVAL  static_cast<uint16_t>(25)
+
+// Longest the telemetry task sleeps between TX-space retries when a frame
+// is waiting for the USB-CDC buffer to drain.
+#define TELEMETRY_RETRY_MS           static_cast<uint32_t>(20)
+
+// true: append CSV column 24, loop_us — the longest control-core scheduler
+// pass since the previous frame (perf.h).  Off by default so the column
+// layout matches Cryocooler.ssproj; binary frames never carry it.
+#define TELEMETRY_PERF_FIELD         false
+
+// =============================================================================
+// Network Telemetry and Console (see net.h)
+// =============================================================================
+
+// Wi-Fi credentials come from build flags, never from this file, e.g.
+//   build_flags = ${env:esp32s3.build_flags} -DNET_WIFI_SSID=\"lab\" -DNET_WIFI_PASSWORD=\"...\"
+// Without NET_WIFI_SSID the network is compiled out and the unit behaves
+// exactly as a USB-only build (it waits for a USB host at boot).  The radio
+// takes ADC2, so a network build polls the acquisition inputs on ADC2 pins
+// through the driver's arbiter instead of by DMA (acquisition.h).
+// [env:esp32s3_net] in platformio.ini is such a build.
+#ifdef NET_WIFI_SSID
+#  define NET_ENABLED                1
+#else
+#  define NET_ENABLED                0
+#  define NET_WIFI_SSID              ""
+#endif
+#ifndef NET_WIFI_PASSWORD
+#  define NET_WIFI_PASSWORD          ""
+#endif
+
+// Default telemetry destination; "net dest" changes it until reboot.  A
+// multicast group (224.0.0.0/4) reaches every dashboard on the segment.
+#ifndef NET_UDP_DEST
+#  define NET_UDP_DEST               "239.10.0.1"
+#endif
+#define NET_UDP_PORT                 static_cast<uint16_t>(5005)
+
+// TCP console port (one session at a time; same commands as USB).
+#define NET_CONSOLE_PORT             static_cast<uint16_t>(2323)
+
+// Bytes a "capture dump" / "log dump" may write to the TCP session per
+// console poll (CONSOLE_POLL_INTERVAL_MS): ~100 KB/s, well inside one
+// lwIP send buffer, so a dump line never waits on the socket.
+#define NET_CONSOLE_TX_BUDGET_BYTES  static_cast<int>(1024)
+
+// Datagram pool (datagram_pool.h): NET_DATAGRAM_COUNT buffers of
+// NET_DATAGRAM_BYTES, which keeps every datagram inside a 1500-byte MTU
+// after IP and UDP headers.  Must be a power of two.
+#define NET_DATAGRAM_BYTES           static_cast<uint16_t>(1400)
+#define NET_DATAGRAM_COUNT           static_cast<uint8_t>(4)
+
+// A datagram is sent once it holds NET_BATCH_MAX_FRAMES frames or its
+// first frame is NET_BATCH_MAX_AGE_MS old, whichever comes first.
+#define NET_BATCH_MAX_FRAMES         static_cast<uint8_t>(8)
+#define NET_BATCH_MAX_AGE_MS         static_cast<uint32_t>(1000)
+
+// Network task: sends sealed datagrams and watches the Wi-Fi link.  Lowest
+// priority on the comms core; lwIP and the Wi-Fi driver run above it.
+#define NET_TASK_PRIORITY            static_cast<uint8_t>(1)
+#define NET_TASK_STACK_BYTES         static_cast<uint32_t>(4096)
+#define NET_TASK_POLL_MS             static_cast<uint32_t>(100)
+
+// Longest setup() waits for a USB host when the network is enabled, so an
+// untethered unit still boots.
+#define NET_USB_WAIT_MS              static_cast<uint32_t>(3000)
+
+// =============================================================================
+// Profiling (see perf.h)
+// =============================================================================
+
+// false compiles every PERF_SCOPE probe out of the hot path.
+#define PERF_ENABLED                 true
+
+// =============================================================================
+// On-Target Soak Benchmark (test/test_embedded_soak, env:esp32s3_soak)
+// =============================================================================
+
+// How long the soak runs the production pipeline under a console flood and
+// a stalled telemetry host.  Override from the command line, e.g.
+//   PLATFORMIO_BUILD_FLAGS="-DSOAK_DURATION_MS=3600000" pio test -e esp32s3_soak
+#ifndef SOAK_DURATION_MS
+#  define SOAK_DURATION_MS           static_cast<uint32_t>(600000)   // 10 min
+#endif
+
+// Host input offered to the console each poll: a full USB-CDC RX buffer.
+#define SOAK_FLOOD_BYTES_PER_POLL    static_cast<uint16_t>(256)
+
+// Pass limits, µs.  Jitter: vTaskDelay() rounds each sleep up to a whole
+// tick (1 ms) and a console command holding controlMutex delays the next
+// pass.  Sensor to DAC: the consumed RTD read is at most one RTD period
+// old and the dac job runs at most one ramp period later.  Console: a
+// command waits for the control pass holding the mutex, and a one-shot RTD
+// read blocks that pass for ~75 ms.
+#define SOAK_JITTER_P99_US           static_cast<uint32_t>(1500)
+#define SOAK_JITTER_MAX_US           static_cast<uint32_t>(5000)
+#define SOAK_SENSOR_TO_DAC_MAX_US    ((RTD_READ_INTERVAL_MS + DAC_RAMP_INTERVAL_MS) * 1000u + SOAK_JITTER_MAX_US)
+#if RTD_AUTO_CONVERT
+#define SOAK_CONSOLE_MAX_US          static_cast<uint32_t>(20000)
+#else
+#define SOAK_CONSOLE_MAX_US          static_cast<uint32_t>(100000)
+#endif
+#define SOAK_EMIT_P99_US             static_cast<uint32_t>(200)
+#define SOAK_EMIT_MAX_US             static_cast<uint32_t>(1000)
+
+// =============================================================================
+// Warm Restart (see warm_restart.h)
+// =============================================================================
+
+// Largest change in cold-stage temperature between the last checkpoint and
+// the first reading after a reset for the run to resume where it stopped.
+// Beyond this the reset took long enough that start() re-plans from the
+// measured temperature instead.
+#define WARM_RESTART_MAX_TEMP_DELTA_K  2.0f
+
+// Longest setup() waits for the first RTD reading to check a checkpoint
+// against (one free-running conversion is ~21 ms, a one-shot read ~75 ms).
+#define WARM_RESTART_TEMP_WAIT_MS      static_cast<uint32_t>(250)
+
+// =============================================================================
+// Run Log (see run_log.h and log_store.h)
+// =============================================================================
+
+// Raw data partition holding the circular record log.  The default Arduino
+// partition table's "spiffs" partition is used as-is; no filesystem is
+// mounted on it.
+#define RUN_LOG_PARTITION_LABEL      "spiffs"
+
+// Periodic sample record: temperature, DAC, state and backoff count.
+// 10 s fills one 4 KB sector (256 records) in ~43 min.
+#define RUN_LOG_SAMPLE_INTERVAL_MS   static_cast<uint32_t>(10000)
+#define RUN_LOG_SAMPLE_PHASE_MS      static_cast<uint32_t>(120)
+
+// Longest a buffered record waits for its page to fill before it is
+// written anyway.  Transitions, faults and backoffs are written at once.
+#define RUN_LOG_FLUSH_INTERVAL_MS    static_cast<uint32_t>(60000)
+
+// Records queued from the control core to the console task, which owns the
+// flash.  Must be a power of two.
+#define RUN_LOG_QUEUE_DEPTH          static_cast<uint32_t>(32)
+
+// Sectors kept erased ahead of the log head.  A sector erase stalls both
+// cores for tens of ms, so erases are done while the machine is Off or Idle,
+// one per console pass, and a run only enters pre-erased sectors: 32 cover
+// ~23 h of 10 s samples, for 128 KB less history.  A run that outlasts
+// them erases as it goes (counted as "hot" erases).
+#define RUN_LOG_ERASE_AHEAD_SECTORS  static_cast<uint32_t>(32)
+
+// =============================================================================
+// Runtime Parameters (see params.h)
+// =============================================================================
+
+// SETPOINT_K, SETPOINT_TOLERANCE_K, COARSE_FINE_THRESHOLD_K, the cooldown
+// rate target and limit, OVERSTROKE_CURRENT_THRESHOLD_A,
+// OVERSTROKE_DEBOUNCE_MS, BACKOFF_DAC_STEP, BACKOFF_MAX_COUNT and
+// DAC_MAX_STEP_PER_INTERVAL are only the defaults of runtime parameters;
+// the firmware reads the live values, which "set" changes and stores here.
+
+// Preferences (NVS) namespace holding the stored profile, one key per name.
+#define PARAMS_NVS_NAMESPACE         "params"
+
 // =============================================================================
 // ACS712 AC Current Sensor — Overstroke (Back-EMF Spike) Detection
 // =============================================================================
@@ -169,26 +563,64 @@
 // For ADC_RESOLUTION = 12 this is (2^12) − 1 = 4095.
 #define ACS712_ADC_MAX_VALUE          static_cast<uint16_t>((1u << ADC_RESOLUTION) - 1u)
 
-// EMA smoothing factor for the current baseline (0 < α ≤ 1).
-// Smaller values track more slowly so brief spikes stand out more.
+// Background sampler: ADC samples taken per AC drive cycle.  The sample
+// rate is locked to the drive (AD9833_FREQ_HZ × this value → 1920 Hz at
+// 60 Hz) so every RMS window spans a whole number of cycles.
+#define ACS712_SAMPLES_PER_CYCLE      static_cast<uint16_t>(32)
+
+// Default number of AC cycles accumulated into each RMS window.
+// Adjustable at runtime via rms::setWindowCycles().
+#define ACS712_WINDOW_CYCLES          static_cast<uint8_t>(4)
+
+// Upper bound accepted by rms::setWindowCycles() (~0.5 s at 60 Hz).
+#define ACS712_MAX_WINDOW_CYCLES      static_cast<uint8_t>(30)
+
+// EMA smoothing factor for the current baseline mean and variance
+// (0 < α ≤ 1).  Smaller values track more slowly so brief spikes stand out
+// more.
 #define OVERSTROKE_EMA_ALPHA          0.08f
 
-// Number of readCurrent() calls used to prime the EMA before spike
-// detection is armed.  At LOOP_INTERVAL_MS = 200 ms this is ~4 seconds.
+// Number of readCurrent() calls (with a fresh RMS window) used to prime the
+// mean and variance before spike detection is armed (~1.3 s of 4-cycle
+// windows at 60 Hz).
 #define OVERSTROKE_PRIME_READINGS     static_cast<uint8_t>(20)
 
-// A reading is flagged as a spike when the instantaneous current exceeds
-// the running EMA baseline by more than this many amps.
+// A reading is flagged as a spike when the peak window exceeds the
+// baseline mean by clamp(k·σ, OVERSTROKE_MIN_EXCESS_A,
+// OVERSTROKE_CURRENT_THRESHOLD_A): k·σ of the baseline's own noise, never
+// less than the floor and never more than the limit (overstroke_detector.h).
 #define OVERSTROKE_CURRENT_THRESHOLD_A  2.0f
+#define OVERSTROKE_MIN_EXCESS_A       0.3f
+
+// Noise multiplier k per state: wider while a cooldown (Coarse, Fine,
+// Overshoot) keeps moving the drive, tighter once it holds steady.
+#define OVERSTROKE_SIGMA_K_COOLDOWN   8.0f
+#define OVERSTROKE_SIGMA_K_STEADY     6.0f
+
+// Re-seed the baseline mean over OVERSTROKE_REPRIME_READINGS readings once
+// the DAC output has moved this many counts since it was last seeded, so a
+// drive ramp does not read as a spike against a lagging baseline.
+#define OVERSTROKE_REPRIME_DAC_COUNTS static_cast<uint16_t>(100)
+#define OVERSTROKE_REPRIME_READINGS   static_cast<uint8_t>(8)
+
+// true: the sampler also runs Goertzel bins at 1×, 2× and 3× AD9833_FREQ_HZ
+// (harmonic_window.h) and a spike only counts if its window's harmonic
+// ratio √(H2² + H3²) / H1 is at least OVERSTROKE_HARMONIC_RATIO.
+#define OVERSTROKE_HARMONIC_CHECK     false
+#define OVERSTROKE_HARMONIC_RATIO     0.15f
 
 // Minimum time between consecutive overstroke detections (milliseconds).
 // Prevents a single physical event from generating many consecutive flags.
 #define OVERSTROKE_DEBOUNCE_MS        static_cast<uint32_t>(2000)
 
+// Number of samples averaged at startup to find the zero-current midpoint.
+// The AC output MUST be off while this runs (two drive cycles by default).
+#define ACS712_MIDPOINT_SAMPLES       static_cast<uint16_t>(2u * ACS712_SAMPLES_PER_CYCLE)
+
 // ESP32 ADC attenuation for ACS712_CURRENT_PIN.
 // MUST match the supply voltage / voltage-divider configuration (see rms.cpp).
-// This constant is applied via analogSetPinAttenuation() before sSensor.begin()
-// so that calibration and live readings always use the same ADC full-scale range.
+// This constant is applied to the acquisition engine's conversion pattern, so
+// midpoint calibration and live readings always use the same full-scale range.
 //
 //   ADC_0db  → 0 – 1.1 V  (not usable; ACS712 output always exceeds this)
 //   ADC_6db  → 0 – 2.2 V  (best resolution; clips at ~4.5 A on 3.3 V supply
@@ -198,6 +630,14 @@
 #  define ACS712_ADC_ATTENUATION  ADC_11db
 #endif
 
+// Overstroke burst capture (see burst_capture.h).  Raw ACS712 samples kept
+// around the first RMS window that crosses the overstroke threshold; at
+// 1920 Hz, 1024 samples ≈ 533 ms.  Must be a power of two.
+#define CAPTURE_SAMPLES               static_cast<uint32_t>(1024)
+
+// Samples recorded after the trigger window; the rest precede it.
+#define CAPTURE_POST_SAMPLES          static_cast<uint32_t>(256)
+
 // =============================================================================
 // DAC Backoff (response to overstroke events)
 // =============================================================================
@@ -227,4 +667,9 @@
 // Duration of the AMBER power-on flash during Initialize (state 0).
 #define INDICATOR_INIT_AMBER_MS     static_cast<uint32_t>(1500)
 
+// Indicator output timer period (esp_timer, see indicator.cpp): bounds both
+// flash-edge jitter and the delay from setFaultMode()/setReadyMode() to the
+// LEDs.  Must divide the flash half-periods for exact edges.
+#define INDICATOR_TICK_MS           static_cast<uint32_t>(5)
+
 #endif // CONFIG_H
@@ -10,6 +10,7 @@
 #define CONVERSIONS_H
 
 #include <Arduino.h>
+#include <stddef.h>
 #include <stdint.h>
 
 
@@ -82,6 +83,45 @@ inline uint16_t tempKToDacValue(float tempK,
     return static_cast<uint16_t>(raw);
 }
 
+/**
+ * Piecewise-linear interpolation of @p x over breakpoints (@p xs, @p ys).
+ *
+ * @p xs must be strictly ascending; @p x outside [xs[0], xs[n-1]] clamps to
+ * the end values.  The segment search is a binary lift with a trip count
+ * fixed by @p n and selects with conditional expressions, so the timing
+ * does not depend on @p x and the compiler can emit conditional moves.
+ * constexpr, so it can also fill tables at compile time.
+ *
+ * @param xs  Breakpoint abscissae (ascending)
+ * @param ys  Breakpoint values
+ * @param n   Number of breakpoints (>= 2)
+ * @param x   Query point
+ */
+template <typename T>
+constexpr T interpolate(const T* xs, const T* ys, size_t n, T x) {
+    x = (x < xs[0])     ? xs[0]     : x;
+    x = (x > xs[n - 1]) ? xs[n - 1] : x;
+
+    // Largest lo in [0, n-2] with xs[lo] <= x
+    size_t step = 1;
+    while (step * 2u <= n - 2u) { step *= 2u; }
+    size_t lo = 0;
+    for (; step > 0; step >>= 1) {
+        const size_t probe = lo + step;
+        lo = (probe <= n - 2u && xs[probe] <= x) ? probe : lo;
+    }
+
+    const T t = (x - xs[lo]) / (xs[lo + 1] - xs[lo]);
+    return ys[lo] + t * (ys[lo + 1] - ys[lo]);
+}
+
+/** interpolate() over fixed-size arrays; N is checked at compile time. */
+template <typename T, size_t N>
+constexpr T interpolate(const T (&xs)[N], const T (&ys)[N], T x) {
+    static_assert(N >= 2, "interpolate() needs at least two breakpoints");
+    return interpolate(&xs[0], &ys[0], N, x);
+}
+
 inline void msToHHMMSS(uint32_t durationMs, char *hmsBuf)
 {
     const uint32_t totalSec = durationMs / 1000u;
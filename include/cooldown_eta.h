@@ -0,0 +1,255 @@
+/**
+ * @file cooldown_eta.h
+ * @brief Online Newtonian cooldown fit and time-to-setpoint estimate
+ *
+ * Model: the cold stage relaxes exponentially toward an asymptote T∞ with
+ * time constant τ.  Sampled every h = sampleMs that is linear in the last
+ * temperature,
+ *
+ *   ΔT_k = T_k − T_{k−1} = α·x_{k−1} + γ,    x = T − T_target
+ *
+ * with α = e^(−h/τ) − 1 and T∞ = T_target − γ/α.  Centering on the target
+ * keeps the two regressors (x, 1) well conditioned in float.  α and γ are
+ * fitted by recursive least squares with forgetting factor λ, so the fit
+ * follows the curve as it bends (rate-limited coarse cooldown, exponential
+ * fine approach); a straight line is the α → 0 limit and still gives the
+ * right ETA.  The time to reach the target from x > 0 is
+ *
+ *   eta = τ · ln((x − d∞) / (−d∞)),    d∞ = T∞ − T_target < 0
+ *
+ * and is unknown while the fitted asymptote does not lie below the target.
+ *
+ * Confidence: two one-sigma ETA errors are combined.  Noise: the
+ * exponentially weighted a-priori residual variance σ² times the RLS
+ * covariance P estimates the parameter covariance, and its linearised
+ * effect on eta gives σ_fit.  Model mismatch (the curve is not yet, or no
+ * longer, exponential — e.g. the first minutes after Start): the predicted
+ * arrival time now + eta should stand still, so its spread over the fit's
+ * memory gives σ_drift.  Confidence is 100 % × (1 − σ_eta / eta) with
+ * σ_eta² = σ_fit² + σ_drift², clamped to 0 .. 100.
+ *
+ * Cost: update() averages samples into the current h-long bucket (a few
+ * adds); once per bucket it runs one 2×2 RLS step and re-evaluates eta and
+ * its gradient (six logf).  eta() only ages the cached value.  No loops, no
+ * allocation.
+ *
+ * Header-only with no Arduino dependencies so it can be unit-tested natively.
+ */
+
+#ifndef COOLDOWN_ETA_H
+#define COOLDOWN_ETA_H
+
+#include <math.h>
+#include <stdint.h>
+
+class CooldownEta {
+public:
+    /** Published estimate; etaS < 0 = unknown. */
+    struct Estimate {
+        int32_t etaS;            ///< seconds until the target is reached
+        uint8_t confidencePct;   ///< 0 .. 100
+    };
+
+    /**
+     * @param sampleMs    RLS sample period h (one bucket mean per step)
+     * @param lambda      forgetting factor per step, 0 < λ ≤ 1
+     * @param minSamples  RLS steps before an estimate is published
+     * @param maxEtaS     longer estimates are reported as unknown
+     */
+    CooldownEta(uint32_t sampleMs, float lambda, uint16_t minSamples, uint32_t maxEtaS)
+        : _sampleMs(sampleMs), _lambda(lambda), _minSamples(minSamples),
+          _maxEtaS(static_cast<float>(maxEtaS)) {
+        reset();
+    }
+
+    /** Forget the fit (a new cooldown starts). */
+    void reset() {
+        _alpha = 0.0f;
+        _gamma = 0.0f;
+        _p00 = P00_INIT;
+        _p01 = 0.0f;
+        _p11 = P11_INIT;
+        _residualVar = 0.0f;
+        _weight      = 0.0f;
+        _steps       = 0;
+        _haveBucket  = false;
+        _havePrev    = false;
+        _bucketSum   = 0.0f;
+        _bucketCount = 0;
+        _etaS        = -1.0f;
+        _confidence  = 0.0f;
+        _etaAtMs     = 0;
+        _arrivalMean = 0.0f;
+        _arrivalVar  = 0.0f;
+        _haveArrival = false;
+    }
+
+    /** Add one temperature sample; @p targetK is where the ETA counts to. */
+    void update(uint32_t nowMs, float tempK, float targetK) {
+        if (!_haveBucket) {
+            _haveBucket  = true;
+            _bucketStart = nowMs;
+        }
+        if (nowMs - _bucketStart >= _sampleMs && _bucketCount > 0) {
+            closeBucket(_bucketSum / static_cast<float>(_bucketCount), targetK, nowMs);
+            _bucketStart = nowMs;
+            _bucketSum   = 0.0f;
+            _bucketCount = 0;
+        }
+        _bucketSum += tempK;
+        ++_bucketCount;
+    }
+
+    /** Estimate at @p nowMs: the last fit's ETA less the time since it was made. */
+    Estimate estimate(uint32_t nowMs) const {
+        if (_etaS < 0.0f) return {-1, 0};
+        const float aged = _etaS - static_cast<float>(nowMs - _etaAtMs) * 0.001f;
+        return {aged > 0.0f ? static_cast<int32_t>(aged + 0.5f) : 0,
+                static_cast<uint8_t>(_confidence + 0.5f)};
+    }
+
+    /** Fitted time constant in seconds (infinite for a straight line). */
+    float tauS() const {
+        return (_alpha < 0.0f && _alpha > -1.0f)
+                   ? -static_cast<float>(_sampleMs) * 0.001f / log1pf(_alpha)
+                   : INFINITY;
+    }
+
+    /** Fitted asymptote relative to the target (d∞), K; NaN without decay. */
+    float asymptoteOffsetK() const { return (_alpha < 0.0f) ? -_gamma / _alpha : NAN; }
+
+    uint16_t steps() const { return _steps; }
+
+private:
+    // Prior covariance: α is O(h/τ) ≤ 1, γ is a per-step drop, O(1 K).
+    static constexpr float P00_INIT = 1.0e-2f;
+    static constexpr float P11_INIT = 1.0e2f;
+
+    /** eta in seconds for parameters (@p a, @p g) at distance @p x; < 0 = unknown */
+    float etaFor(float a, float g, float x) const {
+        if (x <= 0.0f) return 0.0f;
+        const float h = static_cast<float>(_sampleMs) * 0.001f;
+        if (a < 0.0f && a > -1.0f) {
+            const float dInf = -g / a;
+            if (dInf >= 0.0f) return -1.0f;        // settles at or above the target
+            return -h / log1pf(a) * logf((x - dInf) / -dInf);
+        }
+        // No decay fitted: straight line at the per-step drop −γ
+        return (g < 0.0f) ? x * h / -g : -1.0f;
+    }
+
+    void closeBucket(float meanK, float targetK, uint32_t nowMs) {
+        const float x = meanK - targetK;
+        if (_havePrev) {
+            step(_prevX, meanK - _prevMeanK);
+        }
+        _prevX     = x;
+        _prevMeanK = meanK;
+        _havePrev  = true;
+        publish(x, nowMs);
+    }
+
+    /** One RLS step: regress @p dy on (@p x, 1). */
+    void step(float x, float dy) {
+        const float e    = dy - (_alpha * x + _gamma);
+        const float px0  = _p00 * x + _p01;        // P φ
+        const float px1  = _p01 * x + _p11;
+        const float den  = _lambda + x * px0 + px1;
+        const float k0   = px0 / den;
+        const float k1   = px1 / den;
+        _alpha += k0 * e;
+        _gamma += k1 * e;
+
+        // P ← (P − k (Pφ)ᵀ) / λ, without forgetting once P is back at its
+        // prior (no excitation, e.g. a flat stretch), so it cannot wind up.
+        float p00 = _p00 - k0 * px0;
+        float p01 = _p01 - k0 * px1;
+        float p11 = _p11 - k1 * px1;
+        if (p00 < P00_INIT && p11 < P11_INIT) {
+            p00 /= _lambda;
+            p01 /= _lambda;
+            p11 /= _lambda;
+        }
+        _p00 = p00;
+        _p01 = p01;
+        _p11 = p11;
+
+        _weight      = _lambda * _weight + 1.0f;
+        _residualVar += (e * e - _residualVar) / _weight;
+        if (_steps < UINT16_MAX) ++_steps;
+    }
+
+    /** Cache eta and its confidence at distance @p x from the target. */
+    void publish(float x, uint32_t nowMs) {
+        _etaAtMs = nowMs;
+        const float eta = etaFor(_alpha, _gamma, x);
+        if (_steps < _minSamples || eta < 0.0f || eta > _maxEtaS) {
+            _etaS       = -1.0f;
+            _confidence = 0.0f;
+            return;
+        }
+        _etaS = eta;
+        if (eta <= 0.0f) {
+            _confidence = 100.0f;
+            return;
+        }
+
+        // Forward-difference gradient of eta in (α, γ)
+        const float da = 1.0e-3f * fabsf(_alpha) + 1.0e-7f;
+        const float dg = 1.0e-3f * fabsf(_gamma) + 1.0e-5f;
+        const float ea = etaFor(_alpha + da, _gamma, x);
+        const float eg = etaFor(_alpha, _gamma + dg, x);
+        if (ea < 0.0f || eg < 0.0f) {               // on the edge of "unreachable"
+            _confidence = 0.0f;
+            return;
+        }
+        const float ga     = (ea - eta) / da;
+        const float gg     = (eg - eta) / dg;
+        const float fitVar = _residualVar * (ga * ga * _p00 + 2.0f * ga * gg * _p01 + gg * gg * _p11);
+
+        // Spread of the predicted arrival time, weighted like the residuals
+        const float arrival = static_cast<float>(nowMs) * 0.001f + eta;
+        if (!_haveArrival) {
+            _haveArrival = true;
+            _arrivalMean = arrival;
+        }
+        const float d = arrival - _arrivalMean;
+        const float w = 1.0f / _weight;
+        _arrivalMean += d * w;
+        _arrivalVar   = (1.0f - w) * (_arrivalVar + d * d * w);
+
+        const float var = (fitVar > 0.0f ? fitVar : 0.0f) + _arrivalVar;
+        const float rel = sqrtf(var) / eta;
+        _confidence = (rel >= 1.0f) ? 0.0f : 100.0f * (1.0f - rel);
+    }
+
+    uint32_t _sampleMs;
+    float    _lambda;
+    uint16_t _minSamples;
+    float    _maxEtaS;
+
+    // Fit
+    float    _alpha, _gamma;
+    float    _p00, _p01, _p11;
+    float    _residualVar, _weight;
+    uint16_t _steps;
+
+    // Bucket mean and the previous one
+    bool     _haveBucket;
+    uint32_t _bucketStart = 0;
+    float    _bucketSum;
+    uint16_t _bucketCount;
+    bool     _havePrev;
+    float    _prevX     = 0.0f;
+    float    _prevMeanK = 0.0f;
+
+    // Cached estimate
+    float    _etaS;
+    float    _confidence;
+    uint32_t _etaAtMs;
+    float    _arrivalMean;   // s, EW mean of nowMs/1000 + eta
+    float    _arrivalVar;
+    bool     _haveArrival;
+};
+
+#endif // COOLDOWN_ETA_H
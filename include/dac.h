@@ -11,7 +11,7 @@
 namespace dac {
 
 /**
- * Initialize the MCP4921 DAC (configure CS pin, set output to 0).
+ * Initialize the MCP4921 DAC (set output to 0).  Call after spi_bus::init().
  */
 void init();
 
@@ -25,23 +25,42 @@ void init();
 void update(uint16_t dacVal);
 
 /**
- * Rate-limited step toward a target DAC value.
- *
- * Each call moves the current output at most DAC_MAX_STEP_PER_INTERVAL
- * counts in the direction of @p target.  This enforces a maximum slew
- * rate on the DAC output so the cooler power ramps gradually.
- *
- * The actual SPI write is only issued when the value changes.
+ * Set the value serviceRamp() slews toward.  Clamped to MCP4921_MAX_VALUE.
+ */
+void setTarget(uint16_t target);
+
+/**
+ * Take one ramp step toward the setTarget() value.  Call every
+ * DAC_RAMP_INTERVAL_MS (the "dac" scheduler task).
  *
- * @param target  Desired 12-bit output value (0-4095)
+ * The slew limit is the "dacstep" parameter's counts (params.h, default
+ * DAC_MAX_STEP_PER_INTERVAL) per LOOP_INTERVAL_MS, so the cooler power
+ * ramps gradually.  It is re-read on every call and spread over the
+ * shorter period: a fixed-point allowance accumulates each call and whole
+ * counts are spent as they become available, so the output moves in
+ * 1-count steps instead of 5-count jumps.
  */
-void rampToward(uint16_t target);
+void serviceRamp();
+
+/**
+ * Write @p value immediately, bypassing the slew limit, and make it the
+ * ramp target.  Only for a warm restart (warm_restart.h), where the
+ * cooler was already running at this drive a moment before the reset.
+ */
+void restore(uint16_t value);
 
 /**
  * Return the current DAC output value (last value written to hardware).
  */
 uint16_t getCurrent();
 
+/**
+ * Return the measured DAC output voltage on DAC_VOLTAGE_PIN in raw ADC
+ * counts, as filtered by the acquisition engine.  Readings below
+ * DAC_MIN_VOLTAGE are reported as 0 (output off).
+ */
+uint16_t getReadback();
+
 } // namespace dac
 
 #endif // DAC_H
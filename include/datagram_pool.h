@@ -0,0 +1,155 @@
+/**
+ * @file datagram_pool.h
+ * @brief Preallocated datagram buffers that batch telemetry frames
+ *
+ * A fixed pool of Count buffers of Size bytes moves between two tasks:
+ *
+ *   producer (telemetry task)  reserve() a frame's worth of space at the
+ *                              end of the open buffer, format the frame
+ *                              straight into it and commit() the length.
+ *                              The buffer is sealed — handed to the
+ *                              consumer — when the next frame might not
+ *                              fit, after maxFrames frames, or once it has
+ *                              been open maxAgeMs (poll()).
+ *   consumer (network task)    take() a sealed buffer, send it as one
+ *                              datagram, release() it back to the pool.
+ *
+ * Frames are formatted in place, so nothing is copied or allocated per
+ * frame.  Both hand-offs are SpscQueue<uint8_t> of buffer indices; when
+ * every buffer is sealed or in flight reserve() fails and the frame is
+ * counted as dropped, so a slow or absent network never back-pressures the
+ * producer.
+ *
+ * Header-only with no Arduino dependencies so it can be unit-tested natively.
+ */
+
+#ifndef DATAGRAM_POOL_H
+#define DATAGRAM_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "spsc_queue.h"
+
+template <uint8_t Count, uint16_t Size>
+class DatagramPool {
+public:
+    /** One datagram: payload bytes and the frames packed into them. */
+    struct Buffer {
+        uint8_t  data[Size];
+        uint16_t len;
+        uint8_t  frames;
+        uint32_t openedMs;   ///< reserve() time of the first frame
+    };
+
+    /** Producer-side counters. */
+    struct Stats {
+        uint32_t frames;      ///< frames committed
+        uint32_t dropped;     ///< frames refused: no free buffer
+        uint32_t sealed;      ///< datagrams handed to the consumer
+    };
+
+    /**
+     * @param maxFrames  seal after this many frames (0 = only by size/age)
+     * @param maxAgeMs   poll() seals a buffer open at least this long
+     */
+    DatagramPool(uint8_t maxFrames, uint32_t maxAgeMs)
+        : _maxFrames(maxFrames), _maxAgeMs(maxAgeMs) {
+        for (uint8_t i = 0; i < Count; ++i) _free.push(i);
+    }
+
+    // -- Producer -----------------------------------------------------------
+
+    /**
+     * Space for one frame of up to @p maxLen bytes in the open buffer,
+     * sealing it first and opening a fresh one if it has less room left.
+     *
+     * @return nullptr (frame dropped) if no buffer is free
+     */
+    uint8_t* reserve(size_t maxLen, uint32_t nowMs) {
+        if (maxLen > Size) {
+            ++_stats.dropped;
+            return nullptr;
+        }
+        if (_open != NONE && static_cast<size_t>(Size - _buffers[_open].len) < maxLen) seal();
+        if (_open == NONE) {
+            uint8_t i;
+            if (!_free.pop(i)) {
+                ++_stats.dropped;
+                return nullptr;
+            }
+            _open              = i;
+            _buffers[i].len    = 0;
+            _buffers[i].frames = 0;
+        }
+        Buffer& b = _buffers[_open];
+        if (b.frames == 0) b.openedMs = nowMs;   // age runs from the first frame
+        return b.data + b.len;
+    }
+
+    /** Commit @p len bytes written at the last reserve() (0 = discard). */
+    void commit(size_t len) {
+        if (_open == NONE || len == 0) return;
+        Buffer& b = _buffers[_open];
+        b.len = static_cast<uint16_t>(b.len + len);
+        ++b.frames;
+        ++_stats.frames;
+        if (_maxFrames > 0 && b.frames >= _maxFrames) seal();
+    }
+
+    /** Seal the open buffer if it has been open maxAgeMs.  @return true if sealed */
+    bool poll(uint32_t nowMs) {
+        if (_open == NONE || _buffers[_open].frames == 0) return false;
+        if (nowMs - _buffers[_open].openedMs < _maxAgeMs) return false;
+        seal();
+        return true;
+    }
+
+    /**
+     * Empty the open buffer without sending it (e.g. link down).  It stays
+     * open rather than going back to _free, which only the consumer pushes.
+     */
+    void discardOpen() {
+        if (_open == NONE) return;
+        _buffers[_open].len    = 0;
+        _buffers[_open].frames = 0;
+    }
+
+    Stats stats() const { return _stats; }
+    void  resetStats() { _stats = Stats{}; }
+
+    // -- Consumer -----------------------------------------------------------
+
+    /** Next sealed buffer's index.  @return false if none is waiting */
+    bool take(uint8_t& index) { return _ready.pop(index); }
+
+    const Buffer& buffer(uint8_t index) const { return _buffers[index]; }
+
+    /** Give a taken buffer back to the producer. */
+    void release(uint8_t index) { _free.push(index); }
+
+    static constexpr uint8_t  capacity()   { return Count; }
+    static constexpr uint16_t bufferSize() { return Size; }
+
+private:
+    static constexpr uint8_t NONE = 0xFF;
+    static_assert(Count >= 2 && (Count & (Count - 1u)) == 0 && Count < NONE,
+                  "DatagramPool count must be a power of two below 255");
+
+    void seal() {
+        // Cannot fail: every index is in exactly one of _free, _ready, _open
+        // or the consumer's hands, and each queue holds all Count of them.
+        _ready.push(_open);
+        _open = NONE;
+        ++_stats.sealed;
+    }
+
+    Buffer                    _buffers[Count];
+    SpscQueue<uint8_t, Count> _free;    // consumer → producer
+    SpscQueue<uint8_t, Count> _ready;   // producer → consumer
+    uint8_t                   _open = NONE;
+    uint8_t                   _maxFrames;
+    uint32_t                  _maxAgeMs;
+    Stats                     _stats{};
+};
+
+#endif // DATAGRAM_POOL_H
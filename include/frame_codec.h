@@ -0,0 +1,101 @@
+/**
+ * @file frame_codec.h
+ * @brief CRC-16 and COBS helpers for binary serial framing
+ *
+ * COBS (Consistent Overhead Byte Stuffing) removes every 0x00 from a
+ * payload at a cost of one byte per 254, so a single 0x00 can delimit
+ * frames on the wire.  A receiver that joins mid-stream or loses bytes
+ * resynchronises at the next delimiter.
+ *
+ * CRC is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection,
+ * no final XOR); check value for "123456789" is 0x29B1.
+ *
+ * Header-only with no Arduino dependencies so it can be unit-tested natively
+ * and mirrored by host-side decoders.
+ */
+
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace codec {
+
+/** CRC-16/CCITT-FALSE over @p len bytes of @p data. */
+inline uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFFu) {
+    for (size_t i = 0; i < len; ++i) {
+        crc = static_cast<uint16_t>(crc ^ (static_cast<uint16_t>(data[i]) << 8));
+        for (uint8_t b = 0; b < 8; ++b) {
+            crc = (crc & 0x8000u) ? static_cast<uint16_t>((crc << 1) ^ 0x1021u)
+                                  : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/** Worst-case COBS-encoded size of a @p len-byte payload (no delimiter). */
+constexpr size_t cobsMaxEncoded(size_t len) {
+    return len + (len / 254u) + 1u;
+}
+
+/**
+ * COBS-encode @p len bytes of @p in into @p out.  No trailing delimiter is
+ * written.
+ *
+ * @return  Encoded length, or 0 if @p outCap is too small.
+ */
+inline size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out, size_t outCap) {
+    if (outCap < cobsMaxEncoded(len)) {
+        return 0;
+    }
+    size_t  codeIdx = 0;     // where the current block's code byte goes
+    size_t  o       = 1;
+    uint8_t code    = 1;
+    for (size_t i = 0; i < len; ++i) {
+        if (in[i] == 0) {
+            out[codeIdx] = code;
+            codeIdx      = o++;
+            code         = 1;
+        } else {
+            out[o++] = in[i];
+            if (++code == 0xFFu) {
+                out[codeIdx] = code;
+                codeIdx      = o++;
+                code         = 1;
+            }
+        }
+    }
+    out[codeIdx] = code;
+    return o;
+}
+
+/**
+ * Decode one COBS block (delimiter already stripped) of @p len bytes.
+ *
+ * @return  Decoded length, or 0 if the input is malformed or @p outCap is
+ *          too small.
+ */
+inline size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t outCap) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len) {
+        const uint8_t code = in[i++];
+        if (code == 0 || (i + code - 1u) > len) {
+            return 0;
+        }
+        for (uint8_t k = 1; k < code; ++k) {
+            if (o >= outCap) return 0;
+            out[o++] = in[i++];
+        }
+        if (code != 0xFFu && i < len) {
+            if (o >= outCap) return 0;
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+} // namespace codec
+
+#endif // FRAME_CODEC_H
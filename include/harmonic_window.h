@@ -0,0 +1,92 @@
+/**
+ * @file harmonic_window.h
+ * @brief Streaming Goertzel bins at the drive fundamental and its 2nd and
+ *        3rd harmonics (no hardware dependencies)
+ *
+ * Runs beside the RmsWindow accumulator (rms_window.h) over the same
+ * window.  The sampler is locked to the drive at samplesPerCycle samples
+ * per cycle, so harmonic h always falls exactly on a DFT bin and its
+ * Goertzel coefficient 2·cos(2π·h / samplesPerCycle) does not depend on the
+ * window length.  Each push() costs one multiply and two adds per bin; the
+ * magnitudes are only formed once per window.
+ *
+ * The figure of merit is the harmonic ratio √(|X₂|² + |X₃|²) / |X₁|: a
+ * clean sinusoidal drive current (any amplitude, so also a DAC ramp) stays
+ * near 0, while a piston striking its stop clips the waveform and raises
+ * it.  Used to qualify overstroke spikes (overstroke_detector.h).
+ *
+ * Free of Arduino includes so it can be unit-tested natively.
+ */
+
+#ifndef HARMONIC_WINDOW_H
+#define HARMONIC_WINDOW_H
+
+#include <math.h>
+#include <stdint.h>
+
+namespace rms {
+
+/** Harmonics tracked: the fundamental, 2nd and 3rd. */
+static constexpr uint8_t HARMONIC_BINS = 3;
+
+/** Goertzel state for one window. */
+struct HarmonicWindow {
+    float    coeff[HARMONIC_BINS];   ///< 2·cos(2π·h / samplesPerCycle), h = 1..3
+    float    s1[HARMONIC_BINS];
+    float    s2[HARMONIC_BINS];
+    uint32_t count;                  ///< samples accumulated in the window in progress
+    uint32_t length;                 ///< samples per window (>= 1)
+};
+
+/**
+ * Reset @p w, set its window length and the sampling ratio.  Any partial
+ * window is discarded.
+ *
+ * @param length           Samples per window; a whole number of cycles
+ * @param samplesPerCycle  Samples per drive cycle (> 6 so the 3rd harmonic
+ *                         is below Nyquist)
+ */
+inline void harmonicWindowReset(HarmonicWindow& w, uint32_t length, uint16_t samplesPerCycle) {
+    for (uint8_t i = 0; i < HARMONIC_BINS; ++i) {
+        const float h = static_cast<float>(i + 1u);
+        w.coeff[i] = 2.0f * cosf(2.0f * static_cast<float>(M_PI) * h / static_cast<float>(samplesPerCycle));
+        w.s1[i]    = 0.0f;
+        w.s2[i]    = 0.0f;
+    }
+    w.count  = 0;
+    w.length = (length < 1u) ? 1u : length;
+}
+
+/**
+ * Add one zero-centred sample.
+ *
+ * @param ratioOut  Receives the window's harmonic ratio when this sample
+ *                  completes the window (0 with no fundamental); untouched
+ *                  otherwise
+ * @return          true if a window was completed by this sample
+ */
+inline bool harmonicWindowPush(HarmonicWindow& w, int32_t sample, float& ratioOut) {
+    const float x = static_cast<float>(sample);
+    for (uint8_t i = 0; i < HARMONIC_BINS; ++i) {
+        const float s = x + w.coeff[i] * w.s1[i] - w.s2[i];
+        w.s2[i] = w.s1[i];
+        w.s1[i] = s;
+    }
+    if (++w.count < w.length) {
+        return false;
+    }
+
+    float power[HARMONIC_BINS];
+    for (uint8_t i = 0; i < HARMONIC_BINS; ++i) {
+        power[i] = w.s1[i] * w.s1[i] + w.s2[i] * w.s2[i] - w.coeff[i] * w.s1[i] * w.s2[i];
+        w.s1[i]  = 0.0f;
+        w.s2[i]  = 0.0f;
+    }
+    w.count  = 0;
+    ratioOut = (power[0] > 0.0f) ? sqrtf((power[1] + power[2]) / power[0]) : 0.0f;
+    return true;
+}
+
+} // namespace rms
+
+#endif // HARMONIC_WINDOW_H
@@ -20,7 +20,9 @@
  * Flash fast = 2 Hz (INDICATOR_FLASH_FAST_PERIOD_MS)
  * Flash slow = 1 Hz (INDICATOR_FLASH_SLOW_PERIOD_MS)
  *
- * All timing is non-blocking; call update() every loop.
+ * Flash phase is anchored to the moment a mode is set, and the outputs are
+ * driven from a timer every INDICATOR_TICK_MS (indicator.cpp), so callers
+ * only set modes.
  */
 
 #ifndef INDICATOR_H
@@ -43,40 +45,34 @@ enum class Mode : uint8_t {
 };
 
 /**
- * Initialize GPIO pins and the WS2812 driver.
+ * Initialize GPIO pins and the WS2812 driver and start the output timer.
  * Must be called once in setup().
  */
 void init();
 
 /**
  * Set the desired display mode for the FAULT indicator.
+ * Shown within INDICATOR_TICK_MS; re-setting the current mode keeps its phase.
  */
 void setFaultMode(Mode mode);
 
 /**
  * Set the desired display mode for the READY indicator.
+ * Shown within INDICATOR_TICK_MS; re-setting the current mode keeps its phase.
  */
 void setReadyMode(Mode mode);
 
-/**
- * Service the indicator state machine.
- * Must be called every loop iteration (non-blocking).
- *
- * @param nowMs  Current millis() value
- */
-void update(uint32_t nowMs);
-
 /**
  * Return true if the FAULT (red) LED is currently lit this tick.
  * Accounts for flash modes — returns the instantaneous on/off state.
- * Only valid after update() has been called for the current tick.
+ * Reflects what the output timer last drove.
  */
 bool isFaultOn();
 
 /**
  * Return true if the READY (green) LED is currently lit this tick.
  * Accounts for flash modes — returns the instantaneous on/off state.
- * Only valid after update() has been called for the current tick.
+ * Reflects what the output timer last drove.
  */
 bool isReadyOn();
 
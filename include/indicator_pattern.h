@@ -0,0 +1,121 @@
+/**
+ * @file indicator_pattern.h
+ * @brief Timestamp-phased flash patterns for the FAULT / READY indicators
+ *
+ * Each indicator remembers its Mode and the millis() at which that mode was
+ * set.  Whether it is lit is a pure function of the time since then, so a
+ * late evaluation shows the correct phase instead of shifting every later
+ * edge (the old toggle-on-elapsed-delta scheme drifted by each delay):
+ *
+ *   lit = steady mode, or  ⌊elapsed / half-period⌋ is even
+ *
+ * A flashing mode therefore starts lit on the tick it is set.  Setting the
+ * mode an indicator already has does not restart its phase.
+ *
+ * Pattern::evaluate() combines both indicators into the discrete LED levels
+ * and the single WS2812 colour; the caller compares Outputs and only touches
+ * the hardware when something changed (indicator.cpp).
+ *
+ * No hardware dependencies (native-testable).
+ */
+
+#ifndef INDICATOR_PATTERN_H
+#define INDICATOR_PATTERN_H
+
+#include <stdint.h>
+#include "config.h"
+#include "indicator.h"
+
+namespace indicator {
+
+/** WS2812 colour shown for a combination of indicators. */
+enum class Colour : uint8_t {
+    Black,
+    Red,
+    Green,
+    Amber,
+};
+
+/** Half of @p mode's flash period (ms), or 0 for a steady mode. */
+constexpr uint32_t halfPeriodMs(Mode mode) {
+    return (mode == Mode::FlashFastRed || mode == Mode::FlashFastGreen)
+               ? INDICATOR_FLASH_FAST_PERIOD_MS / 2u
+           : (mode == Mode::FlashSlowRed || mode == Mode::FlashSlowGreen)
+               ? INDICATOR_FLASH_SLOW_PERIOD_MS / 2u
+               : 0u;
+}
+
+/** Whether an indicator in @p mode is lit @p elapsedMs after the mode was set. */
+constexpr bool isLit(Mode mode, uint32_t elapsedMs) {
+    return (mode == Mode::Off) ? false
+         : (halfPeriodMs(mode) == 0u) ? true
+         : ((elapsedMs / halfPeriodMs(mode)) & 1u) == 0u;
+}
+
+/** Colour component of @p mode (ignoring flash/solid). */
+constexpr Colour modeColour(Mode mode) {
+    return (mode == Mode::SolidRed || mode == Mode::FlashFastRed || mode == Mode::FlashSlowRed)
+               ? Colour::Red
+         : (mode == Mode::SolidGreen || mode == Mode::FlashFastGreen || mode == Mode::FlashSlowGreen)
+               ? Colour::Green
+         : (mode == Mode::SolidAmber) ? Colour::Amber
+                                      : Colour::Black;
+}
+
+/** Both indicators at one instant. */
+struct Output {
+    bool   faultOn;
+    bool   readyOn;
+    Colour colour;
+
+    bool operator==(const Output& o) const {
+        return faultOn == o.faultOn && readyOn == o.readyOn && colour == o.colour;
+    }
+    bool operator!=(const Output& o) const { return !(*this == o); }
+};
+
+/** Mode and phase origin of the two indicators. */
+class Pattern {
+public:
+    void setFault(Mode mode, uint32_t nowMs) { set(_fault, mode, nowMs); }
+    void setReady(Mode mode, uint32_t nowMs) { set(_ready, mode, nowMs); }
+
+    Mode faultMode() const { return _fault.mode; }
+    Mode readyMode() const { return _ready.mode; }
+
+    /** Indicator levels and WS2812 colour at @p nowMs. */
+    Output evaluate(uint32_t nowMs) const {
+        Output o;
+        o.faultOn = isLit(_fault.mode, nowMs - _fault.sinceMs);
+        o.readyOn = isLit(_ready.mode, nowMs - _ready.sinceMs);
+        if (o.faultOn && o.readyOn) {
+            o.colour = Colour::Amber;   // both active simultaneously
+        } else if (o.faultOn) {
+            o.colour = modeColour(_fault.mode);
+        } else if (o.readyOn) {
+            o.colour = modeColour(_ready.mode);
+        } else {
+            o.colour = Colour::Black;
+        }
+        return o;
+    }
+
+private:
+    struct Channel {
+        Mode     mode    = Mode::Off;
+        uint32_t sinceMs = 0;   // millis() when mode was set
+    };
+
+    static void set(Channel& c, Mode mode, uint32_t nowMs) {
+        if (mode == c.mode) return;
+        c.mode    = mode;
+        c.sinceMs = nowMs;
+    }
+
+    Channel _fault;
+    Channel _ready;
+};
+
+} // namespace indicator
+
+#endif // INDICATOR_PATTERN_H
@@ -0,0 +1,329 @@
+/**
+ * @file log_store.h
+ * @brief Append-only circular record log on raw NOR flash (no hardware
+ *        dependencies)
+ *
+ * Fixed 16-byte records, RECORDS_PER_SECTOR to a 4 KB erase sector, laid
+ * end to end around the whole region:
+ *
+ *   slot    = seq mod (sectorCount × RECORDS_PER_SECTOR)
+ *   sector  = slot / RECORDS_PER_SECTOR
+ *
+ * Appends collect in a one-page RAM buffer and go to flash as one write per
+ * 256-byte page (or earlier on flush(), which writes only the records not
+ * yet written — NOR programming never rewrites a byte).  Entering a sector
+ * erases it first, dropping its RECORDS_PER_SECTOR oldest records, so
+ * between (sectorCount − 1) and sectorCount sectors of history are kept and
+ * every sector is erased once per lap: wear is spread evenly with no
+ * mapping table.
+ *
+ * eraseAhead() lets the owner erase the sectors the head will enter next
+ * at a time of its choosing (run_log.cpp: while the cooler is idle); an
+ * append entering a sector that already reads blank skips the erase.  Each
+ * sector erased early drops its oldest records early.
+ *
+ * Nothing else is stored.  mount() rebuilds the head from the first record
+ * of each sector (the sector with the highest seq is the head) and the
+ * first erased slot inside it.  Each record carries a CRC-8, so a record
+ * torn by a power cut reads back as missing; its slot is skipped.
+ *
+ * Flash is any type with
+ *
+ *   uint32_t sectorCount() const;
+ *   bool read(uint32_t addr, void* dst, uint32_t len);
+ *   bool write(uint32_t addr, const void* src, uint32_t len);
+ *   bool eraseSector(uint32_t sector);
+ *
+ * (esp_partition_* on target, see run_log.cpp; a RAM array in the tests).
+ * Not thread-safe: one task owns the store.
+ *
+ * Header-only so it can be unit-tested natively.
+ */
+
+#ifndef LOG_STORE_H
+#define LOG_STORE_H
+
+#include <stdint.h>
+
+namespace run_log {
+
+enum class RecordType : uint8_t {
+    Boot       = 1,   ///< detail = reset reason
+    Sample     = 2,   ///< periodic; detail = backoff count
+    Transition = 3,   ///< state = new state; detail = previous state
+    Fault      = 4,   ///< state = Fault; detail = FaultReason
+    Backoff    = 5,   ///< detail = backoff count after the event
+};
+
+/** One log entry.  16 bytes, written to flash as-is (little-endian). */
+struct Record {
+    uint32_t seq;      ///< assigned by LogStore::append()
+    uint32_t timeMs;   ///< millis() at the event
+    uint16_t tempQ;    ///< cold stage, TEMP_LSB_K steps (temp_history.h)
+    uint16_t dac;      ///< DAC output counts
+    uint8_t  type;     ///< RecordType
+    int8_t   state;    ///< state_machine::State
+    uint8_t  detail;   ///< see RecordType
+    uint8_t  crc;      ///< CRC-8 of the preceding 15 bytes
+};
+
+static_assert(sizeof(Record) == 16, "Record must stay 16 bytes");
+
+static constexpr uint32_t RECORD_SIZE        = sizeof(Record);
+static constexpr uint32_t PAGE_SIZE          = 256;
+static constexpr uint32_t SECTOR_SIZE        = 4096;
+static constexpr uint32_t RECORDS_PER_PAGE   = PAGE_SIZE / RECORD_SIZE;
+static constexpr uint32_t RECORDS_PER_SECTOR = SECTOR_SIZE / RECORD_SIZE;
+
+/** CRC-8 (poly 0x07) over @p len bytes. */
+inline uint8_t crc8(const uint8_t* p, uint32_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+        crc ^= *p++;
+        for (uint8_t b = 0; b < 8; ++b) {
+            crc = static_cast<uint8_t>((crc & 0x80u) ? (crc << 1) ^ 0x07u : crc << 1);
+        }
+    }
+    return crc;
+}
+
+inline uint8_t recordCrc(const Record& r) {
+    return crc8(reinterpret_cast<const uint8_t*>(&r), RECORD_SIZE - 1u);
+}
+
+/** True if every byte of @p r reads as erased flash. */
+inline bool isErased(const Record& r) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&r);
+    for (uint32_t i = 0; i < RECORD_SIZE; ++i) {
+        if (p[i] != 0xFFu) return false;
+    }
+    return true;
+}
+
+inline bool isValid(const Record& r) {
+    return !isErased(r) && r.crc == recordCrc(r);
+}
+
+/** Return a short ASCII name for a record type. */
+inline const char* recordTypeName(uint8_t type) {
+    switch (static_cast<RecordType>(type)) {
+        case RecordType::Boot:       return "boot";
+        case RecordType::Sample:     return "sample";
+        case RecordType::Transition: return "transition";
+        case RecordType::Fault:      return "fault";
+        case RecordType::Backoff:    return "backoff";
+    }
+    return "?";
+}
+
+/** Write, erase and drop counters (see LogStore::getStats()). */
+struct StoreStats {
+    uint32_t appended;        ///< records accepted since mount()
+    uint32_t pageWrites;      ///< flash write calls
+    uint32_t sectorErases;
+    uint32_t writeErrors;     ///< failed writes or erases
+};
+
+template <typename Flash>
+class LogStore {
+public:
+    explicit LogStore(Flash& flash) : _flash(flash) {}
+
+    /**
+     * Scan the region and position the head after the newest record.
+     * Needs at least two sectors.
+     *
+     * @return false if the region is too small (the store stays unusable)
+     */
+    bool mount() {
+        _mounted    = false;
+        _pending    = 0;
+        _blankAhead = 0;
+        _stats      = StoreStats{};
+        _sectors    = _flash.sectorCount();
+        if (_sectors < 2u) return false;
+
+        bool     any      = false;
+        uint32_t headSeq  = 0;
+        uint32_t head     = 0;
+        uint32_t oldest   = 0;
+        for (uint32_t s = 0; s < _sectors; ++s) {
+            Record r;
+            if (!readSlot(s * RECORDS_PER_SECTOR, r) || !isValid(r)) continue;
+            if (!any || r.seq > headSeq) { headSeq = r.seq; head = s; }
+            if (!any || r.seq < oldest)  { oldest = r.seq; }
+            any = true;
+        }
+
+        if (!any) {
+            // Fresh (or unreadable) region: start at sector 0
+            _nextSeq   = 0;
+            _oldestSeq = 0;
+            _headSlot  = 0;
+            _mounted   = prepareSector(0);
+            _prepared  = 0;
+            return _mounted;
+        }
+
+        // First erased slot in the head sector; torn slots count as used
+        uint32_t used = 1;
+        while (used < RECORDS_PER_SECTOR) {
+            Record r;
+            if (!readSlot(head * RECORDS_PER_SECTOR + used, r) || isErased(r)) break;
+            ++used;
+        }
+        _nextSeq   = headSeq + used;
+        _oldestSeq = oldest;
+        _headSlot  = head * RECORDS_PER_SECTOR + used;   // may be end of sector
+        _prepared  = head;
+        _mounted   = true;
+        return true;
+    }
+
+    bool isMounted() const { return _mounted; }
+
+    /**
+     * Stamp @p r with the next sequence number and CRC and buffer it.  A
+     * page that fills is written at once; entering a new sector erases it
+     * first.
+     *
+     * @return false if the store is not mounted or a flash write failed
+     */
+    bool append(Record r) {
+        if (!_mounted) return false;
+
+        if (_pending == 0 && _headSlot % RECORDS_PER_SECTOR == 0) {
+            // Head at a sector boundary: erase the sector it enters
+            if (_headSlot >= slotCount()) _headSlot = 0;
+            const uint32_t sector = _headSlot / RECORDS_PER_SECTOR;
+            if (sector != _prepared) {
+                if (_blankAhead > 0) {
+                    --_blankAhead;   // erased by eraseAhead(); prepareSector() only reads
+                }
+                if (!prepareSector(sector)) return false;
+                _prepared = sector;
+                if (_nextSeq > capacity() && _nextSeq - capacity() > _oldestSeq) {
+                    _oldestSeq = _nextSeq - capacity();
+                }
+            }
+        }
+
+        r.seq = _nextSeq++;
+        r.crc = recordCrc(r);
+        _page[_pending++] = r;
+        ++_stats.appended;
+
+        if ((_headSlot + _pending) % RECORDS_PER_PAGE == 0) return flush();
+        return true;
+    }
+
+    /** Write any buffered records now. */
+    bool flush() {
+        if (_pending == 0) return true;
+        const uint32_t addr = _headSlot * RECORD_SIZE;
+        const bool ok = _flash.write(addr, _page, _pending * RECORD_SIZE);
+        ++_stats.pageWrites;
+        if (!ok) ++_stats.writeErrors;
+        _headSlot += _pending;
+        _pending   = 0;
+        return ok;
+    }
+
+    /**
+     * Make the next sector past those already blank ahead of the head blank,
+     * erasing it if needed, as long as fewer than @p sectors are (at most
+     * sectorCount − 2, so a sector of history always survives).  One sector
+     * per call.
+     *
+     * @return true if a sector was prepared; false if enough already are,
+     *         the store is not mounted or the erase failed
+     */
+    bool eraseAhead(uint32_t sectors) {
+        if (!_mounted) return false;
+        const uint32_t limit = (sectors < _sectors - 2u) ? sectors : _sectors - 2u;
+        if (_blankAhead >= limit) return false;
+
+        const uint32_t erases = _stats.sectorErases;
+        if (!prepareSector((_prepared + 1u + _blankAhead) % _sectors)) return false;
+        ++_blankAhead;
+        if (_stats.sectorErases != erases) {
+            // The erased sector held the oldest records; the one after now does
+            const uint32_t headSeq = _nextSeq - (_headSlot + _pending - _prepared * RECORDS_PER_SECTOR);
+            const uint32_t behind  = (_sectors - 1u - _blankAhead) * RECORDS_PER_SECTOR;
+            if (headSeq > behind && headSeq - behind > _oldestSeq) _oldestSeq = headSeq - behind;
+        }
+        return true;
+    }
+
+    /** Sectors ahead of the head known to be blank (see eraseAhead()). */
+    uint32_t erasedAhead() const { return _blankAhead; }
+
+    /** Records buffered in RAM, not yet on flash. */
+    uint32_t pending() const { return _pending; }
+
+    /** Oldest sequence number still stored (== nextSeq() when empty). */
+    uint32_t oldestSeq() const { return _oldestSeq; }
+
+    /** Sequence number the next append() will get. */
+    uint32_t nextSeq() const { return _nextSeq; }
+
+    /** Records the region can hold before the oldest sector is reused. */
+    uint32_t capacity() const { return (_sectors - 1u) * RECORDS_PER_SECTOR; }
+
+    /**
+     * Read record @p seq from flash (or the page buffer).
+     *
+     * @return false if it is out of range, torn or overwritten
+     */
+    bool read(uint32_t seq, Record& r) {
+        if (!_mounted || seq < _oldestSeq || seq >= _nextSeq) return false;
+        const uint32_t back = _nextSeq - seq;              // 1 = newest
+        if (back <= _pending) {
+            r = _page[_pending - back];
+            return true;
+        }
+        const uint32_t total = slotCount();
+        const uint32_t fromFlash = back - _pending;        // slots behind _headSlot
+        const uint32_t slot = (_headSlot + total - (fromFlash % total)) % total;
+        return readSlot(slot, r) && isValid(r) && r.seq == seq;
+    }
+
+    StoreStats getStats() const { return _stats; }
+
+private:
+    uint32_t slotCount() const { return _sectors * RECORDS_PER_SECTOR; }
+
+    bool readSlot(uint32_t slot, Record& r) {
+        return _flash.read(slot * RECORD_SIZE, &r, RECORD_SIZE);
+    }
+
+    /** Erase @p sector unless it already reads as blank. */
+    bool prepareSector(uint32_t sector) {
+        bool blank = true;
+        for (uint32_t i = 0; i < RECORDS_PER_SECTOR && blank; ++i) {
+            Record r;
+            blank = readSlot(sector * RECORDS_PER_SECTOR + i, r) && isErased(r);
+        }
+        if (blank) return true;
+        ++_stats.sectorErases;
+        if (_flash.eraseSector(sector)) return true;
+        ++_stats.writeErrors;
+        return false;
+    }
+
+    Flash&     _flash;
+    Record     _page[RECORDS_PER_PAGE] = {};
+    uint32_t   _pending    = 0;   // buffered records, slots _headSlot ..
+    uint32_t   _headSlot   = 0;   // first slot not yet written
+    uint32_t   _nextSeq    = 0;
+    uint32_t   _oldestSeq  = 0;
+    uint32_t   _sectors    = 0;
+    uint32_t   _prepared   = 0;   // sector the head is writing into
+    uint32_t   _blankAhead = 0;   // sectors after _prepared known blank
+    bool       _mounted    = false;
+    StoreStats _stats      = {};
+};
+
+} // namespace run_log
+
+#endif // LOG_STORE_H
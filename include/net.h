@@ -0,0 +1,97 @@
+/**
+ * @file net.h
+ * @brief Wi-Fi telemetry streaming (UDP) and network console (TCP)
+ *
+ * Telemetry:
+ *   init() installs a telemetry tap (telemetry::setTap()), so the
+ *   telemetry task hands this module every sample frame it takes off the
+ *   ring — the same snapshot the USB stream is formatted from.  The tap
+ *   formats each frame as a full CSV keyframe (honouring the column mask,
+ *   never delta: a lost datagram must not leave the dashboard with stale
+ *   columns) straight into a DatagramPool buffer (datagram_pool.h) and
+ *   several frames ride in one datagram, one frame per line, so Serial
+ *   Studio's UDP input parses them unchanged.  flush(), called by the
+ *   telemetry task after each service(), seals a buffer whose first frame
+ *   is NET_BATCH_MAX_AGE_MS old and wakes the network task, which sends
+ *   sealed buffers to the destination (unicast or multicast) and returns
+ *   them to the pool.
+ *
+ *   Neither the control task nor the telemetry task ever waits on the
+ *   network: while the link is down the tap skips frames, and when every
+ *   buffer is already queued for sending it drops them (both counted in
+ *   getStats()).  Wi-Fi joins and reconnects in the background.
+ *
+ * Console:
+ *   One TCP client at a time on NET_CONSOLE_PORT gets the serial_commands
+ *   console: serviceConsole() runs from the console task and feeds the
+ *   session through serial_commands::serviceInput() with the same response
+ *   buffering as USB.  A second client is refused.  "capture dump" and
+ *   "log dump" typed in the session stream back over it, paced to
+ *   NET_CONSOLE_TX_BUDGET_BYTES per console poll.
+ *
+ * The network is compiled in only when the build defines NET_WIFI_SSID
+ * (NET_ENABLED, config.h); otherwise every call is a no-op and
+ * isEnabled() is false.  The radio takes ADC2, so such a build polls the
+ * ADC2 acquisition inputs through the arbiter (acquisition.h).
+ * Target only.
+ */
+
+#ifndef NET_H
+#define NET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+namespace net {
+
+/** Counters reported by the "net" command. */
+struct Stats {
+    bool     linkUp;          ///< Wi-Fi associated with an IP address
+    bool     consoleClient;   ///< a TCP console session is open
+    uint32_t frames;          ///< frames packed into datagrams
+    uint32_t skipped;         ///< frames not sent: link down or streaming off
+    uint32_t dropped;         ///< frames not sent: every datagram buffer busy
+    uint32_t datagrams;       ///< datagrams sent
+    uint32_t sendErrors;      ///< datagrams the UDP stack refused
+};
+
+/** True when the build includes the network (NET_ENABLED). */
+constexpr bool isEnabled() { return NET_ENABLED != 0; }
+
+/**
+ * Start joining Wi-Fi (non-blocking), create the network task on
+ * COMMS_TASK_CORE and install the telemetry tap.  Call once in setup().
+ */
+void init();
+
+/** Telemetry task, after telemetry::service(): seal aged datagrams. */
+void flush();
+
+/** Console task: accept and service the TCP console session. */
+void serviceConsole();
+
+/**
+ * Send telemetry to @p ip (dotted quad; unicast or multicast) : @p port
+ * from now on.
+ *
+ * @return false if @p ip does not parse (destination unchanged)
+ */
+bool setDestination(const char* ip, uint16_t port);
+
+/** Current destination as "a.b.c.d:port" into @p buf. */
+void formatDestination(char* buf, size_t len);
+
+/** Enable or disable UDP streaming (the TCP console is unaffected). */
+void setStreaming(bool on);
+bool isStreaming();
+
+/** Local IP as a dotted quad into @p buf ("-" while the link is down). */
+void formatLocalIp(char* buf, size_t len);
+
+Stats getStats();
+void  resetStats();
+
+} // namespace net
+
+#endif // NET_H
@@ -0,0 +1,171 @@
+/**
+ * @file overstroke_detector.h
+ * @brief Adaptive-baseline overstroke spike detector (no hardware dependencies)
+ *
+ * Fed one ACS712 window RMS per update() (see rms.cpp).  Exponential moving
+ * averages track both the mean and the variance of the "normal" current,
+ * and an event is latched when the largest window since the previous
+ * update exceeds the mean by
+ *
+ *   excess = clamp(k·σ, OVERSTROKE_MIN_EXCESS_A, limit)
+ *
+ * at most once per debounce period.  The noise-normalised k·σ term keeps a
+ * noisy drive from tripping it while the floor keeps a quiet one from
+ * tripping on ADC quantisation; an excess of the limit always counts.  The
+ * caller picks k per state (setSigmaK(); rms.cpp uses a wider band while
+ * the cooldown moves the drive).  Limit and debounce default to
+ * OVERSTROKE_CURRENT_THRESHOLD_A / OVERSTROKE_DEBOUNCE_MS; rms.cpp
+ * refreshes them from the runtime parameters (params.h) through
+ * setLimits() before every update.  A reading beyond the mean ± excess
+ * moves the mean by at most α·excess and does not feed the variance, so a
+ * spike does not inflate its own threshold.
+ *
+ * Priming: detection is armed only after OVERSTROKE_PRIME_READINGS readings
+ * have seeded the mean and variance.  The current follows the DAC drive,
+ * so once the drive reported by setDrive() has moved
+ * OVERSTROKE_REPRIME_DAC_COUNTS from where the baseline was last seeded the
+ * mean is re-seeded over OVERSTROKE_REPRIME_READINGS readings (variance
+ * kept) rather than left to lag the new level.
+ *
+ * Harmonic check: when update() is given a harmonic ratio for the peak
+ * window (harmonic_window.h) a spike only counts if the ratio reaches the
+ * setHarmonicLimit() value: a larger but clean sinusoid is more drive, not
+ * a piston strike.  NO_HARMONICS (or a limit of 0) skips the check.
+ *
+ * The latch stays set until clear(), and no new event is raised while it
+ * is set.
+ *
+ * Shared by rms.cpp and the native plant simulation.
+ */
+
+#ifndef OVERSTROKE_DETECTOR_H
+#define OVERSTROKE_DETECTOR_H
+
+#include <math.h>
+#include <stdint.h>
+#include "config.h"
+
+class OverstrokeDetector {
+public:
+    /** update() harmonic ratio meaning "not measured". */
+    static constexpr float NO_HARMONICS = -1.0f;
+
+    void reset() { *this = OverstrokeDetector{}; }
+
+    /** Excess above the baseline that always counts (amps) and minimum event spacing. */
+    void setLimits(float thresholdA, uint32_t debounceMs) {
+        _limitA     = thresholdA;
+        _debounceMs = debounceMs;
+    }
+
+    /** Noise multiplier k of the threshold. */
+    void setSigmaK(float k) { _sigmaK = k; }
+
+    /** Minimum harmonic ratio of a spike window (0 = no harmonic check). */
+    void setHarmonicLimit(float ratio) { _harmonicLimit = ratio; }
+
+    /** Report the DAC drive in counts; a large enough move re-primes the mean. */
+    void setDrive(uint16_t dacCounts) {
+        const int32_t moved = static_cast<int32_t>(dacCounts) - static_cast<int32_t>(_driveAnchor);
+        if (!_haveDrive || !primed()) {
+            _haveDrive   = true;
+            _driveAnchor = dacCounts;
+            return;
+        }
+        if (moved >= static_cast<int32_t>(OVERSTROKE_REPRIME_DAC_COUNTS) ||
+            -moved >= static_cast<int32_t>(OVERSTROKE_REPRIME_DAC_COUNTS)) {
+            _driveAnchor = dacCounts;
+            _primeCount  = 0;
+            _primeTarget = OVERSTROKE_REPRIME_READINGS;
+            ++_reprimes;
+        }
+    }
+
+    /**
+     * Feed one reading.
+     *
+     * @param currentA       RMS of the newest window (amps)
+     * @param peakA          largest window RMS since the previous update (amps)
+     * @param nowMs          current millis()
+     * @param harmonicRatio  harmonic ratio of the @p peakA window, or NO_HARMONICS
+     * @return true if this reading latched a new event
+     */
+    bool update(float currentA, float peakA, uint32_t nowMs, float harmonicRatio = NO_HARMONICS) {
+        // Prime phase: a plain running mean (and, the first time, variance)
+        // of direct readings, so the baseline converges at once and
+        // detection is not armed prematurely.
+        if (_primeCount < _primeTarget) {
+            const float n = static_cast<float>(++_primeCount);
+            const float d = currentA - _meanA;
+            _meanA += d / n;
+            if (!_seeded) _varA2 += (d * (currentA - _meanA) - _varA2) / n;
+            if (_primeCount >= _primeTarget) _seeded = true;
+            return false;
+        }
+
+        const float excess = excessA();
+        bool event = false;
+        if (!_pending &&
+            (peakA - _meanA) > excess &&
+            (nowMs - _lastEventMs) >= _debounceMs &&
+            harmonicsAgree(harmonicRatio)) {
+            _pending     = true;
+            _lastEventMs = nowMs;
+            event        = true;
+        }
+
+        // Slow-tracking mean and variance; the small alpha keeps transients
+        // visible.  An outlier only nudges the mean (clipped, so a lasting
+        // shift is still followed) and leaves the variance alone, so spikes
+        // do not widen their own threshold.
+        const float d = currentA - _meanA;
+        if (d > excess || d < -excess) {
+            _meanA += OVERSTROKE_EMA_ALPHA * (d > 0.0f ? excess : -excess);
+            return event;
+        }
+        _meanA += OVERSTROKE_EMA_ALPHA * d;
+        _varA2  = (1.0f - OVERSTROKE_EMA_ALPHA) * (_varA2 + OVERSTROKE_EMA_ALPHA * d * d);
+        return event;
+    }
+
+    bool  primed() const    { return _seeded && _primeCount >= _primeTarget; }
+    float baselineA() const { return _meanA; }
+    float sigmaA() const    { return sqrtf(_varA2); }
+
+    /** Current above which a window counts as a spike (valid once primed()). */
+    float thresholdA() const { return _meanA + excessA(); }
+
+    /** Re-primes caused by drive moves since reset(). */
+    uint32_t reprimes() const { return _reprimes; }
+
+    bool pending() const { return _pending; }
+    void clear()         { _pending = false; }
+
+private:
+    float excessA() const {
+        float e = _sigmaK * sqrtf(_varA2);
+        if (e < OVERSTROKE_MIN_EXCESS_A) e = OVERSTROKE_MIN_EXCESS_A;
+        return (e > _limitA) ? _limitA : e;   // the limit wins over the floor
+    }
+
+    bool harmonicsAgree(float ratio) const {
+        return _harmonicLimit <= 0.0f || ratio < 0.0f || ratio >= _harmonicLimit;
+    }
+
+    float    _limitA        = OVERSTROKE_CURRENT_THRESHOLD_A;
+    uint32_t _debounceMs    = OVERSTROKE_DEBOUNCE_MS;
+    float    _sigmaK        = OVERSTROKE_SIGMA_K_STEADY;
+    float    _harmonicLimit = OVERSTROKE_HARMONIC_RATIO;
+    float    _meanA         = 0.0f;
+    float    _varA2         = 0.0f;
+    uint8_t  _primeCount    = 0;
+    uint8_t  _primeTarget   = OVERSTROKE_PRIME_READINGS;
+    bool     _seeded        = false;   // first prime done: variance is valid
+    bool     _haveDrive     = false;
+    uint16_t _driveAnchor   = 0;       // drive the mean was last seeded at
+    uint32_t _reprimes      = 0;
+    bool     _pending       = false;
+    uint32_t _lastEventMs   = 0;
+};
+
+#endif // OVERSTROKE_DETECTOR_H
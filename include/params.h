@@ -0,0 +1,155 @@
+/**
+ * @file params.h
+ * @brief Typed runtime parameter registry for the tunable config.h limits
+ *
+ * Each tunable has a constexpr descriptor (console name, type, unit,
+ * config.h default and accepted range) and one live value, which starts at
+ * the default.  Hot paths (state machine, overstroke detector, DAC slew)
+ * read the live value through the inline get() / getUint(): one array load,
+ * no lookup.
+ *
+ * Changes arrive as a batch (the "set" console command, or a stored profile
+ * at boot) and apply() commits all of them or none: every value is checked
+ * against its descriptor and the resulting set is checked as a whole (the
+ * setpoint band must sit below the coarse/fine threshold, the rate target
+ * at or below the rate limit) before any of it is stored.  Console
+ * commands run with the control mutex held, so a batch always lands
+ * between two control ticks.
+ *
+ * On target, save() writes the live values to NVS (Preferences namespace
+ * PARAMS_NVS_NAMESPACE, one key per parameter name) and load() applies
+ * whatever was stored at boot through the same checks, so a profile that
+ * no longer validates against this image is ignored.  On the native build
+ * there is no NVS: save() and erase() do nothing and load() finds nothing.
+ *
+ * The registry itself has no Arduino dependencies so it can be unit-tested
+ * natively.
+ */
+
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include <stdint.h>
+#include "config.h"
+
+namespace params {
+
+enum class Id : uint8_t {
+    SetpointK            = 0,   ///< SETPOINT_K
+    SetpointToleranceK   = 1,   ///< SETPOINT_TOLERANCE_K
+    CoarseFineK          = 2,   ///< COARSE_FINE_THRESHOLD_K
+    CooldownRate         = 3,   ///< COOLDOWN_RATE_TARGET_K_PER_MIN
+    MaxCooldownRate      = 4,   ///< MAX_COOLDOWN_RATE_K_PER_MIN
+    OverstrokeThresholdA = 5,   ///< OVERSTROKE_CURRENT_THRESHOLD_A
+    OverstrokeDebounceMs = 6,   ///< OVERSTROKE_DEBOUNCE_MS
+    BackoffDacStep       = 7,   ///< BACKOFF_DAC_STEP
+    BackoffMaxCount      = 8,   ///< BACKOFF_MAX_COUNT
+    DacMaxStep           = 9,   ///< DAC_MAX_STEP_PER_INTERVAL
+};
+
+static constexpr uint8_t COUNT = 10;
+
+/** Value type; Uint values are stored as floats but must be whole numbers. */
+enum class Type : uint8_t {
+    Float = 0,
+    Uint  = 1,
+};
+
+struct Descriptor {
+    Id          id;      ///< must equal the table index
+    const char* name;    ///< console and NVS key ("set <name> <value>"), ≤ 15 chars
+    Type        type;
+    const char* unit;
+    float       def;     ///< config.h value
+    float       min;
+    float       max;
+};
+
+static constexpr Descriptor DESCRIPTORS[COUNT] = {
+    // id                        name          type         unit     default / min / max
+    {Id::SetpointK,            "setpoint",   Type::Float, "K",     SETPOINT_K,                     40.0f,  150.0f},
+    {Id::SetpointToleranceK,   "tolerance",  Type::Float, "K",     SETPOINT_TOLERANCE_K,           0.1f,   10.0f},
+    {Id::CoarseFineK,          "threshold",  Type::Float, "K",     COARSE_FINE_THRESHOLD_K,        50.0f,  200.0f},
+    {Id::CooldownRate,         "rate",       Type::Float, "K/min", COOLDOWN_RATE_TARGET_K_PER_MIN, 0.05f,  5.0f},
+    {Id::MaxCooldownRate,      "maxrate",    Type::Float, "K/min", MAX_COOLDOWN_RATE_K_PER_MIN,    0.05f,  5.0f},
+    {Id::OverstrokeThresholdA, "overstroke", Type::Float, "A",     OVERSTROKE_CURRENT_THRESHOLD_A, 0.1f,   5.0f},
+    {Id::OverstrokeDebounceMs, "debounce",   Type::Uint,  "ms",    OVERSTROKE_DEBOUNCE_MS,         100.0f, 60000.0f},
+    {Id::BackoffDacStep,       "backoff",    Type::Uint,  "cnt",   BACKOFF_DAC_STEP,               1.0f,   1000.0f},
+    {Id::BackoffMaxCount,      "backoffs",   Type::Uint,  "",      BACKOFF_MAX_COUNT,              1.0f,   50.0f},
+    {Id::DacMaxStep,           "dacstep",    Type::Uint,  "cnt",   DAC_MAX_STEP_PER_INTERVAL,      1.0f,   100.0f},
+};
+
+constexpr bool descriptorsIndexed(uint8_t i = 0) {
+    return i == COUNT ||
+           (static_cast<uint8_t>(DESCRIPTORS[i].id) == i &&
+            DESCRIPTORS[i].def >= DESCRIPTORS[i].min && DESCRIPTORS[i].def <= DESCRIPTORS[i].max &&
+            descriptorsIndexed(static_cast<uint8_t>(i + 1)));
+}
+static_assert(descriptorsIndexed(), "DESCRIPTORS must be in Id order with defaults in range");
+
+namespace detail {
+extern float values[COUNT];   // live values, indexed by Id (params.cpp)
+}
+
+/** Descriptor for @p id. */
+inline const Descriptor& descriptor(Id id) { return DESCRIPTORS[static_cast<uint8_t>(id)]; }
+
+/** Live value of @p id. */
+inline float get(Id id) { return detail::values[static_cast<uint8_t>(id)]; }
+
+/** Live value of a Type::Uint parameter. */
+inline uint32_t getUint(Id id) { return static_cast<uint32_t>(get(id)); }
+
+/**
+ * Look up a parameter by console name.
+ *
+ * @return false if no parameter has that name
+ */
+bool find(const char* name, Id& id);
+
+/** One pending change in a batch. */
+struct Change {
+    Id    id;
+    float value;
+};
+
+/** Outcome of apply(). */
+enum class Result : uint8_t {
+    Ok           = 0,
+    OutOfRange   = 1,   ///< a value is outside its range, or not whole for Type::Uint
+    Inconsistent = 2,   ///< the resulting set fails a cross-parameter check
+};
+
+/**
+ * Validate and commit @p n changes together.  Later entries for the same
+ * id win.  Nothing is stored unless the result is Result::Ok.
+ *
+ * @param bad  set to the offending change's index for OutOfRange
+ */
+Result apply(const Change* changes, uint8_t n, uint8_t* bad = nullptr);
+
+/** Return every parameter to its config.h default (RAM only; see erase()). */
+void resetDefaults();
+
+/**
+ * Apply the profile stored in NVS, if any.  Call once in setup() before the
+ * control task starts.
+ *
+ * @return true if a stored profile was found and applied
+ */
+bool load();
+
+/**
+ * Write every live value to NVS.  Can erase a flash sector, so the console
+ * calls it outside the control mutex and only while Off or Idle.
+ *
+ * @return false if the write failed (live values are unaffected)
+ */
+bool save();
+
+/** Remove the stored profile, so the next boot starts from the defaults. */
+void erase();
+
+} // namespace params
+
+#endif // PARAMS_H
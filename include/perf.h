@@ -0,0 +1,255 @@
+/**
+ * @file perf.h
+ * @brief Cycle-count profiling probes with constant-memory histograms
+ *
+ * A probe is a fixed slot (Probe) that records how long one stage or
+ * driver call took, in CPU cycles:
+ *
+ *   PERF_SCOPE(perf::Probe::RtdRead);   // times the rest of the block
+ *
+ * Two probes are intervals rather than scopes, recorded by main.cpp's
+ * control jobs with perf::record(): ControlJitter (how far each control
+ * step started from its period) and SensorToDac (RTD read to the DAC pass
+ * that writes the resulting target).
+ *
+ * Each slot keeps count, min, max, sum and a log-linear histogram — exact
+ * below 16 cycles, then four sub-buckets per power of two (≤ 25 % bucket
+ * width) up to 2³² — so percentile() costs one scan of 128 counters and no
+ * sample is ever stored.  Counters are uint16_t; on saturation every bucket
+ * halves, which keeps the distribution's shape.  About 300 bytes per probe.
+ *
+ * Cycle source: ESP.getCycleCount() on target (wraps every ~17.9 s at
+ * 240 MHz, so a single stage must stay shorter than that), a
+ * steady_clock nanosecond count natively.  clockMHz() converts for display.
+ *
+ * Each probe must only be recorded from one task; readers (the "perf"
+ * command, telemetry) may see a torn snapshot, which is acceptable for
+ * diagnostics.  resetAll() from another task is deferred: each probe
+ * clears itself at its next record(), so its recorder stays its only
+ * writer.
+ *
+ * Setting PERF_ENABLED to false in config.h compiles every PERF_SCOPE out;
+ * the probe tables then stay empty.
+ *
+ * Header-only so it can be unit-tested natively.
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <atomic>
+#include <stdint.h>
+#include "config.h"
+
+#ifdef ARDUINO
+#  include <Arduino.h>
+#else
+#  include <chrono>
+#endif
+
+namespace perf {
+
+/** Instrumented stages.  One slot each; see probeName(). */
+enum class Probe : uint8_t {
+    ControlPass    = 0,    ///< one scheduler runDue() on the control core
+    RtdRead        = 1,    ///< temperature::read()
+    RtdFaults      = 2,    ///< temperature::checkFaults()
+    AmbientService = 3,    ///< temperature::serviceAmbient()
+    CurrentRms     = 4,    ///< rms::readCurrent()
+    VoltageRms     = 5,    ///< rms::read()
+    StateMachine   = 6,    ///< state_machine::update()
+    Actuators      = 7,    ///< relays, indicators, DAC target
+    DacRamp        = 8,    ///< dac::serviceRamp()
+    TelemetryEmit  = 9,    ///< telemetry::emit() (control core)
+    TelemetryTx    = 10,   ///< telemetry::service() (comms core)
+    Console        = 11,   ///< serial_commands::service() (comms core)
+    ControlJitter  = 12,   ///< |control job start-to-start − its period|
+    SensorToDac    = 13,   ///< RTD read → the dac pass applying the step computed from it
+};
+
+static constexpr uint8_t PROBE_COUNT = 14;
+
+/** Histogram buckets: 16 exact + 4 per octave for 2⁴ .. 2³². */
+static constexpr uint8_t HIST_BUCKETS = 16 + 28 * 4;
+
+/** Bucket holding @p cycles. */
+inline uint8_t bucketOf(uint32_t cycles) {
+    if (cycles < 16u) return static_cast<uint8_t>(cycles);
+    uint8_t e = 31;
+    while ((cycles >> e) == 0) --e;                        // floor(log2), >= 4
+    const uint8_t sub = static_cast<uint8_t>((cycles >> (e - 2u)) & 3u);
+    return static_cast<uint8_t>(16u + (e - 4u) * 4u + sub);
+}
+
+/** Largest cycle count that falls in bucket @p b. */
+inline uint32_t bucketUpper(uint8_t b) {
+    if (b < 16u) return b;
+    const uint8_t  e    = static_cast<uint8_t>(4u + (b - 16u) / 4u);
+    const uint32_t sub  = (b - 16u) % 4u;
+    const uint64_t base = (static_cast<uint64_t>(4u + sub) << (e - 2u));
+    const uint64_t top  = base + (1ull << (e - 2u)) - 1u;
+    return (top > 0xFFFFFFFFull) ? 0xFFFFFFFFu : static_cast<uint32_t>(top);
+}
+
+/** Distribution of one probe's durations, in cycles. */
+class Histogram {
+public:
+    /** Clear now.  Only from the task that records this probe. */
+    void reset() {
+        for (uint16_t& b : _bins) b = 0;
+        _count = 0;
+        _min   = 0;
+        _max   = 0;
+        _peak  = 0;
+        _sum   = 0;
+    }
+
+    /** Clear at the next record().  Thread-safe. */
+    void requestReset() { _resetRequested.store(true, std::memory_order_release); }
+
+    void record(uint32_t cycles) {
+        if (_resetRequested.load(std::memory_order_relaxed) &&
+            _resetRequested.exchange(false, std::memory_order_acq_rel)) {
+            reset();
+        }
+        ++_count;
+        _sum += cycles;
+        if (_count == 1u || cycles < _min) _min = cycles;
+        if (cycles > _max) _max = cycles;
+        if (cycles > _peak) _peak = cycles;
+
+        uint16_t& c = _bins[bucketOf(cycles)];
+        if (c == 0xFFFFu) {
+            for (uint16_t& b : _bins) b = static_cast<uint16_t>(b >> 1);
+        }
+        ++c;
+    }
+
+    /**
+     * Upper bound of the bucket holding the @p q quantile (0 < q <= 1),
+     * clamped to max().  0 when empty.
+     */
+    uint32_t percentile(float q) const {
+        uint32_t total = 0;
+        for (uint16_t b : _bins) total += b;
+        if (total == 0) return 0;
+        uint32_t rank = static_cast<uint32_t>(q * static_cast<float>(total) + 0.999f);
+        if (rank < 1u) rank = 1u;
+        uint32_t seen = 0;
+        for (uint8_t i = 0; i < HIST_BUCKETS; ++i) {
+            seen += _bins[i];
+            if (seen >= rank) {
+                const uint32_t upper = bucketUpper(i);
+                return (upper < _max) ? upper : _max;
+            }
+        }
+        return _max;
+    }
+
+    /** Longest duration since the previous call (for telemetry); resets it. */
+    uint32_t takePeak() {
+        const uint32_t p = _peak;
+        _peak = 0;
+        return p;
+    }
+
+    /** Samples in bucket @p b (0 .. HIST_BUCKETS-1); see bucketUpper(). */
+    uint16_t bin(uint8_t b) const { return _bins[b]; }
+
+    uint32_t count() const { return _count; }
+    uint32_t min() const   { return _min; }
+    uint32_t max() const   { return _max; }
+    uint64_t sum() const   { return _sum; }
+    uint32_t mean() const  { return _count ? static_cast<uint32_t>(_sum / _count) : 0u; }
+
+private:
+    uint16_t _bins[HIST_BUCKETS] = {};
+    uint32_t _count = 0;
+    uint32_t _min   = 0;
+    uint32_t _max   = 0;
+    uint32_t _peak  = 0;
+    uint64_t _sum   = 0;
+    std::atomic<bool> _resetRequested{false};
+};
+
+/** Current cycle counter. */
+inline uint32_t cycles() {
+#ifdef ARDUINO
+    return ESP.getCycleCount();
+#else
+    using namespace std::chrono;
+    return static_cast<uint32_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/** Cycles per microsecond of cycles(). */
+inline uint32_t clockMHz() {
+#ifdef ARDUINO
+    return getCpuFrequencyMhz();
+#else
+    return 1000u;   // nanoseconds
+#endif
+}
+
+/** The probe table. */
+inline Histogram* table() {
+    static Histogram probes[PROBE_COUNT];
+    return probes;
+}
+
+inline Histogram& probe(Probe p) { return table()[static_cast<uint8_t>(p)]; }
+
+inline void record(Probe p, uint32_t elapsedCycles) { probe(p).record(elapsedCycles); }
+
+/** Clear every probe at its next record().  Thread-safe. */
+inline void resetAll() {
+    for (uint8_t i = 0; i < PROBE_COUNT; ++i) table()[i].requestReset();
+}
+
+/** Times its own lifetime into probe @p p. */
+class Scope {
+public:
+    explicit Scope(Probe p) : _probe(p), _start(cycles()) {}
+    ~Scope() { record(_probe, cycles() - _start); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Probe    _probe;
+    uint32_t _start;
+};
+
+/** Return a short ASCII name for a probe. */
+inline const char* probeName(Probe p) {
+    switch (p) {
+        case Probe::ControlPass:    return "control";
+        case Probe::RtdRead:        return "rtd";
+        case Probe::RtdFaults:      return "rtdFault";
+        case Probe::AmbientService: return "ambient";
+        case Probe::CurrentRms:     return "current";
+        case Probe::VoltageRms:     return "rmsV";
+        case Probe::StateMachine:   return "fsm";
+        case Probe::Actuators:      return "actuate";
+        case Probe::DacRamp:        return "dac";
+        case Probe::TelemetryEmit:  return "tlmEmit";
+        case Probe::TelemetryTx:    return "tlmTx";
+        case Probe::Console:        return "console";
+        case Probe::ControlJitter:  return "jitter";
+        case Probe::SensorToDac:    return "rtd2dac";
+    }
+    return "?";
+}
+
+} // namespace perf
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b)  PERF_CONCAT_(a, b)
+
+#if PERF_ENABLED
+#  define PERF_SCOPE(p) const perf::Scope PERF_CONCAT(perfScope_, __LINE__)(p)
+#else
+#  define PERF_SCOPE(p) do {} while (0)
+#endif
+
+#endif // PERF_H
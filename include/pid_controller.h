@@ -0,0 +1,165 @@
+/**
+ * @file pid_controller.h
+ * @brief PID with feed-forward, anti-windup and bumpless retuning
+ *        (no hardware dependencies)
+ *
+ * The state machine runs one Pid instance for the DAC, switching what it
+ * regulates by state (gain scheduling lives in state_machine.cpp):
+ *
+ *   CoarseCooldown / FineCooldown   error = target rate − measured rate,
+ *                                   feed-forward = linear temperature map
+ *   Overshoot / Settle / Baseline / error = tempK − SETPOINT_K,
+ *   Operating                       no feed-forward (the integrator holds it)
+ *
+ *   u = ff + Kp·e + I + Kd·de/dt,   I += Ki·e·dt,   u clamped to [min, max]
+ *
+ * Anti-windup is conditional integration: the integrator may carry the
+ * output up to a limit but not further while the error pushes into it,
+ * or while the caller reports that the actuator is still slewing toward the
+ * last output (holdIntegral).  The integrator is itself bounded so no
+ * sequence of inputs can leave it far outside the output range.
+ *
+ * retune() makes the next update() bumpless: the integrator is re-seeded so
+ * the output is continuous across a change of gains, setpoint or error
+ * definition.  shift() moves the output by a fixed amount (back-EMF backoff)
+ * without the integrator fighting it back.
+ *
+ * Header-only so it can be unit-tested natively.
+ */
+
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+#include <math.h>
+#include <stdint.h>
+
+namespace control {
+
+/** Loop gains.  Units follow the error: output counts per error unit (·s). */
+struct Gains {
+    float kp;   ///< proportional
+    float ki;   ///< integral, per second
+    float kd;   ///< derivative, × seconds
+};
+
+/** First-order low-pass for noisy measurements (e.g. cooling rate). */
+struct LowPass {
+    float value  = 0.0f;
+    bool  primed = false;
+
+    void reset() { value = 0.0f; primed = false; }
+
+    /** Filter @p x with time constant @p tauS over @p dtS; tauS <= 0 passes through. */
+    float update(float x, float dtS, float tauS) {
+        if (!primed || tauS <= 0.0f) {
+            value  = x;
+            primed = true;
+            return value;
+        }
+        value += (x - value) * (dtS / (tauS + dtS));
+        return value;
+    }
+};
+
+class Pid {
+public:
+    /** Forget all history; the next update() starts from @p output with I = 0. */
+    void reset(float output = 0.0f) {
+        _integral  = 0.0f;
+        _prevError = 0.0f;
+        _output    = output;
+        _primed    = false;
+        _retune    = false;
+        _saturated = false;
+    }
+
+    /** Make the next update() bumpless with respect to the current output. */
+    void retune() { _retune = true; }
+
+    /** Move the output (and integrator) by @p delta, e.g. a DAC backoff. */
+    void shift(float delta) {
+        _integral += delta;
+        _output   += delta;
+    }
+
+    /**
+     * Advance the loop one step.
+     *
+     * @param g             Gains for this step
+     * @param error         Setpoint error; positive drives the output up
+     * @param feedForward   Open-loop output estimate
+     * @param dtS           Seconds since the previous update (0 = no I / D)
+     * @param outMin        Output lower limit
+     * @param outMax        Output upper limit
+     * @param holdIntegral  Freeze the integrator this step (actuator lagging)
+     * @return              New output, clamped to [outMin, outMax]
+     */
+    float update(const Gains& g, float error, float feedForward, float dtS,
+                 float outMin, float outMax, bool holdIntegral = false) {
+        const float p = g.kp * error;
+        float d = 0.0f;
+        if (_primed && !_retune && dtS > 0.0f) {
+            d = g.kd * (error - _prevError) / dtS;
+        }
+
+        if (_retune) {
+            _integral = _output - feedForward - p;
+            _retune   = false;
+        }
+
+        float integral = _integral;
+        if (!holdIntegral && dtS > 0.0f) {
+            integral += g.ki * error * dtS;
+        }
+        // Integrate up to the limit but never further into it
+        const float rest = feedForward + p + d;
+        if (error > 0.0f && rest + integral > outMax) {
+            integral = fminf(integral, fmaxf(_integral, outMax - rest));
+        } else if (error < 0.0f && rest + integral < outMin) {
+            integral = fmaxf(integral, fminf(_integral, outMin - rest));
+        }
+        const float span = outMax - outMin;
+        _integral = clamp(integral, -span - fabsf(feedForward), span + fabsf(feedForward));
+
+        const float u = feedForward + p + _integral + d;
+        _output    = clamp(u, outMin, outMax);
+        _saturated = (u != _output);
+        _prevError = error;
+        _primed    = true;
+        return _output;
+    }
+
+    float output() const    { return _output; }
+    float integral() const  { return _integral; }
+    bool  saturated() const { return _saturated; }
+
+private:
+    static float clamp(float x, float lo, float hi) {
+        return (x < lo) ? lo : (x > hi) ? hi : x;
+    }
+
+    float _integral  = 0.0f;
+    float _prevError = 0.0f;
+    float _output    = 0.0f;
+    bool  _primed    = false;
+    bool  _retune    = false;
+    bool  _saturated = false;
+};
+
+/**
+ * Cooling-rate target that tapers as the stage nears the setpoint:
+ * min(maxRate, (tempK − setpointK) / tauMin), never negative.  Following it
+ * makes the approach exponential with time constant tauMin instead of
+ * arriving at full rate and overshooting.
+ */
+inline float approachRate(float tempK, float setpointK, float maxRate, float tauMin) {
+    const float remaining = tempK - setpointK;
+    if (remaining <= 0.0f) return 0.0f;
+    if (tauMin <= 0.0f) return maxRate;
+    const float r = remaining / tauMin;
+    return (r < maxRate) ? r : maxRate;
+}
+
+} // namespace control
+
+#endif // PID_CONTROLLER_H
@@ -25,6 +25,13 @@
 // =============================================================================
 #define MAX31865_CS        1    // Chip Select for MAX31865 PT100
 
+// DRDY (active low, falls when a conversion result is ready and returns
+// high once the RTD registers are read).  Polled by temperature::read() in
+// auto-convert mode, with a fetch anyway after RTD_DRDY_TIMEOUT_CONVERSIONS
+// conversion times.  -1: not wired (the current board); reads are paced by
+// RTD_READ_INTERVAL_MS alone.  Set the GPIO here on a board that routes it.
+#define MAX31865_DRDY     -1
+
 // =============================================================================
 // AD9833 Waveform Generator
 // =============================================================================
@@ -78,6 +85,13 @@
 // stays within the ESP32-S3 ADC input range of 0–3.3 V.
 #define ACS712_CURRENT_PIN 14
 
+// NOTE: DAC_VOLTAGE_PIN is on ADC1; ACS712_CURRENT_PIN and VOLTAGE_12_TEST_PIN
+// are on ADC2.  All three are converted by the acquisition engine's DMA
+// pattern (acquisition.h), which therefore runs both ADC units.  ADC2 is
+// shared with the Wi-Fi radio, so a network build (NET_ENABLED) polls the
+// two ADC2 inputs through the driver's arbiter instead; a board revision
+// with all three on ADC1 pins (GPIO 1–10) keeps them on DMA.
+
 // =============================================================================
 // On-board WS2812 RGB Status LED
 // =============================================================================
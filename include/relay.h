@@ -8,13 +8,28 @@
  *                       HIGH = Normal mode (states 5, 6, 7 only).
  *
  *   ALARM_RELAY_PIN   - LOW = idle, HIGH = alarm (state 8 / Fault only).
+ *
+ * Commands are applied in the caller, so a relay follows the control step
+ * that asked for it with no queueing in between.  Only a change of level
+ * reaches the pin, and each change is timestamped (getStatus()).
  */
 
 #ifndef RELAY_H
 #define RELAY_H
 
+#include <stdint.h>
+
 namespace relay {
 
+/** Relay levels and when each last changed. */
+struct Status {
+    bool     normal;          ///< bypass relay in Normal mode
+    bool     alarm;           ///< alarm relay energised
+    uint32_t normalSinceMs;   ///< millis() of the last bypass relay change (or init())
+    uint32_t alarmSinceMs;    ///< millis() of the last alarm relay change (or init())
+    uint32_t switches;        ///< level changes of either relay since init()
+};
+
 /**
  * Initialize relay GPIO pins (outputs, defaulting to Bypass / alarm-off).
  */
@@ -32,6 +47,9 @@ void setBypass(bool normal);
  */
 void setAlarm(bool active);
 
+/** Current levels and change timestamps. */
+Status getStatus();
+
 } // namespace relay
 
 #endif // RELAY_H
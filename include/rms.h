@@ -10,18 +10,33 @@
  *      Still stubbed at 0 V until the hardware driver is implemented.
  *
  *   2. ACS712-05B AC current sensor (back-EMF / overstroke detection)
- *      readCurrent()     → samples the ACS712 and updates the EMA baseline.
+ *      The acquisition engine (DMA, AD9833_FREQ_HZ × ACS712_SAMPLES_PER_CYCLE)
+ *      streams raw ADC samples into a Σx² accumulator and publishes one
+ *      true-RMS value per window of ACS712_WINDOW_CYCLES drive cycles.
+ *      readCurrent()     → O(1): consumes the latest finished window and
+ *                          updates the adaptive baseline.
  *      getCurrentA()     → returns the latest RMS current in amps.
  *      hasOverstroke()   → true if a spike was detected since the last
  *                          clearOverstroke() call.
  *      clearOverstroke() → resets the overstroke flag after the caller has
  *                          processed the event.
  *
- * Overstroke detection fires when the instantaneous AC current exceeds the
- * exponential-moving-average baseline by more than OVERSTROKE_CURRENT_THRESHOLD_A,
- * subject to a per-event debounce of OVERSTROKE_DEBOUNCE_MS.  The EMA is
- * primed for OVERSTROKE_PRIME_READINGS ticks before spike detection is armed,
- * preventing false triggers on power-on.
+ * Overstroke detection fires when the peak window exceeds the baseline mean
+ * by a noise-normalised margin, k·σ clamped between OVERSTROKE_MIN_EXCESS_A
+ * and OVERSTROKE_CURRENT_THRESHOLD_A, with k chosen per state, subject to a
+ * per-event debounce of OVERSTROKE_DEBOUNCE_MS (see rms.cpp and
+ * overstroke_detector.h).  The baseline is primed for
+ * OVERSTROKE_PRIME_READINGS windows before spike detection is armed, and
+ * re-primed when the DAC drive moves, preventing false triggers on power-on
+ * and during ramps.  Optionally a spike must also distort the waveform
+ * (Goertzel 2nd/3rd harmonic ratio, harmonic_window.h).
+ *
+ * Burst capture: every raw sample also goes into a CAPTURE_SAMPLES ring
+ * (burst_capture.h).  The first RMS window whose value crosses the same
+ * threshold (baseline published by readCurrent()) freezes the ring with
+ * CAPTURE_POST_SAMPLES after the trigger, right in the sampler, so the
+ * window is aligned to the spike rather than to the 200 ms control tick.
+ * The frozen waveform is held until rearmCapture().
  */
 
 #ifndef RMS_H
@@ -37,7 +52,9 @@ namespace rms {
 
 /**
  * Initialise both the RMS-to-DC converter stub and the ACS712 sensor.
- * On hardware, calibrates the ACS712 zero-current offset via begin().
+ * On hardware, attaches to the acquisition engine's current channel and
+ * calibrates the zero-current offset from the first samples (the AC output
+ * must be off).  acquisition::init() must already have been called.
  * Must be called once in setup() before read() or readCurrent().
  */
 void init();
@@ -57,7 +74,13 @@ float getVoltage();
 // ---------------------------------------------------------------------------
 
 /**
- * Sample the ACS712-05B and update the EMA current baseline.
+ * Consume the most recent RMS window from the background sampler and update
+ * the current baseline (mean and variance).  Never blocks: if no new window has completed
+ * since the previous call, the cached reading is kept and the EMA is not
+ * re-fed.
+ *
+ * Spike detection uses the largest window seen since the previous call, so
+ * a brief overstroke is not lost when several windows finish per tick.
  *
  * Should be called once per main-loop control tick (LOOP_INTERVAL_MS cadence).
  * On the native (test) build this is a no-op; getCurrentA() returns 0.0f.
@@ -67,6 +90,25 @@ void readCurrent();
 /** Return the latest AC RMS current reading from the ACS712 in amps. */
 float getCurrentA();
 
+/**
+ * Set the number of AC drive cycles per RMS window.
+ * Clamped to [1, ACS712_MAX_WINDOW_CYCLES]; takes effect from the next
+ * window (the partial window in progress is discarded).
+ */
+void setWindowCycles(uint8_t cycles);
+
+/** Return the number of AC drive cycles per RMS window. */
+uint8_t getWindowCycles();
+
+/**
+ * Return the raw ACS712 sample rate in Hz (AD9833_FREQ_HZ ×
+ * ACS712_SAMPLES_PER_CYCLE, as programmed into the acquisition engine).
+ */
+float getSampleRateHz();
+
+/** Return the number of RMS windows completed since init(). */
+uint32_t getWindowCount();
+
 /**
  * Return true if an overstroke (back-EMF current spike) has been detected
  * since the last clearOverstroke() call.
@@ -82,6 +124,40 @@ bool hasOverstroke();
  */
 void clearOverstroke();
 
+// ---------------------------------------------------------------------------
+// Overstroke burst capture
+// ---------------------------------------------------------------------------
+
+/** Description of a frozen capture window. */
+struct CaptureInfo {
+    uint32_t triggerMs;      ///< millis() when the trigger window completed
+    uint32_t samples;        ///< window length (CAPTURE_SAMPLES)
+    uint32_t triggerIndex;   ///< first sample recorded after the trigger
+    float    sampleRateHz;   ///< raw sample rate
+    uint16_t midpoint;       ///< zero-current ADC count
+    float    peakA;          ///< RMS of the trigger window in amps
+    float    baselineA;      ///< EMA baseline at the trigger in amps
+    float    ampsPerCount;   ///< scale for (sample - midpoint) → amps
+};
+
+/**
+ * Return true and fill @p info if a capture window is frozen.
+ * Always false on the native build.
+ */
+bool getCaptureInfo(CaptureInfo& info);
+
+/**
+ * Return raw ADC sample @p i (0 = oldest) of the frozen capture window.
+ * Only valid while getCaptureInfo() returns true.
+ */
+uint16_t getCaptureSample(uint32_t i);
+
+/**
+ * Release the capture window and arm for the next overstroke.  The sampler
+ * applies it at its next sample; getCaptureInfo() is false from this call.
+ */
+void rearmCapture();
+
 } // namespace rms
 
 #endif // RMS_H
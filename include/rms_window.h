@@ -0,0 +1,65 @@
+/**
+ * @file rms_window.h
+ * @brief Streaming true-RMS accumulator (no hardware dependencies)
+ *
+ * Accumulates Σx² of zero-centred samples over a fixed-length window and
+ * yields the RMS of each completed window.  Each push() is O(1) and the
+ * square root is only taken once per window, so it is cheap enough to be
+ * fed from a sampling timer callback on target.
+ *
+ * Free of Arduino includes so it can be unit-tested natively.
+ */
+
+#ifndef RMS_WINDOW_H
+#define RMS_WINDOW_H
+
+#include <math.h>
+#include <stdint.h>
+
+namespace rms {
+
+/** Running Σx² accumulator for one RMS window. */
+struct RmsWindow {
+    uint64_t sumSq;     ///< Σ(sample²) for the window in progress
+    uint32_t count;     ///< samples accumulated in the window in progress
+    uint32_t length;    ///< samples per window (>= 1)
+};
+
+/**
+ * Reset @p w and set its window length.  Any partial window is discarded.
+ *
+ * @param w       Accumulator to reset
+ * @param length  Samples per window; values below 1 are treated as 1
+ */
+inline void rmsWindowReset(RmsWindow& w, uint32_t length) {
+    w.sumSq  = 0;
+    w.count  = 0;
+    w.length = (length < 1u) ? 1u : length;
+}
+
+/**
+ * Add one zero-centred sample to the window.
+ *
+ * @param w        Accumulator
+ * @param sample   Sample value with the DC offset already removed
+ * @param rmsOut   Receives the window RMS (same units as @p sample) when
+ *                 this sample completes the window; untouched otherwise
+ * @return         true if a window was completed by this sample
+ */
+inline bool rmsWindowPush(RmsWindow& w, int32_t sample, float& rmsOut) {
+    const int64_t s = sample;
+    w.sumSq += static_cast<uint64_t>(s * s);
+    if (++w.count < w.length) {
+        return false;
+    }
+
+    const double meanSq = static_cast<double>(w.sumSq) / static_cast<double>(w.count);
+    rmsOut  = static_cast<float>(sqrt(meanSq));
+    w.sumSq = 0;
+    w.count = 0;
+    return true;
+}
+
+} // namespace rms
+
+#endif // RMS_WINDOW_H
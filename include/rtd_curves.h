@@ -0,0 +1,132 @@
+/**
+ * @file rtd_curves.h
+ * @brief RTD calibration curves for the compile-time lookup table
+ *
+ * A curve is any literal type with two constexpr members:
+ *
+ *   double ohmsAt(double kelvin) const;    // R(T), monotonic increasing
+ *   double kelvinAt(double ohms) const;    // its inverse
+ *
+ * rtd::makeRtdLut() is templated on the curve type, so whichever curve
+ * RTD_CURVE (config.h) names is evaluated entirely by the compiler; changing
+ * sensor costs nothing at run time.
+ *
+ * Provided curves:
+ *   CvdCurve       IEC 60751 Callendar–Van Dusen for any R0 — PT100,
+ *                  PT1000 or any other α = 0.00385 element
+ *   TableCurve<N>  resistance → kelvin breakpoints, e.g. a vendor
+ *                  calibration certificate for one serial-numbered unit
+ *
+ * Adding a calibrated unit:
+ *
+ *   namespace rtd { namespace units {
+ *   constexpr TableCurve<4> SN1234 = {{
+ *       // ohms, kelvin — ascending, straight from the certificate
+ *       {  7.95,  40.0 }, { 20.38,  77.35 }, { 60.26, 172.0 }, { 110.9, 300.0 },
+ *   }};
+ *   }}
+ *
+ * and set RTD_CURVE to rtd::units::SN1234.  (Values above are placeholders.)
+ *
+ * Header-only with no Arduino dependencies beyond conversions.h so curves
+ * can be unit-tested natively.
+ */
+
+#ifndef RTD_CURVES_H
+#define RTD_CURVES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "conversions.h"
+
+namespace rtd {
+
+// IEC 60751 Callendar–Van Dusen coefficients (α = 0.00385 platinum)
+static constexpr double CVD_A = 3.9083e-3;
+static constexpr double CVD_B = -5.775e-7;
+static constexpr double CVD_C = -4.183e-12;
+
+/** CVD resistance of an RTD with 0 °C resistance @p r0 at @p tempC. */
+constexpr double cvdResistance(double r0, double tempC) {
+    const double t = tempC;
+    double r = 1.0 + CVD_A * t + CVD_B * t * t;
+    if (t < 0.0) {
+        r += CVD_C * (t - 100.0) * t * t * t;
+    }
+    return r0 * r;
+}
+
+/**
+ * Invert cvdResistance() by bisection.  The curve is monotonic over
+ * [-260 °C, 850 °C], the bracket used here.
+ *
+ * @return  Temperature in Kelvin
+ */
+constexpr double cvdKelvin(double r0, double ohms) {
+    double lo = -260.0;
+    double hi = 850.0;
+    for (int i = 0; i < 64; ++i) {
+        const double mid = 0.5 * (lo + hi);
+        if (cvdResistance(r0, mid) < ohms) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi) + 273.15;
+}
+
+/**
+ * IEC 60751 curve for an element of nominal 0 °C resistance r0.  Exact to
+ * the standard down to 73.15 K; below that it is the CVD extrapolation.
+ */
+struct CvdCurve {
+    double r0;
+
+    constexpr double ohmsAt(double kelvin) const { return cvdResistance(r0, kelvin - 273.15); }
+    constexpr double kelvinAt(double ohms) const { return cvdKelvin(r0, ohms); }
+};
+
+static constexpr CvdCurve PT100{100.0};
+static constexpr CvdCurve PT1000{1000.0};
+
+/** One calibration point. */
+struct Breakpoint {
+    double ohms;
+    double kelvin;
+};
+
+/**
+ * Measured resistance → temperature table, piecewise linear between
+ * breakpoints and clamped at the ends.  Points must be ascending in both
+ * columns.
+ */
+template <size_t N>
+struct TableCurve {
+    static_assert(N >= 2, "TableCurve needs at least two breakpoints");
+
+    Breakpoint points[N];
+
+    constexpr double ohmsAt(double kelvin) const {
+        return interpolateColumn(kelvin, &Breakpoint::kelvin, &Breakpoint::ohms);
+    }
+    constexpr double kelvinAt(double ohms) const {
+        return interpolateColumn(ohms, &Breakpoint::ohms, &Breakpoint::kelvin);
+    }
+
+private:
+    constexpr double interpolateColumn(double v, double Breakpoint::*from,
+                                       double Breakpoint::*to) const {
+        double xs[N] = {};
+        double ys[N] = {};
+        for (size_t i = 0; i < N; ++i) {
+            xs[i] = points[i].*from;
+            ys[i] = points[i].*to;
+        }
+        return conversions::interpolate(xs, ys, v);
+    }
+};
+
+} // namespace rtd
+
+#endif // RTD_CURVES_H
@@ -0,0 +1,96 @@
+/**
+ * @file rtd_lut.h
+ * @brief Compile-time RTD code → temperature lookup table (no hardware dependencies)
+ *
+ * The MAX31865 returns a 15-bit ratio code = 32768 × R_rtd / R_ref.  Instead
+ * of converting that to ohms and solving a calibration curve in float on
+ * every read, makeRtdLut() evaluates the curve's inverse (rtd_curves.h) at
+ * compile time on a uniform grid of codes spanning [minK, maxK], and
+ * lookupMilliK() turns a live code into milli-kelvin with one shift, one
+ * subtract and one integer multiply.
+ *
+ * With rtd::CvdCurve the table follows the full IEC 60751 equation,
+ * including the C term below 0 °C, so it tracks the standard curve exactly
+ * down to its 73.15 K limit (the Adafruit library's sub-zero polynomial
+ * drifts there).  Below 73.15 K a CVD curve is an extrapolation of the fit;
+ * units that need accuracy there should use a TableCurve of measured
+ * breakpoints.
+ *
+ * Header-only and constexpr so the table lands in flash and the module can
+ * be unit-tested natively.  Requires C++14 or later (loops in constexpr).
+ */
+
+#ifndef RTD_LUT_H
+#define RTD_LUT_H
+
+#include <stdint.h>
+#include "rtd_curves.h"
+
+namespace rtd {
+
+/** Full-scale MAX31865 ratio code (R_rtd == R_ref). */
+static constexpr uint32_t CODE_FULL_SCALE = 32768u;
+
+/** Maximum number of table entries (sets flash use: 4 bytes each). */
+static constexpr uint16_t LUT_CAPACITY = 512;
+
+/** Uniform-in-code table of temperatures in milli-kelvin. */
+struct RtdLut {
+    uint16_t codeMin;                  ///< code of entry 0
+    uint8_t  shift;                    ///< log2(codes per entry)
+    uint16_t count;                    ///< entries used (<= LUT_CAPACITY)
+    int32_t  milliK[LUT_CAPACITY];     ///< temperature at codeMin + (i << shift)
+};
+
+/**
+ * Build the table for an RTD following @p curve, read through reference
+ * resistor @p rRef, covering at least [minK, maxK].  The grid step is the
+ * smallest power of two that fits in LUT_CAPACITY entries.
+ */
+template <typename Curve>
+constexpr RtdLut makeRtdLut(const Curve& curve, double rRef, double minK, double maxK) {
+    RtdLut lut{};
+
+    const double codeLo = curve.ohmsAt(minK) / rRef * CODE_FULL_SCALE;
+    const double codeHi = curve.ohmsAt(maxK) / rRef * CODE_FULL_SCALE;
+    const uint32_t first = (codeLo > 0.0) ? static_cast<uint32_t>(codeLo) : 0u;
+    const uint32_t last  = static_cast<uint32_t>(codeHi) + 1u;
+
+    uint8_t shift = 0;
+    while (((last - first) >> shift) + 2u > LUT_CAPACITY) {
+        ++shift;
+    }
+
+    lut.codeMin = static_cast<uint16_t>(first);
+    lut.shift   = shift;
+    lut.count   = static_cast<uint16_t>(((last - first) >> shift) + 2u);
+    for (uint16_t i = 0; i < lut.count; ++i) {
+        const double code = static_cast<double>(first + (static_cast<uint32_t>(i) << shift));
+        const double k    = curve.kelvinAt(code / CODE_FULL_SCALE * rRef);
+        lut.milliK[i]     = static_cast<int32_t>(k * 1000.0 + 0.5);
+    }
+    return lut;
+}
+
+/**
+ * Convert a 15-bit MAX31865 ratio code to milli-kelvin by linear
+ * interpolation in @p lut.  Codes outside the table clamp to its ends.
+ */
+inline int32_t lookupMilliK(const RtdLut& lut, uint16_t code) {
+    if (code <= lut.codeMin) {
+        return lut.milliK[0];
+    }
+    const uint32_t offset = static_cast<uint32_t>(code - lut.codeMin);
+    const uint32_t idx    = offset >> lut.shift;
+    if (idx + 1u >= lut.count) {
+        return lut.milliK[lut.count - 1u];
+    }
+    const int32_t frac = static_cast<int32_t>(offset & ((1u << lut.shift) - 1u));
+    const int32_t lo   = lut.milliK[idx];
+    const int32_t span = lut.milliK[idx + 1u] - lo;   // > 0: curve is monotonic
+    return lo + ((span * frac) >> lut.shift);
+}
+
+} // namespace rtd
+
+#endif // RTD_LUT_H
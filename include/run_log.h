@@ -0,0 +1,113 @@
+/**
+ * @file run_log.h
+ * @brief Persistent run log — temperature samples, state transitions,
+ *        faults and backoffs in a circular flash partition
+ *
+ * Records (log_store.h) go to the raw RUN_LOG_PARTITION_LABEL data
+ * partition, 16 bytes each, batched into 256-byte page writes.  The oldest
+ * 4 KB sector is erased and reused when the partition fills, so the log
+ * keeps the most recent partition-size − 4 KB of history, less the sectors
+ * erased ahead (~81 000 records, nine days of 10 s samples on the default
+ * 1.375 MB partition) and survives
+ * reboots and power cuts; at most the records still buffered in RAM are
+ * lost.
+ *
+ * What is logged:
+ *   Boot        once from init(), detail = esp_reset_reason()
+ *   Sample      every RUN_LOG_SAMPLE_INTERVAL_MS (control core "log" job)
+ *   Transition  every state change (state_machine::setTransitionHook())
+ *   Fault       alongside the transition into Fault, detail = FaultReason
+ *   Backoff     each back-EMF backoff, detail = backoff count
+ *
+ * Threading:
+ *   The log* functions only copy a record into an SPSC queue of
+ *   RUN_LOG_QUEUE_DEPTH and never touch flash, so they are safe on the
+ *   control core.  They are called from the control tick and from console
+ *   commands; both hold controlMutex, which keeps the queue single-producer.
+ *   A full queue drops the record and counts it.
+ *
+ *   service(), read() and every other accessor belong to the console task,
+ *   which owns the flash.  service() drains the queue into the store and
+ *   writes the page buffer immediately after a transition, fault or backoff,
+ *   and otherwise once a buffered record is RUN_LOG_FLUSH_INTERVAL_MS old.
+ *   A 4 KB sector erase takes tens of ms with flash cache disabled on both
+ *   cores, which stalls the control task, so service() only erases while
+ *   the cooler is idle, keeping RUN_LOG_ERASE_AHEAD_SECTORS erased ahead
+ *   of the head.  A run enters those without erasing (one per 256
+ *   records) until the reserve is used up.
+ */
+
+#ifndef RUN_LOG_H
+#define RUN_LOG_H
+
+#include <stdint.h>
+#include "log_store.h"
+#include "state_machine.h"
+
+namespace run_log {
+
+/** Queue and flash counters (see getStats()). */
+struct Stats {
+    StoreStats store;       ///< appends, page writes, erases, write errors
+    uint32_t   dropped;     ///< records lost to a full queue
+    uint32_t   queueHigh;   ///< queue high-water mark
+    uint32_t   maxWriteUs;  ///< longest service() pass that wrote or erased flash
+    uint32_t   hotErases;   ///< sector erases while the cooler was running
+    uint32_t   erasedAhead; ///< sectors currently erased ahead of the head
+};
+
+/**
+ * Mount the partition and log a Boot record.  Call once in setup() before
+ * the tasks start.
+ *
+ * @return false if the partition is missing or too small; every other call
+ *         is then a no-op
+ */
+bool init(uint32_t nowMs);
+
+/** True once init() has mounted the partition. */
+bool isMounted();
+
+/** Queue a periodic sample. */
+void logSample(uint32_t nowMs, float tempK, uint16_t dac,
+               state_machine::State state, uint16_t backoffCount);
+
+/** Queue a state change (and a Fault record when @p to is Fault). */
+void logTransition(state_machine::State from, state_machine::State to,
+                   state_machine::FaultReason reason, uint32_t nowMs,
+                   float tempK, uint16_t dac);
+
+/** Queue a back-EMF backoff event. */
+void logBackoff(uint32_t nowMs, float tempK, uint16_t dac,
+                state_machine::State state, uint16_t backoffCount);
+
+/**
+ * Drain queued records to flash.  Call periodically (console task).
+ *
+ * @param idle  true while the cooler is not being controlled (Off / Idle):
+ *              one sector of the RUN_LOG_ERASE_AHEAD_SECTORS reserve is
+ *              then erased per call
+ */
+void service(uint32_t nowMs, bool idle);
+
+/** Oldest sequence number still stored. */
+uint32_t oldestSeq();
+
+/** Sequence number the next record will get (one past the newest). */
+uint32_t nextSeq();
+
+/** Records kept before the oldest are overwritten. */
+uint32_t capacity();
+
+/**
+ * Read record @p seq straight from flash (or the unwritten page).
+ *
+ * @return false if it is out of range or unreadable
+ */
+bool read(uint32_t seq, Record& r);
+
+Stats getStats();
+
+} // namespace run_log
+
+#endif // RUN_LOG_H
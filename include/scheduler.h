@@ -0,0 +1,164 @@
+/**
+ * @file scheduler.h
+ * @brief Cooperative fixed-period task scheduler with WCET / overrun
+ *        statistics (no hardware dependencies)
+ *
+ * Each Task has its own period and phase offset on a shared microsecond
+ * clock.  runDue() runs every task whose release time has passed, in table
+ * order (earlier entries win ties, so put the most latency-sensitive task
+ * first), and returns how long the caller may sleep before the next
+ * release.  Tasks run to completion; nothing is pre-empted.
+ *
+ * Releases stay on the task's own grid (phase + k × period) however late a
+ * run starts, so jitter never accumulates into drift.  A run that starts a
+ * whole period or more late skips the missed releases rather than running
+ * back-to-back to catch up, and counts them.
+ *
+ * Per-task statistics:
+ *   runs      completed runs
+ *   lastUs / maxUs / totalUs   execution time (maxUs = observed WCET)
+ *   overruns  runs whose execution time exceeded the task's budget
+ *             (budgetUs, or the period when 0)
+ *   skipped   releases dropped because the task started too late
+ *   maxLateUs worst release-to-start latency
+ *
+ * Statistics are written only by the thread calling runDue(); readers on
+ * other threads may see a torn snapshot, which is acceptable for
+ * diagnostics.  resetStats() from another thread is deferred to the next
+ * runDue().
+ *
+ * The clock is injected, so the scheduler is unit-tested natively.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <stdint.h>
+
+namespace sched {
+
+using TaskFn  = void (*)();
+using ClockFn = uint32_t (*)();   ///< free-running microsecond counter (wraps)
+
+struct TaskStats {
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t skipped;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint32_t maxLateUs;
+    uint64_t totalUs;
+};
+
+struct Task {
+    const char* name;
+    TaskFn      fn;
+    uint32_t    periodUs;   ///< release interval (>= 1)
+    uint32_t    phaseUs;    ///< offset of the first release after start()
+    uint32_t    budgetUs;   ///< execution-time budget; 0 = periodUs
+
+    // ---- Owned by the scheduler ------------------------------------------
+    uint32_t    nextUs;
+    TaskStats   stats;
+};
+
+class Scheduler {
+public:
+    Scheduler(Task* tasks, uint8_t count, ClockFn clock)
+        : _tasks(tasks), _count(count), _clock(clock) {}
+
+    /** Schedule every task's first release at now + phase and zero stats. */
+    void start() {
+        const uint32_t now = _clock();
+        for (uint8_t i = 0; i < _count; ++i) {
+            if (_tasks[i].periodUs == 0) _tasks[i].periodUs = 1;
+            _tasks[i].nextUs = now + _tasks[i].phaseUs;
+        }
+        clearStats();
+    }
+
+    /**
+     * Run every task that is due, highest priority (lowest index) first.
+     *
+     * @return  Microseconds until the next release (0 if one is already due)
+     */
+    uint32_t runDue() {
+        if (_resetRequested.exchange(false, std::memory_order_acq_rel)) {
+            clearStats();
+        }
+
+        for (uint8_t i = 0; i < _count; ++i) {
+            Task& t = _tasks[i];
+            const uint32_t start = _clock();
+            const int32_t  late  = static_cast<int32_t>(start - t.nextUs);
+            if (late < 0) continue;
+
+            t.fn();
+            const uint32_t execUs = _clock() - start;
+
+            TaskStats& s = t.stats;
+            ++s.runs;
+            s.lastUs   = execUs;
+            s.totalUs += execUs;
+            if (execUs > s.maxUs) s.maxUs = execUs;
+            if (static_cast<uint32_t>(late) > s.maxLateUs) s.maxLateUs = static_cast<uint32_t>(late);
+            if (execUs > budget(t)) ++s.overruns;
+
+            // Next release on the task's grid, skipping any already missed
+            const uint32_t missed = static_cast<uint32_t>(late) / t.periodUs;
+            s.skipped += missed;
+            t.nextUs  += (missed + 1u) * t.periodUs;
+        }
+
+        const uint32_t now  = _clock();
+        uint32_t       wait = UINT32_MAX;
+        for (uint8_t i = 0; i < _count; ++i) {
+            const int32_t until = static_cast<int32_t>(_tasks[i].nextUs - now);
+            if (until <= 0) return 0;
+            if (static_cast<uint32_t>(until) < wait) wait = static_cast<uint32_t>(until);
+        }
+        return wait;
+    }
+
+    /**
+     * Change task @p i's period from its next release on.  Only call from
+     * the thread that runs runDue() (or before start()).
+     */
+    void setPeriod(uint8_t i, uint32_t periodUs) {
+        if (i < _count) _tasks[i].periodUs = (periodUs == 0) ? 1u : periodUs;
+    }
+
+    /** Zero every task's statistics at the next runDue().  Thread-safe. */
+    void resetStats() { _resetRequested.store(true, std::memory_order_release); }
+
+    uint8_t     count() const          { return _count; }
+    const Task& task(uint8_t i) const  { return _tasks[i]; }
+
+    /** Index of the task named @p name, or count() if there is none. */
+    uint8_t find(const char* name) const {
+        for (uint8_t i = 0; i < _count; ++i) {
+            const char* a = _tasks[i].name;
+            const char* b = name;
+            while (*a && *a == *b) { ++a; ++b; }
+            if (*a == '\0' && *b == '\0') return i;
+        }
+        return _count;
+    }
+
+private:
+    static uint32_t budget(const Task& t) { return t.budgetUs ? t.budgetUs : t.periodUs; }
+
+    void clearStats() {
+        for (uint8_t i = 0; i < _count; ++i) _tasks[i].stats = TaskStats{};
+    }
+
+    Task*             _tasks;
+    uint8_t           _count;
+    ClockFn           _clock;
+    std::atomic<bool> _resetRequested{false};
+};
+
+} // namespace sched
+
+#endif // SCHEDULER_H
@@ -7,12 +7,29 @@
  *   stop    - Abort the process and return to Idle
  *   off     - Power off the system entirely
  *   status  - Print current state and running flag
+ *   tasks   - Control-core job periods, WCET, overruns ("tasks reset")
+ *   perf    - Per-stage timing histograms ("perf reset")
+ *   log     - Run-log range and flash counters ("log dump [from]")
+ *   net     - Wi-Fi telemetry and TCP console ("net dest <ip> [port]", "net on|off")
+ *   spi     - Per-device SPI bus time ("spi reset")
  *   board   - Print compile-time board/platform info
- *   help    - List available commands
+ *   get     - Show runtime parameters ("get [name]", "get profile")
+ *   set     - Change and store parameters ("set <name> <value> ...", "set defaults")
+ *   help    - List available commands ("help [word]")
  *
  * Usage:
  *   Call serial_commands::init() once in setup() after Serial.begin().
- *   Call serial_commands::service() every loop() iteration.
+ *   Call serial_commands::service() periodically from the console task.
+ *   Other byte streams (the TCP console, net.h) get their own LineInput and
+ *   call serviceInput() from the same task.
+ *
+ * Threading:
+ *   service() runs each command into a RAM response buffer with the
+ *   dispatch lock held (see setDispatchLock()), then releases the lock
+ *   before writing the response to the session that sent it.  A stalled USB
+ *   host or TCP client therefore never holds up the control task waiting on
+ *   the same lock.  Every session shares that one buffer, so all of them
+ *   must be serviced from the console task.
  *
  * Testing:
  *   Call serial_commands::processLine() directly with a stub Print to
@@ -22,17 +39,77 @@
 #ifndef SERIAL_COMMANDS_H
 #define SERIAL_COMMANDS_H
 
-// Forward declaration — resolved by <Arduino.h> on target, Print.h stub on native.
+#include <stdint.h>
+
+// Forward declarations — resolved by <Arduino.h> on target, Print.h stub on native.
 class Print;
+class Stream;
+
+namespace sched { class Scheduler; }
 
 namespace serial_commands {
 
+/** Longest accepted command line; room for a full "set" profile. */
+static constexpr uint16_t MAX_LINE_LEN = 256;
+
+/** Line accumulator for one input session (Serial, a TCP client). */
+struct LineInput {
+    char     buf[MAX_LINE_LEN + 1];
+    uint16_t len;
+    bool     overflow;   ///< input ran past MAX_LINE_LEN; line is dropped
+
+    void reset() {
+        len      = 0;
+        overflow = false;
+        buf[0]   = '\0';
+    }
+};
+
 /** Initialise the line buffer.  Call after Serial.begin(). */
 void init();
 
-/** Non-blocking service call.  Call every loop() iteration. */
+/** Non-blocking service call.  Call periodically (console task). */
 void service();
 
+/**
+ * Make service() read from and answer on @p io instead of Serial
+ * (nullptr = Serial).  The on-target soak benchmark floods the console
+ * through it.  The switch takes effect at the next service() call.
+ */
+void setStream(Stream* io);
+
+/**
+ * Read everything @p in has buffered into @p input and dispatch each
+ * complete line, writing its response to @p out.  Target only; call from
+ * the console task (see Threading).
+ */
+void serviceInput(Stream& in, Print& out, LineInput& input);
+
+/**
+ * Tell the console that the session writing to @p out has closed: a
+ * "capture dump" or "log dump" it started is abandoned.  Dumps stream to
+ * the session that typed them, paced by its availableForWrite().  Target
+ * only; console task.
+ */
+void endSession(Print& out);
+
+/** Hook used to bracket command dispatch; see setDispatchLock(). */
+using LockHook = void (*)();
+
+/**
+ * Install hooks that service() calls immediately before and after
+ * dispatching each complete line.  Used to serialise commands (which call
+ * state_machine::start()/stop()/off()) against the control task.
+ * Pass nullptr for both to disable (the default).
+ */
+void setDispatchLock(LockHook lock, LockHook unlock);
+
+/**
+ * Scheduler reported by the "tasks" command.  nullptr (the default)
+ * makes "tasks" report that no scheduler is running.
+ */
+void setScheduler(sched::Scheduler* scheduler);
+
 /**
  * Parse and dispatch one null-terminated command line.
  * Exposed for unit testing: inject any Print to capture the response.
@@ -0,0 +1,62 @@
+/**
+ * @file slew_limiter.h
+ * @brief Fixed-point DAC slew limiter (no hardware dependencies)
+ *
+ * Moves an output toward a target by at most a fractional number of counts
+ * per call.  The allowance is kept in Q8 (counts × 256): each step() banks
+ * creditQ8 and spends whole counts as they become available, so a limit of
+ * e.g. 5 counts per 200 ms serviced every 20 ms moves the output in 1-count
+ * steps instead of one 5-count jump per 200 ms.  Credit is dropped once the
+ * target is reached, so a settled output never jumps on the next change.
+ *
+ * Used by dac.cpp and by the native plant simulation, so both slew the
+ * same way.
+ */
+
+#ifndef SLEW_LIMITER_H
+#define SLEW_LIMITER_H
+
+#include <stdint.h>
+
+class SlewLimiter {
+public:
+    /** @param creditQ8  Allowance added per step(), in counts × 256 */
+    explicit SlewLimiter(uint32_t creditQ8) : _creditQ8(creditQ8) {}
+
+    /** Change the per-step allowance; banked credit is kept. */
+    void     setCredit(uint32_t creditQ8) { _creditQ8 = creditQ8; }
+
+    void     setTarget(uint16_t target) { _target = target; }
+    uint16_t target() const             { return _target; }
+
+    /** Drop any target and banked allowance. */
+    void reset() {
+        _target = 0;
+        _bankQ8 = 0;
+    }
+
+    /** Next output from @p current: one period's allowance toward target(). */
+    uint16_t step(uint16_t current) {
+        if (current == _target) {
+            _bankQ8 = 0;   // no banked slew once settled
+            return current;
+        }
+        _bankQ8 += _creditQ8;
+        const uint32_t allowed = _bankQ8 >> 8;
+        if (allowed == 0) return current;
+
+        const uint16_t gap  = (current < _target) ? _target - current : current - _target;
+        const uint16_t step = (gap < allowed) ? gap : static_cast<uint16_t>(allowed);
+        _bankQ8 -= static_cast<uint32_t>(step) << 8;
+        if (step == gap) _bankQ8 = 0;
+
+        return (current < _target) ? current + step : current - step;
+    }
+
+private:
+    uint32_t _creditQ8;
+    uint32_t _bankQ8 = 0;
+    uint16_t _target = 0;
+};
+
+#endif // SLEW_LIMITER_H
@@ -0,0 +1,105 @@
+/**
+ * @file spi_bus.h
+ * @brief Shared SPI bus manager for the MAX31865, AD9833 and MCP4921
+ *
+ * One owner for the bus that all three devices share:
+ *
+ *   - Per-device SPISettings and CS pin, built once in init() instead of on
+ *     every transfer.
+ *   - A recursive FreeRTOS mutex around every access, so drivers may run
+ *     from any task (and call each other while holding it).
+ *   - Batches: a Batch held across several transfers takes the mutex and
+ *     the SPI host once, and consecutive transfers to the same device stay
+ *     inside one beginTransaction().  The control task holds one across
+ *     each scheduler pass, so e.g. the DAC write and the RTD fetch due on
+ *     the same wake go out back-to-back.
+ *   - Per-device bus-time counters (transactions, bytes, busy time, worst
+ *     transfer, time spent waiting for the bus) for profiling.
+ *
+ * The Adafruit MAX31865 and MD_AD9833 libraries drive SPI themselves;
+ * their calls are bracketed with a Claim so they serialise with everything
+ * else and their bus time is counted against the right device.
+ *
+ * CS stays a GPIO: the Arduino SPI host has a single hardware CS line and
+ * the two libraries toggle their own pins, so per-device hardware CS would
+ * mean replacing both drivers.  Likewise, transfers are 1–3 bytes, which the
+ * SPI FIFO moves faster than a DMA descriptor setup.
+ */
+
+#ifndef SPI_BUS_H
+#define SPI_BUS_H
+
+#include <stdint.h>
+
+namespace spi_bus {
+
+enum class Device : uint8_t {
+    Rtd      = 0,   ///< MAX31865
+    Waveform = 1,   ///< AD9833
+    Dac      = 2,   ///< MCP4921
+};
+
+static constexpr uint8_t DEVICE_COUNT = 3;
+
+/** Bus-time counters for one device (see getStats()). */
+struct Stats {
+    uint32_t transactions;   ///< transfers (or library claims)
+    uint32_t bytes;          ///< bytes clocked by transfer()
+    uint64_t busyUs;         ///< time holding the bus for this device
+    uint32_t maxUs;          ///< longest single transfer / claim
+    uint64_t waitUs;         ///< time spent waiting for the mutex
+};
+
+/**
+ * Start the SPI host, configure every CS pin high and create the bus
+ * mutex.  Call once in setup() before any device init().
+ */
+void init();
+
+/**
+ * One full-duplex transfer with @p dev's cached settings: CS low, @p n bytes
+ * out of @p tx (nullptr = 0xFF) into @p rx (nullptr = discard), CS high.
+ * Takes the bus mutex unless the calling task already holds it.
+ */
+void transfer(Device dev, const uint8_t* tx, uint8_t* rx, uint8_t n);
+
+/**
+ * Holds the bus across several transfer() calls.  Nests; the outermost
+ * Batch releases the bus.
+ */
+class Batch {
+public:
+    Batch();
+    ~Batch();
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+};
+
+/**
+ * Holds the bus for a third-party driver call that does its own
+ * beginTransaction() / CS handling.  Time held is charged to @p dev.
+ */
+class Claim {
+public:
+    explicit Claim(Device dev);
+    ~Claim();
+    Claim(const Claim&) = delete;
+    Claim& operator=(const Claim&) = delete;
+
+private:
+    Device   _dev;
+    uint32_t _startUs;
+};
+
+/** Snapshot of @p dev's counters (may be torn while the bus is busy). */
+Stats getStats(Device dev);
+
+/** Zero every device's counters (takes the bus, so it waits out a holder). */
+void resetStats();
+
+/** Return a short ASCII name for a device. */
+const char* deviceName(Device dev);
+
+} // namespace spi_bus
+
+#endif // SPI_BUS_H
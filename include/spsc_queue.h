@@ -0,0 +1,73 @@
+/**
+ * @file spsc_queue.h
+ * @brief Fixed-capacity lock-free single-producer / single-consumer queue
+ *
+ * Exactly one task pushes and exactly one (other) task pops.  No locks and
+ * no allocation: push() and pop() are a copy plus one acquire load and one
+ * release store each, so a producer on the control core can never be held
+ * up by a slow consumer on the other core — a full queue simply rejects the
+ * item.
+ *
+ * Head and tail are free-running 32-bit counters; their difference is the
+ * fill level, so all N slots are usable.  N must be a power of two.
+ *
+ * Header-only with no Arduino dependencies so it can be unit-tested natively.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stdint.h>
+
+template <typename T, uint32_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1u)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    /** Producer side.  Returns false (item not queued) when full. */
+    bool push(const T& item) {
+        const uint32_t head = _head.load(std::memory_order_relaxed);
+        const uint32_t tail = _tail.load(std::memory_order_acquire);
+        if ((head - tail) >= N) {
+            return false;
+        }
+        _slots[head & (N - 1u)] = item;
+        _head.store(head + 1u, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer side.  Returns false (item untouched) when empty. */
+    bool pop(T& item) {
+        const uint32_t tail = _tail.load(std::memory_order_relaxed);
+        const uint32_t head = _head.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;
+        }
+        item = _slots[tail & (N - 1u)];
+        _tail.store(tail + 1u, std::memory_order_release);
+        return true;
+    }
+
+    /** Number of queued items.  Exact only when called from either side. */
+    uint32_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr uint32_t capacity() { return N; }
+
+    /** Discard all items.  Only safe while neither side is active. */
+    void reset() {
+        _head.store(0, std::memory_order_relaxed);
+        _tail.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    T                     _slots[N] = {};
+    std::atomic<uint32_t> _head{0};   // next slot to write (producer-owned)
+    std::atomic<uint32_t> _tail{0};   // next slot to read  (consumer-owned)
+};
+
+#endif // SPSC_QUEUE_H
@@ -20,6 +20,22 @@
  *   - rmsVoltage     : measured RMS voltage (stub; 0.0 until implemented)
  *   - stalled        : true when temp has not dropped enough in STALL_DETECT_WINDOW_MS
  *   - nowMs          : current millis()
+ *   - currentA, dacActual : extra channels fingerprinted during Baseline
+ *
+ * dacTarget comes from one closed-loop controller (pid_controller.h): a
+ * cooling-rate PI in CoarseCooldown / FineCooldown and a temperature PID on
+ * SETPOINT_K from Overshoot onward, with gains scheduled per state.
+ *
+ * Baseline (6) learns a per-channel mean / σ / histogram (baseline.h) and
+ * only freezes it once no channel is still trending, re-learning otherwise;
+ * Operating (7) scores every tick against it.  A latched CUSUM alarm faults
+ * with BaselineDeviation when BASELINE_DEVIATION_FAULT is set, and is
+ * otherwise only reported.
+ *
+ * All of that per-cooler state lives in a Machine.  The free functions
+ * below drive primary(), the board's one cooler; a fleet build creates one
+ * Machine per channel and ticks them in turn.  The runtime parameters
+ * (params.h) are shared by every channel.
  *
  * The module is pure logic — no Serial or hardware calls — so it can be
  * unit-tested on the native (host-PC) platform.
@@ -31,6 +47,8 @@
 #include <stdint.h>
 #include "config.h"
 #include "indicator.h"
+#include "baseline.h"
+#include "pid_controller.h"
 
 namespace state_machine {
 
@@ -55,8 +73,15 @@ enum class FaultReason : uint8_t {
     RmsOvervoltage    = 1,
     TemperatureStall  = 2,
     TooManyBackoffs   = 3,  ///< back-EMF backoff event count reached BACKOFF_MAX_COUNT
+    BaselineDeviation = 4,  ///< Operating drifted from the Baseline fingerprint (CUSUM)
 };
 
+/** Number of entries in State (Off .. Fault). */
+static constexpr uint8_t STATE_COUNT = 10;
+
+/** Number of entries in FaultReason (None .. BaselineDeviation). */
+static constexpr uint8_t FAULT_REASON_COUNT = 5;
+
 /** Aggregate output produced by update() each loop. */
 struct Output {
     State            state;
@@ -67,8 +92,111 @@ struct Output {
     indicator::Mode  readyIndMode;    ///< desired mode for READY indicator
     const char*      statusText;      ///< human-readable status description
     uint16_t         backoffCount;    ///< cumulative back-EMF backoff events since start()
+    uint8_t          deviationMask;   ///< Operating: baseline::Channel bits with |z| > BASELINE_WARN_Z
+};
+
+/**
+ * Everything update() carries from one tick to the next, with timers held
+ * as elapsed times so the snapshot stays valid across a reboot that
+ * restarts millis().  Trivially copyable; see warm_restart.h.
+ */
+struct Snapshot {
+    State            state;
+    bool             running;
+    bool             settleTimerActive;
+    uint16_t         backoffCount;
+    uint16_t         backoffDacOffset;
+    uint32_t         timeInStateMs;
+    uint32_t         onDurationMs;
+    uint32_t         settleElapsedMs;    ///< valid when settleTimerActive
+    float            settleMinK;         ///< settle window temperature span
+    float            settleMaxK;
+    uint16_t         settleMinDac;       ///< settle window DAC span
+    uint16_t         settleMaxDac;
+    control::Pid     dacLoop;
+    control::LowPass rateFilter;
+    baseline::Engine fingerprint;
+};
+
+/**
+ * Called on every state change, after the new state is in effect.
+ * @p reason is the fault reason for a transition into Fault and
+ * FaultReason::None otherwise.
+ */
+using TransitionHook = void (*)(State from, State to, FaultReason reason, uint32_t nowMs);
+
+/**
+ * One cooler's control state.  Every method behaves exactly as the free
+ * function of the same name documented below; those act on primary().
+ * Not thread-safe: each Machine must be driven from one context (or under
+ * one lock), as the control task does with controlMutex.
+ */
+class Machine {
+public:
+    void        init(uint32_t nowMs);
+    Output      update(float tempK, float coolingRate, float rmsVoltage, bool stalled,
+                       uint32_t nowMs, bool overstroke = false, float currentA = 0.0f,
+                       uint16_t dacActual = 0);
+    void        start(uint32_t nowMs, float tempK = AMBIENT_START_K);
+    void        stop(uint32_t nowMs);
+    void        off(uint32_t nowMs);
+    bool        resume(const Snapshot& s, uint32_t nowMs);
+    Snapshot    snapshot(uint32_t nowMs) const;
+    void        setTransitionHook(TransitionHook hook) { _transitionHook = hook; }
+
+    State       getState() const       { return _state; }
+    bool        isRunning() const      { return _running; }
+    FaultReason getFaultReason() const { return _faultReason; }
+    const char* getStatusText() const;
+    uint32_t    getOnStateDuration() const;
+    uint32_t    getTimeInState() const;
+    const baseline::Engine& getBaseline() const { return _fingerprint; }
+
+private:
+    void     resetControl();
+    void     enterState(State s, uint32_t nowMs);
+    void     enterFault(FaultReason reason, uint32_t nowMs);
+    void     beginBaseline();
+    void     restartSettleWindow(float tempK, uint16_t dacActual, uint32_t nowMs);
+    bool     settleWindowSteady(float tempK, uint16_t dacActual);
+    uint16_t controlDac(State s, float tempK, float coolingRate, uint16_t dacActual,
+                        uint32_t nowMs);
+    Output   buildOutput(State s, uint16_t dacTarget) const;
+
+    State          _state          = State::Off;
+    uint32_t       _stateEntryMs   = 0;       // millis() when _state was entered
+    bool           _running        = false;   // off until start() is called
+    FaultReason    _faultReason    = FaultReason::None;
+    uint32_t       _onStateMs      = 0;       // millis() when it entered an on state
+    uint32_t       _offStateMs     = 0;       // millis() when it entered an off state
+    TransitionHook _transitionHook = nullptr;
+
+    // Settle timer -- starts counting when temp enters the tolerance band
+    // and restarts whenever the loop is still moving (settleWindowSteady())
+    uint32_t _settleStartMs     = 0;
+    bool     _settleTimerActive = false;
+    float    _settleMinK        = 0.0f;   // span of the current window
+    float    _settleMaxK        = 0.0f;
+    uint16_t _settleMinDac      = 0;
+    uint16_t _settleMaxDac      = 0;
+
+    // Back-EMF backoff tracking
+    uint16_t _backoffCount     = 0;   // total backoff events in this run
+    uint16_t _backoffDacOffset = 0;   // cumulative DAC reduction (counts)
+
+    // Baseline fingerprint: learnt in Baseline, checked in Operating
+    baseline::Engine _fingerprint;
+
+    // DAC controller: one loop, gains and error definition scheduled by state
+    control::Pid          _dacLoop;
+    control::LowPass      _rateFilter;
+    const control::Gains* _activeGains   = nullptr;   // nullptr = loop idle
+    uint32_t              _lastControlMs = 0;
 };
 
+/** The Machine behind the free functions below. */
+Machine& primary();
+
 /**
  * Initialise the state machine.
  * Must be called once in setup() with the current millis().
@@ -93,6 +221,8 @@ uint32_t getOnStateDuration();
  *                     this tick.  Triggers a DAC backoff and increments the
  *                     backoff counter in the returned Output.  Defaults to
  *                     false for backward compatibility.
+ * @param currentA     ACS712 RMS current in A (baseline channel)
+ * @param dacActual    DAC value currently applied (baseline channel)
  * @return             Output struct with all actuator targets for this tick
  */
 Output update(float    tempK,
@@ -100,7 +230,9 @@ Output update(float    tempK,
               float    rmsVoltage,
               bool     stalled,
               uint32_t nowMs,
-              bool     overstroke = false);
+              bool     overstroke = false,
+              float    currentA   = 0.0f,
+              uint16_t dacActual  = 0);
 
 /** Return the current state without advancing the machine. */
 State getState();
@@ -147,6 +279,15 @@ const char* stateName(State s);
 /** Return the current fault reason (FaultReason::None if not in Fault). */
 FaultReason getFaultReason();
 
+/** Return a short ASCII name for a fault reason (safe for Serial / telemetry). */
+const char* faultReasonName(FaultReason r);
+
+/**
+ * Return the status text for state @p s.  @p r selects the Fault sentence
+ * and is ignored for every other state.
+ */
+const char* statusText(State s, FaultReason r);
+
 /** Return a short ASCII status text for the current state (safe for Serial / telemetry). */
 const char* getStatusText();
 
@@ -156,6 +297,31 @@ const char* getStatusText();
  */
 uint32_t getTimeInState();
 
+/** Read-only view of the baseline fingerprint and Operating detector. */
+const baseline::Engine& getBaseline();
+
+/** Capture the control state at @p nowMs. */
+Snapshot snapshot(uint32_t nowMs);
+
+/**
+ * Continue a run from @p s as if no time had passed since it was taken:
+ * same state, timers, backoff offset, DAC loop and baseline statistics.
+ * Only a running snapshot in CoarseCooldown .. Operating is resumed; the
+ * caller is expected to have checked that the cold stage is still where
+ * the snapshot left it.
+ *
+ * @return false (nothing changed) if @p s is not resumable or the machine
+ *         is already running
+ */
+bool resume(const Snapshot& s, uint32_t nowMs);
+
+/**
+ * Install a journal hook for state changes (see run_log.h).  Runs in the
+ * caller's context — the control tick or a console command — so it must
+ * not block.  Pass nullptr to disable (the default).
+ */
+void setTransitionHook(TransitionHook hook);
+
 } // namespace state_machine
 
 #endif // STATE_MACHINE_H
@@ -1,53 +1,336 @@
 /**
  * @file telemetry.h
- * @brief Serial Studio CSV telemetry emitter
+ * @brief Serial Studio CSV / compact binary telemetry emitter
  *
- * Emits one telemetry frame per call to emit() using the Serial Studio
- * "Quick Plot" frame format:
+ * Emits one telemetry frame per call to emit().  The default format is the
+ * Serial Studio "Quick Plot" frame:
  *
  *   /*<csv_fields>*\/\r\n
  *
- * Fields (in column order, pipe-delimited):
+ * Fields (in column order, pipe-delimited; rendering and dashboard mapping
+ * come from FIELDS in telemetry_schema.h):
  *   1  state_no         numeric state index -1 to 8
  *   2  state_name       ASCII state label (e.g. "CoarseCooldown")
  *   3  status_text      human-readable status description
  *   4  temp_k           cold-stage temperature in Kelvin   (2 dp)
  *   5  temp_c           cold-stage temperature in Celsius  (2 dp)
- *   6  cooling_rate     K/min; positive = cooling          (3 dp)
- *   7  dac_target       desired DAC count from state machine (0-4095)
- *   8  dac_actual       current DAC output count            (0-4095)
- *   9  rms_v            RMS voltage VDC                     (2 dp)
- *  10  relay_normal     0 = Bypass, 1 = Normal
- *  11  alarm_relay      0 = off,    1 = active
- *  12  red_led          1 = FAULT LED lit, 0 = off
- *  13  green_led        1 = READY LED lit, 0 = off
- *  14  on_duration_ms   total on-state duration in milliseconds
- *  15  on_duration      total on-state duration as HH:MM:SS
- *  16  cooldown_pct     cooldown progress 0–100 %           (2 dp)
- *  17  time_in_state    time spent in the current state as HH:MM:SS
- *  18  current_a        ACS712 AC RMS current in amps             (2 dp)
- *  19  backoff_count    cumulative back-EMF backoff events this run
+ *   6  ambient_temp_c   last valid DS18B20 ambient reading in Celsius (2 dp)
+ *   7  cooling_rate     K/min; positive = cooling          (3 dp)
+ *   8  dac_target       desired DAC count from state machine (0-4095)
+ *   9  dac_actual       current DAC output count            (0-4095)
+ *  10  rms_v            RMS voltage VDC                     (2 dp)
+ *  11  relay_normal     0 = Bypass, 1 = Normal
+ *  12  alarm_relay      0 = off,    1 = active
+ *  13  red_led          1 = FAULT LED lit, 0 = off
+ *  14  green_led        1 = READY LED lit, 0 = off
+ *  15  on_duration_ms   total on-state duration in milliseconds
+ *  16  on_duration      total on-state duration as HH:MM:SS
+ *  17  cooldown_pct     cooldown progress 0–100 %           (2 dp)
+ *  18  time_in_state    time spent in the current state as HH:MM:SS
+ *  19  current_a        ACS712 AC RMS current in amps             (2 dp)
+ *  20  backoff_count    cumulative back-EMF backoff events this run
+ *  21  ambient_age_ms   age of ambient_temp_c in ms; -1 until first reading
+ *  22  eta_s            seconds until setpoint + tolerance (cooldown_eta.h);
+ *                       0 once there, -1 = unknown (not cooling, or too
+ *                       early in the fit)
+ *  23  eta_conf         confidence in eta_s, 0–100 %
+ *  24  loop_us          longest control-core pass since the previous frame,
+ *                       µs — only when TELEMETRY_PERF_FIELD is true
+ *
+ * Buffering:
+ *   emit() never writes to Serial.  It snapshots every field into a Frame and
+ *   pushes it onto a lock-free SPSC ring of TELEMETRY_RING_DEPTH frames
+ *   (producer = control task).  service() — called from the telemetry task —
+ *   formats queued frames and writes each one only when the USB-CDC TX
+ *   buffer has room for the whole frame.  A full ring drops the NEWEST
+ *   frame; drops and the ring high-water mark are counted (getStats()).
+ *
+ *   A second sink (the network, net.h) installs a tap with setTap(): it is
+ *   handed every sample frame as the consumer takes it off the ring, before
+ *   USB formatting.  With a tap installed and no USB host attached,
+ *   service() discards the USB output so frames keep flowing to the tap
+ *   (they count as sent).
+ *
+ * Scheduling:
+ *   emit() passes each control-tick frame through sample(), which keeps
+ *   every Nth frame (setSteadyDivisor(), "telemetry rate") while the state
+ *   is Off, Idle, Baseline or Operating.  Cooldown, Overshoot, Settle,
+ *   Initialize and Fault are sent every tick, and every state change is
+ *   sent immediately.  Both formats are decimated.
+ *
+ *   CSV frames additionally honour a column subscription mask
+ *   (setFieldMask(), bit n-1 = column n) and delta mode (setDeltaMode()):
+ *   the slow DELTA_FIELDS columns are left empty when unchanged since the
+ *   previous frame.  Every Kth frame (setKeyframeInterval()) and the first
+ *   frame after any schedule change is a keyframe with every subscribed
+ *   column filled.  Empty columns keep their position, so the ssproj parser
+ *   is unaffected; a host treats an empty column as "unchanged" (delta) or
+ *   "not subscribed".  Binary frames keep their fixed layout.
  *
  * To visualise in Serial Studio:
  *   - Open Serial Studio, connect at SERIAL_BAUD.
  *   - Enable "Frame detection" with start seq "\/*" and end seq "*\/".
- *   - Load the Cryocooler.ssproj project file.
+ *   - Load the "Cryocooler Dashboard.ssproj" project file.  Its frameParser
+ *     and dataset indices are generated from FIELDS (test/ssproj_map.h).
+ *
+ * Binary format (setFormat(Format::Binary), "telemetry binary"):
+ *   Each frame on the wire is  COBS(payload ‖ crc16_le(payload)) ‖ 0x00.
+ *   A host splits the stream on 0x00, COBS-decodes, checks the trailing
+ *   CRC-16/CCITT-FALSE (see frame_codec.h) and dispatches on byte 0.
+ *   All multi-byte fields are little-endian.  Byte 1 is BINARY_VERSION;
+ *   a decoder must reject versions it does not know.
+ *
+ *   Sample frame (FRAME_TYPE_SAMPLE, 40-byte payload, 44 bytes on the wire):
+ *     off  type  field            scale / meaning
+ *      0   u8    type             0x10
+ *      1   u8    version          BINARY_VERSION
+ *      2   u16   seq              +1 per submit(); gaps = frames dropped
+ *      4   i8    state_no         state_machine::State
+ *      5   u8    fault_reason     state_machine::FaultReason
+ *      6   u8    flags            b0 relay_normal, b1 alarm_relay,
+ *                                 b2 red_led, b3 green_led, b4 ambient_valid
+ *      7   u16   temp_k           0.01 K          (temp_c = temp_k − 273.15)
+ *      9   i16   ambient_temp_c   0.01 °C
+ *     11   i16   cooling_rate     0.001 K/min     (saturates at ±32.767)
+ *     13   u16   dac_target       counts
+ *     15   u16   dac_actual       counts
+ *     17   u16   rms_v            0.01 V
+ *     19   u16   current_a        0.001 A
+ *     21   u16   cooldown_pct     0.01 %
+ *     23   u16   backoff_count
+ *     25   u16   ambient_age_ms   ms; 0xFFFF = no reading or ≥ 65.535 s
+ *     27   u32   on_duration_ms
+ *     31   u32   time_in_state_ms
+ *     35   i32   eta_s            s; -1 = unknown
+ *     39   u8    eta_conf         %
+ *
+ *   Descriptor frame (FRAME_TYPE_DESCRIPTOR) — one per state and fault
+ *   reason, sent once after switching to binary and on requestDescriptor(),
+ *   so state/status strings never ride in sample frames:
+ *      0   u8    type             0x01
+ *      1   u8    version          BINARY_VERSION
+ *      2   u8    index            0 .. count-1
+ *      3   u8    count            DESCRIPTOR_COUNT
+ *      4   u8    kind             0 = state, 1 = fault reason
+ *      5   i8    code             State or FaultReason value
+ *      6   u8    name_len  + name bytes (state_name / fault name)
+ *      …   u8    text_len  + text bytes (status_text for that code)
  */
 
 #ifndef TELEMETRY_H
 #define TELEMETRY_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
 #include "state_machine.h"
+#include "telemetry_schema.h"
+
+// Forward declaration — resolved by <Arduino.h> on target, Print.h stub on native.
+class Print;
 
 namespace telemetry {
 
+/** Wire format selected for drain(). */
+enum class Format : uint8_t {
+    Csv    = 0,   ///< Serial Studio Quick-Plot text (default)
+    Binary = 1,   ///< COBS-framed packed binary (see file header)
+};
+
+/** Binary layout version; bump on any change to the tables above. */
+static constexpr uint8_t BINARY_VERSION = 2;
+
+static constexpr uint8_t FRAME_TYPE_DESCRIPTOR = 0x01;
+static constexpr uint8_t FRAME_TYPE_SAMPLE     = 0x10;
+
+/** Payload bytes of one binary sample frame (before CRC and COBS). */
+static constexpr size_t SAMPLE_PAYLOAD_LEN = 40;
+
+/** setFieldMask() value subscribing every CSV column. */
+static constexpr uint32_t FIELD_MASK_ALL = (1u << FIELD_COUNT) - 1u;
+
+/**
+ * Slow columns suppressed by delta mode when unchanged (FieldSpec::delta):
+ * state_name, status_text, ambient_temp_c, relay/LED flags, on_duration
+ * and time_in_state (HH:MM:SS, i.e. whole seconds) and backoff_count.
+ */
+static constexpr uint32_t DELTA_FIELDS = deltaFieldMask();
+
+/** Descriptor frames per set: every State, then every FaultReason. */
+static constexpr uint8_t DESCRIPTOR_COUNT =
+    state_machine::STATE_COUNT + state_machine::FAULT_REASON_COUNT;
+
+/** Snapshot of every telemetry column, captured on the control task. */
+struct Frame {
+    uint16_t             seq;             ///< assigned by submit()
+    state_machine::State state;
+    state_machine::FaultReason faultReason;
+    const char*          statusText;      ///< static string from state_machine
+    float                tempK;
+    float                tempC;
+    float                ambientTempC;
+    float                coolingRate;
+    uint16_t             dacTarget;
+    uint16_t             dacActual;
+    float                rmsV;
+    bool                 relayNormal;
+    bool                 alarmRelay;
+    bool                 redLed;
+    bool                 greenLed;
+    uint32_t             onDurationMs;
+    float                cooldownPct;
+    uint32_t             timeInStateMs;
+    float                currentA;
+    uint16_t             backoffCount;
+    int32_t              ambientAgeMs;    ///< -1 until first ambient reading
+    int32_t              etaS;            ///< -1 = unknown
+    uint8_t              etaConfPct;
+    uint32_t             loopMaxUs;       ///< column 24 (TELEMETRY_PERF_FIELD)
+};
+
+/** Ring buffer counters (see getStats()). */
+struct Stats {
+    uint32_t submitted;   ///< frames offered to the ring
+    uint32_t sent;        ///< sample frames written to the output
+    uint32_t dropped;     ///< frames rejected because the ring was full
+    uint32_t highWater;   ///< maximum ring occupancy observed
+    uint32_t capacity;    ///< ring capacity (TELEMETRY_RING_DEPTH)
+};
+
+/** Longest formatted frame of either format, including the CSV NUL. */
+static constexpr size_t MAX_FRAME_LEN = 320;
+
 /**
- * Emit one Serial Studio CSV frame to Serial.
+ * Snapshot the current telemetry fields and pass them to sample().  Never
+ * blocks and never touches Serial.  No-op when telemetry is disabled and on
+ * the native build (where the sensor modules are not linked).
  *
  * @param out          State-machine output for this tick
  */
 void emit(const state_machine::Output& out);
 
+/**
+ * Apply the decimation schedule to one control-tick frame and submit() it
+ * when due.  Used by emit(); exposed for native tests.
+ *
+ * @return true if the frame was queued
+ */
+bool sample(const Frame& frame);
+
+/**
+ * Stamp @p frame with the next sequence number and queue it (producer
+ * side).  Used by emit(); exposed so the ring can be exercised natively.
+ * The sequence number advances even when the frame is dropped.
+ *
+ * @return false if the ring was full and the frame was dropped
+ */
+bool submit(const Frame& frame);
+
+/**
+ * Format @p frame as one Serial Studio line into @p buf, column by column
+ * as FIELDS (telemetry_schema.h) describes.  Numbers are rendered with
+ * integer arithmetic only (no printf); Fixed columns are rounded half away
+ * from zero, NaN/inf print as "nan"/"inf" and magnitudes of 1e15 or more
+ * as "inf".  Consumer task only: the lengths of the Text columns are
+ * cached across calls.
+ *
+ * @param fieldMask  Columns to fill (FIELD_MASK_ALL = full frame)
+ * @param prev       If non-null, DELTA_FIELDS columns equal to @p prev are
+ *                   left empty
+ * @return  Number of characters written (excluding NUL), or 0 if the frame
+ *          did not fit in @p len bytes.
+ */
+size_t formatFrame(const Frame& frame, char* buf, size_t len,
+                   uint32_t fieldMask = FIELD_MASK_ALL, const Frame* prev = nullptr);
+
+/**
+ * Encode @p frame as one binary sample frame (payload, CRC, COBS and the
+ * 0x00 delimiter) into @p buf.
+ *
+ * @return  Bytes written, or 0 if the frame did not fit in @p len bytes.
+ */
+size_t formatBinaryFrame(const Frame& frame, uint8_t* buf, size_t len);
+
+/**
+ * Encode descriptor entry @p index (0 .. DESCRIPTOR_COUNT-1) as one binary
+ * frame into @p buf.
+ *
+ * @return  Bytes written, or 0 if @p index is out of range or the frame
+ *          did not fit in @p len bytes.
+ */
+size_t formatDescriptor(uint8_t index, uint8_t* buf, size_t len);
+
+/**
+ * Format and write queued frames to @p out (consumer side) while each
+ * whole frame fits in the remaining @p txSpace bytes.  A frame that does
+ * not fit is kept and retried on the next call.
+ *
+ * @return  Number of frames written.
+ */
+uint32_t drain(Print& out, size_t txSpace);
+
+/**
+ * Target only: drain() to Serial using Serial.availableForWrite(), or to
+ * the setOutput() sink.
+ */
+void service();
+
+/**
+ * Make service() write to @p out, as its availableForWrite() allows,
+ * instead of Serial (nullptr = Serial).  A sink that never has room is a
+ * stalled USB host: the on-target soak benchmark uses one to fill the ring.
+ */
+void setOutput(Print* out);
+
+/** Second frame sink; see setTap(). */
+using FrameTap = void (*)(const Frame& frame);
+
+/**
+ * Install @p tap (nullptr = none).  drain() calls it on the consumer task
+ * with each sample frame popped from the ring, binary or CSV, whether or
+ * not the USB write goes through on this call.  It must not block.
+ */
+void setTap(FrameTap tap);
+
+/**
+ * Select the wire format used by drain().  Switching to Binary queues a
+ * descriptor set ahead of the next sample frame.
+ */
+void setFormat(Format f);
+Format getFormat();
+
+/** Keep every @p n th frame in steady states (1 = every tick; 0 treated as 1). */
+void setSteadyDivisor(uint8_t n);
+uint8_t getSteadyDivisor();
+
+/** Subscribe CSV columns (bit n-1 = column n).  Forces a keyframe. */
+void setFieldMask(uint32_t mask);
+uint32_t getFieldMask();
+
+/** Enable or disable CSV delta mode.  Forces a keyframe. */
+void setDeltaMode(bool on);
+bool isDeltaMode();
+
+/** Send a full keyframe every @p k CSV frames in delta mode (0 = never). */
+void setKeyframeInterval(uint16_t k);
+uint16_t getKeyframeInterval();
+
+/** Restore the compile-time schedule defaults (config.h). */
+void resetSchedule();
+
+/** Re-send the descriptor set (binary mode only; ignored in CSV mode). */
+void requestDescriptor();
+
+/** Return a copy of the ring counters. */
+Stats getStats();
+
+/**
+ * Zero the submitted/sent/dropped/high-water counters.  Thread-safe: the
+ * producer and consumer apply it on their next submit() / drain(), and
+ * getStats() reads zero until they have.
+ */
+void resetStats();
+
 void disable();
 void enable();
 bool isEnabled();
@@ -0,0 +1,108 @@
+/**
+ * @file telemetry_schema.h
+ * @brief Compile-time schema of the Serial Studio CSV telemetry columns
+ *
+ * One FieldSpec per column, in column order.  It is the single source for
+ *   - telemetry::formatFrame(): how each column is rendered (kind and
+ *     decimals) and whether delta mode may suppress it;
+ *   - the dashboard: test/ssproj_map.h generates the frameParser and the
+ *     dataset indices of "Cryocooler Dashboard.ssproj" from it, and a
+ *     native test fails when the committed project has drifted.
+ * Adding or moving a column is therefore one edit here plus the value in
+ * telemetry.cpp's fieldValue(); the descriptions live in telemetry.h.
+ *
+ * Dashboard datasets are matched to columns by title, so a dataset needs a
+ * title listed here.  The generated parser returns the columns in CSV order,
+ * which makes a dataset's index equal to its 1-based column number.
+ *
+ * Free of Arduino includes so it can be used by native tests and tools.
+ */
+
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+#include <stdint.h>
+#include "config.h"
+
+namespace telemetry {
+
+/** How a column's value is rendered. */
+enum class FieldKind : uint8_t {
+    Int,     ///< signed decimal
+    Uint,    ///< unsigned decimal
+    Fixed,   ///< float with FieldSpec::decimals fractional digits
+    Text,    ///< static string, never changes without its pointer changing
+    Hms,     ///< millisecond count rendered as HH:MM:SS
+};
+
+/** One CSV column. */
+struct FieldSpec {
+    uint8_t     column;     ///< 1-based position in the frame
+    const char* key;        ///< CSV name, as in telemetry.h
+    const char* title;      ///< Serial Studio dataset title
+    const char* units;      ///< Serial Studio dataset units ("" = none)
+    FieldKind   kind;
+    uint8_t     decimals;   ///< Fixed only
+    bool        delta;      ///< slow column: delta mode omits it when unchanged
+};
+
+/** Every column, perf column last (sent only when TELEMETRY_PERF_FIELD). */
+static constexpr FieldSpec FIELDS[] = {
+    { 1, "state_no",       "Status ID",        "",      FieldKind::Int,   0, false},
+    { 2, "state_name",     "Status",           "",      FieldKind::Text,  0, true },
+    { 3, "status_text",    "Description",      "",      FieldKind::Text,  0, true },
+    { 4, "temp_k",         "Temperature (K)",  "K",     FieldKind::Fixed, 2, false},
+    { 5, "temp_c",         "Temperature (C)",  "°C",    FieldKind::Fixed, 2, false},
+    { 6, "ambient_temp_c", "Ambient Temp",     "°C",    FieldKind::Fixed, 2, true },
+    { 7, "cooling_rate",   "Cooling Rate",     "K/min", FieldKind::Fixed, 3, false},
+    { 8, "dac_target",     "DAC Target",       "",      FieldKind::Uint,  0, false},
+    { 9, "dac_actual",     "DAC Actual",       "",      FieldKind::Uint,  0, false},
+    {10, "rms_v",          "RMS Voltage",      "VDC",   FieldKind::Fixed, 2, false},
+    {11, "relay_normal",   "Relay Normal",     "",      FieldKind::Uint,  0, true },
+    {12, "alarm_relay",    "Alarm Relay",      "",      FieldKind::Uint,  0, true },
+    {13, "red_led",        "FAULT",            "",      FieldKind::Uint,  0, true },
+    {14, "green_led",      "READY",            "",      FieldKind::Uint,  0, true },
+    {15, "on_duration_ms", "On Duration Ms",   "ms",    FieldKind::Uint,  0, false},
+    {16, "on_duration",    "On Duration",      "",      FieldKind::Hms,   0, true },
+    {17, "cooldown_pct",   "Cooldown Percent", "%",     FieldKind::Fixed, 2, false},
+    {18, "time_in_state",  "Time in state",    "",      FieldKind::Hms,   0, true },
+    {19, "current_a",      "Current",          "A",     FieldKind::Fixed, 2, false},
+    {20, "backoff_count",  "Backoff Count",    "",      FieldKind::Uint,  0, true },
+    {21, "ambient_age_ms", "Ambient Age",      "ms",    FieldKind::Int,   0, false},
+    {22, "eta_s",          "Cooldown ETA",     "s",     FieldKind::Int,   0, false},
+    {23, "eta_conf",       "ETA Confidence",   "%",     FieldKind::Uint,  0, false},
+    {24, "loop_us",        "Loop Time",        "µs",    FieldKind::Uint,  0, false},
+};
+
+/** Columns in FIELDS (the dashboard always knows the perf column). */
+static constexpr uint8_t SCHEMA_FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+/** Number of CSV columns sent by this build. */
+static constexpr uint8_t FIELD_COUNT = TELEMETRY_PERF_FIELD ? SCHEMA_FIELD_COUNT
+                                                            : SCHEMA_FIELD_COUNT - 1u;
+
+/** Bit for 1-based CSV column @p n in a field mask. */
+constexpr uint32_t fieldBit(uint8_t n) { return 1u << (n - 1u); }
+
+/** Mask of the FieldSpec::delta columns. */
+constexpr uint32_t deltaFieldMask() {
+    uint32_t m = 0;
+    for (const FieldSpec& f : FIELDS) {
+        if (f.delta) m |= fieldBit(f.column);
+    }
+    return m;
+}
+
+/** True if FIELDS lists every column once, in order, and fits a 32-bit mask. */
+constexpr bool schemaIsDense() {
+    for (uint8_t i = 0; i < SCHEMA_FIELD_COUNT; ++i) {
+        if (FIELDS[i].column != i + 1u) return false;
+    }
+    return SCHEMA_FIELD_COUNT <= 32u;
+}
+
+static_assert(schemaIsDense(), "FIELDS must list columns 1..N in order");
+
+} // namespace telemetry
+
+#endif // TELEMETRY_SCHEMA_H
@@ -0,0 +1,239 @@
+/**
+ * @file temp_history.h
+ * @brief Compact temperature sample rings and the two-resolution history
+ *        used for rate and stall checks (no hardware dependencies)
+ *
+ * SampleRing<N> stores samples as two parallel uint16_t arrays — 4 bytes
+ * per entry instead of the 8–12 of a {uint32_t, float, ...} struct:
+ *
+ *   dt      milliseconds since the previous entry (saturates at 65 535)
+ *   temp    kelvin in TEMP_LSB_K steps, 0 .. 327.675 K (clamped)
+ *
+ * Only the newest absolute timestamp and the running sum of the deltas
+ * are kept alongside, so oldest(), newest() and spanMs() stay O(1).  Scans
+ * go through SampleRing::Iterator, which rebuilds {timestampMs, tempK}
+ * oldest → newest from the deltas; rate, stall and any later statistics
+ * share that one view of the data.
+ *
+ * TempHistory combines two rings:
+ *
+ *   fine    the last FINE_N raw samples — coolingRateKPerMin()
+ *           is the slope between its oldest and newest entries
+ *   coarse  one mean per bucketMs of samples, COARSE_N buckets deep —
+ *           stalled() compares the oldest and newest completed buckets
+ *
+ * Every push() is O(1): it writes one fine slot, adds to the open bucket's
+ * running sum, and at most once per bucket closes it into the coarse ring.
+ *
+ * Size the coarse ring as window / bucketMs + 1 so that, once full, its
+ * oldest and newest buckets are exactly one window apart.  Until the ring
+ * spans the window stalled() returns false: there is not yet enough history
+ * to say the stage has failed to cool.
+ *
+ * Header-only so it can be unit-tested natively.
+ */
+
+#ifndef TEMP_HISTORY_H
+#define TEMP_HISTORY_H
+
+#include <stdint.h>
+
+/** Temperature quantum of a stored sample: 5 mK spans 0 .. 327.675 K. */
+static constexpr float TEMP_LSB_K = 0.005f;
+
+/** One reconstructed history entry. */
+struct TempSample {
+    uint32_t timestampMs;
+    float    tempK;
+};
+
+/** Quantize @p tempK to TEMP_LSB_K steps, clamped to the uint16_t range. */
+inline uint16_t quantizeTempK(float tempK) {
+    const float q = tempK / TEMP_LSB_K + 0.5f;
+    if (q <= 0.0f) return 0;
+    if (q >= 65535.0f) return 65535u;
+    return static_cast<uint16_t>(q);
+}
+
+inline float dequantizeTempK(uint16_t q) {
+    return static_cast<float>(q) * TEMP_LSB_K;
+}
+
+/**
+ * Fixed-capacity ring of quantized samples, stored structure-of-arrays.
+ * Timestamps must be pushed in non-decreasing millis() order (wrap is fine).
+ */
+template <uint16_t N>
+class SampleRing {
+    static_assert(N >= 2, "SampleRing needs at least two entries");
+
+public:
+    /** Forward iterator yielding samples oldest → newest. */
+    class Iterator {
+    public:
+        TempSample operator*() const {
+            return {_timestampMs, dequantizeTempK(_ring->_temp[slot()])};
+        }
+        Iterator& operator++() {
+            if (++_i < _ring->_count) {
+                _timestampMs += _ring->_dt[slot()];
+            }
+            return *this;
+        }
+        bool operator!=(const Iterator& o) const { return _i != o._i; }
+
+    private:
+        friend class SampleRing;
+        Iterator(const SampleRing* ring, uint16_t i, uint32_t t)
+            : _ring(ring), _i(i), _timestampMs(t) {}
+        uint16_t slot() const { return _ring->slotAt(_i); }
+
+        const SampleRing* _ring;
+        uint16_t          _i;
+        uint32_t          _timestampMs;
+    };
+
+    /** Append one sample, overwriting the oldest when full.  O(1). */
+    void push(uint32_t timestampMs, float tempK) {
+        uint16_t dt = 0;
+        if (_count > 0) {
+            const uint32_t elapsed = timestampMs - _newestMs;
+            dt = (elapsed > 0xFFFFu) ? static_cast<uint16_t>(0xFFFFu)
+                                     : static_cast<uint16_t>(elapsed);
+        }
+        if (_count == N) {
+            // The second-oldest becomes oldest; its delta leaves the span.
+            _spanMs -= _dt[slotAt(1)];
+            --_count;
+        }
+        _dt[_head]   = dt;
+        _temp[_head] = quantizeTempK(tempK);
+        _head = static_cast<uint16_t>((_head + 1u) % N);
+        if (_count > 0) _spanMs += dt;
+        ++_count;
+        _newestMs = timestampMs;
+    }
+
+    void clear() {
+        _head   = 0;
+        _count  = 0;
+        _spanMs = 0;
+    }
+
+    uint16_t size() const { return _count; }
+    bool     empty() const { return _count == 0; }
+    static constexpr uint16_t capacity() { return N; }
+
+    /** Milliseconds from the oldest to the newest entry. */
+    uint32_t spanMs() const { return _spanMs; }
+
+    /** Oldest / newest entry.  Only meaningful when !empty(). */
+    TempSample oldest() const {
+        return {_newestMs - _spanMs, dequantizeTempK(_temp[slotAt(0)])};
+    }
+    TempSample newest() const {
+        return {_newestMs, dequantizeTempK(_temp[slotAt(static_cast<uint16_t>(_count - 1u))])};
+    }
+
+    Iterator begin() const { return Iterator(this, 0, _newestMs - _spanMs); }
+    Iterator end() const   { return Iterator(this, _count, _newestMs); }
+
+private:
+    uint16_t slotAt(uint16_t i) const {
+        return static_cast<uint16_t>((_head + N - _count + i) % N);
+    }
+
+    uint16_t _dt[N]   = {};
+    uint16_t _temp[N] = {};
+    uint16_t _head     = 0;
+    uint16_t _count    = 0;
+    uint32_t _newestMs = 0;
+    uint32_t _spanMs   = 0;   // Σ dt of every entry but the oldest
+};
+
+template <uint16_t FINE_N, uint16_t COARSE_N>
+class TempHistory {
+public:
+    using FineRing   = SampleRing<FINE_N>;
+    using CoarseRing = SampleRing<COARSE_N>;
+
+    /**
+     * @param bucketMs  Coarse bucket length (1 .. 65 535)
+     * @param windowMs  Stall look-back; clipped to what COARSE_N buckets span
+     */
+    TempHistory(uint32_t bucketMs, uint32_t windowMs) { configure(bucketMs, windowMs); }
+
+    /** Discard all history and set the bucket length and stall window. */
+    void configure(uint32_t bucketMs, uint32_t windowMs) {
+        _bucketMs = (bucketMs < 1u) ? 1u : (bucketMs > 0xFFFFu) ? 0xFFFFu : bucketMs;
+        const uint32_t span = _bucketMs * static_cast<uint32_t>(COARSE_N - 1u);
+        _windowMs = (windowMs > span) ? span : windowMs;
+        _fine.clear();
+        restartStallWindow();
+    }
+
+    /** Discard coarse history only; stalled() stays false for one window. */
+    void restartStallWindow() {
+        _coarse.clear();
+        _bucketOpen = false;
+        _bucketSum  = 0.0f;
+        _bucketN    = 0;
+    }
+
+    /** Record one temperature sample.  O(1). */
+    void push(uint32_t timestampMs, float tempK) {
+        _fine.push(timestampMs, tempK);
+
+        if (_bucketOpen && (timestampMs - _bucketStartMs) >= _bucketMs) {
+            _coarse.push(_bucketStartMs, _bucketSum / static_cast<float>(_bucketN));
+            _bucketOpen = false;
+        }
+        if (!_bucketOpen) {
+            _bucketOpen    = true;
+            _bucketStartMs = timestampMs;
+            _bucketSum     = 0.0f;
+            _bucketN       = 0;
+        }
+        _bucketSum += tempK;
+        ++_bucketN;
+    }
+
+    /**
+     * Cooling rate in K/min over the fine ring (positive = cooling).
+     * 0 with fewer than two samples or zero elapsed time.
+     */
+    float coolingRateKPerMin() const {
+        if (_fine.size() < 2) return 0.0f;
+        const uint32_t dtMs = _fine.spanMs();
+        if (dtMs == 0) return 0.0f;
+        return (_fine.oldest().tempK - _fine.newest().tempK) /
+               (static_cast<float>(dtMs) / 60000.0f);
+    }
+
+    /**
+     * True once the coarse ring spans the stall window and the mean
+     * temperature has dropped by less than @p minDropK across it.
+     */
+    bool stalled(float minDropK) const {
+        if (_coarse.size() < 2) return false;
+        if (_coarse.spanMs() < _windowMs) return false;
+        return (_coarse.oldest().tempK - _coarse.newest().tempK) < minDropK;
+    }
+
+    const FineRing&   fine() const   { return _fine; }
+    const CoarseRing& coarse() const { return _coarse; }
+    uint32_t          windowMs() const { return _windowMs; }
+
+private:
+    FineRing   _fine;
+    CoarseRing _coarse;
+
+    uint32_t _bucketMs      = 1;
+    uint32_t _windowMs      = 0;
+    uint32_t _bucketStartMs = 0;   // timestamp of the open bucket's first sample
+    float    _bucketSum     = 0.0f;
+    uint32_t _bucketN       = 0;
+    bool     _bucketOpen    = false;
+};
+
+#endif // TEMP_HISTORY_H
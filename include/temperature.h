@@ -6,6 +6,8 @@
  * history used by the state machine for:
  *   - Cooling-rate calculation (to enforce the 10 C/10 min limit)
  *   - Temperature-stall detection (fault trigger)
+ * and an online cooldown fit (cooldown_eta.h) reported as the telemetry
+ * time-to-setpoint.
  *
  * This header is free of Adafruit / hardware includes and may be safely
  * included from unit tests compiled on the host PC.
@@ -15,9 +17,19 @@
 #define TEMPERATURE_H
 
 #include <stdint.h>
+#include "config.h"
+#include "cooldown_eta.h"
+#include "state_machine.h"
+#include "temp_history.h"
 
 namespace temperature {
 
+/** Cold-stage history: full-rate fine ring plus stall-window bucket means. */
+using ColdHistory = TempHistory<TEMP_HISTORY_SIZE, STALL_HISTORY_BUCKETS>;
+
+/** Ambient history, one entry per AMBIENT_HISTORY_INTERVAL_MS (kelvin). */
+using AmbientHistory = SampleRing<AMBIENT_HISTORY_SIZE>;
+
 /**
  * Initialize the MAX31865 RTD sensor.
  * Prints a diagnostic message to Serial.
@@ -26,14 +38,36 @@ void init();
 
 /**
  * Read RTD resistance and temperature from hardware.
- * Stores the result internally and prints to Serial.
- * Must be called periodically (every LOOP_INTERVAL_MS).
+ * Stores the result internally and appends it to the history.
+ * Must be called periodically (every RTD_READ_INTERVAL_MS).
+ *
+ * With RTD_AUTO_CONVERT this fetches the converter's latest code in one
+ * short SPI transaction.  When DRDY is wired and still high (no conversion
+ * finished since the last fetch) nothing is read or recorded, so the
+ * history never holds the same conversion twice.  A DRDY that stays high
+ * for RTD_DRDY_TIMEOUT_CONVERSIONS conversion times is ignored for that
+ * read (reported once on Serial).
+ *
+ * The ambient (DS18B20) reading is NOT taken here — see serviceAmbient().
  *
  * @param nowMs  Current millis() value (injected for testability)
  */
 void read(uint32_t nowMs);
 
-float readAmbientTemperature();
+/**
+ * Advance the split-phase DS18B20 ambient conversion.  Non-blocking.
+ *
+ * Starts a conversion every AMBIENT_READ_INTERVAL_MS, then polls for
+ * completion on later calls (only once the nominal conversion time has
+ * elapsed) and publishes the result when it arrives.  A conversion that has
+ * not completed within AMBIENT_CONVERSION_TIMEOUT_MS is abandoned and the
+ * previous value is kept.
+ *
+ * Call every loop() iteration.
+ *
+ * @param nowMs  Current millis() value
+ */
+void serviceAmbient(uint32_t nowMs);
 
 /**
  * Return the most recently measured ambient temperature in Celsius.
@@ -41,9 +75,24 @@ float readAmbientTemperature();
  */
 float getLastAmbientTempC();
 
+/** Return true once at least one valid ambient conversion has completed. */
+bool hasAmbient();
+
+/**
+ * Return the age of the last valid ambient reading in milliseconds.
+ * Returns 0 when hasAmbient() is false.
+ *
+ * @param nowMs  Current millis() value
+ */
+uint32_t getAmbientAgeMs(uint32_t nowMs);
+
 /**
  * Check for MAX31865 fault conditions and report via Serial.
  * Clears the fault register after reading.
+ *
+ * With RTD_AUTO_CONVERT the fault status register is only read when the
+ * last fetched code carried the fault bit; the Adafruit fault-detection
+ * cycle is not run, since it would stop the free-running conversions.
  */
 void checkFaults();
 
@@ -61,14 +110,16 @@ float getLastTempC();
 
 /**
  * Return the current cooling rate in Kelvin per minute (positive = cooling).
- * Computed over the oldest and newest samples in the ring buffer.
+ * Computed over the oldest and newest of the last TEMP_HISTORY_SIZE samples.
  * Returns 0.0f if fewer than 2 samples are available.
  */
 float getCoolingRateKPerMin();
 
 /**
  * Return true if the temperature has stalled: the cold stage has not dropped
- * by STALL_MIN_DROP_K within the most recent STALL_DETECT_WINDOW_MS.
+ * by STALL_MIN_DROP_K within the most recent STALL_DETECT_WINDOW_MS,
+ * compared on STALL_BUCKET_MS means.  False until a full window of history
+ * has been collected since init() or restartStallWindow().
  *
  * Only meaningful during cool-down states -- the caller (state machine)
  * is responsible for checking this only when actively cooling.
@@ -76,8 +127,39 @@ float getCoolingRateKPerMin();
 bool isStalled();
 
 /**
- * Return the temperature as a percentage of the maximum temperature.
- * 0% = 298K, 100% = 78K
+ * Discard the stall-detection history so isStalled() reports false for the
+ * next STALL_DETECT_WINDOW_MS.  Call when a cooldown begins, so the flat
+ * pre-start history does not read as a stall.
+ */
+void restartStallWindow();
+
+/**
+ * Forget the cooldown fit.  Call when a cooldown begins, alongside
+ * restartStallWindow(), so the pre-start history is not fitted.
+ */
+void restartCooldownEta();
+
+/** Telemetry time-to-setpoint; etaS < 0 = unknown. */
+using Eta = CooldownEta::Estimate;
+
+/**
+ * Time until the cold stage reaches the live setpoint + tolerance, as
+ * reported in state @p s: the fit's estimate during Coarse/Fine cooldown,
+ * 0 (100 %) once past it (Overshoot .. Operating), unknown otherwise.
+ *
+ * @param nowMs  Current millis() value
+ */
+Eta getCooldownEta(state_machine::State s, uint32_t nowMs);
+
+/** Read-only view of the cold-stage history, for scans via its iterators. */
+const ColdHistory& getHistory();
+
+/** Read-only view of the ambient history (values in kelvin). */
+const AmbientHistory& getAmbientHistory();
+
+/**
+ * Return cooldown progress from AMBIENT_START_K (0 %) to the live setpoint
+ * (100 %), clamped to 0 .. 100.
  */
 float getTemperatureToPercent();
 
@@ -0,0 +1,68 @@
+/**
+ * @file warm_restart.h
+ * @brief Control snapshot in RTC memory so a running unit resumes after a
+ *        watchdog, panic or brownout reset
+ *
+ * Every control tick checkpoint() copies state_machine::snapshot() plus the
+ * applied DAC value and the cold-stage temperature into RTC_NOINIT memory,
+ * which survives every reset except power-on.  Two slots are written
+ * alternately, each with a sequence number and CRC-16, so a reset in the
+ * middle of a checkpoint leaves the previous slot intact (~0.8 KB of the
+ * 8 KB RTC slow memory in all).
+ *
+ * At boot restore() uses the newest valid slot only when:
+ *
+ *   - the reset was not a power-on (RTC memory is undefined then);
+ *   - the snapshot was taken while running (a stopped, off or faulted
+ *     unit stays stopped — operator action is needed);
+ *   - the first RTD reading is within WARM_RESTART_MAX_TEMP_DELTA_K of the
+ *     snapshot, i.e. the reset was short enough that the plant has not
+ *     moved.
+ *
+ * It then resumes the state machine (state, timers, backoff offset, loop
+ * integrator, baseline statistics) and writes the DAC straight to its
+ * previous value, so the first control tick after boot continues the run
+ * instead of re-ramping from zero.  A running snapshot that fails only the
+ * temperature check falls back to state_machine::start() from the measured
+ * temperature.
+ *
+ * NVS was not used: a per-tick checkpoint would wear it out, and a
+ * checkpoint old enough to survive a power cycle would fail the temperature
+ * check anyway.  The run log (run_log.h) keeps the long-term history.
+ */
+
+#ifndef WARM_RESTART_H
+#define WARM_RESTART_H
+
+#include <stdint.h>
+#include "state_machine.h"
+
+namespace warm_restart {
+
+/** Outcome of restore(), for the boot banner. */
+enum class Result : uint8_t {
+    ColdBoot    = 0,   ///< power-on reset
+    NoSnapshot  = 1,   ///< no valid slot
+    NotRunning  = 2,   ///< unit was stopped, off or faulted
+    NoReading   = 3,   ///< running, but no RTD reading to check against
+    Restarted   = 4,   ///< temperature moved: start() from the reading
+    Resumed     = 5,   ///< snapshot restored
+};
+
+/** Store the latest control state.  Call after each control tick. */
+void checkpoint(const state_machine::Snapshot& s, float tempK, uint16_t dacActual);
+
+/**
+ * Resume from the newest checkpoint if it is safe (see above).  Call once
+ * in setup() after state_machine::init(), dac::init() and a first RTD read.
+ *
+ * @param tempK  first cold-stage reading, 0 if none
+ */
+Result restore(uint32_t nowMs, float tempK);
+
+/** Return a short ASCII description of a Result. */
+const char* resultName(Result r);
+
+} // namespace warm_restart
+
+#endif // WARM_RESTART_H
@@ -0,0 +1,262 @@
+/**
+ * @file acquisition.cpp
+ * @brief Continuous-mode (DMA) ADC acquisition engine implementation
+ *
+ * The ADC digital controller walks a three-entry conversion pattern
+ * (DAC voltage, ACS712 current, 12 V rail) at 3 × the per-channel rate and
+ * writes type-2 results into the DMA pool.  A reader task blocks in
+ * adc_digi_read_bytes() for one frame at a time, then for each result:
+ *
+ *   1. maps (unit, channel) back to a Channel slot,
+ *   2. updates that slot's fixed-point EMA filter,
+ *   3. calls the slot's raw sample sink, if any.
+ *
+ * Filter state is a Q(shift) accumulator: acc = acc − acc/2^k + x, so the
+ * filtered value is acc >> k.  Reads of the published 16-bit value are
+ * atomic on Xtensa, so getFiltered() needs no lock.
+ *
+ * The Wi-Fi driver owns ADC2 while the radio runs, and continuous-mode
+ * conversions on it then fail.  A network build (NET_ENABLED) therefore
+ * leaves ADC2 channels out of the DMA pattern and converts them from a
+ * periodic esp_timer at the same per-channel rate with adc2_get_raw(),
+ * which goes through the driver's Wi-Fi arbiter.  A read the arbiter
+ * refuses repeats the channel's last sample, so a sink still sees
+ * ACS712_SAMPLES_PER_CYCLE samples per drive cycle; getPollMissCount()
+ * counts those.
+ */
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_timer.h>
+
+#include "acquisition.h"
+#include "config.h"
+#include "pin_config.h"
+
+// ---------------------------------------------------------------------------
+// Module constants
+// ---------------------------------------------------------------------------
+
+static constexpr uint32_t SAMPLE_RATE_PER_CHANNEL_HZ =
+    static_cast<uint32_t>(AD9833_FREQ_HZ) * ACS712_SAMPLES_PER_CYCLE;
+
+// One frame = ADC_FRAME_CYCLES drive cycles of every channel.
+static constexpr uint32_t FRAME_RESULTS =
+    static_cast<uint32_t>(ACS712_SAMPLES_PER_CYCLE) * ADC_FRAME_CYCLES
+    * acquisition::CHANNEL_COUNT;
+static constexpr uint32_t FRAME_BYTES = FRAME_RESULTS * SOC_ADC_DIGI_RESULT_BYTES;
+
+// Polled ADC2 channels are converted once per timer period.
+static constexpr uint64_t POLL_PERIOD_US =
+    (1000000ull + SAMPLE_RATE_PER_CHANNEL_HZ / 2u) / SAMPLE_RATE_PER_CHANNEL_HZ;
+
+// ---------------------------------------------------------------------------
+// Module state
+// ---------------------------------------------------------------------------
+
+struct ChannelSlot {
+    uint8_t                  pin;
+    uint8_t                  filterShift;
+    adc_attenuation_t        atten;
+    uint8_t                  unit;        // 0 = ADC1, 1 = ADC2
+    uint8_t                  channel;     // channel within the unit
+    bool                     polled;      // adc2_get_raw() instead of DMA
+    uint16_t                 last;        // polled: repeated on a refused read
+    uint32_t                 acc;         // EMA accumulator (value << filterShift)
+    bool                     primed;
+    volatile uint16_t        filtered;
+    volatile uint32_t        count;
+    acquisition::SampleSink  sink;
+};
+
+static ChannelSlot slots[acquisition::CHANNEL_COUNT] = {
+    { DAC_VOLTAGE_PIN,     ADC_DAC_VOLTAGE_FILTER_SHIFT, ADC_11db,               0, 0, false, 0, 0, false, 0, 0, nullptr },
+    { ACS712_CURRENT_PIN,  ADC_CURRENT_FILTER_SHIFT,     ACS712_ADC_ATTENUATION, 0, 0, false, 0, 0, false, 0, 0, nullptr },
+    { VOLTAGE_12_TEST_PIN, ADC_RAIL_12V_FILTER_SHIFT,    ADC_11db,               0, 0, false, 0, 0, false, 0, 0, nullptr },
+};
+
+static uint8_t            frame[FRAME_BYTES];
+static uint32_t           frameBytes = FRAME_BYTES;   // shrinks with fewer DMA channels
+static TaskHandle_t       readerTask = nullptr;
+static esp_timer_handle_t pollTimer  = nullptr;
+static volatile uint32_t  overruns   = 0;
+static volatile uint32_t  pollMisses = 0;
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+static void ingest(ChannelSlot& s, uint16_t raw) {
+    if (!s.primed) {
+        s.acc    = static_cast<uint32_t>(raw) << s.filterShift;
+        s.primed = true;
+    } else {
+        s.acc = s.acc - (s.acc >> s.filterShift) + raw;
+    }
+    s.filtered = static_cast<uint16_t>(s.acc >> s.filterShift);
+    s.count    = s.count + 1u;
+
+    const acquisition::SampleSink sink = s.sink;
+    if (sink != nullptr) {
+        sink(raw);
+    }
+}
+
+static void processFrame(const uint8_t* buf, uint32_t len) {
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const auto* r = reinterpret_cast<const adc_digi_output_data_t*>(&buf[i]);
+        const uint8_t unit    = static_cast<uint8_t>(r->type2.unit);
+        const uint8_t channel = static_cast<uint8_t>(r->type2.channel);
+        for (auto& s : slots) {
+            if (s.unit == unit && s.channel == channel) {
+                ingest(s, static_cast<uint16_t>(r->type2.data));
+                break;
+            }
+        }
+    }
+}
+
+static void readerLoop(void*) {
+    for (;;) {
+        uint32_t len = 0;
+        const esp_err_t err = adc_digi_read_bytes(frame, frameBytes, &len, ADC_MAX_DELAY);
+        if (err == ESP_ERR_INVALID_STATE) {
+            // Pool overflowed: the driver kept the newest data, we lost some.
+            overruns = overruns + 1u;
+        } else if (err != ESP_OK) {
+            continue;
+        }
+        processFrame(frame, len);
+    }
+}
+
+/** esp_timer callback: one arbitrated conversion of every polled channel. */
+static void onPollTick(void*) {
+    for (auto& s : slots) {
+        if (!s.polled) continue;
+        int raw = 0;
+        if (adc2_get_raw(static_cast<adc2_channel_t>(s.channel), ADC_WIDTH_BIT_12, &raw) == ESP_OK) {
+            s.last = static_cast<uint16_t>(raw);
+        } else {
+            pollMisses = pollMisses + 1u;   // radio holds ADC2 this period
+            if (!s.primed) continue;        // nothing to repeat yet
+        }
+        ingest(s, s.last);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+namespace acquisition {
+
+void init() {
+    if (readerTask != nullptr) return;
+
+    uint32_t adc1Mask    = 0;
+    uint32_t adc2Mask    = 0;
+    uint8_t  patternLen  = 0;
+    bool     anyPolled   = false;
+    adc_digi_pattern_config_t pattern[CHANNEL_COUNT] = {};
+
+    for (uint8_t i = 0; i < CHANNEL_COUNT; ++i) {
+        ChannelSlot& s = slots[i];
+        const int8_t ch = digitalPinToAnalogChannel(s.pin);
+        if (ch < 0) {
+            Serial.printf("acquisition: pin %u has no ADC channel!\n", s.pin);
+            continue;
+        }
+        s.unit    = static_cast<uint8_t>(ch / SOC_ADC_MAX_CHANNEL_NUM);
+        s.channel = static_cast<uint8_t>(ch % SOC_ADC_MAX_CHANNEL_NUM);
+        s.acc     = 0;
+        s.primed  = false;
+        s.polled  = NET_ENABLED && s.unit == 1;
+        if (s.polled) {
+            adc2_config_channel_atten(static_cast<adc2_channel_t>(s.channel),
+                                      static_cast<adc_atten_t>(s.atten));
+            anyPolled = true;
+            continue;
+        }
+        (s.unit == 0 ? adc1Mask : adc2Mask) |= (1u << s.channel);
+
+        adc_digi_pattern_config_t& p = pattern[patternLen++];
+        p.atten     = static_cast<uint8_t>(s.atten);
+        p.channel   = s.channel;
+        p.unit      = s.unit;
+        p.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    // A frame stays ADC_FRAME_CYCLES drive cycles of every DMA channel.
+    frameBytes = FRAME_BYTES / CHANNEL_COUNT * patternLen;
+
+    adc_digi_init_config_t initCfg = {};
+    initCfg.max_store_buf_size = 2u * frameBytes;   // double-buffered pool
+    initCfg.conv_num_each_intr = frameBytes;
+    initCfg.adc1_chan_mask     = adc1Mask;
+    initCfg.adc2_chan_mask     = adc2Mask;
+    if (adc_digi_initialize(&initCfg) != ESP_OK) {
+        Serial.println("acquisition: adc_digi_initialize failed!");
+        return;
+    }
+
+    adc_digi_configuration_t digCfg = {};
+    digCfg.conv_limit_en  = false;
+    digCfg.conv_limit_num = 250;
+    digCfg.pattern_num    = patternLen;
+    digCfg.adc_pattern    = pattern;
+    digCfg.sample_freq_hz = SAMPLE_RATE_PER_CHANNEL_HZ * patternLen;
+    digCfg.conv_mode      = (adc2Mask != 0) ? ADC_CONV_BOTH_UNIT : ADC_CONV_SINGLE_UNIT_1;
+    digCfg.format         = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&digCfg) != ESP_OK) {
+        Serial.println("acquisition: adc_digi_controller_configure failed!");
+        return;
+    }
+
+    adc_digi_start();
+    xTaskCreatePinnedToCore(readerLoop, "adc", ADC_TASK_STACK_BYTES, nullptr,
+                            ADC_TASK_PRIORITY, &readerTask, ADC_TASK_CORE);
+
+    if (anyPolled) {
+        // Task dispatch: adc2_get_raw() takes the arbiter lock, which an
+        // ISR may not.  The esp_timer task runs on core 0.
+        const esp_timer_create_args_t args = {
+            onPollTick, nullptr, ESP_TIMER_TASK, "adc2", true,
+        };
+        if (esp_timer_create(&args, &pollTimer) != ESP_OK ||
+            esp_timer_start_periodic(pollTimer, POLL_PERIOD_US) != ESP_OK) {
+            Serial.println("acquisition: ADC2 poll timer failed to start!");
+        }
+    }
+
+    Serial.printf("Acquisition engine running - %lu Hz per channel, %lu-byte frames, %u polled\n",
+                  static_cast<unsigned long>(SAMPLE_RATE_PER_CHANNEL_HZ),
+                  static_cast<unsigned long>(frameBytes),
+                  static_cast<unsigned>(CHANNEL_COUNT - patternLen));
+}
+
+void setSampleSink(Channel ch, SampleSink sink) {
+    slots[static_cast<uint8_t>(ch)].sink = sink;
+}
+
+uint16_t getFiltered(Channel ch) {
+    return slots[static_cast<uint8_t>(ch)].filtered;
+}
+
+uint32_t getSampleCount(Channel ch) {
+    return slots[static_cast<uint8_t>(ch)].count;
+}
+
+float getSampleRateHz() {
+    return static_cast<float>(SAMPLE_RATE_PER_CHANNEL_HZ);
+}
+
+uint32_t getOverrunCount() {
+    return overruns;
+}
+
+uint32_t getPollMissCount() {
+    return pollMisses;
+}
+
+} // namespace acquisition
@@ -13,14 +13,26 @@
  */
 
 #include <Arduino.h>
-#include <SPI.h>
 #include <stdint.h>
 
 #include "pin_config.h"
 #include "config.h"
 #include "dac.h"
+#include "params.h"
+#include "acquisition.h"
+#include "spi_bus.h"
+#include "slew_limiter.h"
+
+// Slew allowance per serviceRamp() call, counts × 256: the same
+// "dacstep" counts per LOOP_INTERVAL_MS (params.h, default
+// DAC_MAX_STEP_PER_INTERVAL), spread over the finer ramp period so the
+// output moves in small, frequent steps.
+static constexpr uint32_t rampCreditQ8(uint32_t stepPerInterval) {
+    return (stepPerInterval * 256u * DAC_RAMP_INTERVAL_MS) / LOOP_INTERVAL_MS;
+}
 
-static uint16_t currentDacVal = 0;
+static uint16_t    currentDacVal = 0;
+static SlewLimiter ramp(rampCreditQ8(DAC_MAX_STEP_PER_INTERVAL));
 
 // MCP4921 control bits: Write to DAC A | Buffered | Gain 1x | Active
 static constexpr uint16_t MCP4921_CTRL_BITS = 0x3000;
@@ -38,11 +50,8 @@ static void writeSpi(uint16_t dacVal) {
     currentDacVal = dacVal;
 
     const uint16_t packet = MCP4921_CTRL_BITS | dacVal;
-    SPI.beginTransaction(SPISettings(MCP4921_SPI_SPEED, MSBFIRST, SPI_MODE0));
-    digitalWrite(MCP4921_CS, LOW);
-    SPI.transfer16(packet);
-    digitalWrite(MCP4921_CS, HIGH);
-    SPI.endTransaction();
+    const uint8_t  tx[2]  = {static_cast<uint8_t>(packet >> 8), static_cast<uint8_t>(packet)};
+    spi_bus::transfer(spi_bus::Device::Dac, tx, nullptr, 2);
 }
 
 // ---------------------------------------------------------------------------
@@ -52,8 +61,8 @@ static void writeSpi(uint16_t dacVal) {
 namespace dac {
 
 void init() {
-    pinMode(MCP4921_CS, OUTPUT);
-    digitalWrite(MCP4921_CS, HIGH);
+    // CS is configured by spi_bus::init(); force the first write through.
+    currentDacVal = 1;
     writeSpi(0);
 }
 
@@ -61,26 +70,29 @@ void update(uint16_t dacVal) {
     writeSpi(dacVal);
 }
 
-void rampToward(uint16_t target) {
-    if (target > MCP4921_MAX_VALUE) {
-        target = MCP4921_MAX_VALUE;
-    }
-
-    uint16_t next = currentDacVal;
+void setTarget(uint16_t target) {
+    ramp.setTarget((target > MCP4921_MAX_VALUE) ? MCP4921_MAX_VALUE : target);
+}
 
-    if (next < target) {
-        const uint16_t step = target - next;
-        next += (step > DAC_MAX_STEP_PER_INTERVAL) ? DAC_MAX_STEP_PER_INTERVAL : step;
-    } else if (next > target) {
-        const uint16_t step = next - target;
-        next -= (step > DAC_MAX_STEP_PER_INTERVAL) ? DAC_MAX_STEP_PER_INTERVAL : step;
-    }
+void serviceRamp() {
+    ramp.setCredit(rampCreditQ8(params::getUint(params::Id::DacMaxStep)));
+    writeSpi(ramp.step(currentDacVal));
+}
 
-    writeSpi(next);
+void restore(uint16_t value) {
+    if (value > MCP4921_MAX_VALUE) value = MCP4921_MAX_VALUE;
+    ramp.reset();
+    ramp.setTarget(value);
+    writeSpi(value);
 }
 
 uint16_t getCurrent() {
     return currentDacVal;
 }
 
+uint16_t getReadback() {
+    const uint16_t raw = acquisition::getFiltered(acquisition::Channel::DacVoltage);
+    return (raw < DAC_MIN_VOLTAGE) ? static_cast<uint16_t>(0) : raw;
+}
+
 } // namespace dac
@@ -6,15 +6,25 @@
  * FAULT + READY colour, and optional discrete digital outputs on
  * FAULT_IND_PIN / READY_IND_PIN.
  *
- * Flash timing is non-blocking (state-machine style).
+ * The outputs are driven from a periodic esp_timer (INDICATOR_TICK_MS), not
+ * from any application task, so a blocked console or a busy control pass
+ * cannot stretch a flash.  Each tick evaluates the timestamp-phased Pattern
+ * (indicator_pattern.h) and touches the hardware only on a change: the
+ * discrete pins when a level flips, FastLED.show() (one RMT frame) only
+ * when the colour does.  A steady display costs a compare per tick.
+ *
+ * setFaultMode() / setReadyMode() run on the control core; they update the
+ * Pattern under patternMux and the next tick shows the new mode.
  */
 
 #include <Arduino.h>
 #include <FastLED.h>
+#include <esp_timer.h>
 
 #include "pin_config.h"
 #include "config.h"
 #include "indicator.h"
+#include "indicator_pattern.h"
 
 // ---------------------------------------------------------------------------
 // Module constants
@@ -28,87 +38,55 @@ static constexpr uint8_t LED_COUNT = 1;
 
 static CRGB leds[LED_COUNT];
 
-static indicator::Mode faultMode = indicator::Mode::Off;
-static indicator::Mode readyMode = indicator::Mode::Off;
+// Requested modes (guarded by patternMux)
+static indicator::Pattern pattern;
+static portMUX_TYPE       patternMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Timer task only: what the hardware currently shows
+static indicator::Output shown = {false, false, indicator::Colour::Black};
 
-// Per-indicator flash state
-static bool     faultLedOn   = false;
-static bool     readyLedOn   = false;
-static uint32_t faultLastMs  = 0;
-static uint32_t readyLastMs  = 0;
+// Published for isFaultOn() / isReadyOn()
+static volatile bool faultOnCached = false;
+static volatile bool readyOnCached = false;
 
-// Cached result of last update() — used by isFaultOn() / isReadyOn()
-static bool     faultOnCached = false;
-static bool     readyOnCached = false;
+static esp_timer_handle_t tickTimer = nullptr;
 
 // ---------------------------------------------------------------------------
 // Internal helpers
 // ---------------------------------------------------------------------------
 
-/**
- * Evaluate one indicator's state and return whether the LED should be on
- * for this tick.  Updates the toggle state when the period elapses.
- */
-static bool evalMode(indicator::Mode    mode,
-                     bool&              ledOn,
-                     uint32_t&          lastMs,
-                     uint32_t           nowMs)
-{
-    using Mode = indicator::Mode;
-    switch (mode) {
-        case Mode::Off:
-            return false;
-
-        case Mode::SolidRed:
-        case Mode::SolidGreen:
-        case Mode::SolidAmber:
-            return true;
-
-        case Mode::FlashFastRed:
-        case Mode::FlashFastGreen: {
-            const uint32_t half = INDICATOR_FLASH_FAST_PERIOD_MS / 2;
-            if ((nowMs - lastMs) >= half) {
-                lastMs = nowMs;
-                ledOn = !ledOn;
-            }
-            return ledOn;
-        }
-
-        case Mode::FlashSlowRed:
-        case Mode::FlashSlowGreen: {
-            const uint32_t half = INDICATOR_FLASH_SLOW_PERIOD_MS / 2;
-            if ((nowMs - lastMs) >= half) {
-                lastMs = nowMs;
-                ledOn = !ledOn;
-            }
-            return ledOn;
-        }
+static CRGB toCrgb(indicator::Colour colour) {
+    using Colour = indicator::Colour;
+    switch (colour) {
+        case Colour::Red:   return CRGB::Red;
+        case Colour::Green: return CRGB::Green;
+        case Colour::Amber: return CRGB(255, 80, 0);   // Orange-amber
+        case Colour::Black: break;
     }
-    return false;
+    return CRGB::Black;
 }
 
-/**
- * Return the colour component of a mode (ignoring flash/solid).
- */
-static CRGB modeToColour(indicator::Mode mode) {
-    using Mode = indicator::Mode;
-    switch (mode) {
-        case Mode::SolidRed:
-        case Mode::FlashFastRed:
-        case Mode::FlashSlowRed:
-            return CRGB::Red;
-
-        case Mode::SolidGreen:
-        case Mode::FlashFastGreen:
-        case Mode::FlashSlowGreen:
-            return CRGB::Green;
-
-        case Mode::SolidAmber:
-            return CRGB(255, 80, 0);   // Orange-amber
-
-        default:
-            return CRGB::Black;
+/** esp_timer callback: bring the LEDs to the Pattern's current output. */
+static void onTick(void*) {
+    portENTER_CRITICAL(&patternMux);
+    const indicator::Pattern p = pattern;
+    portEXIT_CRITICAL(&patternMux);
+
+    const indicator::Output o = p.evaluate(millis());
+    if (o == shown) return;
+
+    // Discrete LEDs (active HIGH)
+    if (o.faultOn != shown.faultOn) digitalWrite(FAULT_IND_PIN, o.faultOn ? HIGH : LOW);
+    if (o.readyOn != shown.readyOn) digitalWrite(READY_IND_PIN, o.readyOn ? HIGH : LOW);
+    faultOnCached = o.faultOn;
+    readyOnCached = o.readyOn;
+
+    // WS2812: a new frame only for a new colour
+    if (o.colour != shown.colour) {
+        leds[0] = toCrgb(o.colour);
+        FastLED.show();
     }
+    shown = o;
 }
 
 // ---------------------------------------------------------------------------
@@ -128,50 +106,30 @@ void init() {
     pinMode(READY_IND_PIN, OUTPUT);
     digitalWrite(FAULT_IND_PIN, LOW);
     digitalWrite(READY_IND_PIN, LOW);
-}
 
-void setFaultMode(Mode mode) {
-    if (mode != faultMode) {
-        faultMode  = mode;
-        faultLedOn = false;
-        faultLastMs = 0;
+    // Task dispatch: FastLED.show() waits on the RMT driver, which an ISR
+    // may not.  The esp_timer task outranks every application task.
+    const esp_timer_create_args_t args = {
+        onTick, nullptr, ESP_TIMER_TASK, "indicator", true,
+    };
+    if (esp_timer_create(&args, &tickTimer) != ESP_OK ||
+        esp_timer_start_periodic(tickTimer, INDICATOR_TICK_MS * 1000ull) != ESP_OK) {
+        Serial.println("indicator: output timer failed to start");
     }
 }
 
-void setReadyMode(Mode mode) {
-    if (mode != readyMode) {
-        readyMode  = mode;
-        readyLedOn = false;
-        readyLastMs = 0;
-    }
+void setFaultMode(Mode mode) {
+    const uint32_t nowMs = millis();
+    portENTER_CRITICAL(&patternMux);
+    pattern.setFault(mode, nowMs);
+    portEXIT_CRITICAL(&patternMux);
 }
 
-void update(uint32_t nowMs) {
-    const bool faultOn = evalMode(faultMode, faultLedOn, faultLastMs, nowMs);
-    const bool readyOn = evalMode(readyMode, readyLedOn, readyLastMs, nowMs);
-
-    // Cache for isFaultOn() / isReadyOn()
-    faultOnCached = faultOn;
-    readyOnCached = readyOn;
-
-    // Discrete LEDs (active HIGH)
-    digitalWrite(FAULT_IND_PIN, faultOn ? HIGH : LOW);
-    digitalWrite(READY_IND_PIN, readyOn ? HIGH : LOW);
-
-    // WS2812 — blend fault and ready colours
-    CRGB colour = CRGB::Black;
-    if (faultOn && readyOn) {
-        // Both active simultaneously: show amber
-        colour = CRGB(255, 80, 0);
-    } else if (faultOn) {
-        colour = modeToColour(faultMode);
-    } else if (readyOn) {
-        colour = modeToColour(readyMode);
-    }
-
-    leds[0] = colour;
-    FastLED.setBrightness(WAVE_STATUS_LED_BRIGHTNESS);
-    FastLED.show();
+void setReadyMode(Mode mode) {
+    const uint32_t nowMs = millis();
+    portENTER_CRITICAL(&patternMux);
+    pattern.setReady(mode, nowMs);
+    portEXIT_CRITICAL(&patternMux);
 }
 
 bool isFaultOn() {
@@ -3,70 +3,338 @@
  * @brief ESP32-S3 cryocooler controller -- application entry point
  *
  * Orchestrates all subsystem modules through the state machine and emits
- * one Serial Studio telemetry frame each loop tick.  See telemetry.h for
+ * one Serial Studio telemetry frame each control tick.  See telemetry.h for
  * the full Serial Studio frame format and column definitions.
  *
+ * Task layout (FreeRTOS, created at the end of setup()):
+ *
+ *   Core 1  control    CONTROL_TASK_PRIORITY, a cooperative scheduler
+ *                      (scheduler.h) running each job at its own period:
+ *                      current per drive cycle, DAC ramp at 50 Hz, RTD,
+ *                      state_machine::update() → actuators, telemetry::emit()
+ *                      into the telemetry ring, the ambient sensor and
+ *                      run-log samples.
+ *                      Periods and phases are in config.h; per-job WCET and
+ *                      overruns are reported by the "tasks" command.
+ *
+ *   Core 0  telemetry  woken by the control task (or every
+ *                      TELEMETRY_RETRY_MS); telemetry::service() writes
+ *                      queued frames as USB-CDC TX space allows and hands
+ *                      each one to the network tap; net::flush().
+ *           console    every CONSOLE_POLL_INTERVAL_MS: serial_commands,
+ *                      the TCP console and run-log flash writes.
+ *           adc        acquisition engine reader (see acquisition.h).
+ *           net        UDP telemetry datagrams and Wi-Fi link state
+ *                      (net.h; only when built with NET_WIFI_SSID).
+ *
+ *   esp_timer  indicator LED outputs every INDICATOR_TICK_MS (indicator.h);
+ *              in a network build, the ADC2 acquisition inputs at the
+ *              per-channel sample rate (acquisition.h).
+ *
+ * The control task never touches Serial on its hot path: frames go
+ * through a lock-free SPSC ring (dropped if full), so USB-CDC backpressure
+ * can only stall the core-0 tasks.  Console commands that mutate the state
+ * machine take controlMutex, which the control task holds while it runs
+ * the jobs that are due; command output is buffered and written after the
+ * mutex is released.
+ *
+ * Statistics have one writer, the task that counts them.  A console
+ * "reset" command therefore never writes them across cores: it posts a
+ * request that the owner applies on its next pass (scheduler jobs,
+ * telemetry ring, perf probes, net counters).  SPI bus counters, which are
+ * only written by whoever holds the bus, are reset under the bus lock.
+ *
+ * setup() is app::init() then app::startTasks() (app.h), so the on-target
+ * soak benchmark starts exactly this pipeline.
+ *
  * Required Libraries (platformio.ini lib_deps):
  *   - Adafruit MAX31865
  *   - MD_AD9833
  *   - FastLED
- *   - SmoothADC
+ *   - DallasTemperature
  */
 
 #include <Arduino.h>
-#include <SPI.h>
-#include <SmoothADC.h>
 
 #include "config.h"
 #include "pin_config.h"
+#include "acquisition.h"
 #include "temperature.h"
 #include "waveform.h"
 #include "dac.h"
+#include "params.h"
 #include "rms.h"
 #include "relay.h"
 #include "indicator.h"
 #include "state_machine.h"
 #include "telemetry.h"
 #include "serial_commands.h"
+#include "net.h"
+#include "scheduler.h"
+#include "spi_bus.h"
+#include "perf.h"
+#include "run_log.h"
+#include "warm_restart.h"
+#include "app.h"
 
 // =============================================================================
-// Module-level objects
+// Task state
 // =============================================================================
 
-static SmoothADC dacVoltageAdc;
+static TaskHandle_t      controlTaskHandle   = nullptr;
+static TaskHandle_t      telemetryTaskHandle = nullptr;
+static TaskHandle_t      consoleTaskHandle   = nullptr;
+static SemaphoreHandle_t controlMutex        = nullptr;
+static bool              wasCooling          = false;   // previous step's state was a cooldown
+static state_machine::Output lastOutput      = {};      // latest control step, for telemetry
+
+// Interval probes (perf::Probe::ControlJitter / SensorToDac), control core
+static uint32_t lastControlCycles = 0;
+static bool     haveControlCycles = false;
+static uint32_t rtdReadCycles     = 0;       // start of the latest RTD read
+static uint32_t dacPendingCycles  = 0;       // RTD read behind the newest control step
+static bool     dacPending        = false;   // that step has not reached the dac job yet
 
 // =============================================================================
-// Timing state
+// Scheduled jobs (control core; caller holds controlMutex)
 // =============================================================================
 
-static uint32_t previousLoopMs = 0;
+static bool isCooldown(state_machine::State s) {
+    return s == state_machine::State::CoarseCooldown ||
+           s == state_machine::State::FineCooldown;
+}
+
+/** ACS712 window RMS, spike detection and drive RMS voltage. */
+static void currentJob() {
+    {
+        PERF_SCOPE(perf::Probe::VoltageRms);
+        rms::read();
+    }
+    PERF_SCOPE(perf::Probe::CurrentRms);
+    rms::readCurrent();
+}
+
+/** One fine DAC slew step toward the state-machine target. */
+static void dacJob() {
+    {
+        PERF_SCOPE(perf::Probe::DacRamp);
+        dac::serviceRamp();
+    }
+    if (PERF_ENABLED && dacPending) {
+        perf::record(perf::Probe::SensorToDac, perf::cycles() - dacPendingCycles);
+        dacPending = false;
+    }
+}
+
+/** MAX31865 read → temperature history, then RTD fault check. */
+static void rtdJob() {
+    rtdReadCycles = perf::cycles();
+    {
+        PERF_SCOPE(perf::Probe::RtdRead);
+        temperature::read(millis());
+    }
+    PERF_SCOPE(perf::Probe::RtdFaults);
+    temperature::checkFaults();
+}
+
+/** DS18B20 conversion state machine (never blocks). */
+static void ambientJob() {
+    PERF_SCOPE(perf::Probe::AmbientService);
+    temperature::serviceAmbient(millis());
+}
+
+/** How far this control step started from one period after the last. */
+static void recordJitter() {
+    if (!PERF_ENABLED) return;
+    const uint32_t now = perf::cycles();
+    if (haveControlCycles) {
+        const uint32_t nominal = LOOP_INTERVAL_MS * 1000u * perf::clockMHz();
+        const uint32_t elapsed = now - lastControlCycles;
+        perf::record(perf::Probe::ControlJitter,
+                     elapsed > nominal ? elapsed - nominal : nominal - elapsed);
+    }
+    lastControlCycles = now;
+    haveControlCycles = true;
+}
+
+/** State machine step on the latest sensor values → actuators. */
+static void controlJob() {
+    const uint32_t nowMs = millis();
+    recordJitter();
+
+    // A cooldown starts with an empty stall window and cooldown fit: the
+    // flat history from before Start must not count as "failed to cool"
+    // nor bend the ETA.  start() (console, warm restart) enters the
+    // cooldown between steps, so restart before this step reads isStalled().
+    if (isCooldown(state_machine::getState()) && !wasCooling) {
+        temperature::restartStallWindow();
+        temperature::restartCooldownEta();
+        wasCooling = true;
+    }
+
+    const float tempK       = temperature::getLastTempK();
+    const float coolingRate = temperature::getCoolingRateKPerMin();
+    const bool  stalled     = temperature::isStalled();
+    const float rmsV        = rms::getVoltage();
+
+    const bool overstroke = rms::hasOverstroke();
+    state_machine::Output out;
+    {
+        PERF_SCOPE(perf::Probe::StateMachine);
+        out = state_machine::update(tempK, coolingRate, rmsV, stalled, nowMs, overstroke,
+                                    rms::getCurrentA(), dac::getCurrent());
+    }
+    if (overstroke) { rms::clearOverstroke(); }
+    if (out.backoffCount > lastOutput.backoffCount) {
+        run_log::logBackoff(nowMs, tempK, dac::getCurrent(), out.state, out.backoffCount);
+    }
+
+    PERF_SCOPE(perf::Probe::Actuators);
+
+    // Same for a cooldown entered by update() itself
+    const bool cooling = isCooldown(out.state);
+    if (cooling && !wasCooling) {
+        temperature::restartStallWindow();
+        temperature::restartCooldownEta();
+    }
+    wasCooling = cooling;
+
+    relay::setBypass(!out.bypassRelay);   // setBypass(true) = Normal
+    relay::setAlarm(out.alarmRelay);
+
+    indicator::setFaultMode(out.faultIndMode);
+    indicator::setReadyMode(out.readyIndMode);
+
+    // The dac job slews toward this (rate-limited in dac.cpp)
+    dac::setTarget(out.dacTarget);
+    dacPendingCycles = rtdReadCycles;
+    dacPending       = true;
+
+    // RTC-memory checkpoint so a warm reset resumes this tick's state
+    warm_restart::checkpoint(state_machine::snapshot(nowMs), tempK, dac::getCurrent());
+
+    lastOutput = out;
+}
+
+/** Snapshot the latest control output into the telemetry ring. */
+static void telemetryJob() {
+    {
+        PERF_SCOPE(perf::Probe::TelemetryEmit);
+        telemetry::emit(lastOutput);   // never blocks; dropped if full
+    }
+    xTaskNotifyGive(telemetryTaskHandle);
+}
+
+/** Periodic run-log sample of the latest control output. */
+static void logJob() {
+    run_log::logSample(millis(), temperature::getLastTempK(), dac::getCurrent(),
+                       lastOutput.state, lastOutput.backoffCount);
+}
+
+static constexpr uint32_t MS = 1000;   // scheduler periods are in µs
+
+// Table order is priority order when several jobs are due together.
+static sched::Task controlJobs[] = {
+    {"current",   currentJob,   CURRENT_READ_INTERVAL_US,          0,                              0, 0, {}},
+    {"dac",       dacJob,       DAC_RAMP_INTERVAL_MS * MS,         0,                              0, 0, {}},
+    {"rtd",       rtdJob,       RTD_READ_INTERVAL_MS * MS,         RTD_READ_PHASE_MS * MS,         0, 0, {}},
+    {"control",   controlJob,   LOOP_INTERVAL_MS * MS,             CONTROL_PHASE_MS * MS,          0, 0, {}},
+    {"telemetry", telemetryJob, TELEMETRY_EMIT_INTERVAL_MS * MS,   TELEMETRY_EMIT_PHASE_MS * MS,   0, 0, {}},
+    {"ambient",   ambientJob,   AMBIENT_SERVICE_INTERVAL_MS * MS,  AMBIENT_SERVICE_PHASE_MS * MS,  0, 0, {}},
+    {"log",       logJob,       RUN_LOG_SAMPLE_INTERVAL_MS * MS,   RUN_LOG_SAMPLE_PHASE_MS * MS,   0, 0, {}},
+};
+
+static sched::Scheduler scheduler(
+    controlJobs, static_cast<uint8_t>(sizeof(controlJobs) / sizeof(controlJobs[0])),
+    []() -> uint32_t { return static_cast<uint32_t>(micros()); });
 
 // =============================================================================
-// Setup
+// Tasks
 // =============================================================================
 
-void setup() {
+static void controlTask(void*) {
+    scheduler.start();
+    for (;;) {
+        xSemaphoreTake(controlMutex, portMAX_DELAY);
+        uint32_t waitUs;
+        {
+            // One bus acquisition for every job due on this wake
+            spi_bus::Batch bus;
+            PERF_SCOPE(perf::Probe::ControlPass);
+            waitUs = scheduler.runDue();
+        }
+        xSemaphoreGive(controlMutex);
+
+        // Sleep to the next release, rounded up to a whole RTOS tick; the
+        // job then runs up to one tick late, which shows up as lateness.
+        if (waitUs > 0) {
+            const TickType_t ticks = pdMS_TO_TICKS((waitUs + 999u) / 1000u);
+            vTaskDelay(ticks > 0 ? ticks : 1);
+        }
+    }
+}
+
+static void telemetryTask(void*) {
+    for (;;) {
+        // A frame held back for TX space is retried on the timeout.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TELEMETRY_RETRY_MS));
+        PERF_SCOPE(perf::Probe::TelemetryTx);
+        telemetry::service();
+        net::flush();
+    }
+}
+
+static void consoleTask(void*) {
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(CONSOLE_POLL_INTERVAL_MS));
+
+        // Process incoming serial commands (non-blocking)
+        {
+            PERF_SCOPE(perf::Probe::Console);
+            serial_commands::service();
+            net::serviceConsole();
+        }
+
+        // Queued run-log records → flash (page writes; sector erases only
+        // while idle, since an erase stalls the control core too)
+        const state_machine::State st = state_machine::getState();
+        run_log::service(millis(), st == state_machine::State::Off ||
+                                   st == state_machine::State::Idle);
+    }
+}
+
+// =============================================================================
+// Bring-up (app.h)
+// =============================================================================
+
+namespace app {
+
+void init() {
     Serial.begin(SERIAL_BAUD);
 
-    // Wait for USB-CDC serial port (ESP32-S3 native USB).
-    while (!Serial) delay(10);
+    // Wait for USB-CDC serial port (ESP32-S3 native USB).  A network build
+    // may run untethered, so it only waits NET_USB_WAIT_MS for a host.
+    const uint32_t usbWaitStartMs = millis();
+    while (!Serial && (!net::isEnabled() || millis() - usbWaitStartMs < NET_USB_WAIT_MS)) {
+        delay(10);
+    }
 
     Serial.println("Cryocooler Controller -- starting up");
     Serial.println("=====================================");
 
+    // Stored parameter profile (params.h) before anything reads the limits
+    Serial.println(params::load() ? "Parameters: stored profile applied"
+                                  : "Parameters: config.h defaults");
+
     analogReadResolution(ADC_RESOLUTION);
 
-    // Shared SPI bus
-    SPI.begin(SPI_CLK, SPI_MISO, SPI_MOSI, -1);
+    // Shared SPI bus (MAX31865, AD9833, MCP4921); before any device init()
+    spi_bus::init();
 
-    // Smooth DAC voltage readback
-    dacVoltageAdc.init(DAC_VOLTAGE_PIN, TB_MS, DAC_VOLTAGE_ADC_SMOOTH_PERIOD_MS);
-    dacVoltageAdc.enable();
-    dacVoltageAdc.setPeriod(0);
-    for (uint8_t i = 0; i < DAC_VOLTAGE_ADC_SMOOTH_PRIME_SAMPLES; ++i) {
-        dacVoltageAdc.serviceADCPin();
-    }
-    dacVoltageAdc.setPeriod(DAC_VOLTAGE_ADC_SMOOTH_PERIOD_MS);
+    // DMA acquisition of DAC readback, ACS712 current and 12 V rail.
+    // Must start before rms::init(), which calibrates from the stream.
+    acquisition::init();
 
     // Peripherals
     waveform::init();
@@ -79,63 +347,81 @@ void setup() {
     // Kick off state machine in Off state
     state_machine::init(millis());
 
-    // Initialise serial command handler
+    // Run log: Boot record now, then every state change and backoff.  The
+    // hook runs under controlMutex (control tick or console command).
+    if (!run_log::init(millis())) {
+        Serial.println("run_log: partition '" RUN_LOG_PARTITION_LABEL "' not found - logging disabled");
+    }
+    state_machine::setTransitionHook(
+        [](state_machine::State from, state_machine::State to,
+           state_machine::FaultReason reason, uint32_t nowMs) {
+            run_log::logTransition(from, to, reason, nowMs,
+                                   temperature::getLastTempK(), dac::getCurrent());
+        });
+
+    // Watchdog / brownout reset while running: pick the run back up from
+    // the RTC checkpoint, checked against a fresh RTD reading.
+    const uint32_t tempWaitStartMs = millis();
+    while (temperature::getLastTempK() <= 0.0f &&
+           millis() - tempWaitStartMs < WARM_RESTART_TEMP_WAIT_MS) {
+        temperature::read(millis());
+        delay(5);
+    }
+    const warm_restart::Result restart =
+        warm_restart::restore(millis(), temperature::getLastTempK());
+    Serial.printf("Warm restart: %s (state %s)\n", warm_restart::resultName(restart),
+                  state_machine::stateName(state_machine::getState()));
+
+    // Initialise serial command handler; commands are serialised against
+    // the control tick through controlMutex.
+    controlMutex = xSemaphoreCreateMutex();
     serial_commands::init();
+    serial_commands::setDispatchLock(
+        [] { xSemaphoreTake(controlMutex, portMAX_DELAY); },
+        [] { xSemaphoreGive(controlMutex); });
+    serial_commands::setScheduler(&scheduler);
+
+    // Wi-Fi joins in the background; tap installed before telemetry starts
+    net::init();
 
     Serial.println("Setup complete. System is Off.");
     Serial.println("Type 'help' for available commands.\n");
 }
 
-// =============================================================================
-// Main Loop
-// =============================================================================
-
-void loop() {
-    // Service smoothed ADC every iteration (non-blocking)
-    dacVoltageAdc.serviceADCPin();
-
-    const uint32_t nowMs = millis();
-
-    // Process incoming serial commands (non-blocking)
-    serial_commands::service();
-
-    // Indicator LEDs update every loop for accurate flash timing
-    indicator::update(nowMs);
-
-    // Main control tick at LOOP_INTERVAL_MS cadence
-    if ((nowMs - previousLoopMs) < LOOP_INTERVAL_MS) {
-        return;
-    }
-    previousLoopMs = nowMs;
-
-    // ---- 1. Read sensors ------------------------------------------------
-    temperature::read(nowMs);
-    rms::read();
-    rms::readCurrent();
-
-    const float tempK       = temperature::getLastTempK();
-    const float tempC       = temperature::getLastTempC();
-    const float coolingRate = temperature::getCoolingRateKPerMin();
-    const bool  stalled     = temperature::isStalled();
-    const float rmsV        = rms::getVoltage();
+void startTasks() {
+    // Telemetry first so the control task always has someone to notify.
+    xTaskCreatePinnedToCore(telemetryTask, "telemetry", TELEMETRY_TASK_STACK_BYTES,
+                            nullptr, TELEMETRY_TASK_PRIORITY, &telemetryTaskHandle,
+                            COMMS_TASK_CORE);
+    xTaskCreatePinnedToCore(consoleTask, "console", CONSOLE_TASK_STACK_BYTES,
+                            nullptr, CONSOLE_TASK_PRIORITY, &consoleTaskHandle,
+                            COMMS_TASK_CORE);
+    xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK_BYTES,
+                            nullptr, CONTROL_TASK_PRIORITY, &controlTaskHandle,
+                            CONTROL_TASK_CORE);
+}
 
-    temperature::checkFaults();
+sched::Scheduler& getScheduler() { return scheduler; }
 
-    // ---- 2. Advance state machine ---------------------------------------
-    const bool overstroke = rms::hasOverstroke();
-    const auto out = state_machine::update(tempK, coolingRate, rmsV, stalled, nowMs, overstroke);
-    if (overstroke) { rms::clearOverstroke(); }
+} // namespace app
 
-    // ---- 3. Drive actuators ---------------------------------------------
-    relay::setBypass(!out.bypassRelay);   // setBypass(true) = Normal
-    relay::setAlarm(out.alarmRelay);
+// =============================================================================
+// Setup and Main Loop
+// =============================================================================
 
-    indicator::setFaultMode(out.faultIndMode);
-    indicator::setReadyMode(out.readyIndMode);
+// The on-target test suites link the firmware sources with their own
+// setup() / loop() (see platformio.ini, env:esp32s3_bench / esp32s3_soak).
+#ifndef PIO_UNIT_TESTING
 
-    // Ramp DAC toward the state-machine target (rate-limited in dac.cpp)
-    dac::rampToward(out.dacTarget);
+void setup() {
+    app::init();
+    app::startTasks();
+}
 
-    // ---- 4. Telemetry ---------------------------------------------------
-    telemetry::emit(out);
+void loop() {
+    // All work runs in the tasks created by setup(); retire the Arduino
+    // loop task so it does not compete with them.
+    vTaskDelete(nullptr);
 }
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,295 @@
+/**
+ * @file net.cpp
+ * @brief Wi-Fi telemetry streaming (UDP) and network console (TCP)
+ *
+ * Ownership (see net.h):
+ *   telemetry task  onFrame() and flush(): the pool's producer side and
+ *                   the skipped counter
+ *   network task    link state, the pool's consumer side, UDP sends and
+ *                   their counters
+ *   console task    the TCP server, its one client and that session's
+ *                   LineInput; "net" commands
+ * The destination is the only state written by one task (console) and read
+ * by another (network) as more than one word, so it sits behind destMux.
+ * "net reset" posts a request each owner applies to its counters.
+ */
+
+#include <Arduino.h>
+#include "net.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if NET_ENABLED
+#  include <atomic>
+#  include <WiFi.h>
+#  include <WiFiUdp.h>
+#  include "datagram_pool.h"
+#  include "serial_commands.h"
+#  include "telemetry.h"
+#endif
+
+namespace net {
+
+#if NET_ENABLED
+
+// ---------------------------------------------------------------------------
+// State
+// ---------------------------------------------------------------------------
+
+static DatagramPool<NET_DATAGRAM_COUNT, NET_DATAGRAM_BYTES> pool(NET_BATCH_MAX_FRAMES,
+                                                                 NET_BATCH_MAX_AGE_MS);
+
+static TaskHandle_t  netTaskHandle = nullptr;
+static volatile bool linkUp        = false;   // network task writes
+static volatile bool streaming     = true;    // console writes
+
+static portMUX_TYPE destMux  = portMUX_INITIALIZER_UNLOCKED;
+static IPAddress    destIp;
+static uint16_t     destPort = NET_UDP_PORT;
+
+static WiFiUDP  udp;
+static uint32_t skippedCount   = 0;   // telemetry task
+static uint32_t lastSealed     = 0;   // telemetry task
+static uint32_t datagramCount  = 0;   // network task
+static uint32_t sendErrorCount = 0;   // network task
+
+// resetStats() (console) only posts these; each task zeroes its own counters
+static std::atomic<bool> telemetryResetRequested{false};
+static std::atomic<bool> networkResetRequested{false};
+
+/**
+ * The TCP session as the console sees it.  WiFiClient reports no TX space
+ * (Print::availableForWrite() is 0), so the session grants
+ * NET_CONSOLE_TX_BUDGET_BYTES per serviceConsole() call instead; a dump
+ * paced by it never queues more than that per console poll.
+ */
+class ConsoleSession : public Stream {
+public:
+    WiFiClient client;
+
+    void refill() { _budget = NET_CONSOLE_TX_BUDGET_BYTES; }
+
+    int    available() override { return client.available(); }
+    int    read() override      { return client.read(); }
+    int    peek() override      { return client.peek(); }
+    int    availableForWrite() override { return client.connected() ? _budget : 0; }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t len) override {
+        const size_t n = client.write(buf, len);
+        _budget = n < static_cast<size_t>(_budget) ? _budget - static_cast<int>(n) : 0;
+        return n;
+    }
+    using Print::write;
+
+private:
+    int _budget = 0;
+};
+
+static WiFiServer                 server(NET_CONSOLE_PORT);
+static ConsoleSession             session;
+static WiFiClient&                client = session.client;
+static bool                       serverStarted = false;
+static serial_commands::LineInput consoleInput;
+
+// ---------------------------------------------------------------------------
+// Telemetry task
+// ---------------------------------------------------------------------------
+
+/** Apply a pending resetStats() to the telemetry task's counters. */
+static void applyTelemetryReset() {
+    if (telemetryResetRequested.exchange(false, std::memory_order_acq_rel)) {
+        pool.resetStats();
+        skippedCount = 0;
+        lastSealed   = 0;
+    }
+}
+
+/** Telemetry tap: format @p f in place at the end of the open datagram. */
+static void onFrame(const telemetry::Frame& f) {
+    applyTelemetryReset();
+    if (!linkUp || !streaming) {
+        ++skippedCount;
+        return;
+    }
+    uint8_t* slot = pool.reserve(telemetry::MAX_FRAME_LEN, millis());
+    if (slot == nullptr) return;   // counted by the pool as dropped
+    pool.commit(telemetry::formatFrame(f, reinterpret_cast<char*>(slot),
+                                       telemetry::MAX_FRAME_LEN, telemetry::getFieldMask()));
+}
+
+void flush() {
+    applyTelemetryReset();
+    const uint32_t nowMs = millis();
+    if (!linkUp || !streaming) {
+        pool.discardOpen();
+    } else {
+        pool.poll(nowMs);
+    }
+    const uint32_t sealed = pool.stats().sealed;
+    if (sealed != lastSealed && netTaskHandle != nullptr) {
+        lastSealed = sealed;
+        xTaskNotifyGive(netTaskHandle);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Network task
+// ---------------------------------------------------------------------------
+
+/** Send every sealed datagram; a buffer sealed before the link dropped is lost. */
+static void sendReady() {
+    if (networkResetRequested.exchange(false, std::memory_order_acq_rel)) {
+        datagramCount  = 0;
+        sendErrorCount = 0;
+    }
+    portENTER_CRITICAL(&destMux);
+    const IPAddress ip   = destIp;
+    const uint16_t  port = destPort;
+    portEXIT_CRITICAL(&destMux);
+
+    uint8_t index;
+    while (pool.take(index)) {
+        const auto& b  = pool.buffer(index);
+        const bool  ok = linkUp && udp.beginPacket(ip, port) &&
+                         udp.write(b.data, b.len) == b.len && udp.endPacket();
+        if (ok) {
+            ++datagramCount;
+        } else {
+            ++sendErrorCount;
+        }
+        pool.release(index);
+    }
+}
+
+static void netTask(void*) {
+    for (;;) {
+        // Woken by flush() when a datagram is sealed; the timeout keeps
+        // the link state fresh while nothing is being sent.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(NET_TASK_POLL_MS));
+        linkUp = (WiFi.status() == WL_CONNECTED);
+        sendReady();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+void init() {
+    setDestination(NET_UDP_DEST, NET_UDP_PORT);
+
+    WiFi.mode(WIFI_STA);
+    WiFi.setSleep(false);           // modem sleep adds 100 ms+ to console round trips
+    WiFi.setAutoReconnect(true);
+    WiFi.begin(NET_WIFI_SSID, NET_WIFI_PASSWORD);   // returns at once; joins in the background
+
+    xTaskCreatePinnedToCore(netTask, "net", NET_TASK_STACK_BYTES, nullptr,
+                            NET_TASK_PRIORITY, &netTaskHandle, COMMS_TASK_CORE);
+    telemetry::setTap(onFrame);
+}
+
+/** Close the TCP session, abandoning any dump streaming to it. */
+static void closeSession() {
+    client.stop();
+    serial_commands::endSession(session);
+}
+
+void serviceConsole() {
+    if (!linkUp) {
+        if (client) closeSession();
+        return;
+    }
+    if (!serverStarted) {
+        server.begin();
+        server.setNoDelay(true);
+        serverStarted = true;
+    }
+    if (server.hasClient()) {
+        WiFiClient next = server.available();
+        if (client.connected()) {
+            next.println("[ERR] Console busy; one session at a time");
+            next.stop();
+        } else {
+            closeSession();   // a dump for the previous client ends with it
+            client = next;
+            consoleInput.reset();
+            client.println("Cryocooler Controller console. Type 'help' for available commands.");
+        }
+    }
+    if (!client) return;
+    if (!client.connected()) {
+        closeSession();
+        return;
+    }
+    session.refill();
+    serial_commands::serviceInput(session, session, consoleInput);
+}
+
+bool setDestination(const char* ip, uint16_t port) {
+    IPAddress parsed;
+    if (!parsed.fromString(ip)) return false;
+    portENTER_CRITICAL(&destMux);
+    destIp   = parsed;
+    destPort = port;
+    portEXIT_CRITICAL(&destMux);
+    return true;
+}
+
+void formatDestination(char* buf, size_t len) {
+    portENTER_CRITICAL(&destMux);
+    const IPAddress ip   = destIp;
+    const uint16_t  port = destPort;
+    portEXIT_CRITICAL(&destMux);
+    snprintf(buf, len, "%u.%u.%u.%u:%u", ip[0], ip[1], ip[2], ip[3], static_cast<unsigned>(port));
+}
+
+void setStreaming(bool on) { streaming = on; }
+bool isStreaming() { return streaming; }
+
+void formatLocalIp(char* buf, size_t len) {
+    if (!linkUp) {
+        snprintf(buf, len, "-");
+        return;
+    }
+    const IPAddress ip = WiFi.localIP();
+    snprintf(buf, len, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+Stats getStats() {
+    // A reset not yet applied already reads as zero
+    const bool tReset = telemetryResetRequested.load(std::memory_order_acquire);
+    const bool nReset = networkResetRequested.load(std::memory_order_acquire);
+    const auto pst    = pool.stats();
+    Stats s{};
+    s.linkUp        = linkUp;
+    s.consoleClient = client.connected();
+    s.frames        = tReset ? 0u : pst.frames;
+    s.skipped       = tReset ? 0u : skippedCount;
+    s.dropped       = tReset ? 0u : pst.dropped;
+    s.datagrams     = nReset ? 0u : datagramCount;
+    s.sendErrors    = nReset ? 0u : sendErrorCount;
+    return s;
+}
+
+void resetStats() {
+    telemetryResetRequested.store(true, std::memory_order_release);
+    networkResetRequested.store(true, std::memory_order_release);
+}
+
+#else   // !NET_ENABLED: USB-only build
+
+void init() {}
+void flush() {}
+void serviceConsole() {}
+bool setDestination(const char*, uint16_t) { return false; }
+void formatDestination(char* buf, size_t len) { snprintf(buf, len, "-"); }
+void setStreaming(bool) {}
+bool isStreaming() { return false; }
+void formatLocalIp(char* buf, size_t len) { snprintf(buf, len, "-"); }
+Stats getStats() { return Stats{}; }
+void resetStats() {}
+
+#endif
+
+} // namespace net
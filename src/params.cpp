@@ -0,0 +1,128 @@
+/**
+ * @file params.cpp
+ * @brief Runtime parameter registry — batch commit and NVS profile storage
+ */
+
+#include <math.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#  include <Preferences.h>
+#endif
+
+#include "config.h"
+#include "params.h"
+
+namespace params {
+
+namespace detail {
+float values[COUNT] = {
+    SETPOINT_K, SETPOINT_TOLERANCE_K, COARSE_FINE_THRESHOLD_K, COOLDOWN_RATE_TARGET_K_PER_MIN,
+    MAX_COOLDOWN_RATE_K_PER_MIN, OVERSTROKE_CURRENT_THRESHOLD_A, OVERSTROKE_DEBOUNCE_MS,
+    BACKOFF_DAC_STEP, BACKOFF_MAX_COUNT, DAC_MAX_STEP_PER_INTERVAL,
+};
+}
+
+using detail::values;
+
+static uint8_t idx(Id id) { return static_cast<uint8_t>(id); }
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+bool find(const char* name, Id& id) {
+    for (uint8_t i = 0; i < COUNT; ++i) {
+        if (strcmp(DESCRIPTORS[i].name, name) == 0) {
+            id = static_cast<Id>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+Result apply(const Change* changes, uint8_t n, uint8_t* bad) {
+    float next[COUNT];
+    memcpy(next, values, sizeof(next));
+
+    for (uint8_t i = 0; i < n; ++i) {
+        const Descriptor& d = DESCRIPTORS[idx(changes[i].id)];
+        const float v = changes[i].value;
+        if (!(v >= d.min && v <= d.max) ||     // also rejects NaN
+            (d.type == Type::Uint && v != floorf(v))) {
+            if (bad) *bad = i;
+            return Result::OutOfRange;
+        }
+        next[idx(changes[i].id)] = v;
+    }
+
+    // The setpoint band must end below the Coarse → Fine boundary, or
+    // FineCooldown would never be entered; the rate loop target must not
+    // exceed the rate limit it exists to respect.
+    if (next[idx(Id::SetpointK)] + next[idx(Id::SetpointToleranceK)] >=
+            next[idx(Id::CoarseFineK)] ||
+        next[idx(Id::CooldownRate)] > next[idx(Id::MaxCooldownRate)]) {
+        return Result::Inconsistent;
+    }
+
+    memcpy(values, next, sizeof(values));
+    return Result::Ok;
+}
+
+void resetDefaults() {
+    for (uint8_t i = 0; i < COUNT; ++i) values[i] = DESCRIPTORS[i].def;
+}
+
+// ---------------------------------------------------------------------------
+// NVS profile
+// ---------------------------------------------------------------------------
+
+#ifdef ARDUINO
+
+bool load() {
+    Preferences prefs;
+    if (!prefs.begin(PARAMS_NVS_NAMESPACE, /*readOnly=*/true)) return false;
+
+    Change  stored[COUNT];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < COUNT; ++i) {
+        if (prefs.isKey(DESCRIPTORS[i].name)) {
+            stored[n++] = {static_cast<Id>(i), prefs.getFloat(DESCRIPTORS[i].name)};
+        }
+    }
+    prefs.end();
+
+    // Keys missing from an older profile keep their defaults
+    return n > 0 && apply(stored, n) == Result::Ok;
+}
+
+bool save() {
+    Preferences prefs;
+    if (!prefs.begin(PARAMS_NVS_NAMESPACE, /*readOnly=*/false)) return false;
+    bool ok = true;
+    for (uint8_t i = 0; i < COUNT; ++i) {
+        // putFloat() returns the bytes written; unchanged values are a no-op
+        // inside NVS, so re-saving a profile does not wear the flash.
+        ok = (prefs.putFloat(DESCRIPTORS[i].name, values[i]) == sizeof(float)) && ok;
+    }
+    prefs.end();
+    return ok;
+}
+
+void erase() {
+    Preferences prefs;
+    if (prefs.begin(PARAMS_NVS_NAMESPACE, /*readOnly=*/false)) {
+        prefs.clear();
+        prefs.end();
+    }
+}
+
+#else   // native build: no NVS
+
+bool load()  { return false; }
+bool save()  { return true; }
+void erase() {}
+
+#endif
+
+} // namespace params
@@ -1,6 +1,10 @@
 /**
  * @file relay.cpp
  * @brief Bypass and alarm relay implementation
+ *
+ * Written from the control task and read by the console ("status"); the
+ * Status is copied under statusMux so a reader never sees a level with
+ * another change's timestamp.
  */
 
 #include <Arduino.h>
@@ -8,6 +12,21 @@
 #include "pin_config.h"
 #include "relay.h"
 
+static relay::Status status    = {};
+static portMUX_TYPE  statusMux  = portMUX_INITIALIZER_UNLOCKED;
+
+/** Drive @p pin to @p level if @p current differs; stamp the change. */
+static void apply(uint8_t pin, bool level, bool& current, uint32_t& sinceMs) {
+    if (level == current) return;
+    digitalWrite(pin, level ? HIGH : LOW);
+    const uint32_t nowMs = millis();
+    portENTER_CRITICAL(&statusMux);
+    current = level;
+    sinceMs = nowMs;
+    ++status.switches;
+    portEXIT_CRITICAL(&statusMux);
+}
+
 namespace relay {
 
 void init() {
@@ -15,14 +34,26 @@ void init() {
     pinMode(ALARM_RELAY_PIN,  OUTPUT);
     digitalWrite(BYPASS_RELAY_PIN, LOW);   // start in Bypass
     digitalWrite(ALARM_RELAY_PIN,  LOW);   // alarm off
+
+    const uint32_t nowMs = millis();
+    portENTER_CRITICAL(&statusMux);
+    status = {false, false, nowMs, nowMs, 0};
+    portEXIT_CRITICAL(&statusMux);
 }
 
 void setBypass(bool normal) {
-    digitalWrite(BYPASS_RELAY_PIN, normal ? HIGH : LOW);
+    apply(BYPASS_RELAY_PIN, normal, status.normal, status.normalSinceMs);
 }
 
 void setAlarm(bool active) {
-    digitalWrite(ALARM_RELAY_PIN, active ? HIGH : LOW);
+    apply(ALARM_RELAY_PIN, active, status.alarm, status.alarmSinceMs);
+}
+
+Status getStatus() {
+    portENTER_CRITICAL(&statusMux);
+    const Status s = status;
+    portEXIT_CRITICAL(&statusMux);
+    return s;
 }
 
 } // namespace relay
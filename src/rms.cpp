@@ -3,15 +3,46 @@
  * @brief AC voltage and current monitoring — RMS stub + ACS712 implementation.
  *
  * ── Overstroke detection algorithm ──────────────────────────────────────────
- * An exponential moving average (EMA) tracks the "normal" AC RMS current.
- * A reading is classified as an overstroke spike when:
+ * Exponential moving averages track the mean μ and variance σ² of the
+ * "normal" AC RMS current.  A reading is classified as an overstroke spike
+ * when:
  *
- *   instantaneous_current > ema_baseline + OVERSTROKE_CURRENT_THRESHOLD_A
- *   AND (millis() - last_event_ms) >= OVERSTROKE_DEBOUNCE_MS
- *   AND the EMA has been primed for OVERSTROKE_PRIME_READINGS ticks.
+ *   peak_window > μ + clamp(k·σ, OVERSTROKE_MIN_EXCESS_A, "overstroke")
+ *   AND (millis() - last_event_ms) >= "debounce" parameter
+ *   AND the baseline is primed (OVERSTROKE_PRIME_READINGS readings, and
+ *       OVERSTROKE_REPRIME_READINGS after every OVERSTROKE_REPRIME_DAC_COUNTS
+ *       move of the DAC output)
+ *   AND, with OVERSTROKE_HARMONIC_CHECK, the peak window's 2nd/3rd harmonic
+ *       ratio reaches OVERSTROKE_HARMONIC_RATIO.
+ *
+ * k is OVERSTROKE_SIGMA_K_COOLDOWN while a cooldown moves the drive and
+ * OVERSTROKE_SIGMA_K_STEADY otherwise.  "overstroke" and "debounce" are
+ * runtime parameters (params.h) defaulting to OVERSTROKE_CURRENT_THRESHOLD_A
+ * and OVERSTROKE_DEBOUNCE_MS.
  *
  * The small EMA alpha (OVERSTROKE_EMA_ALPHA) means the baseline tracks the
  * slowly-evolving steady-state current while brief spikes stand out clearly.
+ * The detector itself is overstroke_detector.h, shared with the native
+ * plant simulation.
+ *
+ * ── Background sampling ─────────────────────────────────────────────────────
+ * The acquisition engine (acquisition.h) converts ACS712_CURRENT_PIN (by DMA,
+ * or polled in a network build) ACS712_SAMPLES_PER_CYCLE times per drive cycle and hands every raw sample
+ * to onCurrentSample(), which feeds an RmsWindow accumulator (rms_window.h)
+ * and, with OVERSTROKE_HARMONIC_CHECK, a HarmonicWindow over the same
+ * samples (harmonic_window.h).  When a window of ACS712_WINDOW_CYCLES
+ * cycles completes, the sink publishes its RMS (and the largest window
+ * since the last consumer read, with that window's harmonic ratio) under a
+ * spinlock.  readCurrent() only picks up that result, so the control
+ * tick never waits on the ADC.
+ *
+ * Every calibrated raw sample is also pushed into a BurstCapture ring.  When
+ * a window's RMS exceeds captureThreshold (baseline + threshold in counts,
+ * published by readCurrent() once primed) the ring is triggered from the
+ * sink itself and freezes CAPTURE_POST_SAMPLES later.
+ *
+ * The zero-current midpoint is the mean of the first ACS712_MIDPOINT_SAMPLES
+ * samples after init(); RMS windows are not accumulated until it is known.
  *
  * Hardware note (ACS712-05B supply voltage and ADC attenuation):
  *
@@ -28,40 +59,125 @@
  *     ADC_6db clips at 2.2 V (≈ 4.1 A) but gives better spike resolution.
  *
  *   The attenuation constant ACS712_ADC_ATTENUATION (config.h) is applied
- *   to ACS712_CURRENT_PIN before sensor.autoMidPoint() so the zero-offset
- *   calibration always uses the same range as the live readings.
+ *   to the ACS712_CURRENT_PIN entry of the acquisition pattern, so the
+ *   zero-offset calibration always uses the same range as the live readings.
  */
 
 #ifdef ARDUINO
 #  include <Arduino.h>
-#  include <ACS712.h>
+#  include "acquisition.h"
 #else
 // Native (host-PC) build: Arduino.h stub provides millis().
 #  include "Arduino.h"
 #endif
 
 #include "rms.h"
+#include "rms_window.h"
+#include "harmonic_window.h"
+#include "burst_capture.h"
+#include "overstroke_detector.h"
 #include "config.h"
+#include "params.h"
 #include "pin_config.h"
 
+#ifdef ARDUINO
+#  include "dac.h"
+#  include "state_machine.h"
+#endif
+
 // ---------------------------------------------------------------------------
 // Module state
 // ---------------------------------------------------------------------------
 
 static float    voltage          = 0.0f;   // RMS voltage (stub, always 0)
 static float    currentA         = 0.0f;   // latest ACS712 reading
-static float    currentEmaA      = 0.0f;   // EMA baseline of AC current
-static uint8_t  primeCount       = 0;      // readings collected so far for priming
-static bool     overstrokeFlag   = false;  // set on spike; cleared by caller
-static uint32_t lastOverstrokeMs = 0;      // timestamp of most recent event
+static uint8_t  windowCycles     = ACS712_WINDOW_CYCLES;
+static OverstrokeDetector detector;        // EMA baseline, latch and debounce
+
+// ADC counts → amps: (mV per count) / (mV per amp)
+static constexpr float AMPS_PER_COUNT =
+    (ACS712_ADC_VOLTS * 1000.0f / static_cast<float>(ACS712_ADC_MAX_VALUE))
+    / ACS712_SENSITIVITY_MV_PER_A;
 
 #ifdef ARDUINO
-// RobTillaart ACS712 — 5 A sensor on ESP32-S3 (3.3 V supply, 12-bit ADC).
-// Constructor: (analogPin, volts, maxADC, mVperAmpere)
-static ACS712 sensor(ACS712_CURRENT_PIN,
-                      ACS712_ADC_VOLTS,
-                      ACS712_ADC_MAX_VALUE,
-                      ACS712_SENSITIVITY_MV_PER_A);
+// ── Sampler state (written from the acquisition task) ───────────────────────
+static rms::RmsWindow     window        = {};
+static rms::HarmonicWindow harmonics    = {};
+static int32_t            midPoint      = 0;      // zero-current ADC count
+static uint32_t           midPointSum   = 0;      // calibration accumulator
+static uint16_t           midPointCount = 0;      // calibration samples so far
+static volatile bool      calibrated    = false;  // midPoint is valid
+static volatile bool      resizePending = false;  // window length change requested
+
+// ── Published result (guarded by resultMux) ────────────────────────────────
+static portMUX_TYPE resultMux      = portMUX_INITIALIZER_UNLOCKED;
+static float        latestRms      = 0.0f;   // RMS of newest window (counts)
+static float        peakRms        = 0.0f;   // largest window since last consume
+static float        peakHarmonic   = OverstrokeDetector::NO_HARMONICS;   // ratio of that window
+static uint32_t     windowSeq      = 0;      // windows completed since init()
+static uint32_t     consumedSeq    = 0;      // windowSeq seen by readCurrent()
+
+// ── Burst capture (ring owned by the sampler until frozen) ─────────────────
+static BurstCapture<CAPTURE_SAMPLES> capture(CAPTURE_POST_SAMPLES);
+static volatile float captureThreshold = 0.0f;   // counts; 0 = not yet primed
+static volatile float captureBaseline  = 0.0f;   // counts at last readCurrent()
+static uint32_t       captureMs        = 0;      // written before freeze
+static float          capturePeak      = 0.0f;
+static float          captureEma       = 0.0f;
+
+static uint32_t samplesPerWindow() {
+    return static_cast<uint32_t>(windowCycles) * ACS712_SAMPLES_PER_CYCLE;
+}
+
+/** Acquisition sink: one raw ACS712 sample per call, O(1). */
+static void onCurrentSample(uint16_t raw) {
+    if (!calibrated) {
+        midPointSum += raw;
+        if (++midPointCount >= ACS712_MIDPOINT_SAMPLES) {
+            midPoint   = static_cast<int32_t>(midPointSum / midPointCount);
+            calibrated = true;
+        }
+        return;
+    }
+
+    if (resizePending) {
+        resizePending = false;
+        rms::rmsWindowReset(window, samplesPerWindow());
+        rms::harmonicWindowReset(harmonics, samplesPerWindow(), ACS712_SAMPLES_PER_CYCLE);
+    }
+
+    capture.push(raw);
+
+    // Both windows have the same length, so they complete on the same sample.
+    const int32_t sample = static_cast<int32_t>(raw) - midPoint;
+    float ratio = OverstrokeDetector::NO_HARMONICS;
+    if (OVERSTROKE_HARMONIC_CHECK) {
+        rms::harmonicWindowPush(harmonics, sample, ratio);
+    }
+    float rmsCounts;
+    if (!rms::rmsWindowPush(window, sample, rmsCounts)) {
+        return;
+    }
+
+    const float threshold = captureThreshold;
+    if (threshold > 0.0f && rmsCounts > threshold) {
+        const float baseline = captureBaseline;
+        if (capture.trigger()) {
+            captureMs   = millis();
+            capturePeak = rmsCounts;
+            captureEma  = baseline;
+        }
+    }
+
+    portENTER_CRITICAL(&resultMux);
+    latestRms = rmsCounts;
+    if (rmsCounts > peakRms) {
+        peakRms      = rmsCounts;
+        peakHarmonic = ratio;
+    }
+    ++windowSeq;
+    portEXIT_CRITICAL(&resultMux);
+}
 #endif
 
 namespace rms {
@@ -69,22 +185,37 @@ namespace rms {
 void init() {
     voltage          = 0.0f;
     currentA         = 0.0f;
-    currentEmaA      = 0.0f;
-    primeCount       = 0;
-    overstrokeFlag   = false;
-    lastOverstrokeMs = 0;
+    detector.reset();
+    windowCycles     = ACS712_WINDOW_CYCLES;
 
 #ifdef ARDUINO
-    // Set ADC input attenuation BEFORE autoMidPoint() so that calibration
-    // samples are captured using the same full-scale range as live readings.
-    // See config.h for available choices and voltage/resolution trade-offs.
-    analogSetPinAttenuation(ACS712_CURRENT_PIN, ACS712_ADC_ATTENUATION);
-
-    // Auto-calibrate the zero-current midpoint over one full AC cycle.
-    // The AC output MUST be off (zero load current) when this is called.
-    // Blocks ~2 cycles (~33 ms at AD9833_FREQ_HZ = 60 Hz) — acceptable
-    // during initialisation; not an issue for the main loop.
-    sensor.autoMidPoint(AD9833_FREQ_HZ, 1);
+    // Detach while resetting so the acquisition task never sees a
+    // half-initialised accumulator.
+    acquisition::setSampleSink(acquisition::Channel::Current, nullptr);
+
+    // Auto-calibrate the zero-current midpoint from the first
+    // ACS712_MIDPOINT_SAMPLES samples (~33 ms at AD9833_FREQ_HZ = 60 Hz).
+    // The AC output MUST be off (zero load current) during this window.
+    // Non-blocking: readCurrent() simply sees no windows until it is done.
+    midPoint      = 0;
+    midPointSum   = 0;
+    midPointCount = 0;
+    calibrated    = false;
+
+    rmsWindowReset(window, samplesPerWindow());
+    harmonicWindowReset(harmonics, samplesPerWindow(), ACS712_SAMPLES_PER_CYCLE);
+    resizePending = false;
+    latestRms     = 0.0f;
+    peakRms       = 0.0f;
+    peakHarmonic  = OverstrokeDetector::NO_HARMONICS;
+    windowSeq     = 0;
+    consumedSeq   = 0;
+
+    capture.reset(CAPTURE_POST_SAMPLES);
+    captureThreshold = 0.0f;
+    captureBaseline  = 0.0f;
+
+    acquisition::setSampleSink(acquisition::Channel::Current, onCurrentSample);
 #endif
 }
 
@@ -99,34 +230,41 @@ float getVoltage() {
 
 void readCurrent() {
 #ifdef ARDUINO
-    // mA_AC_sampling computes true RMS via Σ(sample²) over one full cycle
-    // (~16.7 ms at 60 Hz).  This is more robust than mA_AC() for compressor
-    // loads whose current waveform may deviate from a pure sine.  The blocking
-    // duration is bounded and predictable — not an arbitrary delay().
-    // Result is in milliamps; divide by 1000 to convert to amps.
-    const float current = sensor.mA_AC_sampling(AD9833_FREQ_HZ, 1) / 1000.0f;
-    currentA = current;
+    // Pick up the newest finished window (true RMS via Σ(sample²) over
+    // whole drive cycles), plus the peak window since the last call.
+    portENTER_CRITICAL(&resultMux);
+    const uint32_t seq        = windowSeq;
+    const float    rmsCounts  = latestRms;
+    const float    peakCounts = peakRms;
+    const float    peakRatio  = peakHarmonic;
+    peakRms      = 0.0f;
+    peakHarmonic = OverstrokeDetector::NO_HARMONICS;
+    portEXIT_CRITICAL(&resultMux);
 
-    // Prime phase: seed the EMA with direct readings so the baseline
-    // converges quickly and spike detection is not armed prematurely.
-    if (primeCount < OVERSTROKE_PRIME_READINGS) {
-        currentEmaA = current;
-        ++primeCount;
-        return;
+    if (seq == consumedSeq) {
+        return;   // no window completed since last tick
     }
+    consumedSeq = seq;
 
-    // Update EMA baseline (slow-tracking, small alpha keeps transients visible).
-    currentEmaA += OVERSTROKE_EMA_ALPHA * (current - currentEmaA);
+    const float current = rmsCounts * AMPS_PER_COUNT;
+    const float peak    = peakCounts * AMPS_PER_COUNT;
+    currentA = current;
 
-    // Spike check: fire if delta exceeds threshold AND debounce has elapsed.
-    const float    delta = current - currentEmaA;
-    const uint32_t now   = millis();
+    // Same core as the control job, so the state and drive are this tick's.
+    const state_machine::State s = state_machine::getState();
+    const bool cooling = s == state_machine::State::CoarseCooldown ||
+                         s == state_machine::State::FineCooldown ||
+                         s == state_machine::State::Overshoot;
+    detector.setLimits(params::get(params::Id::OverstrokeThresholdA),
+                       params::getUint(params::Id::OverstrokeDebounceMs));
+    detector.setSigmaK(cooling ? OVERSTROKE_SIGMA_K_COOLDOWN : OVERSTROKE_SIGMA_K_STEADY);
+    detector.setDrive(dac::getCurrent());
+    detector.update(current, peak, millis(), peakRatio);
 
-    if (!overstrokeFlag &&
-        delta   > OVERSTROKE_CURRENT_THRESHOLD_A &&
-        (now - lastOverstrokeMs) >= OVERSTROKE_DEBOUNCE_MS) {
-        overstrokeFlag   = true;
-        lastOverstrokeMs = now;
+    // Hand the same spike threshold to the sampler's burst-capture trigger.
+    if (detector.primed()) {
+        captureBaseline  = detector.baselineA() / AMPS_PER_COUNT;
+        captureThreshold = detector.thresholdA() / AMPS_PER_COUNT;
     }
 #endif
     // Native build: no-op — state remains 0 A, no spurious overstrokes.
@@ -136,12 +274,77 @@ float getCurrentA() {
     return currentA;
 }
 
+void setWindowCycles(uint8_t cycles) {
+    if (cycles < 1u)                       cycles = 1u;
+    if (cycles > ACS712_MAX_WINDOW_CYCLES) cycles = ACS712_MAX_WINDOW_CYCLES;
+    windowCycles = cycles;
+#ifdef ARDUINO
+    resizePending = true;   // applied by the sampler at its next sample
+#endif
+}
+
+uint8_t getWindowCycles() {
+    return windowCycles;
+}
+
+float getSampleRateHz() {
+#ifdef ARDUINO
+    return acquisition::getSampleRateHz();
+#else
+    return static_cast<float>(AD9833_FREQ_HZ) * ACS712_SAMPLES_PER_CYCLE;
+#endif
+}
+
+uint32_t getWindowCount() {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&resultMux);
+    const uint32_t seq = windowSeq;
+    portEXIT_CRITICAL(&resultMux);
+    return seq;
+#else
+    return 0;
+#endif
+}
+
 bool hasOverstroke() {
-    return overstrokeFlag;
+    return detector.pending();
 }
 
 void clearOverstroke() {
-    overstrokeFlag = false;
+    detector.clear();
+}
+
+bool getCaptureInfo(CaptureInfo& info) {
+#ifdef ARDUINO
+    if (!capture.isFrozen()) return false;
+    info.triggerMs    = captureMs;
+    info.samples      = capture.size();
+    info.triggerIndex = capture.triggerIndex();
+    info.sampleRateHz = getSampleRateHz();
+    info.midpoint     = static_cast<uint16_t>(midPoint);
+    info.peakA        = capturePeak * AMPS_PER_COUNT;
+    info.baselineA    = captureEma * AMPS_PER_COUNT;
+    info.ampsPerCount = AMPS_PER_COUNT;
+    return true;
+#else
+    (void)info;
+    return false;
+#endif
+}
+
+uint16_t getCaptureSample(uint32_t i) {
+#ifdef ARDUINO
+    return capture.at(i);
+#else
+    (void)i;
+    return 0;
+#endif
+}
+
+void rearmCapture() {
+#ifdef ARDUINO
+    capture.rearm();
+#endif
 }
 
 } // namespace rms
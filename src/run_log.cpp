@@ -0,0 +1,188 @@
+/**
+ * @file run_log.cpp
+ * @brief Persistent run log on a raw esp_partition
+ *
+ * A raw partition rather than LittleFS: the record format is already
+ * append-only and sector-circular, so a filesystem would only add metadata
+ * writes (and their erases) to every append and make the retention window
+ * depend on its block allocator.  Here each page write is exactly one
+ * esp_partition_write() and each sector is erased once per lap, ahead of
+ * need while the cooler is idle (see run_log.h).
+ */
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <esp_system.h>
+
+#include "config.h"
+#include "run_log.h"
+#include "spsc_queue.h"
+#include "temp_history.h"
+
+namespace run_log {
+
+// ---------------------------------------------------------------------------
+// Flash backend
+// ---------------------------------------------------------------------------
+
+class PartitionFlash {
+public:
+    bool open() {
+        _part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         RUN_LOG_PARTITION_LABEL);
+        return _part != nullptr;
+    }
+
+    uint32_t sectorCount() const { return _part ? _part->size / SECTOR_SIZE : 0; }
+
+    bool read(uint32_t addr, void* dst, uint32_t len) {
+        return esp_partition_read(_part, addr, dst, len) == ESP_OK;
+    }
+
+    bool write(uint32_t addr, const void* src, uint32_t len) {
+        return esp_partition_write(_part, addr, src, len) == ESP_OK;
+    }
+
+    bool eraseSector(uint32_t sector) {
+        return esp_partition_erase_range(_part, sector * SECTOR_SIZE, SECTOR_SIZE) == ESP_OK;
+    }
+
+private:
+    const esp_partition_t* _part = nullptr;
+};
+
+// ---------------------------------------------------------------------------
+// Module-private state
+// ---------------------------------------------------------------------------
+
+static PartitionFlash                         flash;
+static LogStore<PartitionFlash>               store(flash);
+static SpscQueue<Record, RUN_LOG_QUEUE_DEPTH> queue;
+
+static bool     mounted        = false;
+static uint32_t firstPendingMs = 0;   // millis() the oldest buffered record was queued
+static uint32_t dropped        = 0;
+static uint32_t queueHigh      = 0;
+static uint32_t maxWriteUs     = 0;
+static uint32_t hotErases      = 0;
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+static Record makeRecord(RecordType type, uint32_t nowMs, float tempK, uint16_t dac,
+                         state_machine::State state, uint8_t detail) {
+    Record r{};
+    r.timeMs = nowMs;
+    r.tempQ  = quantizeTempK(tempK);
+    r.dac    = dac;
+    r.type   = static_cast<uint8_t>(type);
+    r.state  = static_cast<int8_t>(state);
+    r.detail = detail;
+    return r;
+}
+
+static uint8_t clampCount(uint16_t n) {
+    return n > 255u ? static_cast<uint8_t>(255) : static_cast<uint8_t>(n);
+}
+
+static void enqueue(const Record& r) {
+    if (!mounted) return;
+    if (!queue.push(r)) {
+        ++dropped;
+        return;
+    }
+    const uint32_t depth = queue.size();
+    if (depth > queueHigh) queueHigh = depth;
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+bool init(uint32_t nowMs) {
+    mounted = flash.open() && store.mount();
+    if (!mounted) return false;
+
+    Record boot = makeRecord(RecordType::Boot, nowMs, 0.0f, 0, state_machine::State::Off,
+                             static_cast<uint8_t>(esp_reset_reason()));
+    store.append(boot);
+    store.flush();
+    return true;
+}
+
+bool isMounted() { return mounted; }
+
+void logSample(uint32_t nowMs, float tempK, uint16_t dac,
+               state_machine::State state, uint16_t backoffCount) {
+    enqueue(makeRecord(RecordType::Sample, nowMs, tempK, dac, state, clampCount(backoffCount)));
+}
+
+void logTransition(state_machine::State from, state_machine::State to,
+                   state_machine::FaultReason reason, uint32_t nowMs,
+                   float tempK, uint16_t dac) {
+    enqueue(makeRecord(RecordType::Transition, nowMs, tempK, dac, to,
+                       static_cast<uint8_t>(static_cast<int8_t>(from))));
+    if (to == state_machine::State::Fault) {
+        enqueue(makeRecord(RecordType::Fault, nowMs, tempK, dac, to,
+                           static_cast<uint8_t>(reason)));
+    }
+}
+
+void logBackoff(uint32_t nowMs, float tempK, uint16_t dac,
+                state_machine::State state, uint16_t backoffCount) {
+    enqueue(makeRecord(RecordType::Backoff, nowMs, tempK, dac, state, clampCount(backoffCount)));
+}
+
+void service(uint32_t nowMs, bool idle) {
+    if (!mounted) return;
+
+    const uint32_t t0     = micros();
+    const uint32_t writes = store.getStats().pageWrites;
+    const uint32_t erases = store.getStats().sectorErases;
+    bool urgent = false;
+
+    Record r;
+    while (queue.pop(r)) {
+        if (store.pending() == 0) firstPendingMs = nowMs;
+        urgent = urgent || r.type != static_cast<uint8_t>(RecordType::Sample);
+        store.append(r);
+    }
+
+    if (store.pending() > 0 &&
+        (urgent || (nowMs - firstPendingMs) >= RUN_LOG_FLUSH_INTERVAL_MS)) {
+        store.flush();
+    }
+
+    if (idle) {
+        store.eraseAhead(RUN_LOG_ERASE_AHEAD_SECTORS);
+    } else {
+        hotErases += store.getStats().sectorErases - erases;   // reserve used up
+    }
+
+    if (store.getStats().pageWrites != writes || store.getStats().sectorErases != erases) {
+        const uint32_t us = micros() - t0;
+        if (us > maxWriteUs) maxWriteUs = us;
+    }
+}
+
+uint32_t oldestSeq() { return store.oldestSeq(); }
+
+uint32_t nextSeq() { return store.nextSeq(); }
+
+uint32_t capacity() { return mounted ? store.capacity() : 0; }
+
+bool read(uint32_t seq, Record& r) { return store.read(seq, r); }
+
+Stats getStats() {
+    Stats s;
+    s.store       = store.getStats();
+    s.dropped     = dropped;
+    s.queueHigh   = queueHigh;
+    s.maxWriteUs  = maxWriteUs;
+    s.hotErases   = hotErases;
+    s.erasedAhead = store.erasedAhead();
+    return s;
+}
+
+} // namespace run_log
@@ -5,19 +5,41 @@
  * service() accumulates bytes from Serial into a char[] line buffer and calls
  * processLine() on each newline.  processLine() is exposed separately so it
  * can be called from unit tests with a stub Print object.
+ *
+ * processLine() tokenizes the line (command_line.h), finds the longest
+ * command name in the sorted commands[] table by binary search, and hands
+ * the remaining tokens to the handler as typed Args.
+ *
+ * On target, processLine() writes into a fixed RAM buffer (ResponseBuffer)
+ * while the dispatch lock is held; the buffer is flushed to Serial only
+ * after the lock is released.
  */
 
 #ifdef ARDUINO
 #  include <Arduino.h>
 #else
 #  include <cstdio>
+#  include <cstdlib>
 #  include <cstring>
 #  include "Arduino.h"  // native stub — provides millis() and Print
 #endif
 
 #include "serial_commands.h"
+#include "command_line.h"
+#include "params.h"
+#include "perf.h"
+#include "scheduler.h"
 #include "state_machine.h"
 #include "telemetry.h"
+#ifdef ARDUINO
+#  include "net.h"
+#  include "relay.h"
+#  include "rms.h"
+#  include "run_log.h"
+#  include "spi_bus.h"
+#  include "temp_history.h"
+#  include "temperature.h"
+#endif
 
 namespace serial_commands {
 
@@ -25,15 +47,196 @@ namespace serial_commands {
 // Line buffer (non-blocking accumulator)
 // ---------------------------------------------------------------------------
 
-static constexpr uint8_t MAX_LINE_LEN = 80;
-static char    lineBuf[MAX_LINE_LEN + 1];
-static uint8_t lineLen = 0;
+static LineInput serialInput;
+
+// service()'s session (see setStream()); nullptr = Serial
+static Stream* volatile consoleStream = nullptr;
+
+// Dispatch lock hooks (see setDispatchLock())
+static LockHook lockHook   = nullptr;
+static LockHook unlockHook = nullptr;
+
+// Control-core scheduler reported by "tasks" (see setScheduler())
+static sched::Scheduler* taskScheduler = nullptr;
+
+// NVS write a "set" leaves for the console task (see serviceStore())
+enum class Store : uint8_t { None, Save, Erase };
+static void requestStore(Store s);
+
+#if defined(ARDUINO)
+// The stream service() read last (console task only)
+static Stream* servicedStream = nullptr;
+
+// ---------------------------------------------------------------------------
+// Response buffer — collects one command's output so it can be written to
+// Serial after the dispatch lock is released.  Output beyond the capacity is
+// dropped and flagged with a trailing marker.
+// ---------------------------------------------------------------------------
+
+class ResponseBuffer : public Print {
+public:
+    static constexpr size_t kCapacity = 2048;
+
+    void reset() { _len = 0; _truncated = false; }
+
+    size_t write(uint8_t c) override {
+        if (_len >= kCapacity) { _truncated = true; return 0; }
+        _buf[_len++] = c;
+        return 1;
+    }
+
+    void flushTo(Print& out) {
+        out.write(_buf, _len);
+        if (_truncated) { out.println("[...]"); }
+        reset();
+    }
+
+private:
+    uint8_t _buf[kCapacity];
+    size_t  _len       = 0;
+    bool    _truncated = false;
+};
+
+static ResponseBuffer response;
+
+// Session output of the line serviceInput() is dispatching (nullptr between
+// lines).  A dump started by that line streams to it.
+static Print* sessionOut = nullptr;
+
+static Print& requestingOutput() {
+    return sessionOut != nullptr ? *sessionOut : static_cast<Print&>(Serial);
+}
+
+// ---------------------------------------------------------------------------
+// Capture dump streamer — "capture dump" prints a header and sets the cursor;
+// service() then writes CAPTURE_DUMP_PER_LINE samples per line to the
+// requesting session, only while its TX buffer has room, so a dump never
+// blocks the console task.
+// ---------------------------------------------------------------------------
+
+static constexpr uint32_t CAPTURE_DUMP_PER_LINE = 16;
+static constexpr int      CAPTURE_DUMP_LINE_MAX = 8 + 5 * CAPTURE_DUMP_PER_LINE + 2;
+static int32_t            dumpNext = -1;      // next sample index; -1 = idle
+static Print*             dumpOut  = nullptr; // requesting session
+
+static void serviceCaptureDump() {
+    rms::CaptureInfo info;
+    if (dumpNext < 0) return;
+    Print& out = *dumpOut;
+    if (!rms::getCaptureInfo(info)) {       // rearmed mid-dump
+        dumpNext = -1;
+        out.println("[ERR] Capture dump aborted");
+        return;
+    }
+    while (dumpNext >= 0 && out.availableForWrite() >= CAPTURE_DUMP_LINE_MAX) {
+        const uint32_t start = static_cast<uint32_t>(dumpNext);
+        if (start >= info.samples) {
+            dumpNext = -1;
+            out.println("[OK] Capture dump complete");
+            return;
+        }
+        char line[CAPTURE_DUMP_LINE_MAX + 1];
+        int  n = snprintf(line, sizeof(line), "#cap %04lu", static_cast<unsigned long>(start));
+        for (uint32_t i = start; i < start + CAPTURE_DUMP_PER_LINE && i < info.samples; ++i) {
+            n += snprintf(line + n, sizeof(line) - n, " %u",
+                          static_cast<unsigned>(rms::getCaptureSample(i)));
+        }
+        out.println(line);
+        dumpNext = static_cast<int32_t>(start + CAPTURE_DUMP_PER_LINE);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Run-log dump streamer — "log dump [from]" fixes the range and service()
+// reads one record from flash per line to the requesting session, under the
+// same TX-space rule.  Nothing beyond one record is buffered.
+// ---------------------------------------------------------------------------
+
+static constexpr int LOG_DUMP_LINE_MAX = 64;
+static bool          logDumpActive  = false;
+static Print*        logDumpOut     = nullptr;   // requesting session
+static uint32_t      logDumpNext    = 0;   // next sequence number
+static uint32_t      logDumpEnd     = 0;   // one past the last (fixed at start)
+static uint32_t      logDumpLines   = 0;
+static uint32_t      logDumpSkipped = 0;   // torn or overwritten mid-dump
+
+// ---------------------------------------------------------------------------
+// Parameter store — "set" applies its batch under the dispatch lock but only
+// records the NVS write; service() performs it after the lock is released,
+// and only while the machine is Off or Idle.  An NVS page rollover erases a
+// flash sector, which stalls both cores, so like run-log erases it is kept
+// out of a cooldown.  The newest request wins; a failure is reported to the
+// session that asked.
+// ---------------------------------------------------------------------------
+
+static Store  storePending = Store::None;
+static Print* storeOut     = nullptr;   // requesting session; nullptr = Serial
+
+static void requestStore(Store s) {
+    storePending = s;
+    storeOut     = &requestingOutput();
+}
+
+static bool machineAtRest() {
+    const state_machine::State st = state_machine::getState();
+    return st == state_machine::State::Off || st == state_machine::State::Idle;
+}
+
+static void serviceStore() {
+    if (storePending == Store::None || !machineAtRest()) return;
+    const Store s = storePending;
+    storePending = Store::None;
+    if (s == Store::Erase) {
+        params::erase();
+    } else if (!params::save()) {
+        Print& out = storeOut != nullptr ? *storeOut : static_cast<Print&>(Serial);
+        out.println("[ERR] NVS write failed; values apply until reboot");
+    }
+}
+
+static void serviceLogDump() {
+    if (!logDumpActive) return;
+    Print& out = *logDumpOut;
+    while (logDumpActive && out.availableForWrite() >= LOG_DUMP_LINE_MAX) {
+        // A long dump can be overtaken by the write head reusing a sector
+        const uint32_t oldest = run_log::oldestSeq();
+        if (logDumpNext < oldest) {
+            logDumpSkipped += (oldest < logDumpEnd ? oldest : logDumpEnd) - logDumpNext;
+            logDumpNext = oldest;
+        }
+        if (logDumpNext >= logDumpEnd) {
+            logDumpActive = false;
+            char done[LOG_DUMP_LINE_MAX];
+            snprintf(done, sizeof(done), "[OK] Log dump complete: %lu records, %lu missing",
+                     static_cast<unsigned long>(logDumpLines),
+                     static_cast<unsigned long>(logDumpSkipped));
+            out.println(done);
+            return;
+        }
+        run_log::Record r;
+        if (!run_log::read(logDumpNext, r)) {
+            ++logDumpSkipped;
+            ++logDumpNext;
+            continue;
+        }
+        char line[LOG_DUMP_LINE_MAX + 1];
+        snprintf(line, sizeof(line), "#log %lu,%lu,%s,%d,%u,%.3f,%u",
+                 static_cast<unsigned long>(r.seq), static_cast<unsigned long>(r.timeMs),
+                 run_log::recordTypeName(r.type), static_cast<int>(r.state),
+                 static_cast<unsigned>(r.detail), dequantizeTempK(r.tempQ),
+                 static_cast<unsigned>(r.dac));
+        out.println(line);
+        ++logDumpLines;
+        ++logDumpNext;
+    }
+}
+#endif
 
 // ---------------------------------------------------------------------------
 // Command handler type and dispatch table
 // ---------------------------------------------------------------------------
 
-using HandlerFn = void (*)(Print&);
+using HandlerFn = void (*)(Print& out, const cmdline::Args& args);
 
 struct Command {
     const char* name;
@@ -42,13 +245,13 @@ struct Command {
 };
 
 // Forward declaration so handleHelp can reference commands below.
-static void handleHelp(Print& out);
+static void handleHelp(Print& out, const cmdline::Args&);
 
 // ---------------------------------------------------------------------------
 // Individual command handlers
 // ---------------------------------------------------------------------------
 
-static void handleStart(Print& out) {
+static void handleStart(Print& out, const cmdline::Args&) {
     if (state_machine::isRunning()) {
         out.println("[ERR] Already running");
         return;
@@ -58,11 +261,19 @@ static void handleStart(Print& out) {
         out.println("[ERR] Cannot start: not in Idle or Off state");
         return;
     }
+#ifdef ARDUINO
+    // Resume state from the measured cold stage (a unit that is already
+    // cold goes straight to FineCooldown / Settle); before the first RTD
+    // reading fall back to the warm-start default.
+    const float tempK = temperature::getLastTempK();
+    state_machine::start(millis(), tempK > 0.0f ? tempK : AMBIENT_START_K);
+#else
     state_machine::start(millis());
+#endif
     out.println("[OK] Process started");
 }
 
-static void handleStop(Print& out) {
+static void handleStop(Print& out, const cmdline::Args&) {
     if (!state_machine::isRunning()) {
         out.println("[ERR] Not currently running");
         return;
@@ -71,7 +282,7 @@ static void handleStop(Print& out) {
     out.println("[OK] Process stopped");
 }
 
-static void handleOff(Print& out) {
+static void handleOff(Print& out, const cmdline::Args&) {
     if (state_machine::getState() == state_machine::State::Off) {
         out.println("[ERR] System is already off");
         return;
@@ -80,26 +291,574 @@ static void handleOff(Print& out) {
     out.println("[OK] System turned off");
 }
 
-static void handleStatus(Print& out) {
+static void handleStatus(Print& out, const cmdline::Args&) {
     char buf[96];
     snprintf(buf, sizeof(buf), "[OK] %s (%d) | running: %s",
              state_machine::stateName(state_machine::getState()),
              static_cast<int8_t>(state_machine::getState()),
              state_machine::isRunning() ? "yes" : "no");
     out.println(buf);
+#ifdef ARDUINO
+    // Relay levels and how long each has held (timestamped in relay.cpp)
+    const relay::Status r = relay::getStatus();
+    const uint32_t nowMs = millis();
+    snprintf(buf, sizeof(buf), "  relays: %s %lu ms | alarm %s %lu ms | %lu switches",
+             r.normal ? "normal" : "bypass", static_cast<unsigned long>(nowMs - r.normalSinceMs),
+             r.alarm ? "on" : "off", static_cast<unsigned long>(nowMs - r.alarmSinceMs),
+             static_cast<unsigned long>(r.switches));
+    out.println(buf);
+#endif
 }
 
-static void handleTelemetryOff(Print& out) {
+static void handleTelemetryOff(Print& out, const cmdline::Args&) {
     telemetry::disable();
     out.println("[OK] Telemetry disabled");
 }
 
-static void handleTelemetryOn(Print& out) {
+static void handleTelemetryOn(Print& out, const cmdline::Args&) {
     telemetry::enable();
     out.println("[OK] Telemetry enabled");
 }
 
-static void handleBoard(Print& out) {
+static void handleTelemetryCsv(Print& out, const cmdline::Args&) {
+    telemetry::setFormat(telemetry::Format::Csv);
+    out.println("[OK] Telemetry format: CSV (Serial Studio)");
+}
+
+static void handleTelemetryBinary(Print& out, const cmdline::Args&) {
+    telemetry::setFormat(telemetry::Format::Binary);
+    out.println("[OK] Telemetry format: binary (COBS, see telemetry.h)");
+}
+
+static void handleTelemetryDescriptor(Print& out, const cmdline::Args&) {
+    if (telemetry::getFormat() != telemetry::Format::Binary) {
+        out.println("[ERR] Descriptor frames are only sent in binary mode");
+        return;
+    }
+    telemetry::requestDescriptor();
+    out.println("[OK] Descriptor frames queued");
+}
+
+static void handleTelemetryRate(Print& out, const cmdline::Args& args) {
+    uint32_t n = 0;
+    if (args.count() != 1 || !args.uintAt(0, 255, n) || n < 1) {
+        out.println("[ERR] Usage: telemetry rate <1-255>  (send every Nth tick in steady states)");
+        return;
+    }
+    telemetry::setSteadyDivisor(static_cast<uint8_t>(n));
+    char buf[80];
+    snprintf(buf, sizeof(buf), "[OK] Steady-state telemetry every %lu tick(s) (%lu ms)",
+             static_cast<unsigned long>(n),
+             static_cast<unsigned long>(n * LOOP_INTERVAL_MS));
+    out.println(buf);
+}
+
+static void handleTelemetryFields(Print& out, const cmdline::Args& args) {
+    uint32_t mask = 0;
+    if (args.is("all")) {
+        mask = telemetry::FIELD_MASK_ALL;
+    } else if (args.count() != 1 || !args.uintAt(0, telemetry::FIELD_MASK_ALL, mask)) {
+        out.println("[ERR] Usage: telemetry fields <mask|all>  (bit n-1 = column n)");
+        return;
+    }
+    telemetry::setFieldMask(mask);
+    char buf[48];
+    snprintf(buf, sizeof(buf), "[OK] Telemetry field mask 0x%06lX",
+             static_cast<unsigned long>(mask));
+    out.println(buf);
+}
+
+static void handleTelemetryDelta(Print& out, const cmdline::Args& args) {
+    if (args.is("on")) {
+        telemetry::setDeltaMode(true);
+        out.println("[OK] Telemetry delta mode on");
+    } else if (args.is("off")) {
+        telemetry::setDeltaMode(false);
+        out.println("[OK] Telemetry delta mode off");
+    } else {
+        out.println("[ERR] Usage: telemetry delta <on|off>");
+    }
+}
+
+static void handleTelemetryKeyframe(Print& out, const cmdline::Args& args) {
+    uint32_t k = 0;
+    if (args.count() != 1 || !args.uintAt(0, 0xFFFFu, k)) {
+        out.println("[ERR] Usage: telemetry keyframe <frames>  (0 = only on change)");
+        return;
+    }
+    telemetry::setKeyframeInterval(static_cast<uint16_t>(k));
+    char buf[64];
+    snprintf(buf, sizeof(buf), "[OK] Telemetry keyframe every %lu frame(s)",
+             static_cast<unsigned long>(k));
+    out.println(buf);
+}
+
+static void handleTelemetryConfig(Print& out, const cmdline::Args&) {
+    char buf[144];
+    snprintf(buf, sizeof(buf),
+             "[OK] Telemetry: %s, %s | rate 1/%u | fields 0x%06lX | delta %s | keyframe %u",
+             telemetry::isEnabled() ? "on" : "off",
+             telemetry::getFormat() == telemetry::Format::Binary ? "binary" : "csv",
+             static_cast<unsigned>(telemetry::getSteadyDivisor()),
+             static_cast<unsigned long>(telemetry::getFieldMask()),
+             telemetry::isDeltaMode() ? "on" : "off",
+             static_cast<unsigned>(telemetry::getKeyframeInterval()));
+    out.println(buf);
+}
+
+static void handleTelemetryStats(Print& out, const cmdline::Args&) {
+    const telemetry::Stats st = telemetry::getStats();
+    char buf[128];   // five 10-digit counters
+    snprintf(buf, sizeof(buf),
+             "[OK] Telemetry ring: submitted %lu | sent %lu | dropped %lu | high-water %lu/%lu",
+             static_cast<unsigned long>(st.submitted),
+             static_cast<unsigned long>(st.sent),
+             static_cast<unsigned long>(st.dropped),
+             static_cast<unsigned long>(st.highWater),
+             static_cast<unsigned long>(st.capacity));
+    out.println(buf);
+}
+
+static void handleTelemetryStatsReset(Print& out, const cmdline::Args&) {
+    telemetry::resetStats();
+    out.println("[OK] Telemetry counters reset");
+}
+
+static void handleCapture(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    rms::CaptureInfo info;
+    if (!rms::getCaptureInfo(info)) {
+        out.println("[OK] Capture armed; no overstroke captured yet");
+        return;
+    }
+    char buf[128];
+    snprintf(buf, sizeof(buf),
+             "[OK] Capture at %lu ms: %lu samples @ %.0f Hz, trigger index %lu, "
+             "peak %.2f A, baseline %.2f A",
+             static_cast<unsigned long>(info.triggerMs),
+             static_cast<unsigned long>(info.samples), info.sampleRateHz,
+             static_cast<unsigned long>(info.triggerIndex),
+             info.peakA, info.baselineA);
+    out.println(buf);
+#else
+    out.println("[ERR] Capture not available on this build");
+#endif
+}
+
+static void handleCaptureDump(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    rms::CaptureInfo info;
+    if (!rms::getCaptureInfo(info)) {
+        out.println("[ERR] No capture to dump");
+        return;
+    }
+    char buf[128];
+    snprintf(buf, sizeof(buf),
+             "[OK] Capture dump: samples %lu rate_hz %.1f trigger %lu midpoint %u "
+             "amps_per_count %.6f t_ms %lu",
+             static_cast<unsigned long>(info.samples), info.sampleRateHz,
+             static_cast<unsigned long>(info.triggerIndex),
+             static_cast<unsigned>(info.midpoint), info.ampsPerCount,
+             static_cast<unsigned long>(info.triggerMs));
+    out.println(buf);
+    dumpNext = 0;
+    dumpOut  = &requestingOutput();
+#else
+    out.println("[ERR] Capture not available on this build");
+#endif
+}
+
+static void handleCaptureRearm(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    dumpNext = -1;
+    rms::rearmCapture();
+    out.println("[OK] Capture re-armed");
+#else
+    out.println("[ERR] Capture not available on this build");
+#endif
+}
+
+static void handleBaseline(Print& out, const cmdline::Args&) {
+    using baseline::Channel;
+    static const char* const PHASE_NAMES[] = {"idle", "learning", "monitoring"};
+    const baseline::Engine& b = state_machine::getBaseline();
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "[OK] Baseline %s | warn 0x%02X | alarm 0x%02X",
+             PHASE_NAMES[static_cast<uint8_t>(b.phase())],
+             static_cast<unsigned>(b.warnMask()), static_cast<unsigned>(b.alarmMask()));
+    out.println(buf);
+
+    for (uint8_t c = 0; c < baseline::CHANNEL_COUNT; ++c) {
+        const Channel ch = static_cast<Channel>(c);
+        const baseline::RunningStats& st = b.stats(ch);
+        const baseline::Histogram&    h  = b.histogram(ch);
+        snprintf(buf, sizeof(buf),
+                 "  %-8s n %lu | mean %.4f | sd %.4f | z %+.2f | cusum %.2f/%.2f",
+                 baseline::channelName(ch), static_cast<unsigned long>(st.n),
+                 st.mean, st.stddev(), b.z(ch), b.cusum(ch).up, b.cusum(ch).down);
+        out.println(buf);
+
+        int n = snprintf(buf, sizeof(buf), "  %-8s hist [%.3g,%.3g) <%u", "",
+                         h.lo, h.hi, static_cast<unsigned>(h.under));
+        for (uint8_t i = 0; i < baseline::HISTOGRAM_BINS && n > 0 && n < static_cast<int>(sizeof(buf)); ++i) {
+            n += snprintf(buf + n, sizeof(buf) - n, " %u", static_cast<unsigned>(h.bins[i]));
+        }
+        if (n > 0 && n < static_cast<int>(sizeof(buf))) {
+            snprintf(buf + n, sizeof(buf) - n, " >%u", static_cast<unsigned>(h.over));
+        }
+        out.println(buf);
+    }
+}
+
+static void handleTasks(Print& out, const cmdline::Args&) {
+    if (taskScheduler == nullptr) {
+        out.println("[ERR] No scheduler running");
+        return;
+    }
+    out.println("[OK] Tasks (us): period | runs | last | avg | wcet | late max | overruns | skipped");
+    char buf[128];
+    for (uint8_t i = 0; i < taskScheduler->count(); ++i) {
+        const sched::Task&      t = taskScheduler->task(i);
+        const sched::TaskStats& s = t.stats;
+        const unsigned long avg =
+            s.runs ? static_cast<unsigned long>(s.totalUs / s.runs) : 0ul;
+        snprintf(buf, sizeof(buf), "  %-10s %7lu | %8lu | %5lu | %5lu | %5lu | %6lu | %lu | %lu",
+                 t.name, static_cast<unsigned long>(t.periodUs),
+                 static_cast<unsigned long>(s.runs), static_cast<unsigned long>(s.lastUs), avg,
+                 static_cast<unsigned long>(s.maxUs), static_cast<unsigned long>(s.maxLateUs),
+                 static_cast<unsigned long>(s.overruns), static_cast<unsigned long>(s.skipped));
+        out.println(buf);
+    }
+}
+
+static void handleTasksReset(Print& out, const cmdline::Args&) {
+    if (taskScheduler == nullptr) {
+        out.println("[ERR] No scheduler running");
+        return;
+    }
+    taskScheduler->resetStats();
+    out.println("[OK] Task statistics reset");
+}
+
+static void handlePerf(Print& out, const cmdline::Args&) {
+#if PERF_ENABLED
+    const float mhz = static_cast<float>(perf::clockMHz());
+    out.println("[OK] Perf (us): count | min | avg | p99 | max");
+    char buf[112];
+    for (uint8_t i = 0; i < perf::PROBE_COUNT; ++i) {
+        const perf::Probe      p = static_cast<perf::Probe>(i);
+        const perf::Histogram& h = perf::probe(p);
+        snprintf(buf, sizeof(buf), "  %-9s %8lu | %8.1f | %8.1f | %8.1f | %8.1f",
+                 perf::probeName(p), static_cast<unsigned long>(h.count()),
+                 h.min() / mhz, h.mean() / mhz, h.percentile(0.99f) / mhz, h.max() / mhz);
+        out.println(buf);
+    }
+#else
+    out.println("[ERR] Profiling compiled out (PERF_ENABLED false)");
+#endif
+}
+
+static void handlePerfReset(Print& out, const cmdline::Args&) {
+    perf::resetAll();
+    out.println("[OK] Perf probes reset (each clears at its next sample)");
+}
+
+static void handleLog(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    if (!run_log::isMounted()) {
+        out.println("[ERR] Run log partition not mounted");
+        return;
+    }
+    const run_log::Stats st = run_log::getStats();
+    char buf[112];
+    snprintf(buf, sizeof(buf), "[OK] Run log: seq %lu..%lu (%lu stored, capacity %lu)",
+             static_cast<unsigned long>(run_log::oldestSeq()),
+             static_cast<unsigned long>(run_log::nextSeq()),
+             static_cast<unsigned long>(run_log::nextSeq() - run_log::oldestSeq()),
+             static_cast<unsigned long>(run_log::capacity()));
+    out.println(buf);
+    snprintf(buf, sizeof(buf),
+             "  appended %lu | page writes %lu | erases %lu | write errors %lu",
+             static_cast<unsigned long>(st.store.appended),
+             static_cast<unsigned long>(st.store.pageWrites),
+             static_cast<unsigned long>(st.store.sectorErases),
+             static_cast<unsigned long>(st.store.writeErrors));
+    out.println(buf);
+    snprintf(buf, sizeof(buf), "  dropped %lu | queue high %lu/%lu | max write %lu us",
+             static_cast<unsigned long>(st.dropped), static_cast<unsigned long>(st.queueHigh),
+             static_cast<unsigned long>(RUN_LOG_QUEUE_DEPTH),
+             static_cast<unsigned long>(st.maxWriteUs));
+    out.println(buf);
+    snprintf(buf, sizeof(buf), "  erased ahead %lu/%lu | hot erases %lu",
+             static_cast<unsigned long>(st.erasedAhead),
+             static_cast<unsigned long>(RUN_LOG_ERASE_AHEAD_SECTORS),
+             static_cast<unsigned long>(st.hotErases));
+    out.println(buf);
+#else
+    out.println("[ERR] Run log not available on this build");
+#endif
+}
+
+static void handleLogDump(Print& out, const cmdline::Args& args) {
+#ifdef ARDUINO
+    if (!run_log::isMounted()) {
+        out.println("[ERR] Run log partition not mounted");
+        return;
+    }
+    uint32_t from = run_log::oldestSeq();
+    if (args.count() > 1 || (args.count() == 1 && !args.uintAt(0, UINT32_MAX, from))) {
+        out.println("[ERR] Usage: log dump [from_seq]");
+        return;
+    }
+    if (from < run_log::oldestSeq()) from = run_log::oldestSeq();
+    logDumpNext    = from;
+    logDumpEnd     = run_log::nextSeq();
+    logDumpLines   = 0;
+    logDumpSkipped = 0;
+    logDumpActive  = true;
+    logDumpOut     = &requestingOutput();
+    char buf[96];
+    snprintf(buf, sizeof(buf),
+             "[OK] Log dump: seq %lu..%lu; #log seq,time_ms,type,state,detail,temp_k,dac",
+             static_cast<unsigned long>(logDumpNext), static_cast<unsigned long>(logDumpEnd));
+    out.println(buf);
+#else
+    (void)args;
+    out.println("[ERR] Run log not available on this build");
+#endif
+}
+
+/** Decimal places a parameter is shown with. */
+static int paramDigits(const params::Descriptor& d) {
+    return (d.type == params::Type::Uint) ? 0 : 3;
+}
+
+static void printParam(Print& out, const char* prefix, params::Id id) {
+    const params::Descriptor& d = params::descriptor(id);
+    const int digits = paramDigits(d);
+    char buf[112];
+    snprintf(buf, sizeof(buf), "%s%-10s %9.*f %-5s (default %.*f, %.*f .. %.*f)", prefix, d.name,
+             digits, params::get(id), d.unit, digits, d.def, digits, d.min, digits, d.max);
+    out.println(buf);
+}
+
+/** One line that "set" accepts back verbatim: the whole live profile. */
+static void printProfile(Print& out) {
+    char   buf[MAX_LINE_LEN + 1];
+    size_t n = static_cast<size_t>(snprintf(buf, sizeof(buf), "set"));
+    for (uint8_t i = 0; i < params::COUNT && n < sizeof(buf); ++i) {
+        const params::Descriptor& d = params::DESCRIPTORS[i];
+        n += static_cast<size_t>(snprintf(buf + n, sizeof(buf) - n, " %s %.*f", d.name,
+                                          (d.type == params::Type::Uint) ? 0 : 4,
+                                          params::get(d.id)));
+    }
+    out.println(buf);
+}
+
+static void handleGet(Print& out, const cmdline::Args& args) {
+    if (args.count() > 1) {
+        out.println("[ERR] Usage: get [name | profile]");
+        return;
+    }
+    if (args.is("profile")) {
+        printProfile(out);
+        return;
+    }
+    if (args.count() == 1) {
+        params::Id id;
+        if (!params::find(args[0], id)) {
+            char buf[80];
+            snprintf(buf, sizeof(buf), "[ERR] Unknown parameter '%.32s'  (type 'get')", args[0]);
+            out.println(buf);
+            return;
+        }
+        printParam(out, "[OK] ", id);
+        return;
+    }
+    out.println("[OK] Parameters:");
+    for (uint8_t i = 0; i < params::COUNT; ++i) {
+        printParam(out, "  ", static_cast<params::Id>(i));
+    }
+}
+
+/** Note that requestStore() waits for Off/Idle, when it has to. */
+static void printStoreDeferral(Print& out) {
+#ifdef ARDUINO
+    if (!machineAtRest()) {
+        out.println("[OK] Stored profile updates once the cooler is Off or Idle");
+    }
+#else
+    (void)out;
+#endif
+}
+
+static void handleSet(Print& out, const cmdline::Args& args) {
+    if (args.is("defaults")) {
+        params::resetDefaults();
+        requestStore(Store::Erase);
+        out.println("[OK] Parameters reset to config.h defaults; stored profile erased");
+        printStoreDeferral(out);
+        return;
+    }
+    if (args.empty() || (args.count() % 2) != 0) {
+        out.println("[ERR] Usage: set <name> <value> [<name> <value> ...] | set defaults");
+        return;
+    }
+
+    // Parse the whole batch first; params::apply() then commits all or none
+    params::Change changes[cmdline::MAX_TOKENS / 2] = {};
+    const uint8_t  n = static_cast<uint8_t>(args.count() / 2);
+    char buf[96];
+    for (uint8_t i = 0; i < n; ++i) {
+        const char* name = args[static_cast<uint8_t>(2 * i)];
+        if (!params::find(name, changes[i].id)) {
+            snprintf(buf, sizeof(buf), "[ERR] Unknown parameter '%.32s'  (type 'get')", name);
+            out.println(buf);
+            return;
+        }
+        if (!args.floatAt(static_cast<uint8_t>(2 * i + 1), changes[i].value)) {
+            snprintf(buf, sizeof(buf), "[ERR] %s: '%.24s' is not a number", name,
+                     args[static_cast<uint8_t>(2 * i + 1)]);
+            out.println(buf);
+            return;
+        }
+    }
+
+    uint8_t bad = 0;
+    switch (params::apply(changes, n, &bad)) {
+        case params::Result::Ok:
+            break;
+        case params::Result::OutOfRange: {
+            const params::Descriptor& d = params::descriptor(changes[bad].id);
+            const int digits = paramDigits(d);
+            snprintf(buf, sizeof(buf), "[ERR] %s must be %s%.*f .. %.*f %s; nothing changed",
+                     d.name, (d.type == params::Type::Uint) ? "a whole number " : "",
+                     digits, d.min, digits, d.max, d.unit);
+            out.println(buf);
+            return;
+        }
+        case params::Result::Inconsistent:
+            out.println("[ERR] setpoint + tolerance must stay below threshold and "
+                        "rate at or below maxrate; nothing changed");
+            return;
+    }
+    for (uint8_t i = 0; i < n; ++i) printParam(out, "[OK] ", changes[i].id);
+    requestStore(Store::Save);
+    printStoreDeferral(out);
+}
+
+static void handleSpi(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    out.println("[OK] SPI bus (us): transactions | bytes | busy | max | wait");
+    char buf[112];
+    for (uint8_t i = 0; i < spi_bus::DEVICE_COUNT; ++i) {
+        const spi_bus::Device dev = static_cast<spi_bus::Device>(i);
+        const spi_bus::Stats  st  = spi_bus::getStats(dev);
+        snprintf(buf, sizeof(buf), "  %-9s %8lu | %8lu | %10llu | %5lu | %llu",
+                 spi_bus::deviceName(dev), static_cast<unsigned long>(st.transactions),
+                 static_cast<unsigned long>(st.bytes), static_cast<unsigned long long>(st.busyUs),
+                 static_cast<unsigned long>(st.maxUs), static_cast<unsigned long long>(st.waitUs));
+        out.println(buf);
+    }
+#else
+    out.println("[ERR] SPI bus not available on this build");
+#endif
+}
+
+static void handleSpiReset(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    spi_bus::resetStats();
+    out.println("[OK] SPI bus statistics reset");
+#else
+    out.println("[ERR] SPI bus not available on this build");
+#endif
+}
+
+#ifdef ARDUINO
+/** False (and an error printed) when the image was built without Wi-Fi. */
+static bool requireNet(Print& out) {
+    if (net::isEnabled()) return true;
+    out.println("[ERR] Network not built (define NET_WIFI_SSID)");
+    return false;
+}
+#endif
+
+static void handleNet(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    if (!requireNet(out)) return;
+    const net::Stats st = net::getStats();
+    char ip[16];
+    char dest[24];
+    net::formatLocalIp(ip, sizeof(ip));
+    net::formatDestination(dest, sizeof(dest));
+    char buf[128];
+    snprintf(buf, sizeof(buf), "[OK] Net: link %s | ip %s | udp %s %s | console :%u%s",
+             st.linkUp ? "up" : "down", ip, dest, net::isStreaming() ? "on" : "off",
+             static_cast<unsigned>(NET_CONSOLE_PORT), st.consoleClient ? " (session open)" : "");
+    out.println(buf);
+    snprintf(buf, sizeof(buf),
+             "[OK] Net telemetry: frames %lu | datagrams %lu | skipped %lu | dropped %lu | errors %lu",
+             static_cast<unsigned long>(st.frames), static_cast<unsigned long>(st.datagrams),
+             static_cast<unsigned long>(st.skipped), static_cast<unsigned long>(st.dropped),
+             static_cast<unsigned long>(st.sendErrors));
+    out.println(buf);
+#else
+    out.println("[ERR] Network not available on this build");
+#endif
+}
+
+static void handleNetDest(Print& out, const cmdline::Args& args) {
+#ifdef ARDUINO
+    if (!requireNet(out)) return;
+    uint32_t port = NET_UDP_PORT;
+    if (args.empty() || args.count() > 2 || (args.count() == 2 && !args.uintAt(1, 65535, port)) ||
+        port == 0 || !net::setDestination(args[0], static_cast<uint16_t>(port))) {
+        out.println("[ERR] Usage: net dest <a.b.c.d> [port]");
+        return;
+    }
+    char dest[24];
+    net::formatDestination(dest, sizeof(dest));
+    char buf[48];
+    snprintf(buf, sizeof(buf), "[OK] Telemetry datagrams to %s", dest);
+    out.println(buf);
+#else
+    (void)args;
+    out.println("[ERR] Network not available on this build");
+#endif
+}
+
+static void handleNetOn(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    if (!requireNet(out)) return;
+    net::setStreaming(true);
+    out.println("[OK] Network telemetry enabled");
+#else
+    out.println("[ERR] Network not available on this build");
+#endif
+}
+
+static void handleNetOff(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    if (!requireNet(out)) return;
+    net::setStreaming(false);
+    out.println("[OK] Network telemetry disabled");
+#else
+    out.println("[ERR] Network not available on this build");
+#endif
+}
+
+static void handleNetReset(Print& out, const cmdline::Args&) {
+#ifdef ARDUINO
+    if (!requireNet(out)) return;
+    net::resetStats();
+    out.println("[OK] Network counters reset");
+#else
+    out.println("[ERR] Network not available on this build");
+#endif
+}
+
+static void handleBoard(Print& out, const cmdline::Args&) {
     out.println("[OK] Board info:");
 #ifdef ARDUINO_VARIANT
     out.println("  ARDUINO_VARIANT:       " ARDUINO_VARIANT);
@@ -134,25 +893,111 @@ static void handleBoard(Print& out) {
 // Command table  (handleHelp defined below so it can iterate commands)
 // ---------------------------------------------------------------------------
 
-static const Command commands[] = {
-    {"start",  handleStart,  "Begin the cooldown process (from Off or Idle)"},
-    {"stop",   handleStop,   "Abort the process and return to Idle"},
+// Sorted by name (strcmp order; checked at compile time below) so
+// processLine() can binary-search it.  A name may be up to
+// MAX_COMMAND_WORDS words; the longest match wins.
+static constexpr Command commands[] = {
+    {"baseline", handleBaseline, "Show baseline fingerprint and deviation scores"},
+    {"board",  handleBoard,  "Print compile-time board/platform info"},
+    {"capture", handleCapture, "Show overstroke capture status"},
+    {"capture dump", handleCaptureDump, "Stream the frozen overstroke waveform"},
+    {"capture rearm", handleCaptureRearm, "Release the capture for the next event"},
+    {"get",    handleGet,    "[name | profile]: show runtime parameters"},
+    {"help",   handleHelp,   "[word]: show available commands"},
+    {"log",    handleLog,    "Show run-log range and flash counters"},
+    {"log dump", handleLogDump, "[from]: stream run-log records from flash"},
+    {"net",    handleNet,    "Show Wi-Fi link, UDP telemetry and console status"},
+    {"net dest", handleNetDest, "<a.b.c.d> [port]: telemetry datagram destination"},
+    {"net off", handleNetOff, "Stop UDP telemetry"},
+    {"net on", handleNetOn,  "Resume UDP telemetry"},
+    {"net reset", handleNetReset, "Zero network counters"},
     {"off",    handleOff,    "Power off the system entirely"},
+    {"perf",   handlePerf,   "Show per-stage timing (min/avg/p99/max)"},
+    {"perf reset", handlePerfReset, "Zero profiling probes"},
+    {"set",    handleSet,    "<name> <value> ... | defaults: change and store parameters"},
+    {"spi",    handleSpi,    "Show per-device SPI bus time"},
+    {"spi reset", handleSpiReset, "Zero SPI bus counters"},
+    {"start",  handleStart,  "Begin the cooldown process (from Off or Idle)"},
     {"status", handleStatus, "Print current state and running flag"},
-    {"board",  handleBoard,  "Print compile-time board/platform info"},
-    {"help",   handleHelp,   "Show available commands"},
+    {"stop",   handleStop,   "Abort the process and return to Idle"},
+    {"tasks",  handleTasks,  "Show scheduler job periods, WCET and overruns"},
+    {"tasks reset", handleTasksReset, "Zero scheduler job statistics"},
+    {"telemetry binary", handleTelemetryBinary, "Compact COBS binary frames"},
+    {"telemetry config", handleTelemetryConfig, "Show telemetry format and schedule"},
+    {"telemetry csv", handleTelemetryCsv, "Serial Studio CSV frames (default)"},
+    {"telemetry delta", handleTelemetryDelta, "<on|off>: omit unchanged slow columns"},
+    {"telemetry descriptor", handleTelemetryDescriptor, "Re-send binary descriptor frames"},
+    {"telemetry fields", handleTelemetryFields, "<mask|all>: CSV column mask"},
+    {"telemetry keyframe", handleTelemetryKeyframe, "<K>: full frame every K (delta)"},
     {"telemetry off", handleTelemetryOff, "Disable telemetry"},
     {"telemetry on", handleTelemetryOn, "Enable telemetry"},
+    {"telemetry rate", handleTelemetryRate, "<N>: every Nth tick when steady"},
+    {"telemetry stats", handleTelemetryStats, "Show telemetry ring counters"},
+    {"telemetry stats reset", handleTelemetryStatsReset, "Zero telemetry ring counters"},
 };
 
 static constexpr uint8_t COMMAND_COUNT =
     static_cast<uint8_t>(sizeof(commands) / sizeof(commands[0]));
 
-static void handleHelp(Print& out) {
+static constexpr int compareNames(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) { ++a; ++b; }
+    return static_cast<int>(static_cast<unsigned char>(*a)) -
+           static_cast<int>(static_cast<unsigned char>(*b));
+}
+
+static constexpr bool commandsSorted() {
+    for (uint8_t i = 1; i < COMMAND_COUNT; ++i) {
+        if (compareNames(commands[i - 1].name, commands[i].name) >= 0) return false;
+    }
+    return true;
+}
+
+static_assert(commandsSorted(), "commands[] must be sorted by name, without duplicates");
+
+static constexpr uint8_t wordCount(const char* name) {
+    uint8_t n = 1;
+    for (; *name != '\0'; ++name) {
+        if (*name == ' ') ++n;
+    }
+    return n;
+}
+
+static constexpr uint8_t maxCommandWords() {
+    uint8_t n = 1;
+    for (uint8_t i = 0; i < COMMAND_COUNT; ++i) {
+        if (wordCount(commands[i].name) > n) n = wordCount(commands[i].name);
+    }
+    return n;
+}
+
+static constexpr uint8_t MAX_COMMAND_WORDS = maxCommandWords();
+
+/** Binary search for a command named exactly @p name. */
+static const Command* findCommand(const char* name) {
+    uint8_t lo = 0;
+    uint8_t hi = COMMAND_COUNT;
+    while (lo < hi) {
+        const uint8_t mid = static_cast<uint8_t>((lo + hi) / 2u);
+        const int c = strcmp(commands[mid].name, name);
+        if (c == 0) return &commands[mid];
+        if (c < 0) lo = static_cast<uint8_t>(mid + 1u);
+        else       hi = mid;
+    }
+    return nullptr;
+}
+
+static void handleHelp(Print& out, const cmdline::Args& args) {
+    // "help telemetry" lists only the commands starting with that word
+    const char*  word = args[0];
+    const size_t len  = strlen(word);
     out.println("[OK] Available commands:");
     for (uint8_t i = 0; i < COMMAND_COUNT; ++i) {
+        if (len > 0 && (strncmp(commands[i].name, word, len) != 0 ||
+                        (commands[i].name[len] != '\0' && commands[i].name[len] != ' '))) {
+            continue;
+        }
         char line[80];
-        snprintf(line, sizeof(line), "  %-16s  %s",
+        snprintf(line, sizeof(line), "  %-22s  %s",
                  commands[i].name, commands[i].help);
         out.println(line);
     }
@@ -162,55 +1007,118 @@ static void handleHelp(Print& out) {
 // Public API
 // ---------------------------------------------------------------------------
 
+void setScheduler(sched::Scheduler* scheduler) {
+    taskScheduler = scheduler;
+}
+
 void processLine(const char* line, Print& out) {
-    // Skip leading whitespace.
-    while (*line == ' ' || *line == '\t') { ++line; }
-    if (*line == '\0') { return; }
-
-    // Match commands by prefix: the command name must exactly fill the start of
-    // the line, followed by end-of-string, a space, or a tab.  This naturally
-    // handles multi-word command names like "telemetry off" — longer/more-specific
-    // names must appear before shorter prefixes in commands to take precedence.
-    for (uint8_t i = 0; i < COMMAND_COUNT; ++i) {
-        const size_t nameLen = strlen(commands[i].name);
-        if (strncmp(commands[i].name, line, nameLen) == 0 &&
-            (line[nameLen] == '\0' || line[nameLen] == ' ' || line[nameLen] == '\t')) {
-            commands[i].handler(out);
+    char buf[MAX_LINE_LEN + 1];
+    const size_t len = strlen(line);
+    if (len > MAX_LINE_LEN) {
+        out.println("[ERR] Line too long; ignored");
+        return;
+    }
+    memcpy(buf, line, len + 1);
+
+    const cmdline::Tokens t = cmdline::tokenize(buf);
+    if (t.count == 0) { return; }
+    if (t.overflow) {
+        out.println("[ERR] Too many arguments; ignored");
+        return;
+    }
+
+    // Longest match first: "telemetry stats reset" before "telemetry stats".
+    // Tokens are rejoined with single spaces, so extra blanks between the
+    // words of a command name do not matter.
+    char name[MAX_LINE_LEN + 1];
+    for (uint8_t words = (t.count < MAX_COMMAND_WORDS) ? t.count : MAX_COMMAND_WORDS;
+         words > 0; --words) {
+        size_t n = 0;
+        for (uint8_t i = 0; i < words; ++i) {
+            const size_t w = strlen(t.v[i]);
+            if (i > 0) name[n++] = ' ';
+            memcpy(name + n, t.v[i], w);
+            n += w;
+        }
+        name[n] = '\0';
+        const Command* cmd = findCommand(name);
+        if (cmd != nullptr) {
+            cmd->handler(out, cmdline::Args(t.v + words, static_cast<uint8_t>(t.count - words)));
             return;
         }
     }
 
-    // Unknown command — show up to the first space so the message stays tidy.
-    const char* end = line;
-    while (*end && *end != ' ' && *end != '\t') { ++end; }
-    char msg[80];
-    snprintf(msg, sizeof(msg),
-             "[ERR] Unknown command: '%.*s'  (type 'help')",
-             static_cast<int>(end - line), line);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "[ERR] Unknown command: '%.40s'  (type 'help')", t.v[0]);
     out.println(msg);
 }
 
 void init() {
-    lineLen    = 0;
-    lineBuf[0] = '\0';
+    serialInput.reset();
+}
+
+void setDispatchLock(LockHook lock, LockHook unlock) {
+    lockHook   = lock;
+    unlockHook = unlock;
 }
 
-void service() {
 #if defined(ARDUINO)
-    while (Serial.available()) {
-        const char c = static_cast<char>(Serial.read());
+void serviceInput(Stream& in, Print& out, LineInput& input) {
+    while (in.available()) {
+        const char c = static_cast<char>(in.read());
         if (c == '\r') { continue; }
         if (c == '\n') {
-            lineBuf[lineLen] = '\0';
-            if (lineLen > 0) {
-                processLine(lineBuf, Serial);
+            input.buf[input.len] = '\0';
+            if (input.overflow) {
+                char msg[64];
+                snprintf(msg, sizeof(msg), "[ERR] Line too long (max %u characters); ignored",
+                         static_cast<unsigned>(MAX_LINE_LEN));
+                out.println(msg);
+            } else if (input.len > 0) {
+                if (lockHook)   { lockHook(); }
+                sessionOut = &out;
+                processLine(input.buf, response);
+                sessionOut = nullptr;
+                if (unlockHook) { unlockHook(); }
+                response.flushTo(out);
             }
-            lineLen = 0;
-        } else if (lineLen < MAX_LINE_LEN) {
-            lineBuf[lineLen++] = c;
+            input.reset();
+        } else if (input.len < MAX_LINE_LEN) {
+            input.buf[input.len++] = c;
+        } else {
+            input.overflow = true;   // rest of the line is dropped and reported
         }
-        // Characters beyond MAX_LINE_LEN are silently dropped until next newline.
     }
+}
+
+void endSession(Print& out) {
+    if (dumpOut == &out)    { dumpNext = -1; }
+    if (logDumpOut == &out) { logDumpActive = false; }
+    if (storeOut == &out)   { storeOut = nullptr; }   // still stored; errors go to Serial
+}
+#else   // native build: no dispatch lock and no flash; store at once
+
+static void requestStore(Store s) {
+    if (s == Store::Erase) params::erase();
+    else                   params::save();
+}
+#endif
+
+void setStream(Stream* io) { consoleStream = io; }
+
+void service() {
+#if defined(ARDUINO)
+    Stream* io = consoleStream;
+    if (io == nullptr) io = &Serial;
+    if (io != servicedStream) {   // a half line and a dump belong to the old stream
+        if (servicedStream != nullptr) endSession(*servicedStream);
+        servicedStream = io;
+        serialInput.reset();
+    }
+    serviceInput(*io, *io, serialInput);
+    serviceStore();
+    serviceCaptureDump();
+    serviceLogDump();
 #endif
 }
 
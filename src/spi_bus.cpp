@@ -0,0 +1,148 @@
+/**
+ * @file spi_bus.cpp
+ * @brief Shared SPI bus manager implementation
+ *
+ * Lock depth and the open transaction are only touched by the task that
+ * holds busMutex, so they need no further protection.  A transaction opened
+ * by transfer() is left open while the bus stays held, and closed when the
+ * next transfer is for another device, when a Claim hands the host to a
+ * library, or when the outermost holder releases the bus.
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "pin_config.h"
+#include "config.h"
+#include "spi_bus.h"
+
+// ---------------------------------------------------------------------------
+// Module-private state
+// ---------------------------------------------------------------------------
+
+struct DeviceConfig {
+    uint8_t  cs;
+    uint32_t hz;
+    uint8_t  mode;
+};
+
+static const DeviceConfig DEVICES[spi_bus::DEVICE_COUNT] = {
+    {MAX31865_CS, MAX31865_SPI_SPEED, SPI_MODE1},   // Rtd
+    {AD9833_CS,   AD9833_SPI_SPEED,   SPI_MODE2},   // Waveform
+    {MCP4921_CS,  MCP4921_SPI_SPEED,  SPI_MODE0},   // Dac
+};
+
+static constexpr int8_t NO_DEVICE = -1;
+
+static SPISettings       settings[spi_bus::DEVICE_COUNT];
+static SemaphoreHandle_t busMutex  = nullptr;
+static uint8_t           lockDepth = 0;           // holder's nesting depth
+static int8_t            openDev   = NO_DEVICE;   // device with an open beginTransaction()
+static spi_bus::Stats    stats[spi_bus::DEVICE_COUNT];
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+static uint8_t idx(spi_bus::Device dev) { return static_cast<uint8_t>(dev); }
+
+static void closeTransaction() {
+    if (openDev == NO_DEVICE) return;
+    SPI.endTransaction();
+    openDev = NO_DEVICE;
+}
+
+/** Take the bus; the wait is charged to @p waiter when given. */
+static void lock(spi_bus::Stats* waiter) {
+    const uint32_t t0 = micros();
+    xSemaphoreTakeRecursive(busMutex, portMAX_DELAY);
+    if (lockDepth++ == 0 && waiter != nullptr) {
+        waiter->waitUs += micros() - t0;
+    }
+}
+
+static void unlock() {
+    if (--lockDepth == 0) closeTransaction();
+    xSemaphoreGiveRecursive(busMutex);
+}
+
+static void account(spi_bus::Stats& s, uint32_t us, uint32_t bytes) {
+    ++s.transactions;
+    s.bytes  += bytes;
+    s.busyUs += us;
+    if (us > s.maxUs) s.maxUs = us;
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+namespace spi_bus {
+
+void init() {
+    for (uint8_t i = 0; i < DEVICE_COUNT; ++i) {
+        pinMode(DEVICES[i].cs, OUTPUT);
+        digitalWrite(DEVICES[i].cs, HIGH);
+        settings[i] = SPISettings(DEVICES[i].hz, MSBFIRST, DEVICES[i].mode);
+    }
+    SPI.begin(SPI_CLK, SPI_MISO, SPI_MOSI, -1);
+    busMutex = xSemaphoreCreateRecursiveMutex();
+    resetStats();
+}
+
+void transfer(Device dev, const uint8_t* tx, uint8_t* rx, uint8_t n) {
+    const uint8_t i = idx(dev);
+    lock(&stats[i]);
+    const uint32_t t0 = micros();
+    if (openDev != static_cast<int8_t>(i)) {
+        closeTransaction();
+        SPI.beginTransaction(settings[i]);
+        openDev = static_cast<int8_t>(i);
+    }
+    digitalWrite(DEVICES[i].cs, LOW);
+    for (uint8_t k = 0; k < n; ++k) {
+        const uint8_t b = SPI.transfer(tx ? tx[k] : 0xFF);
+        if (rx) rx[k] = b;
+    }
+    digitalWrite(DEVICES[i].cs, HIGH);
+    account(stats[i], micros() - t0, n);
+    unlock();
+}
+
+Batch::Batch()  { lock(nullptr); }
+Batch::~Batch() { unlock(); }
+
+Claim::Claim(Device dev) : _dev(dev), _startUs(0) {
+    lock(&stats[idx(dev)]);
+    closeTransaction();   // the library begins its own
+    _startUs = micros();
+}
+
+Claim::~Claim() {
+    account(stats[idx(_dev)], micros() - _startUs, 0);
+    unlock();
+}
+
+Stats getStats(Device dev) {
+    return stats[idx(dev)];
+}
+
+void resetStats() {
+    // Under the bus lock: every counter is written by its bus holder
+    lock(nullptr);
+    for (Stats& s : stats) s = Stats{};
+    unlock();
+}
+
+const char* deviceName(Device dev) {
+    switch (dev) {
+        case Device::Rtd:      return "max31865";
+        case Device::Waveform: return "ad9833";
+        case Device::Dac:      return "mcp4921";
+    }
+    return "?";
+}
+
+} // namespace spi_bus
@@ -4,136 +4,207 @@
  *
  * Pure logic -- no Serial.print, no hardware calls.
  * All inputs are injected via update(); all outputs are returned in the
- * Output struct so that callers (main.cpp) handle I/O.
+ * Output struct so that callers (main.cpp) handle I/O.  All per-cooler state
+ * is in Machine; the free functions forward to primary().
  */
 
 #include "state_machine.h"
 #include "config.h"
 #include "conversions.h"
 #include "indicator.h"
+#include "params.h"
+#include "pid_controller.h"
 #include <Arduino.h>
+#include <string.h>
 
 namespace state_machine {
 
 // ---------------------------------------------------------------------------
-// Module state
+// Shared configuration
 // ---------------------------------------------------------------------------
 
-static State       currentState    = State::Off;
-static uint32_t    currentStateEntryMs = 0;   // millis() when current state was entered
-static bool        running         = false; // process is off until start() is called
-static FaultReason faultReason     = FaultReason::None;
-static uint32_t    onStateMs       = 0;   // millis() when it entered an on state
-static uint32_t    offStateMs      = 0;   // millis() when it entered an off state
-
-// Settle timer -- starts counting when temp enters the tolerance band
-static uint32_t settleStartMs     = 0;
-static bool     settleTimerActive = false;
-
-// Back-EMF backoff tracking
-static uint16_t backoffCount      = 0;   // total backoff events in this run
-static uint16_t backoffDacOffset  = 0;   // cumulative DAC reduction (counts)
+// Temperature histogram range is the setpoint band, filled in when Baseline
+// begins so it follows runtime setpoint overrides (params.h).
+static const baseline::ChannelConfig BASELINE_CHANNELS[baseline::CHANNEL_COUNT] = {
+    // histLo, histHi, minSigma, maxDrift — indexed by baseline::Channel
+    {0.0f, 0.0f,                                          BASELINE_MIN_SIGMA_TEMP_K,    BASELINE_DRIFT_TEMP_K},
+    {0.0f, BASELINE_HIST_MAX_CURRENT_A,                   BASELINE_MIN_SIGMA_CURRENT_A, BASELINE_DRIFT_CURRENT_A},
+    {0.0f, static_cast<float>(MCP4921_MAX_VALUE) + 1.0f, BASELINE_MIN_SIGMA_DAC,       BASELINE_DRIFT_DAC},
+    {0.0f, RMS_MAX_VOLTAGE_VDC,                           BASELINE_MIN_SIGMA_RMS_V,     BASELINE_DRIFT_RMS_V},
+};
+
+static const baseline::Limits BASELINE_LIMITS = {
+    BASELINE_WARN_Z, BASELINE_CUSUM_K, BASELINE_CUSUM_H, BASELINE_WARMUP_CHECKS,
+};
+
+static const control::Gains COARSE_GAINS = {CTRL_COARSE_KP, CTRL_COARSE_KI, 0.0f};
+static const control::Gains FINE_GAINS   = {CTRL_FINE_KP,   CTRL_FINE_KI,   0.0f};
+static const control::Gains SETTLE_GAINS = {CTRL_SETTLE_KP, CTRL_SETTLE_KI, CTRL_SETTLE_KD};
+static const control::Gains HOLD_GAINS   = {CTRL_HOLD_KP,   CTRL_HOLD_KI,   CTRL_HOLD_KD};
 
 // ---------------------------------------------------------------------------
 // Internal helpers
 // ---------------------------------------------------------------------------
 
-static void enterState(State s, uint32_t nowMs) {
-    currentState        = s;
-    currentStateEntryMs = nowMs;
+/** Stop the DAC loop; the next controlled state starts it from zero. */
+void Machine::resetControl() {
+    _dacLoop.reset(0.0f);
+    _rateFilter.reset();
+    _activeGains = nullptr;
+}
+
+void Machine::enterState(State s, uint32_t nowMs) {
+    const State from = _state;
+    _state           = s;
+    _stateEntryMs    = nowMs;
+    if (s == State::Off || s == State::Initialize || s == State::Idle || s == State::Fault) {
+        resetControl();
+    }
     if (s != State::Settle) {
-        settleTimerActive = false;
-        settleStartMs     = 0;
+        _settleTimerActive = false;
+        _settleStartMs     = 0;
     }
     if (s != State::Fault) {
-        faultReason = FaultReason::None;
+        _faultReason = FaultReason::None;
+    }
+    if (_transitionHook && from != s) {
+        _transitionHook(from, s, _faultReason, nowMs);
     }
 }
 
-static void enterFault(FaultReason reason, uint32_t nowMs) {
-    faultReason = reason;
-    running     = false;
+void Machine::enterFault(FaultReason reason, uint32_t nowMs) {
+    _faultReason = reason;
+    _running     = false;
     enterState(State::Fault, nowMs);
 }
 
-/** Return the status description string for a given state. */
-static const char* statusTextForState(State s) {
-    switch (s) {
-        case State::Off:            return "System is off";
-        case State::Initialize:     return "Initial power up state";
-        case State::Idle:           return "Cold stage is warm; dewar is not cooling";
-        case State::CoarseCooldown: return "Cooling; cold stage is above 85K";
-        case State::FineCooldown:   return "Cooling; cold stage is below 85K";
-        case State::Overshoot:      return "Cold stage is cooler than set point; integrator is settling";
-        case State::Settle:         return "Cold stage temperature is settling; circuits switched to Normal";
-        case State::Baseline:       return "Cold stage temperature has settled; collecting baseline data";
-        case State::Operating:      return "System is operating normally; checking for deviations from baseline";
-        case State::Fault:
-            switch (faultReason) {
-                case FaultReason::RmsOvervoltage:   return "Fault: RMS voltage exceeded safe limit";
-                case FaultReason::TemperatureStall: return "Fault: Temperature stalled during cooldown";
-                case FaultReason::TooManyBackoffs:  return "Fault: Too many back-EMF stroke events; output backed off";
-                default:                            return "Fault: Unknown reason";
-            }
-    }
-    return "Unknown state";
+/** Start learning the fingerprint around the current setpoint band. */
+void Machine::beginBaseline() {
+    const float sp  = params::get(params::Id::SetpointK);
+    const float tol = params::get(params::Id::SetpointToleranceK);
+    baseline::ChannelConfig channels[baseline::CHANNEL_COUNT];
+    memcpy(channels, BASELINE_CHANNELS, sizeof(channels));
+    baseline::ChannelConfig& temp = channels[static_cast<uint8_t>(baseline::Channel::TempK)];
+    temp.histLo = sp - tol;
+    temp.histHi = sp + tol;
+    _fingerprint.begin(channels, BASELINE_LIMITS);
+}
+
+/** Start a settle window at this sample. */
+void Machine::restartSettleWindow(float tempK, uint16_t dacActual, uint32_t nowMs) {
+    _settleTimerActive = true;
+    _settleStartMs     = nowMs;
+    _settleMinK        = tempK;
+    _settleMaxK        = tempK;
+    _settleMinDac      = dacActual;
+    _settleMaxDac      = dacActual;
+}
+
+/**
+ * Widen the settle window by this sample.  False once the temperature or
+ * the applied DAC has moved more than the SETTLE_MAX_* span within it: the
+ * loop is still converging, so Baseline would learn a transient.
+ */
+bool Machine::settleWindowSteady(float tempK, uint16_t dacActual) {
+    if (tempK < _settleMinK)         _settleMinK   = tempK;
+    if (tempK > _settleMaxK)         _settleMaxK   = tempK;
+    if (dacActual < _settleMinDac)   _settleMinDac = dacActual;
+    if (dacActual > _settleMaxDac)   _settleMaxDac = dacActual;
+    return (_settleMaxK - _settleMinK) <= SETTLE_MAX_TEMP_SPAN_K &&
+           static_cast<uint16_t>(_settleMaxDac - _settleMinDac) <= SETTLE_MAX_DAC_SPAN;
 }
 
 /** True when the cold stage temperature is within the setpoint tolerance band. */
 static bool inBand(float tempK) {
-    return (tempK >= (SETPOINT_K - SETPOINT_TOLERANCE_K)) &&
-           (tempK <= (SETPOINT_K + SETPOINT_TOLERANCE_K));
+    const float sp  = params::get(params::Id::SetpointK);
+    const float tol = params::get(params::Id::SetpointToleranceK);
+    return (tempK >= (sp - tol)) && (tempK <= (sp + tol));
 }
 
 /** True when the cold stage has clearly overshot (gone below) the setpoint. */
 static bool overshot(float tempK) {
-    return (tempK < (SETPOINT_K - SETPOINT_TOLERANCE_K));
+    return (tempK < (params::get(params::Id::SetpointK) -
+                     params::get(params::Id::SetpointToleranceK)));
+}
+
+static const control::Gains& gainsFor(State s) {
+    switch (s) {
+        case State::CoarseCooldown: return COARSE_GAINS;
+        case State::FineCooldown:   return FINE_GAINS;
+        case State::Overshoot:
+        case State::Settle:         return SETTLE_GAINS;
+        default:                    return HOLD_GAINS;
+    }
 }
 
 /**
- * Compute the target DAC value for cooldown states.
+ * Run one step of the DAC loop for state @p s and return the target.
  *
- * The output is proportional to how far the temperature has dropped from
- * AMBIENT_START_K toward SETPOINT_K.  The coolingRate guard freezes the
- * target (no further increase) when the stage is already cooling faster
- * than the configured limit.
+ * Cooldown states track a cooling-rate target (PI, feed-forward from the
+ * linear temperature map, so the loop only trims it); the remaining
+ * controlled states hold SETPOINT_K (PID).  Changing state retunes the loop
+ * bumplessly.  The integrator is frozen while the DAC ramp in dac.cpp is
+ * still slewing toward the previous target, and the output ceiling drops by
+ * the accumulated back-EMF backoff.
  */
-static uint16_t cooldownDacTarget(float tempK, float coolingRate) {
-    const uint16_t proportional = conversions::tempKToDacValue(
-        tempK,
-        AMBIENT_START_K,
-        SETPOINT_K,
-        MCP4921_MAX_VALUE);
-
-    // Hold target when cooling rate already exceeds the limit so that the
-    // DAC ramp does not push temperature down any faster.
-    if (coolingRate > MAX_COOLDOWN_RATE_K_PER_MIN) {
-        return proportional;
+uint16_t Machine::controlDac(State s, float tempK, float coolingRate,
+                             uint16_t dacActual, uint32_t nowMs) {
+    float dtS = 0.0f;
+    if (_activeGains != nullptr) {
+        const uint32_t dtMs = nowMs - _lastControlMs;
+        dtS = static_cast<float>((dtMs > 1000u) ? 1000u : dtMs) * 0.001f;
+    }
+    _lastControlMs = nowMs;
+
+    const control::Gains& gains = gainsFor(s);
+    if (_activeGains != nullptr && _activeGains != &gains) {
+        _dacLoop.retune();
+    }
+    _activeGains = &gains;
+
+    const float setpointK = params::get(params::Id::SetpointK);
+    float error   = 0.0f;
+    float ff      = 0.0f;
+    float ceiling = static_cast<float>(MCP4921_MAX_VALUE - _backoffDacOffset);
+    if (s == State::CoarseCooldown || s == State::FineCooldown) {
+        const float rate = _rateFilter.update(coolingRate, dtS, CTRL_RATE_FILTER_TAU_S);
+        float target = params::get(params::Id::CooldownRate);
+        if (s == State::FineCooldown) {
+            target = control::approachRate(tempK, setpointK, target, FINE_APPROACH_TAU_MIN);
+        }
+        error = target - rate;
+        ff    = static_cast<float>(conversions::tempKToDacValue(
+                    tempK, AMBIENT_START_K, setpointK, MCP4921_MAX_VALUE));
+        // Over the rate limit: the feed-forward keeps rising as the stage
+        // cools, so hold the drive where it is and let P / I bring it down
+        if (rate > params::get(params::Id::MaxCooldownRate) &&
+            static_cast<float>(dacActual) < ceiling) {
+            ceiling = static_cast<float>(dacActual);
+        }
+    } else {
+        error = tempK - setpointK;   // too warm → more drive
     }
 
-    return proportional;
+    const bool  lagging = fabsf(_dacLoop.output() - static_cast<float>(dacActual)) >
+                          params::get(params::Id::DacMaxStep);   // dac.cpp's per-tick ramp
+    const float u = _dacLoop.update(gains, error, ff, dtS, 0.0f, ceiling, lagging);
+    return static_cast<uint16_t>(u + 0.5f);
 }
 
 /**
  * Build the Output struct for a given state.
  * Relay and indicator assignments follow the design spec exactly.
  */
-static Output buildOutput(State s, uint16_t dacTarget) {
+Output Machine::buildOutput(State s, uint16_t dacTarget) const {
     using Mode = indicator::Mode;
 
-    // Apply accumulated backoff reduction (floor at 0).
-    if (backoffDacOffset > 0 && dacTarget > 0) {
-        dacTarget = (backoffDacOffset >= dacTarget)
-                        ? static_cast<uint16_t>(0)
-                        : static_cast<uint16_t>(dacTarget - backoffDacOffset);
-    }
-
     Output o{};
     o.state        = s;
     o.dacTarget    = dacTarget;
     o.alarmRelay   = false;
-    o.statusText   = statusTextForState(s);
-    o.backoffCount = backoffCount;
+    o.statusText   = statusText(s, _faultReason);
+    o.backoffCount = _backoffCount;
+    o.deviationMask = (s == State::Operating) ? _fingerprint.warnMask() : 0;
 
     switch (s) {
         case State::Off:
@@ -201,51 +272,55 @@ static Output buildOutput(State s, uint16_t dacTarget) {
 }
 
 // ---------------------------------------------------------------------------
-// Public API
+// Machine
 // ---------------------------------------------------------------------------
 
-void init(uint32_t nowMs) {
-    running          = false;
-    onStateMs        = 0;
-    offStateMs       = 0;
-    faultReason      = FaultReason::None;
-    backoffCount     = 0;
-    backoffDacOffset = 0;
+void Machine::init(uint32_t nowMs) {
+    _running          = false;
+    _onStateMs        = 0;
+    _offStateMs       = 0;
+    _faultReason      = FaultReason::None;
+    _backoffCount     = 0;
+    _backoffDacOffset = 0;
+    _fingerprint.stop();
     enterState(State::Off, nowMs);
 }
 
-Output update(float    tempK,
-              float    coolingRate,
-              float    rmsVoltage,
-              bool     stalled,
-              uint32_t nowMs,
-              bool     overstroke)
+Output Machine::update(float    tempK,
+                       float    coolingRate,
+                       float    rmsVoltage,
+                       bool     stalled,
+                       uint32_t nowMs,
+                       bool     overstroke,
+                       float    currentA,
+                       uint16_t dacActual)
 {
     // ------------------------------------------------------------------
     // Global fault checks (fire from any non-Fault state)
     // ------------------------------------------------------------------
-    if (currentState != State::Fault) {
+    if (_state != State::Fault) {
         if (rmsVoltage > RMS_MAX_VOLTAGE_VDC) {
             enterFault(FaultReason::RmsOvervoltage, nowMs);
             return buildOutput(State::Fault, 0);
         }
-        if ((currentState == State::CoarseCooldown ||
-             currentState == State::FineCooldown) && stalled) {
+        if ((_state == State::CoarseCooldown ||
+             _state == State::FineCooldown) && stalled) {
             enterFault(FaultReason::TemperatureStall, nowMs);
             return buildOutput(State::Fault, 0);
         }
 
         // Back-EMF overstroke: increment backoff counter and apply DAC
-        // reduction.  After BACKOFF_MAX_COUNT events the system faults.
-        if (overstroke && running) {
-            ++backoffCount;
+        // reduction.  After the "backoffs" parameter's count the system faults.
+        if (overstroke && _running) {
+            ++_backoffCount;
             // Accumulate DAC reduction; cap at full-scale to stay in uint16_t.
-            const uint32_t newOffset = static_cast<uint32_t>(backoffDacOffset)
-                                       + static_cast<uint32_t>(BACKOFF_DAC_STEP);
-            backoffDacOffset = (newOffset > MCP4921_MAX_VALUE)
+            const uint32_t step      = params::getUint(params::Id::BackoffDacStep);
+            const uint32_t newOffset = static_cast<uint32_t>(_backoffDacOffset) + step;
+            _backoffDacOffset = (newOffset > MCP4921_MAX_VALUE)
                                     ? static_cast<uint16_t>(MCP4921_MAX_VALUE)
                                     : static_cast<uint16_t>(newOffset);
-            if (backoffCount >= static_cast<uint16_t>(BACKOFF_MAX_COUNT)) {
+            _dacLoop.shift(-static_cast<float>(step));
+            if (_backoffCount >= params::getUint(params::Id::BackoffMaxCount)) {
                 enterFault(FaultReason::TooManyBackoffs, nowMs);
                 return buildOutput(State::Fault, 0);
             }
@@ -257,22 +332,25 @@ Output update(float    tempK,
     // Each branch MUST return the new state's buildOutput after calling
     // enterState() so the caller always sees the current state.
     // ------------------------------------------------------------------
-    const uint32_t elapsed = nowMs - currentStateEntryMs;
+    const uint32_t elapsed = nowMs - _stateEntryMs;
+    const baseline::Sample sample = {{
+        tempK, currentA, static_cast<float>(dacActual), rmsVoltage,
+    }};
 
-    switch (currentState) {
+    switch (_state) {
 
         // ---- Off -------------------------------------------------------
         case State::Off:
-            if (offStateMs == 0) {
-            offStateMs = nowMs;
+            if (_offStateMs == 0) {
+            _offStateMs = nowMs;
             }
             return buildOutput(State::Off, 0);
 
         // ---- Initialize ------------------------------------------------
         case State::Initialize:
-            if (onStateMs == 0) {
-                onStateMs = nowMs;
-                offStateMs = 0;
+            if (_onStateMs == 0) {
+                _onStateMs = nowMs;
+                _offStateMs = 0;
             }
             if (elapsed >= INDICATOR_INIT_AMBER_MS) {
                 enterState(State::Idle, nowMs);
@@ -282,55 +360,59 @@ Output update(float    tempK,
 
         // ---- Idle ------------------------------------------------------
         case State::Idle:
-            if (offStateMs == 0) {
-                offStateMs = nowMs;
+            if (_offStateMs == 0) {
+                _offStateMs = nowMs;
             }
             // Remain in Idle until start() is called externally.
             return buildOutput(State::Idle, 0);
 
         // ---- Coarse Cooldown -------------------------------------------
-        case State::CoarseCooldown: {
-            const uint16_t target = cooldownDacTarget(tempK, coolingRate);
-            if (tempK < COARSE_FINE_THRESHOLD_K) {
+        case State::CoarseCooldown:
+            if (tempK < params::get(params::Id::CoarseFineK)) {
                 enterState(State::FineCooldown, nowMs);
-                return buildOutput(State::FineCooldown, target);
+                return buildOutput(State::FineCooldown,
+                                   controlDac(State::FineCooldown, tempK, coolingRate, dacActual, nowMs));
             }
-            return buildOutput(State::CoarseCooldown, target);
-        }
+            return buildOutput(State::CoarseCooldown,
+                               controlDac(State::CoarseCooldown, tempK, coolingRate, dacActual, nowMs));
 
         // ---- Fine Cooldown ---------------------------------------------
         case State::FineCooldown: {
             // Temperature bounced back above threshold: return to Coarse
-            if (tempK > COARSE_FINE_THRESHOLD_K) {
-                const uint16_t target = cooldownDacTarget(tempK, coolingRate);
+            if (tempK > params::get(params::Id::CoarseFineK)) {
                 enterState(State::CoarseCooldown, nowMs);
-                return buildOutput(State::CoarseCooldown, target);
+                return buildOutput(State::CoarseCooldown,
+                                   controlDac(State::CoarseCooldown, tempK, coolingRate, dacActual, nowMs));
             }
 
             // Clear overshoot: below the tolerance band
             if (overshot(tempK)) {
                 enterState(State::Overshoot, nowMs);
-                return buildOutput(State::Overshoot, 0);
+                return buildOutput(State::Overshoot,
+                                   controlDac(State::Overshoot, tempK, coolingRate, dacActual, nowMs));
             }
 
             // Reached setpoint band without overshoot: skip Overshoot, go to Settle
             if (inBand(tempK)) {
                 enterState(State::Settle, nowMs);
-                return buildOutput(State::Settle, 0);
+                return buildOutput(State::Settle,
+                                   controlDac(State::Settle, tempK, coolingRate, dacActual, nowMs));
             }
 
-            const uint16_t target = cooldownDacTarget(tempK, coolingRate);
-            return buildOutput(State::FineCooldown, target);
+            return buildOutput(State::FineCooldown,
+                               controlDac(State::FineCooldown, tempK, coolingRate, dacActual, nowMs));
         }
 
         // ---- Overshoot -------------------------------------------------
         case State::Overshoot:
-            // DAC stays at 0; wait for temperature to rise back into band
+            // Temperature loop backs the drive off; wait to rise back into band
             if (inBand(tempK)) {
                 enterState(State::Settle, nowMs);
-                return buildOutput(State::Settle, 0);
+                return buildOutput(State::Settle,
+                                   controlDac(State::Settle, tempK, coolingRate, dacActual, nowMs));
             }
-            return buildOutput(State::Overshoot, 0);
+            return buildOutput(State::Overshoot,
+                               controlDac(State::Overshoot, tempK, coolingRate, dacActual, nowMs));
 
         // ---- Settle ----------------------------------------------------
         case State::Settle: {
@@ -338,36 +420,53 @@ Output update(float    tempK,
 
             if (!stable) {
                 // Drifted out of band -- reset timer
-                settleTimerActive = false;
-                settleStartMs     = 0;
+                _settleTimerActive = false;
+                _settleStartMs     = 0;
             } else {
-                if (!settleTimerActive) {
-                    settleTimerActive = true;
-                    settleStartMs     = nowMs;
-                } else if ((nowMs - settleStartMs) >= SETTLE_DURATION_MS) {
+                if (!_settleTimerActive || !settleWindowSteady(tempK, dacActual)) {
+                    // In band, but the loop is still moving: time from here
+                    restartSettleWindow(tempK, dacActual, nowMs);
+                } else if ((nowMs - _settleStartMs) >= SETTLE_DURATION_MS) {
+                    beginBaseline();
                     enterState(State::Baseline, nowMs);
-                    return buildOutput(State::Baseline, 0);
+                    return buildOutput(State::Baseline,
+                                       controlDac(State::Baseline, tempK, coolingRate, dacActual, nowMs));
                 }
             }
-            return buildOutput(State::Settle, 0);
+            return buildOutput(State::Settle,
+                               controlDac(State::Settle, tempK, coolingRate, dacActual, nowMs));
         }
 
         // ---- Baseline --------------------------------------------------
         case State::Baseline:
+            _fingerprint.learn(sample);
             if (elapsed >= BASELINE_DURATION_MS) {
-                enterState(State::Operating, nowMs);
-                return buildOutput(State::Operating, 0);
+                if (_fingerprint.freeze()) {
+                    enterState(State::Operating, nowMs);
+                    return buildOutput(State::Operating,
+                                       controlDac(State::Operating, tempK, coolingRate, dacActual, nowMs));
+                }
+                // Still trending: learn a fresh window rather than a transient
+                beginBaseline();
+                _stateEntryMs = nowMs;
             }
-            return buildOutput(State::Baseline, 0);
+            return buildOutput(State::Baseline,
+                               controlDac(State::Baseline, tempK, coolingRate, dacActual, nowMs));
 
         // ---- Operating -------------------------------------------------
         case State::Operating:
-            return buildOutput(State::Operating, 0);
+            _fingerprint.check(sample);
+            if (BASELINE_DEVIATION_FAULT && _fingerprint.alarmMask() != 0) {
+                enterFault(FaultReason::BaselineDeviation, nowMs);
+                return buildOutput(State::Fault, 0);
+            }
+            return buildOutput(State::Operating,
+                               controlDac(State::Operating, tempK, coolingRate, dacActual, nowMs));
 
         // ---- Fault (terminal) ------------------------------------------
         case State::Fault:
-            if (offStateMs == 0) {
-                offStateMs = nowMs;
+            if (_offStateMs == 0) {
+                _offStateMs = nowMs;
             }
             return buildOutput(State::Fault, 0);
     }
@@ -376,39 +475,33 @@ Output update(float    tempK,
     return buildOutput(State::Fault, 0);
 }
 
-State getState() {
-    return currentState;
-}
-
-bool isRunning() {
-    return running;
-}
-
-uint32_t getOnStateDuration(){
+uint32_t Machine::getOnStateDuration() const {
     // If its not currently on, then return falsey
-    if (onStateMs == 0) return 0;
+    if (_onStateMs == 0) return 0;
 
     // If its currently off (determined by if it has a stop time), then return
     // the difference between the stop time and the start time
-    if (offStateMs != 0) return offStateMs - onStateMs;
+    if (_offStateMs != 0) return _offStateMs - _onStateMs;
 
     // No off state ms means its currently running. So get the time since it started.
-    return millis() - onStateMs;
+    return millis() - _onStateMs;
 }
 
-void start(uint32_t nowMs, float tempK) {
-    if (running == true) return;
-    running          = true;
-    onStateMs        = nowMs;
-    offStateMs       = 0;
-    faultReason      = FaultReason::None;
-    backoffCount     = 0;
-    backoffDacOffset = 0;
+void Machine::start(uint32_t nowMs, float tempK) {
+    if (_running == true) return;
+    _running          = true;
+    _onStateMs        = nowMs;
+    _offStateMs       = 0;
+    _faultReason      = FaultReason::None;
+    _backoffCount     = 0;
+    _backoffDacOffset = 0;
+    _fingerprint.stop();
+    resetControl();
 
     // Select the resumption state based on current cold-stage temperature.
     // This lets the system pick up where it left off after a reboot without
     // entering a cooldown state that would trigger a spurious stall fault.
-    if (tempK >= COARSE_FINE_THRESHOLD_K) {
+    if (tempK >= params::get(params::Id::CoarseFineK)) {
         // Warm start (or unknown temp): begin full cooldown sequence.
         enterState(State::CoarseCooldown, nowMs);
     } else if (overshot(tempK)) {
@@ -423,26 +516,84 @@ void start(uint32_t nowMs, float tempK) {
     }
 }
 
-void stop(uint32_t nowMs) {
-    if (running == false) return;
-    running     = false;
-    if (offStateMs == 0) offStateMs = nowMs;
-    faultReason = FaultReason::None;
+Snapshot Machine::snapshot(uint32_t nowMs) const {
+    Snapshot s;
+    s.state             = _state;
+    s.running           = _running;
+    s.settleTimerActive = _settleTimerActive;
+    s.backoffCount      = _backoffCount;
+    s.backoffDacOffset  = _backoffDacOffset;
+    s.timeInStateMs     = nowMs - _stateEntryMs;
+    s.onDurationMs      = (_onStateMs != 0 && _offStateMs == 0) ? nowMs - _onStateMs : 0;
+    s.settleElapsedMs   = _settleTimerActive ? nowMs - _settleStartMs : 0;
+    s.settleMinK        = _settleMinK;
+    s.settleMaxK        = _settleMaxK;
+    s.settleMinDac      = _settleMinDac;
+    s.settleMaxDac      = _settleMaxDac;
+    s.dacLoop           = _dacLoop;
+    s.rateFilter        = _rateFilter;
+    s.fingerprint       = _fingerprint;
+    return s;
+}
+
+bool Machine::resume(const Snapshot& s, uint32_t nowMs) {
+    if (_running || !s.running) return false;
+    if (s.state < State::CoarseCooldown || s.state > State::Operating) return false;
+
+    _running          = true;
+    _onStateMs        = nowMs - s.onDurationMs;
+    if (_onStateMs == 0) _onStateMs = 1;   // 0 means "never started"
+    _offStateMs       = 0;
+    _faultReason      = FaultReason::None;
+    _backoffCount     = s.backoffCount;
+    _backoffDacOffset = s.backoffDacOffset;
+    enterState(s.state, nowMs);
+
+    // Rebase the timers onto the new millis() and pick the loop up where
+    // it stopped: same gains, so no retune, and a fresh dt.
+    _stateEntryMs = nowMs - s.timeInStateMs;
+    _settleTimerActive   = (s.state == State::Settle) && s.settleTimerActive;
+    _settleStartMs       = _settleTimerActive ? nowMs - s.settleElapsedMs : 0;
+    _settleMinK          = s.settleMinK;
+    _settleMaxK          = s.settleMaxK;
+    _settleMinDac        = s.settleMinDac;
+    _settleMaxDac        = s.settleMaxDac;
+    _dacLoop             = s.dacLoop;
+    _rateFilter          = s.rateFilter;
+    _fingerprint         = s.fingerprint;
+    _activeGains         = &gainsFor(s.state);
+    _lastControlMs       = nowMs;
+    return true;
+}
+
+void Machine::stop(uint32_t nowMs) {
+    if (_running == false) return;
+    _running     = false;
+    if (_offStateMs == 0) _offStateMs = nowMs;
+    _faultReason = FaultReason::None;
     enterState(State::Idle, nowMs);
 }
 
-void off(uint32_t nowMs) {
-    if (currentState == State::Off) return;
-    running     = false;
-    if (offStateMs == 0) offStateMs = nowMs;
-    faultReason = FaultReason::None;
+void Machine::off(uint32_t nowMs) {
+    if (_state == State::Off) return;
+    _running     = false;
+    if (_offStateMs == 0) _offStateMs = nowMs;
+    _faultReason = FaultReason::None;
     enterState(State::Off, nowMs);
 }
 
-FaultReason getFaultReason() {
-    return faultReason;
+const char* Machine::getStatusText() const {
+    return statusText(_state, _faultReason);
+}
+
+uint32_t Machine::getTimeInState() const {
+    return millis() - _stateEntryMs;
 }
 
+// ---------------------------------------------------------------------------
+// Names and status text
+// ---------------------------------------------------------------------------
+
 const char* stateName(State s) {
     switch (s) {
         case State::Off:            return "Off";
@@ -459,12 +610,74 @@ const char* stateName(State s) {
     return "Unknown";
 }
 
-const char* getStatusText(){
-    return statusTextForState(getState());
+const char* faultReasonName(FaultReason r) {
+    switch (r) {
+        case FaultReason::None:             return "None";
+        case FaultReason::RmsOvervoltage:   return "RmsOvervoltage";
+        case FaultReason::TemperatureStall: return "TemperatureStall";
+        case FaultReason::TooManyBackoffs:  return "TooManyBackoffs";
+        case FaultReason::BaselineDeviation: return "BaselineDeviation";
+    }
+    return "Unknown";
 }
 
-uint32_t getTimeInState() {
-    return millis() - currentStateEntryMs;
+const char* statusText(State s, FaultReason r) {
+    switch (s) {
+        case State::Off:            return "System is off";
+        case State::Initialize:     return "Initial power up state";
+        case State::Idle:           return "Cold stage is warm; dewar is not cooling";
+        case State::CoarseCooldown: return "Cooling; cold stage is above 85K";
+        case State::FineCooldown:   return "Cooling; cold stage is below 85K";
+        case State::Overshoot:      return "Cold stage is cooler than set point; integrator is settling";
+        case State::Settle:         return "Cold stage temperature is settling; circuits switched to Normal";
+        case State::Baseline:       return "Cold stage temperature has settled; collecting baseline data";
+        case State::Operating:      return "System is operating normally; checking for deviations from baseline";
+        case State::Fault:
+            switch (r) {
+                case FaultReason::RmsOvervoltage:   return "Fault: RMS voltage exceeded safe limit";
+                case FaultReason::TemperatureStall: return "Fault: Temperature stalled during cooldown";
+                case FaultReason::TooManyBackoffs:  return "Fault: Too many back-EMF stroke events; output backed off";
+                case FaultReason::BaselineDeviation: return "Fault: Operation deviated from baseline";
+                default:                            return "Fault: Unknown reason";
+            }
+    }
+    return "Unknown state";
 }
 
+// ---------------------------------------------------------------------------
+// Single-channel API (primary())
+// ---------------------------------------------------------------------------
+
+static Machine primaryMachine;
+
+Machine& primary() {
+    return primaryMachine;
+}
+
+void init(uint32_t nowMs) { primary().init(nowMs); }
+
+Output update(float tempK, float coolingRate, float rmsVoltage, bool stalled, uint32_t nowMs,
+              bool overstroke, float currentA, uint16_t dacActual) {
+    return primary().update(tempK, coolingRate, rmsVoltage, stalled, nowMs,
+                            overstroke, currentA, dacActual);
+}
+
+void start(uint32_t nowMs, float tempK) { primary().start(nowMs, tempK); }
+void stop(uint32_t nowMs)               { primary().stop(nowMs); }
+void off(uint32_t nowMs)                { primary().off(nowMs); }
+
+bool     resume(const Snapshot& s, uint32_t nowMs) { return primary().resume(s, nowMs); }
+Snapshot snapshot(uint32_t nowMs)                  { return primary().snapshot(nowMs); }
+
+State       getState()           { return primary().getState(); }
+bool        isRunning()          { return primary().isRunning(); }
+FaultReason getFaultReason()     { return primary().getFaultReason(); }
+const char* getStatusText()      { return primary().getStatusText(); }
+uint32_t    getOnStateDuration() { return primary().getOnStateDuration(); }
+uint32_t    getTimeInState()     { return primary().getTimeInState(); }
+
+const baseline::Engine& getBaseline() { return primary().getBaseline(); }
+
+void setTransitionHook(TransitionHook hook) { primary().setTransitionHook(hook); }
+
 } // namespace state_machine
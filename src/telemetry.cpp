@@ -1,10 +1,19 @@
 /**
  * @file telemetry.cpp
- * @brief Serial Studio CSV telemetry implementation
+ * @brief Serial Studio CSV / compact binary telemetry implementation
+ *
+ * emit() (control task) → ring (SpscQueue<Frame>) → service()/drain()
+ * (telemetry task) → Serial.  The consumer formats at most one frame ahead:
+ * if the formatted frame does not fit in the TX space it is held in
+ * pendingBuf and retried on the next drain().  In binary mode a pending
+ * descriptor set is sent, one entry per pending slot, before any further
+ * sample frames.  CSV lines are rendered column by column from the FIELDS
+ * schema (telemetry_schema.h) with integer arithmetic only, straight into
+ * pendingBuf, and leave in a single write().
  */
 
-// emit() depends on Serial and hardware modules — target only.
-// enable()/disable()/isEnabled() are plain flag operations and compile everywhere.
+// emit() and service() depend on Serial and hardware modules — target only.
+// The ring, formatter and enable/disable flags compile everywhere.
 #include <Arduino.h>
 #include "temperature.h"
 #include "telemetry.h"
@@ -12,63 +21,595 @@
 #include "rms.h"
 #include "dac.h"
 #include "conversions.h"
+#include "spsc_queue.h"
+#include "frame_codec.h"
+#include "perf.h"
+
+#include <atomic>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
 
 namespace telemetry {
 
-static bool enabled = true;
+static bool            enabled = true;
+static volatile Format format  = Format::Csv;
+
+// ---------------------------------------------------------------------------
+// Ring and counters
+// ---------------------------------------------------------------------------
+
+static SpscQueue<Frame, TELEMETRY_RING_DEPTH> ring;
+
+static uint32_t submittedCount = 0;   // producer-owned
+static uint32_t droppedCount   = 0;   // producer-owned
+static uint32_t highWater      = 0;   // producer-owned
+static uint32_t sentCount      = 0;   // consumer-owned
+static uint16_t nextSeq        = 0;   // producer-owned
+
+// resetStats() from the console only posts these; each side zeroes its own
+// counters on its next submit() / drain(), so every counter keeps one writer.
+static std::atomic<bool> producerResetRequested{false};
+static std::atomic<bool> consumerResetRequested{false};
+
+// Formatted frame waiting for TX space (consumer-owned)
+static uint8_t pendingBuf[MAX_FRAME_LEN];
+static size_t  pendingLen = 0;
+static bool    pendingIsSample = false;
+
+// Schedule (see telemetry.h "Scheduling").  Written by console commands,
+// read by the producer (divisor) and consumer (mask, delta, keyframes).
+static volatile uint8_t  steadyDivisor     = TELEMETRY_STEADY_DIVISOR;
+static volatile uint32_t fieldMask         = FIELD_MASK_ALL;
+static volatile bool     deltaMode         = false;
+static volatile uint16_t keyframeInterval  = TELEMETRY_KEYFRAME_INTERVAL;
+static volatile bool     keyframeRequested = true;
+
+// Decimator (producer-owned)
+static state_machine::State lastSampledState = state_machine::State::Off;
+static uint8_t              ticksSinceSample = 0;
+static bool                 haveSampled      = false;
+
+// Delta reference (consumer-owned): last CSV frame formatted for output
+static Frame    lastSent{};
+static uint16_t framesSinceKeyframe = 0;
+
+// Second sink (see setTap()); called by the consumer
+static FrameTap frameTap = nullptr;
+
+// service() output in place of Serial (see setOutput())
+static Print* volatile outputSink = nullptr;
+
+// Descriptor set: requested from any task, streamed by the consumer
+static volatile bool descriptorRequested = false;
+static uint8_t       descriptorNext      = DESCRIPTOR_COUNT;   // none in progress
+
+// ---------------------------------------------------------------------------
+// Internal helpers
+// ---------------------------------------------------------------------------
+
+/** Bounded appender over a fixed char buffer; keeps one byte for the NUL. */
+struct LineWriter {
+    char*  buf;
+    size_t len;
+    size_t pos;
+    bool   ok;
+
+    void put(const char* s, size_t n) {
+        if (!ok) return;
+        if (n >= len - pos) { ok = false; return; }
+        memcpy(buf + pos, s, n);
+        pos += n;
+    }
+    void put(char c) { put(&c, 1); }
+
+    /** Decimal @p v, zero-padded to at least @p minDigits digits. */
+    void digits(uint64_t v, uint8_t minDigits = 1) {
+        char    tmp[20];
+        uint8_t n = 0;
+        if (v <= UINT32_MAX) {   // 32-bit division is native on the S3
+            uint32_t v32 = static_cast<uint32_t>(v);
+            do { tmp[sizeof(tmp) - 1u - n++] = static_cast<char>('0' + v32 % 10u); v32 /= 10u; }
+            while (v32 != 0 || n < minDigits);
+        } else {
+            do { tmp[sizeof(tmp) - 1u - n++] = static_cast<char>('0' + v % 10u); v /= 10u; }
+            while (v != 0 || n < minDigits);
+        }
+        put(tmp + sizeof(tmp) - n, n);
+    }
+
+    void signedDigits(int32_t v) {
+        if (v < 0) put('-');
+        digits(v < 0 ? 0u - static_cast<uint32_t>(v) : static_cast<uint32_t>(v));
+    }
+
+    /** @p v with @p decimals fractional digits, rounded half away from zero. */
+    void fixed(float v, uint8_t decimals) {
+        if (v != v) { put("nan", 3); return; }
+        const bool  neg = v < 0.0f;
+        const float mag = neg ? -v : v;
+        if (!(mag < 1.0e15f)) { put(neg ? "-inf" : "inf", neg ? 4u : 3u); return; }
+
+        uint64_t scale = 1;
+        for (uint8_t d = 0; d < decimals; ++d) scale *= 10u;
+        const uint64_t q = static_cast<uint64_t>(mag * static_cast<float>(scale) + 0.5f);
+        if (neg && q != 0) put('-');   // no "-0.00"
+        digits(q / scale);
+        if (decimals == 0) return;
+        put('.');
+        digits(q % scale, decimals);
+    }
+
+    /** Milliseconds as HH:MM:SS (hours keep growing past 99). */
+    void hms(uint32_t ms) {
+        const uint32_t sec = ms / 1000u;
+        digits(sec / 3600u, 2);
+        put(':');
+        digits((sec % 3600u) / 60u, 2);
+        put(':');
+        digits(sec % 60u, 2);
+    }
+};
+
+/** One column of a Frame; the member set follows the column's FieldKind. */
+struct Value {
+    int32_t     i;
+    uint32_t    u;
+    float       f;
+    const char* s;
+};
+
+/** CSV column @p column (1-based, see telemetry.h) of @p f. */
+static Value fieldValue(uint8_t column, const Frame& f) {
+    Value v{0, 0, 0.0f, nullptr};
+    switch (column) {
+        case 1:  v.i = static_cast<int32_t>(f.state);         break;
+        case 2:  v.s = state_machine::stateName(f.state);     break;
+        case 3:  v.s = f.statusText;                          break;
+        case 4:  v.f = f.tempK;                               break;
+        case 5:  v.f = f.tempC;                               break;
+        case 6:  v.f = f.ambientTempC;                        break;
+        case 7:  v.f = f.coolingRate;                         break;
+        case 8:  v.u = f.dacTarget;                           break;
+        case 9:  v.u = f.dacActual;                           break;
+        case 10: v.f = f.rmsV;                                break;
+        case 11: v.u = f.relayNormal ? 1u : 0u;               break;
+        case 12: v.u = f.alarmRelay ? 1u : 0u;                break;
+        case 13: v.u = f.redLed ? 1u : 0u;                    break;
+        case 14: v.u = f.greenLed ? 1u : 0u;                  break;
+        case 15: v.u = f.onDurationMs;                        break;
+        case 16: v.u = f.onDurationMs;                        break;
+        case 17: v.f = f.cooldownPct;                         break;
+        case 18: v.u = f.timeInStateMs;                       break;
+        case 19: v.f = f.currentA;                            break;
+        case 20: v.u = f.backoffCount;                        break;
+        case 21: v.i = f.ambientAgeMs;                        break;
+        case 22: v.i = f.etaS;                                break;
+        case 23: v.u = f.etaConfPct;                          break;
+        case 24: v.u = f.loopMaxUs;                           break;
+        default: break;
+    }
+    return v;
+}
+
+/** True if @p a and @p b render identically as a @p kind column. */
+static bool sameRendering(FieldKind kind, const Value& a, const Value& b) {
+    switch (kind) {
+        case FieldKind::Int:   return a.i == b.i;
+        case FieldKind::Uint:  return a.u == b.u;
+        case FieldKind::Fixed: return a.f == b.f;
+        case FieldKind::Text:  return a.s == b.s;   // static strings
+        case FieldKind::Hms:   return (a.u / 1000u) == (b.u / 1000u);
+    }
+    return false;
+}
+
+// Text column lengths, memoised on the string pointer: state and status
+// strings are static and change only with a state change (consumer-owned).
+struct TextCache {
+    const char* s;
+    size_t      len;
+};
+static TextCache textCache[SCHEMA_FIELD_COUNT];
+
+/** Render @p v as column @p spec. */
+static void appendValue(LineWriter& w, const FieldSpec& spec, const Value& v) {
+    switch (spec.kind) {
+        case FieldKind::Int:   w.signedDigits(v.i);           break;
+        case FieldKind::Uint:  w.digits(v.u);                 break;
+        case FieldKind::Fixed: w.fixed(v.f, spec.decimals);   break;
+        case FieldKind::Hms:   w.hms(v.u);                    break;
+        case FieldKind::Text: {
+            TextCache& c = textCache[spec.column - 1u];
+            if (c.s != v.s) {
+                c.s   = v.s;
+                c.len = (v.s != nullptr) ? strlen(v.s) : 0;
+            }
+            w.put(c.s, c.len);
+            break;
+        }
+    }
+}
+
+/** Little-endian byte writer over a fixed buffer. */
+struct Packer {
+    uint8_t* buf;
+    size_t   len;
+    size_t   pos;
+    bool     ok;
+
+    void u8(uint8_t v) {
+        if (pos >= len) { ok = false; return; }
+        buf[pos++] = v;
+    }
+    void u16(uint16_t v) { u8(static_cast<uint8_t>(v)); u8(static_cast<uint8_t>(v >> 8)); }
+    void u32(uint32_t v) { u16(static_cast<uint16_t>(v)); u16(static_cast<uint16_t>(v >> 16)); }
+    void str(const char* s) {
+        const size_t n = strlen(s);
+        const uint8_t l = static_cast<uint8_t>(n > 0xFFu ? 0xFFu : n);
+        u8(l);
+        for (uint8_t i = 0; i < l; ++i) u8(static_cast<uint8_t>(s[i]));
+    }
+};
+
+/** Round @p v / @p lsb to the nearest integer, saturated to [lo, hi]. */
+static int32_t scaled(float v, float lsb, int32_t lo, int32_t hi) {
+    const float q = roundf(v / lsb);
+    if (!(q >= static_cast<float>(lo))) return lo;   // also catches NaN
+    if (q >= static_cast<float>(hi))    return hi;
+    return static_cast<int32_t>(q);
+}
+
+/**
+ * Append CRC-16 to the @p payloadLen-byte payload in @p scratch, COBS-encode
+ * it into @p buf and terminate with 0x00.  Returns bytes written or 0.
+ */
+static size_t sealFrame(uint8_t* scratch, size_t payloadLen, uint8_t* buf, size_t len) {
+    const uint16_t crc = codec::crc16(scratch, payloadLen);
+    scratch[payloadLen]      = static_cast<uint8_t>(crc);
+    scratch[payloadLen + 1u] = static_cast<uint8_t>(crc >> 8);
+
+    if (len < 1u) return 0;
+    const size_t n = codec::cobsEncode(scratch, payloadLen + 2u, buf, len - 1u);
+    if (n == 0) return 0;
+    buf[n] = 0x00;
+    return n + 1u;
+}
+
+/** Format the next frame for the current mode into pendingBuf (consumer). */
+static bool loadPending() {
+    const bool binary = (format == Format::Binary);
+
+    if (descriptorRequested) {
+        descriptorRequested = false;
+        descriptorNext      = binary ? 0 : DESCRIPTOR_COUNT;
+    }
+    if (binary && descriptorNext < DESCRIPTOR_COUNT) {
+        pendingLen      = formatDescriptor(descriptorNext++, pendingBuf, sizeof(pendingBuf));
+        pendingIsSample = false;
+        return true;
+    }
+
+    Frame f;
+    if (!ring.pop(f)) return false;
+    if (frameTap != nullptr) frameTap(f);
+    pendingIsSample = true;
+    if (binary) {
+        pendingLen = formatBinaryFrame(f, pendingBuf, sizeof(pendingBuf));
+        return true;
+    }
+
+    // CSV: full keyframe, or only the delta fields that changed since lastSent
+    const uint16_t k   = keyframeInterval;
+    bool           key = !deltaMode || keyframeRequested || (k > 0 && framesSinceKeyframe + 1u >= k);
+    if (key) {
+        keyframeRequested   = false;
+        framesSinceKeyframe = 0;
+    } else {
+        ++framesSinceKeyframe;
+    }
+    pendingLen = formatFrame(f, reinterpret_cast<char*>(pendingBuf), sizeof(pendingBuf),
+                             fieldMask, key ? nullptr : &lastSent);
+    lastSent = f;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
 
 void disable()   { enabled = false; }
 void enable()    { enabled = true; }
 bool isEnabled() { return enabled; }
 
+/** Steady states tolerate decimation; everything else is sent every tick. */
+static bool isSteadyState(state_machine::State st) {
+    using state_machine::State;
+    return st == State::Off || st == State::Idle ||
+           st == State::Baseline || st == State::Operating;
+}
+
+bool sample(const Frame& frame) {
+    const bool stateChanged = !haveSampled || frame.state != lastSampledState;
+    const uint8_t divisor   = isSteadyState(frame.state) ? steadyDivisor : 1u;
+
+    haveSampled      = true;
+    lastSampledState = frame.state;
+    if (!stateChanged && ++ticksSinceSample < divisor) {
+        return false;
+    }
+    ticksSinceSample = 0;
+    return submit(frame);
+}
+
+bool submit(const Frame& frame) {
+    if (producerResetRequested.exchange(false, std::memory_order_acq_rel)) {
+        submittedCount = 0;
+        droppedCount   = 0;
+        highWater      = 0;
+    }
+    Frame stamped = frame;
+    stamped.seq   = nextSeq++;
+    ++submittedCount;
+    if (!ring.push(stamped)) {
+        ++droppedCount;
+        return false;
+    }
+    const uint32_t depth = ring.size();
+    if (depth > highWater) {
+        highWater = depth;
+    }
+    return true;
+}
+
+size_t formatFrame(const Frame& f, char* buf, size_t len,
+                   uint32_t fieldMask, const Frame* prev) {
+    // Serial Studio Quick-Plot frame: /*...*/\r\n
+    // FIELD_COUNT pipe-delimited fields as FIELDS describes (and the ssproj
+    // parser expects); masked or unchanged delta fields are left empty so
+    // column positions never move.
+    LineWriter w{buf, len, 0, true};
+    w.put("/*", 2);
+    for (uint8_t i = 0; i < FIELD_COUNT; ++i) {
+        const FieldSpec& spec = FIELDS[i];
+        if (i > 0) w.put('|');
+        if ((fieldMask & fieldBit(spec.column)) == 0) continue;
+        const Value v = fieldValue(spec.column, f);
+        if (prev != nullptr && spec.delta &&
+            sameRendering(spec.kind, v, fieldValue(spec.column, *prev))) continue;
+        appendValue(w, spec, v);
+    }
+    w.put("*/\r\n", 4);
+
+    if (!w.ok) return 0;
+    buf[w.pos] = '\0';
+    return w.pos;
+}
+
+size_t formatBinaryFrame(const Frame& f, uint8_t* buf, size_t len) {
+    uint8_t scratch[SAMPLE_PAYLOAD_LEN + 2u];
+    Packer  p{scratch, SAMPLE_PAYLOAD_LEN, 0, true};
+
+    const uint8_t flags = static_cast<uint8_t>(
+        (f.relayNormal       ? 0x01u : 0u) |
+        (f.alarmRelay        ? 0x02u : 0u) |
+        (f.redLed            ? 0x04u : 0u) |
+        (f.greenLed          ? 0x08u : 0u) |
+        (f.ambientAgeMs >= 0 ? 0x10u : 0u));
+    const uint16_t ambientAge = (f.ambientAgeMs < 0 || f.ambientAgeMs > 0xFFFF)
+        ? 0xFFFFu : static_cast<uint16_t>(f.ambientAgeMs);
+
+    p.u8(FRAME_TYPE_SAMPLE);
+    p.u8(BINARY_VERSION);
+    p.u16(f.seq);
+    p.u8(static_cast<uint8_t>(f.state));
+    p.u8(static_cast<uint8_t>(f.faultReason));
+    p.u8(flags);
+    p.u16(static_cast<uint16_t>(scaled(f.tempK,        0.01f,  0,      0xFFFF)));
+    p.u16(static_cast<uint16_t>(scaled(f.ambientTempC, 0.01f,  -32768, 32767)));
+    p.u16(static_cast<uint16_t>(scaled(f.coolingRate,  0.001f, -32768, 32767)));
+    p.u16(f.dacTarget);
+    p.u16(f.dacActual);
+    p.u16(static_cast<uint16_t>(scaled(f.rmsV,         0.01f,  0,      0xFFFF)));
+    p.u16(static_cast<uint16_t>(scaled(f.currentA,     0.001f, 0,      0xFFFF)));
+    p.u16(static_cast<uint16_t>(scaled(f.cooldownPct,  0.01f,  0,      0xFFFF)));
+    p.u16(f.backoffCount);
+    p.u16(ambientAge);
+    p.u32(f.onDurationMs);
+    p.u32(f.timeInStateMs);
+    p.u32(static_cast<uint32_t>(f.etaS));
+    p.u8(f.etaConfPct);
+
+    if (!p.ok || p.pos != SAMPLE_PAYLOAD_LEN) return 0;
+    return sealFrame(scratch, p.pos, buf, len);
+}
+
+size_t formatDescriptor(uint8_t index, uint8_t* buf, size_t len) {
+    using state_machine::State;
+    using state_machine::FaultReason;
+    if (index >= DESCRIPTOR_COUNT) return 0;
+
+    uint8_t kind;
+    int8_t  code;
+    const char* name;
+    const char* text;
+    if (index < state_machine::STATE_COUNT) {
+        const State st = static_cast<State>(static_cast<int8_t>(index) - 1);   // Off = -1
+        kind = 0;
+        code = static_cast<int8_t>(st);
+        name = state_machine::stateName(st);
+        text = state_machine::statusText(st, FaultReason::None);
+    } else {
+        const FaultReason r = static_cast<FaultReason>(index - state_machine::STATE_COUNT);
+        kind = 1;
+        code = static_cast<int8_t>(r);
+        name = state_machine::faultReasonName(r);
+        text = state_machine::statusText(State::Fault, r);
+    }
+
+    uint8_t scratch[MAX_FRAME_LEN / 2u];
+    Packer  p{scratch, sizeof(scratch) - 2u, 0, true};   // leave room for CRC
+    p.u8(FRAME_TYPE_DESCRIPTOR);
+    p.u8(BINARY_VERSION);
+    p.u8(index);
+    p.u8(DESCRIPTOR_COUNT);
+    p.u8(kind);
+    p.u8(static_cast<uint8_t>(code));
+    p.str(name);
+    p.str(text);
+
+    if (!p.ok) return 0;
+    return sealFrame(scratch, p.pos, buf, len);
+}
+
+uint32_t drain(Print& out, size_t txSpace) {
+    if (consumerResetRequested.exchange(false, std::memory_order_acq_rel)) {
+        sentCount = 0;
+    }
+    uint32_t written = 0;
+    for (;;) {
+        if (pendingLen == 0) {
+            if (!loadPending()) break;
+            if (pendingLen == 0) continue;   // unformattable; discard
+        }
+        if (pendingLen > txSpace) break;     // retry once the host catches up
+
+        out.write(pendingBuf, pendingLen);
+        txSpace   -= pendingLen;
+        pendingLen = 0;
+        if (pendingIsSample) {
+            ++sentCount;
+            ++written;
+        }
+    }
+    return written;
+}
+
+#ifdef ARDUINO
+/** USB output while no host is attached, so the tap still sees every frame. */
+class DiscardPrint : public Print {
+public:
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t*, size_t n) override { return n; }
+};
+
+static DiscardPrint discard;
+#endif
+
+void service() {
+#ifdef ARDUINO
+    Print* sink = outputSink;
+    if (sink != nullptr) {
+        const int room = sink->availableForWrite();
+        drain(*sink, room > 0 ? static_cast<size_t>(room) : 0u);
+    } else if (Serial || frameTap == nullptr) {
+        drain(Serial, static_cast<size_t>(Serial.availableForWrite()));
+    } else {
+        drain(discard, SIZE_MAX);
+    }
+#endif
+}
+
+void setTap(FrameTap tap) { frameTap = tap; }
+
+void setOutput(Print* out) { outputSink = out; }
+
+void setFormat(Format f) {
+    if (f == Format::Binary && format != Format::Binary) {
+        descriptorRequested = true;
+    }
+    format            = f;
+    keyframeRequested = true;
+}
+
+Format getFormat() { return format; }
+
+void setSteadyDivisor(uint8_t n) { steadyDivisor = (n < 1u) ? 1u : n; }
+uint8_t getSteadyDivisor() { return steadyDivisor; }
+
+void setFieldMask(uint32_t mask) {
+    fieldMask         = mask & FIELD_MASK_ALL;
+    keyframeRequested = true;
+}
+uint32_t getFieldMask() { return fieldMask; }
+
+void setDeltaMode(bool on) {
+    deltaMode         = on;
+    keyframeRequested = true;
+}
+bool isDeltaMode() { return deltaMode; }
+
+void setKeyframeInterval(uint16_t k) { keyframeInterval = k; }
+uint16_t getKeyframeInterval() { return keyframeInterval; }
+
+void resetSchedule() {
+    steadyDivisor     = TELEMETRY_STEADY_DIVISOR;
+    fieldMask         = FIELD_MASK_ALL;
+    deltaMode         = false;
+    keyframeInterval  = TELEMETRY_KEYFRAME_INTERVAL;
+    keyframeRequested = true;
+    haveSampled       = false;
+    ticksSinceSample  = 0;
+}
+
+void requestDescriptor() {
+    if (format == Format::Binary) {
+        descriptorRequested = true;
+    }
+}
+
+Stats getStats() {
+    // A reset not yet applied already reads as zero
+    const bool producerReset = producerResetRequested.load(std::memory_order_acquire);
+    const bool consumerReset = consumerResetRequested.load(std::memory_order_acquire);
+    Stats s{};
+    s.submitted = producerReset ? 0u : submittedCount;
+    s.sent      = consumerReset ? 0u : sentCount;
+    s.dropped   = producerReset ? 0u : droppedCount;
+    s.highWater = producerReset ? 0u : highWater;
+    s.capacity  = ring.capacity();
+    return s;
+}
+
+void resetStats() {
+    producerResetRequested.store(true, std::memory_order_release);
+    consumerResetRequested.store(true, std::memory_order_release);
+}
+
 void emit(const state_machine::Output& out)
 {
 #ifdef ARDUINO
     if (!enabled) return;
 
-    const uint16_t dacActual  = dac::getCurrent();
-
-    // On-state duration (total time running since start())
-    const uint32_t durationMs = state_machine::getOnStateDuration();
-    const uint32_t durSec     = durationMs / 1000u;
-    char hmsBuf[12];
-    snprintf(hmsBuf, sizeof(hmsBuf), "%02lu:%02lu:%02lu",
-             static_cast<unsigned long>(durSec / 3600u),
-             static_cast<unsigned long>((durSec % 3600u) / 60u),
-             static_cast<unsigned long>(durSec % 60u));
-
-    // Time in current state (resets on every state transition)
-    const uint32_t stateMs  = state_machine::getTimeInState();
-    const uint32_t stateSec = stateMs / 1000u;
-    char tisHmsBuf[12];
-    snprintf(tisHmsBuf, sizeof(tisHmsBuf), "%02lu:%02lu:%02lu",
-             static_cast<unsigned long>(stateSec / 3600u),
-             static_cast<unsigned long>((stateSec % 3600u) / 60u),
-             static_cast<unsigned long>(stateSec % 60u));
+    Frame f{};
+    f.state         = out.state;
+    f.faultReason   = state_machine::getFaultReason();
+    f.statusText    = out.statusText;
+    f.tempK         = temperature::getLastTempK();
+    f.tempC         = temperature::getLastTempC();
+    f.ambientTempC  = temperature::getLastAmbientTempC();
+    f.coolingRate   = temperature::getCoolingRateKPerMin();
+    f.dacTarget     = out.dacTarget;
+    f.dacActual     = dac::getCurrent();
+    f.rmsV          = rms::getVoltage();
+    f.relayNormal   = !out.bypassRelay;
+    f.alarmRelay    = out.alarmRelay;
+    f.redLed        = indicator::isFaultOn();
+    f.greenLed      = indicator::isReadyOn();
+    f.onDurationMs  = state_machine::getOnStateDuration();
+    f.cooldownPct   = temperature::getTemperatureToPercent();
+    f.timeInStateMs = state_machine::getTimeInState();
+    f.currentA      = rms::getCurrentA();
+    f.backoffCount  = out.backoffCount;
+    f.ambientAgeMs  = temperature::hasAmbient()
+        ? static_cast<int32_t>(temperature::getAmbientAgeMs(millis()))
+        : -1;
+    const temperature::Eta eta = temperature::getCooldownEta(out.state, millis());
+    f.etaS          = eta.etaS;
+    f.etaConfPct    = eta.confidencePct;
+    f.loopMaxUs     = perf::probe(perf::Probe::ControlPass).takePeak() / perf::clockMHz();
 
-    // Serial Studio Quick-Plot frame: /*...*/\r\n
-    // 19 pipe-delimited fields matching Cryocooler.ssproj parser
-    Serial.printf("/*%d|%s|%s|%.2f|%.2f|%.2f|%.3f|%u|%u|%.2f|%u|%u|%d|%d|%lu|%s|%.2f|%s|%.2f|%u*/\r\n",
-                  static_cast<int8_t>(out.state),           //  1 state_no
-                  state_machine::stateName(out.state),       //  2 state_name
-                  state_machine::getStatusText(),            //  3 status_text
-                  temperature::getLastTempK(),               //  4 temp_k
-                  temperature::getLastTempC(),               //  5 temp_c
-                  temperature::getLastAmbientTempC(),        //  6 ambient_temp_c
-                  temperature::getCoolingRateKPerMin(),      //  6 cooling_rate
-                  static_cast<unsigned>(out.dacTarget),      //  7 dac_target
-                  static_cast<unsigned>(dacActual),          //  8 dac_actual
-                  rms::getVoltage(),                         //  9 rms_v
-                  static_cast<uint8_t>(!out.bypassRelay),   // 10 relay_normal (1=Normal)
-                  static_cast<uint8_t>(out.alarmRelay),     // 11 alarm_relay
-                  indicator::isFaultOn(),                    // 12 red_led
-                  indicator::isReadyOn(),                    // 13 green_led
-                  static_cast<unsigned long>(durationMs),   // 14 on_duration_ms
-                  hmsBuf,                                    // 15 on_duration HH:MM:SS
-                  temperature::getTemperatureToPercent(),   // 16 cooldown_percent
-                  tisHmsBuf,                                 // 17 time_in_state HH:MM:SS
-                  rms::getCurrentA(),                        // 18 current_a (amps)
-                  static_cast<unsigned>(out.backoffCount));  // 19 backoff_count
+    sample(f);
 #else
     (void)out;
 #endif
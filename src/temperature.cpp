@@ -2,8 +2,31 @@
  * @file temperature.cpp
  * @brief MAX31865 RTD temperature sensor implementation
  *
- * Maintains a ring buffer of (timestamp, tempK) samples for cooling-rate
- * calculation and temperature-stall detection.
+ * Maintains a two-resolution sample history (temp_history.h): a short
+ * full-rate ring for the cooling rate and a ring of 10 s means spanning the
+ * stall window, both updated in O(1) per read().  Ambient gets its own
+ * once-a-minute ring rather than riding along in every cold-stage sample.
+ * read() also feeds the cooldown fit (cooldown_eta.h), which costs a few
+ * adds per reading and one 2×2 RLS step per ETA_SAMPLE_MS.
+ *
+ * With RTD_AUTO_CONVERT the MAX31865 free-runs: bias stays on, the filter
+ * notch matches the drive frequency and a new code lands every 16.7 / 20 ms.
+ * read() polls DRDY and, when a result is waiting, fetches the RTD MSB/LSB
+ * registers in one ~30 µs SPI transaction instead of the Adafruit one-shot
+ * readRTD() (bias on, 10 ms settle, 65 ms conversion, bias off — all
+ * blocking delay()).  The 15-bit code goes straight through a constexpr
+ * lookup table (rtd_lut.h) with integer interpolation — no float CVD solve.
+ *
+ * The DS18B20 ambient sensor runs split-phase, decoupled from read():
+ *
+ *   Idle ──(interval elapsed)──▶ Converting ──(complete)──▶ Idle (publish)
+ *                                    │
+ *                                    └──(timeout)──────────▶ Idle (keep old)
+ *
+ * DallasTemperature is put in setWaitForConversion(false) mode, so
+ * requestTemperatures() only issues the Convert T command and returns.
+ * Completion is polled once the nominal conversion time has elapsed, which
+ * keeps 1-Wire traffic to a handful of read slots per conversion.
  */
 
 #include <Arduino.h>
@@ -15,56 +38,96 @@
 #include "config.h"
 #include "temperature.h"
 #include "conversions.h"
+#include "cooldown_eta.h"
+#include "params.h"
+#include "rtd_lut.h"
+#include "temp_history.h"
+#include "spi_bus.h"
 
 // ---------------------------------------------------------------------------
 // Module-private types and state
 // ---------------------------------------------------------------------------
 
-
-struct TempSample {
-    uint32_t timestampMs;
-    float    tempK;
-    float    ambientTempC;
-};
-
 static Adafruit_MAX31865 max31865(MAX31865_CS);
 
-// Ring buffer - fixed size determined by TEMP_HISTORY_SIZE
-static TempSample  history[TEMP_HISTORY_SIZE];
-static uint8_t     head         = 0;   // index of next write position
-static uint8_t     count        = 0;   // number of valid samples stored
+// Code → milli-kelvin table, evaluated by the compiler and placed in flash.
+static constexpr rtd::RtdLut RTD_LUT =
+    rtd::makeRtdLut(RTD_CURVE, RTD_RREF, RTD_LUT_MIN_K, RTD_LUT_MAX_K);
+
+// Fine ring of TEMP_HISTORY_SIZE samples, coarse ring over the stall window
+static temperature::ColdHistory    history(STALL_BUCKET_MS, STALL_DETECT_WINDOW_MS);
+static temperature::AmbientHistory ambientHistory;
+static CooldownEta                 cooldownEta(ETA_SAMPLE_MS, ETA_FORGETTING, ETA_MIN_SAMPLES, ETA_MAX_S);
+static uint32_t                    ambientHistoryMs = 0;   // timestamp of newest ambient entry
+static bool         rtdFaultBit  = false;   // fault flag (bit 0) of the last RTD code
+static uint32_t     lastRtdFetchMs = 0;     // nowMs of the last auto-convert fetch
 static float       lastTempK    = 0.0f;
 static float       lastTempC    = 0.0f;
 static float       lastAmbientTempC = 0.0f;
 
+// Split-phase ambient conversion state
+enum class AmbientPhase : uint8_t { Idle, Converting };
+
+static AmbientPhase ambientPhase        = AmbientPhase::Idle;
+static uint32_t     ambientRequestMs    = 0;      // millis() of last Convert T
+static uint32_t     ambientPublishedMs  = 0;      // millis() of last valid result
+static uint32_t     ambientConversionMs = 750;    // nominal; refined in init()
+static bool         ambientRequested    = false;  // at least one Convert T issued
+static bool         ambientValid        = false;  // at least one valid result
+
 
 OneWire oneWire(ONE_WIRE_BUS);
 DallasTemperature sensors(&oneWire);
+
 // ---------------------------------------------------------------------------
-// Internal helpers
+// Direct MAX31865 register access (auto-convert mode)
 // ---------------------------------------------------------------------------
 
-static void pushSample(uint32_t nowMs, float tempK, float ambientTempC) {
-    history[head].timestampMs = nowMs;
-    history[head].tempK       = tempK;
-    history[head].ambientTempC = ambientTempC;
-    head = static_cast<uint8_t>((head + 1) % TEMP_HISTORY_SIZE);
-    if (count < TEMP_HISTORY_SIZE) {
-        ++count;
-    }
+static constexpr uint8_t MAX31865_REG_RTD_MSB    = 0x01;
+static constexpr uint8_t MAX31865_REG_FAULT_STAT = 0x07;
+
+/** Read @p n (<= 2) consecutive registers starting at @p addr in one transaction. */
+static void readRegisters(uint8_t addr, uint8_t* buf, uint8_t n) {
+    const uint8_t tx[3] = {static_cast<uint8_t>(addr & 0x7F), 0xFF, 0xFF};   // bit 7 clear = read
+    uint8_t       rx[3];
+    spi_bus::transfer(spi_bus::Device::Rtd, tx, rx, static_cast<uint8_t>(n + 1u));
+    for (uint8_t i = 0; i < n; ++i) { buf[i] = rx[i + 1]; }
 }
 
+#if MAX31865_DRDY >= 0
+// One auto-convert period, rounded up (see RTD_FILTER_50HZ)
+static constexpr uint32_t RTD_CONVERSION_MS   = RTD_FILTER_50HZ ? 20u : 17u;
+static constexpr uint32_t RTD_DRDY_TIMEOUT_MS = RTD_DRDY_TIMEOUT_CONVERSIONS * RTD_CONVERSION_MS;
+static bool               drdyTimeoutReported = false;
+#endif
+
 /**
- * Return a reference to the sample at logical index @p i
- * (0 = oldest, count-1 = newest).
+ * True when a conversion has finished since the last RTD register read, or
+ * when DRDY has stayed high past RTD_DRDY_TIMEOUT_MS since that read.
  */
-static const TempSample& sampleAt(uint8_t i) {
-    // oldest slot in the ring is (head - count + i) mod SIZE
-    auto idx = static_cast<uint8_t>(
-        (head + TEMP_HISTORY_SIZE - count + i) % TEMP_HISTORY_SIZE);
-    return history[idx];
+static bool rtdReady(uint32_t nowMs) {
+#if MAX31865_DRDY >= 0
+    if (digitalRead(MAX31865_DRDY) == LOW) return true;
+    if ((nowMs - lastRtdFetchMs) < RTD_DRDY_TIMEOUT_MS) return false;
+    if (!drdyTimeoutReported) {
+        Serial.println("WARNING: MAX31865 DRDY not asserting; reading without it.");
+        drdyTimeoutReported = true;
+    }
+    return true;
+#else
+    (void)nowMs;
+    return true;   // paced by RTD_READ_INTERVAL_MS > conversion time
+#endif
 }
 
+/** Latest 15-bit RTD code; records the fault flag in rtdFaultBit. */
+static uint16_t fetchRtdCode() {
+    uint8_t raw[2];
+    readRegisters(MAX31865_REG_RTD_MSB, raw, 2);
+    const uint16_t word = static_cast<uint16_t>((raw[0] << 8) | raw[1]);
+    rtdFaultBit = (word & 0x0001u) != 0;
+    return static_cast<uint16_t>(word >> 1);
+}
 // ---------------------------------------------------------------------------
 // Public API
 // ---------------------------------------------------------------------------
@@ -72,6 +135,18 @@ static const TempSample& sampleAt(uint8_t i) {
 namespace temperature {
 
 void init() {
+    // Ambient sensor: asynchronous conversions so requestTemperatures()
+    // never stalls the control loop.  Set up before the MAX31865 so a
+    // missing RTD does not also disable ambient readings.
+    sensors.begin();
+    sensors.setWaitForConversion(false);
+    ambientConversionMs = static_cast<uint32_t>(
+        sensors.millisToWaitForConversion(sensors.getResolution()));
+    ambientPhase     = AmbientPhase::Idle;
+    ambientRequested = false;
+    ambientValid     = false;
+
+    spi_bus::Claim bus(spi_bus::Device::Rtd);
     if (!max31865.begin(RTD_WIRE_CONFIG)) {
         Serial.println("Could not initialize MAX31865! Check wiring.");
         // Non-blocking: continue anyway; the state machine will see tempK == 0
@@ -90,37 +165,100 @@ void init() {
         Serial.println("MAX31865 initialized successfully!");
     }
 
+#if RTD_AUTO_CONVERT
+    // readRTD() above left bias off; switch to free-running conversions.
+#  if MAX31865_DRDY >= 0
+    pinMode(MAX31865_DRDY, INPUT_PULLUP);
+#  endif
+    max31865.enable50Hz(RTD_FILTER_50HZ);
+    max31865.enableBias(true);
+    max31865.autoConvert(true);
+#endif
+
     analogReadResolution(12);
-    sensors.begin();
 }
 
 void read(uint32_t nowMs) {
-    const uint16_t rtd          = max31865.readRTD();
-    const float    resistance   = conversions::rtdRawToResistance(rtd, RTD_RREF);
-    const float    tempC        = max31865.temperature(RTD_RNOMINAL, RTD_RREF);
-    const float    tempK        = conversions::celsiusToKelvin(tempC);
-    const float    tempF        = conversions::celsiusToFahrenheit(tempC);
-    const float    ambientTempC = readAmbientTemperature();
-
-    lastTempC = tempC;
-    lastTempK = tempK;
-    lastAmbientTempC = ambientTempC;
-    pushSample(nowMs, tempK, ambientTempC);
+#if RTD_AUTO_CONVERT
+    if (!rtdReady(nowMs)) return;   // same conversion as last time
+    lastRtdFetchMs        = nowMs;
+    const uint16_t rtd    = fetchRtdCode();
+#else
+    uint16_t rtd;
+    {
+        spi_bus::Claim bus(spi_bus::Device::Rtd);
+        rtd = max31865.readRTD();
+    }
+#endif
+    const int32_t  milliK = rtd::lookupMilliK(RTD_LUT, rtd);
+    const float    tempK  = static_cast<float>(milliK) * 0.001f;
 
-    //Serial.printf("RTD raw: %u  Resistance: %.2f Ohm  Temp: %.2f C / %.2f F / %.2f K\n",
-    //              rtd, resistance, tempC, tempF, tempK);
+    lastTempK = tempK;
+    lastTempC = tempK - 273.15f;
+    history.push(nowMs, tempK);
+    cooldownEta.update(nowMs, tempK, params::get(params::Id::SetpointK) +
+                                     params::get(params::Id::SetpointToleranceK));
 }
 
-float readAmbientTemperature() {
-    sensors.requestTemperatures(); // Send the command to get temperatures
-    if (sensors.getDeviceCount() > 0) {
-        return sensors.getTempCByIndex(0);
+void serviceAmbient(uint32_t nowMs) {
+    switch (ambientPhase) {
+        case AmbientPhase::Idle:
+            if (ambientRequested &&
+                (nowMs - ambientRequestMs) < AMBIENT_READ_INTERVAL_MS) {
+                return;
+            }
+            ambientRequestMs = nowMs;
+            ambientRequested = true;
+            if (sensors.getDeviceCount() == 0) {
+                return;   // nothing on the bus; retry next interval
+            }
+            sensors.requestTemperatures();   // returns immediately
+            ambientPhase = AmbientPhase::Converting;
+            return;
+
+        case AmbientPhase::Converting: {
+            const uint32_t elapsed = nowMs - ambientRequestMs;
+            if (elapsed < ambientConversionMs) {
+                return;   // cannot be done yet; don't touch the bus
+            }
+            if (!sensors.isConversionComplete()) {
+                if (elapsed >= AMBIENT_CONVERSION_TIMEOUT_MS) {
+                    ambientPhase = AmbientPhase::Idle;
+                }
+                return;
+            }
+
+            ambientPhase = AmbientPhase::Idle;
+            const float tempC = sensors.getTempCByIndex(0);
+            if (tempC == DEVICE_DISCONNECTED_C) {
+                return;   // CRC / presence failure; keep last valid value
+            }
+            lastAmbientTempC   = tempC;
+            ambientPublishedMs = nowMs;
+            ambientValid       = true;
+            if (ambientHistory.empty() ||
+                (nowMs - ambientHistoryMs) >= AMBIENT_HISTORY_INTERVAL_MS) {
+                ambientHistory.push(nowMs, tempC + 273.15f);
+                ambientHistoryMs = nowMs;
+            }
+            return;
+        }
     }
-    return 0.0f;
 }
 
 void checkFaults() {
-    const uint8_t fault = max31865.readFault();
+#if RTD_AUTO_CONVERT
+    if (!rtdFaultBit) return;
+    uint8_t fault = 0;
+    readRegisters(MAX31865_REG_FAULT_STAT, &fault, 1);
+    rtdFaultBit = false;
+#else
+    uint8_t fault;
+    {
+        spi_bus::Claim bus(spi_bus::Device::Rtd);
+        fault = max31865.readFault();
+    }
+#endif
     if (fault == 0) return;
 
     Serial.printf("Fault detected! Code: 0x%02X\n", fault);
@@ -132,6 +270,7 @@ void checkFaults() {
     if (fault & MAX31865_FAULT_RTDINLOW)    Serial.println("  - RTDIN- < 0.85 x Bias - FORCE- open");
     if (fault & MAX31865_FAULT_OVUV)        Serial.println("  - Under/Over voltage");
 
+    spi_bus::Claim bus(spi_bus::Device::Rtd);
     max31865.clearFault();
 }
 
@@ -147,59 +286,65 @@ float getLastAmbientTempC() {
     return lastAmbientTempC;
 }
 
+bool hasAmbient() {
+    return ambientValid;
+}
+
+uint32_t getAmbientAgeMs(uint32_t nowMs) {
+    return ambientValid ? (nowMs - ambientPublishedMs) : 0;
+}
+
 float getCoolingRateKPerMin() {
-    if (count < 2) return 0.0f;
+    return history.coolingRateKPerMin();
+}
 
-    const auto& oldest = sampleAt(0);
-    const auto& newest = sampleAt(static_cast<uint8_t>(count - 1));
+bool isStalled() {
+    return history.stalled(STALL_MIN_DROP_K);
+}
 
-    const uint32_t dtMs = newest.timestampMs - oldest.timestampMs;
-    if (dtMs == 0) return 0.0f;
+void restartStallWindow() {
+    history.restartStallWindow();
+}
 
-    // Positive result = temperature is decreasing (cooling)
-    const float dTempK    = oldest.tempK - newest.tempK;
-    const float dtMinutes = static_cast<float>(dtMs) / 60000.0f;
-    return dTempK / dtMinutes;
+void restartCooldownEta() {
+    cooldownEta.reset();
 }
 
-bool isStalled() {
-  return false;
-    if (count < 2) return false;
-
-    const auto& newest = sampleAt(static_cast<uint8_t>(count - 1));
-    const uint32_t windowStart = (newest.timestampMs >= STALL_DETECT_WINDOW_MS)
-                                 ? newest.timestampMs - STALL_DETECT_WINDOW_MS
-                                 : 0;
-
-    // Find the oldest sample within the detection window
-    float refTempK = newest.tempK;
-    for (uint8_t i = 0; i < count; ++i) {
-        const auto& s = sampleAt(i);
-        if (s.timestampMs >= windowStart) {
-            refTempK = s.tempK;
-            break;
-        }
+Eta getCooldownEta(state_machine::State s, uint32_t nowMs) {
+    using state_machine::State;
+    switch (s) {
+        case State::CoarseCooldown:
+        case State::FineCooldown:
+            return cooldownEta.estimate(nowMs);
+        case State::Overshoot:
+        case State::Settle:
+        case State::Baseline:
+        case State::Operating:
+            return {0, 100};
+        default:
+            return {-1, 0};
     }
+}
+
+const ColdHistory& getHistory() {
+    return history;
+}
 
-    // Stalled if the drop within the window is below the minimum threshold
-    const float drop = refTempK - newest.tempK;
-    return (drop < STALL_MIN_DROP_K);
+const AmbientHistory& getAmbientHistory() {
+    return ambientHistory;
 }
 
 float getTemperatureToPercent()
 {
     const float tempK = getLastTempK();
     const float T_MAX = AMBIENT_START_K;
-    const float T_MIN = SETPOINT_K;
+    const float T_MIN = params::get(params::Id::SetpointK);
 
-    // Clamp temperature
-    //if (tempK >= T_MAX) return 0.0;
-    //if (tempK <= T_MIN) return 100.0;
+    if (tempK >= T_MAX) return 0.0f;
+    if (tempK <= T_MIN) return 100.0f;
 
     // Linear interpolation
-    float percent = (T_MAX - tempK) / (T_MAX - T_MIN) * 100.0;
-
-    return percent;
+    return (T_MAX - tempK) / (T_MAX - T_MIN) * 100.0f;
 }
 
 } // namespace temperature
@@ -0,0 +1,113 @@
+/**
+ * @file warm_restart.cpp
+ * @brief RTC-memory control checkpoint implementation
+ */
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <math.h>
+#include <stddef.h>
+
+#include "config.h"
+#include "dac.h"
+#include "frame_codec.h"
+#include "warm_restart.h"
+
+namespace warm_restart {
+
+// ---------------------------------------------------------------------------
+// Checkpoint slots (RTC slow memory, not cleared by a warm reset)
+// ---------------------------------------------------------------------------
+
+static constexpr uint32_t MAGIC   = 0x43525753u;   // "SWRC"
+static constexpr uint16_t VERSION = 2;             // bump when Snapshot changes
+
+struct Slot {
+    uint32_t                magic;
+    uint16_t                version;
+    uint16_t                size;      // sizeof(Snapshot) when written
+    uint32_t                seq;
+    float                   tempK;
+    uint16_t                dacActual;
+    state_machine::Snapshot snapshot;
+    uint16_t                crc;       // CRC-16 of everything above
+};
+
+static RTC_NOINIT_ATTR Slot slots[2];
+
+static uint32_t nextSeq = 0;   // continues from the restored slot
+
+static uint16_t slotCrc(const Slot& s) {
+    return codec::crc16(reinterpret_cast<const uint8_t*>(&s), offsetof(Slot, crc));
+}
+
+static bool slotValid(const Slot& s) {
+    return s.magic == MAGIC && s.version == VERSION &&
+           s.size == sizeof(state_machine::Snapshot) && s.crc == slotCrc(s);
+}
+
+/** Newest valid slot, or nullptr. */
+static const Slot* newest() {
+    const bool a = slotValid(slots[0]);
+    const bool b = slotValid(slots[1]);
+    if (a && b) return (slots[1].seq - slots[0].seq) < 0x80000000u ? &slots[1] : &slots[0];
+    if (a) return &slots[0];
+    if (b) return &slots[1];
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+void checkpoint(const state_machine::Snapshot& s, float tempK, uint16_t dacActual) {
+    // Overwrite the older slot; the other stays valid until this one is
+    Slot& slot     = slots[nextSeq & 1u];
+    slot.magic     = MAGIC;
+    slot.version   = VERSION;
+    slot.size      = static_cast<uint16_t>(sizeof(state_machine::Snapshot));
+    slot.seq       = nextSeq++;
+    slot.tempK     = tempK;
+    slot.dacActual = dacActual;
+    slot.snapshot  = s;
+    slot.crc       = slotCrc(slot);
+}
+
+Result restore(uint32_t nowMs, float tempK) {
+    const esp_reset_reason_t reason = esp_reset_reason();
+    if (reason == ESP_RST_POWERON || reason == ESP_RST_UNKNOWN) {
+        return Result::ColdBoot;
+    }
+
+    const Slot* slot = newest();
+    if (slot == nullptr) return Result::NoSnapshot;
+    nextSeq = slot->seq + 1u;
+
+    const state_machine::Snapshot& snap = slot->snapshot;
+    if (!snap.running) return Result::NotRunning;
+
+    if (tempK <= 0.0f) return Result::NoReading;    // stay Off
+    if (fabsf(tempK - slot->tempK) > WARM_RESTART_MAX_TEMP_DELTA_K ||
+        !state_machine::resume(snap, nowMs)) {
+        state_machine::start(nowMs, tempK);
+        return Result::Restarted;
+    }
+
+    dac::restore(slot->dacActual);
+    return Result::Resumed;
+}
+
+const char* resultName(Result r) {
+    switch (r) {
+        case Result::ColdBoot:   return "cold boot";
+        case Result::NoSnapshot: return "no snapshot";
+        case Result::NotRunning: return "was not running";
+        case Result::NoReading:  return "no RTD reading";
+        case Result::Restarted:  return "temperature moved, restarted";
+        case Result::Resumed:    return "resumed";
+    }
+    return "?";
+}
+
+} // namespace warm_restart
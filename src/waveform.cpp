@@ -9,12 +9,14 @@
 #include "pin_config.h"
 #include "config.h"
 #include "waveform.h"
+#include "spi_bus.h"
 
 static MD_AD9833 ad9833(AD9833_CS);
 
 namespace waveform {
 
 void init() {
+    spi_bus::Claim bus(spi_bus::Device::Waveform);
     ad9833.begin();
     ad9833.setMode(MD_AD9833::MODE_SINE);
     ad9833.setFrequency(MD_AD9833::CHAN_0, AD9833_FREQ_HZ);
@@ -0,0 +1,216 @@
+/**
+ * @file bench_cases.h
+ * @brief Benchmark harness and cases shared by the native and on-target
+ *        benchmark suites
+ *
+ * Included by test/test_bench/ (host, against the native stubs) and
+ * test/test_embedded_bench/ (ESP32-S3).  Each case times one operation per
+ * iteration with perf::cycles() — nanoseconds on the host, CPU cycles on
+ * target — into a perf::Histogram, then reports one machine-readable line:
+ *
+ *   BENCH {"bench":"fsm_update","unit":"ns","iters":108000,
+ *          "min":41,"mean":63,"p99":95,"max":2210}
+ *
+ * Strip the "BENCH " prefix to get one JSON object per line, e.g.
+ *   pio test -e native_bench | grep '^BENCH ' | cut -c7- > bench.jsonl
+ * and compare runs by bench name.  p99 is the upper edge of its histogram
+ * bucket (within 25 %, see perf.h).
+ */
+
+#ifndef BENCH_CASES_H
+#define BENCH_CASES_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "conversions.h"
+#include "perf.h"
+#include "rtd_curves.h"
+#include "rtd_lut.h"
+#include "serial_commands.h"
+#include "state_machine.h"
+#include "telemetry.h"
+
+namespace bench {
+
+/** Sink for bench output lines (printf on host, Serial on target). */
+using WriteFn = void (*)(const char* line);
+
+/** One benchmark's summary. */
+struct Result {
+    const char* name;
+    uint32_t    iters;
+    uint32_t    min;
+    uint32_t    mean;
+    uint32_t    p99;
+    uint32_t    max;
+};
+
+inline const char* unit() {
+#ifdef ARDUINO
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+/** Format @p r as one BENCH line and pass it to @p write. */
+inline void report(const Result& r, WriteFn write) {
+    char line[192];
+    snprintf(line, sizeof(line),
+             "BENCH {\"bench\":\"%s\",\"unit\":\"%s\",\"iters\":%lu,"
+             "\"min\":%lu,\"mean\":%lu,\"p99\":%lu,\"max\":%lu}",
+             r.name, unit(), static_cast<unsigned long>(r.iters),
+             static_cast<unsigned long>(r.min), static_cast<unsigned long>(r.mean),
+             static_cast<unsigned long>(r.p99), static_cast<unsigned long>(r.max));
+    write(line);
+}
+
+/** Time @p iters calls of @p fn(i), one sample per call. */
+template <typename Fn>
+Result run(const char* name, uint32_t iters, Fn&& fn) {
+    perf::Histogram h;
+    for (uint32_t i = 0; i < iters; ++i) {
+        const uint32_t t0 = perf::cycles();
+        fn(i);
+        h.record(perf::cycles() - t0);
+    }
+    return {name, h.count(), h.min(), h.mean(), h.percentile(0.99f), h.max()};
+}
+
+/** Stores a value where the optimiser cannot discard the computation. */
+template <typename T>
+inline void keep(const T& v) {
+    static volatile T sink;
+    sink = v;
+}
+
+// ---------------------------------------------------------------------------
+// Console output sink: discards on target, truncates harmlessly on host
+// ---------------------------------------------------------------------------
+
+#ifdef ARDUINO
+class NullPrint : public Print {
+public:
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t*, size_t n) override { return n; }
+    void   reset() {}
+};
+#else
+class NullPrint : public Print {};   // stub Print; reset() is inherited
+#endif
+
+// ---------------------------------------------------------------------------
+// Cases
+// ---------------------------------------------------------------------------
+
+/** Tiny LCG so traces are identical on every platform and run. */
+struct Lcg {
+    uint32_t s = 12345u;
+    float next() {                       // uniform in [-1, 1)
+        s = s * 1664525u + 1013904223u;
+        return static_cast<float>(s >> 8) / 8388608.0f - 1.0f;
+    }
+};
+
+/**
+ * state_machine::update() over a synthetic six-hour run at LOOP_INTERVAL_MS:
+ * a 1 K/min cooldown from AMBIENT_START_K to SETPOINT_K, then holding the
+ * setpoint, with ±20 mK measurement noise.
+ */
+inline Result fsmUpdateTrace() {
+    static constexpr uint32_t HOURS = 6;
+    const uint32_t ticks = HOURS * 3600u * 1000u / LOOP_INTERVAL_MS;
+
+    state_machine::init(0);
+    state_machine::start(0, AMBIENT_START_K);
+    Lcg noise;
+
+    return run("fsm_update", ticks, [&](uint32_t i) {
+        const uint32_t nowMs  = (i + 1u) * LOOP_INTERVAL_MS;
+        const float    minute = static_cast<float>(nowMs) / 60000.0f;
+        float tempK = AMBIENT_START_K - minute;          // 1 K/min
+        float rate  = 1.0f;
+        if (tempK < SETPOINT_K) { tempK = SETPOINT_K; rate = 0.0f; }
+        tempK += 0.02f * noise.next();
+
+        const auto out = state_machine::update(tempK, rate, 60.0f, false, nowMs, false,
+                                               1.0f, 2000);
+        keep(out.dacTarget);
+    });
+}
+
+/** conversions::tempKToDacValue() swept across the cooldown range. */
+inline Result tempToDac() {
+    return run("temp_to_dac", 20000, [](uint32_t i) {
+        const float tempK = SETPOINT_K + static_cast<float>(i % 2200u) * 0.1f;
+        keep(conversions::tempKToDacValue(tempK, AMBIENT_START_K, SETPOINT_K,
+                                          MCP4921_MAX_VALUE));
+    });
+}
+
+/** RTD code → kelvin through the firmware's compile-time lookup table. */
+inline Result rtdLookup() {
+    static constexpr rtd::RtdLut LUT =
+        rtd::makeRtdLut(RTD_CURVE, RTD_RREF, RTD_LUT_MIN_K, RTD_LUT_MAX_K);
+    return run("rtd_lookup", 20000, [](uint32_t i) {
+        const uint16_t code = static_cast<uint16_t>(2000u + (i * 37u) % 6000u);
+        keep(rtd::lookupMilliK(LUT, code));
+    });
+}
+
+/** serial_commands::processLine() for a mix of commands. */
+inline Result commandDispatch() {
+    static const char* const LINES[] = {
+        "status", "telemetry rate 2", "telemetry config", "no such command", "telemetry rate 1",
+    };
+    static constexpr uint32_t LINE_COUNT = sizeof(LINES) / sizeof(LINES[0]);
+    NullPrint out;
+    return run("command_dispatch", 5000, [&](uint32_t i) {
+        out.reset();
+        serial_commands::processLine(LINES[i % LINE_COUNT], out);
+    });
+}
+
+inline telemetry::Frame sampleFrame(uint32_t i) {
+    telemetry::Frame f{};
+    f.state         = state_machine::State::Operating;
+    f.statusText    = "Operating normally";
+    f.tempK         = 77.25f + 0.01f * static_cast<float>(i % 50u);
+    f.tempC         = f.tempK - 273.15f;
+    f.ambientTempC  = 21.5f;
+    f.coolingRate   = 0.125f;
+    f.dacTarget     = 1234;
+    f.dacActual     = 1200;
+    f.rmsV          = 10.5f;
+    f.relayNormal   = true;
+    f.greenLed      = true;
+    f.onDurationMs  = 3723000u + i * LOOP_INTERVAL_MS;
+    f.cooldownPct   = 100.0f;
+    f.timeInStateMs = 61000u + i * LOOP_INTERVAL_MS;
+    f.currentA      = 1.25f;
+    f.backoffCount  = 3;
+    f.ambientAgeMs  = 800;
+    return f;
+}
+
+/** telemetry::formatFrame(): one full Serial Studio CSV line. */
+inline Result telemetryCsv() {
+    char buf[telemetry::MAX_FRAME_LEN];
+    return run("telemetry_csv", 5000, [&](uint32_t i) {
+        keep(telemetry::formatFrame(sampleFrame(i), buf, sizeof(buf)));
+    });
+}
+
+/** telemetry::formatBinaryFrame(): pack, CRC and COBS one sample. */
+inline Result telemetryBinary() {
+    uint8_t buf[telemetry::MAX_FRAME_LEN];
+    return run("telemetry_binary", 5000, [&](uint32_t i) {
+        keep(telemetry::formatBinaryFrame(sampleFrame(i), buf, sizeof(buf)));
+    });
+}
+
+} // namespace bench
+
+#endif // BENCH_CASES_H
@@ -0,0 +1,445 @@
+/**
+ * @file plant_sim.h
+ * @brief Deterministic cryocooler plant and control-core rig for native runs
+ *
+ * Closes the loop around the firmware's own logic on the host, in simulated
+ * time, so cooldown timing and backoff parameters can be tuned in seconds
+ * rather than multi-hour bench runs:
+ *
+ *   Plant          cold-stage thermal mass with an ambient heat leak, cooled
+ *                  by a compressor whose drive lags the DAC command.  Lift
+ *                  grows with the cold-stage temperature, as it does on a
+ *                  real Stirling / GM cooler.
+ *   CurrentSensor  ACS712 window RMS (idle + drive-proportional current,
+ *                  noise) plus injectable overstroke spikes.
+ *   Clock          64-bit simulated microseconds; every advance is pushed to
+ *                  the native millis() / micros() stub.
+ *   Rig            the control core from main.cpp on that clock: the same
+ *                  sched::Scheduler job table and periods (less the DS18B20
+ *                  ambient job; ambient is a plant constant), MAX31865 codes
+ *                  through the firmware RTD lookup table into a
+ *                  temperature::ColdHistory and a CooldownEta,
+ *                  OverstrokeDetector, the Rig's own state_machine::Machine,
+ *                  the dac.cpp SlewLimiter, and telemetry::sample() → drain()
+ *                  into a discarding sink.
+ *
+ * Jobs take no simulated time, and between releases the plant is
+ * integrated over the gap the scheduler reports, so a four-hour cooldown
+ * runs in well under a second.  All noise comes from a fixed-seed LCG:
+ * the same parameters always give the same run.
+ *
+ * Native only (needs the millis() / micros() stub); used by
+ * test/test_native/test_simulation.cpp.  Only one Rig may run at a time,
+ * since the millis() stub and the telemetry module are singletons.
+ */
+
+#ifndef PLANT_SIM_H
+#define PLANT_SIM_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string>
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "cooldown_eta.h"
+#include "overstroke_detector.h"
+#include "params.h"
+#include "rtd_curves.h"
+#include "rtd_lut.h"
+#include "scheduler.h"
+#include "slew_limiter.h"
+#include "state_machine.h"
+#include "telemetry.h"
+#include "temperature.h"
+
+namespace sim {
+
+// ---------------------------------------------------------------------------
+// Clock and noise
+// ---------------------------------------------------------------------------
+
+/** Simulated time; drives the native millis() / micros() stub. */
+class Clock {
+public:
+    void reset() {
+        _us = 0;
+        stub_setMicros(_us);
+    }
+
+    void advanceUs(uint32_t us) {
+        _us += us;
+        stub_setMicros(_us);
+    }
+
+    uint64_t nowUs() const { return _us; }
+    uint32_t nowMs() const { return static_cast<uint32_t>(_us / 1000u); }
+
+private:
+    uint64_t _us = 0;
+};
+
+/** Fixed-seed LCG, uniform in [-1, 1). */
+struct Noise {
+    uint32_t s = 12345u;
+    float next() {
+        s = s * 1664525u + 1013904223u;
+        return static_cast<float>(s >> 8) / 8388608.0f - 1.0f;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Plant
+// ---------------------------------------------------------------------------
+
+/**
+ * Plant constants.  The defaults need about half drive to hold SETPOINT_K
+ * (leak 21.7 W against 45 W of lift) and can cool at ~2 K/min near the
+ * coarse/fine threshold, so the cooldown is rate-limited by the firmware
+ * rather than by the plant.
+ */
+struct PlantParams {
+    float ambientK          = AMBIENT_START_K;
+    float heatCapacityJPerK = 600.0f;   ///< cold stage + load (10 W ≈ 1 K/min)
+    float leakWPerK         = 0.1f;     ///< conduction + radiation to ambient
+    float liftAtSetpointW   = 45.0f;    ///< lift at full drive, at SETPOINT_K
+    float liftSlopeWPerK    = 0.1f;     ///< extra lift per kelvin above SETPOINT_K
+    float compressorTauS    = 3.0f;     ///< drive response to a DAC step
+    float idleCurrentA      = 0.4f;     ///< ACS712 RMS at zero drive
+    float currentPerDriveA  = 2.2f;     ///< extra RMS current at full drive
+    float currentNoiseA     = 0.01f;    ///< ± per current window
+    float rtdNoiseK         = 0.005f;   ///< ± per RTD conversion
+};
+
+/** Lumped cold-stage thermal model: C dT/dt = G (T_amb − T) − lift. */
+class Plant {
+public:
+    PlantParams params;
+
+    explicit Plant(const PlantParams& p = PlantParams{}) : params(p), _tempK(p.ambientK) {}
+
+    void reset(float tempK) {
+        _tempK = tempK;
+        _drive = 0.0f;
+    }
+
+    /** Advance @p dtS seconds with the DAC output at @p dacCounts. */
+    void step(uint16_t dacCounts, float dtS) {
+        const float command = static_cast<float>(dacCounts) / static_cast<float>(MCP4921_MAX_VALUE);
+        _drive += (command - _drive) * (dtS / (params.compressorTauS + dtS));
+
+        const float leakW = params.leakWPerK * (params.ambientK - _tempK);
+        _tempK += (leakW - liftW()) / params.heatCapacityJPerK * dtS;
+    }
+
+    float tempK() const { return _tempK; }
+    float drive() const { return _drive; }   ///< 0 .. 1
+
+    float liftW() const {
+        const float full = params.liftAtSetpointW + params.liftSlopeWPerK * (_tempK - SETPOINT_K);
+        return _drive * ((full > 0.0f) ? full : 0.0f);
+    }
+
+    /** Compressor RMS current before sensor noise and spikes. */
+    float currentA() const { return params.idleCurrentA + params.currentPerDriveA * _drive; }
+
+private:
+    float _tempK;
+    float _drive = 0.0f;
+};
+
+// ---------------------------------------------------------------------------
+// Current sensor
+// ---------------------------------------------------------------------------
+
+/** An injected overstroke: extra RMS current over [atMs, atMs + durationMs). */
+struct Spike {
+    uint32_t atMs;
+    uint32_t durationMs;
+    float    amplitudeA;
+};
+
+/** Simulated ACS712: one RMS value per ACS712_WINDOW_CYCLES drive cycles. */
+class CurrentSensor {
+public:
+    static constexpr uint8_t MAX_SPIKES = 16;
+
+    void reset() {
+        _count = 0;
+        _noise = Noise{54321u};
+    }
+
+    /** Schedule @p s.  Returns false when MAX_SPIKES are already pending. */
+    bool inject(const Spike& s) {
+        if (_count >= MAX_SPIKES) return false;
+        _spikes[_count++] = s;
+        return true;
+    }
+
+    /** RMS of the window [startMs, endMs) around a true current of @p baseA. */
+    float window(float baseA, float noiseA, uint32_t startMs, uint32_t endMs) {
+        float a = baseA + noiseA * _noise.next();
+        for (uint8_t i = 0; i < _count; ++i) {
+            const Spike& s = _spikes[i];
+            if (s.atMs < endMs && startMs < s.atMs + s.durationMs) a += s.amplitudeA;
+        }
+        return a;
+    }
+
+private:
+    Spike   _spikes[MAX_SPIKES] = {};
+    uint8_t _count = 0;
+    Noise   _noise{54321u};
+};
+
+// ---------------------------------------------------------------------------
+// Rig: the control core of main.cpp on a simulated clock
+// ---------------------------------------------------------------------------
+
+class Rig {
+public:
+    Plant         plant;
+    CurrentSensor sensor;
+    Clock         clock;
+
+    explicit Rig(const PlantParams& p = PlantParams{})
+        : plant(p),
+          _history(STALL_BUCKET_MS, STALL_DETECT_WINDOW_MS),
+          _eta(ETA_SAMPLE_MS, ETA_FORGETTING, ETA_MIN_SAMPLES, ETA_MAX_S),
+          _slew(rampCreditQ8(DAC_MAX_STEP_PER_INTERVAL)),
+          _scheduler(_jobs, JOB_COUNT, []() -> uint32_t { return micros(); }) {
+        reset();
+    }
+
+    /** Warm plant, Off state, empty history; time back to zero. */
+    void reset() {
+        active() = this;
+        clock.reset();
+        plant.reset(plant.params.ambientK);
+        sensor.reset();
+        _history.configure(STALL_BUCKET_MS, STALL_DETECT_WINDOW_MS);
+        _eta.reset();
+        _detector.reset();
+        _slew.reset();
+        _dac        = 0;
+        _cycles     = 0;
+        _windowMs   = 0;
+        _currentA   = 0.0f;
+        _tempK      = 0.0f;
+        _wasCooling = false;
+        _framesOut  = 0;
+        _rtdNoise   = Noise{};
+
+        telemetry::enable();
+        telemetry::resetSchedule();
+        telemetry::resetStats();
+        while (telemetry::drain(_sink, SIZE_MAX) > 0) { _sink.reset(); }
+
+        _machine.init(clock.nowMs());
+        _last = _machine.update(plant.tempK(), 0.0f, 0.0f, false, clock.nowMs(), false);
+        _scheduler.start();
+    }
+
+    /** The "start" console command. */
+    void start() { _machine.start(clock.nowMs(), _tempK > 0.0f ? _tempK : plant.tempK()); }
+
+    /** Run for @p ms of simulated time. */
+    void run(uint32_t ms) {
+        runUntil([](const Rig&) { return false; }, ms);
+    }
+
+    /**
+     * Run until @p done(*this) holds (checked after every scheduler pass)
+     * or @p timeoutMs of simulated time have passed.
+     *
+     * @return true if @p done was met
+     */
+    template <typename Pred>
+    bool runUntil(Pred&& done, uint32_t timeoutMs) {
+        active() = this;
+        const uint64_t endUs = clock.nowUs() + static_cast<uint64_t>(timeoutMs) * 1000u;
+        while (clock.nowUs() < endUs) {
+            const uint32_t waitUs = _scheduler.runDue();
+            if (done(*this)) return true;
+
+            const uint64_t left = endUs - clock.nowUs();
+            const uint32_t dtUs = (waitUs < left) ? waitUs : static_cast<uint32_t>(left);
+            plant.step(_dac, static_cast<float>(dtUs) * 1e-6f);
+            clock.advanceUs(dtUs);
+        }
+        return false;
+    }
+
+    const state_machine::Machine& machine() const { return _machine; }
+    const state_machine::Output& output() const { return _last; }
+    state_machine::State state() const          { return _last.state; }
+    uint16_t dacActual() const                  { return _dac; }
+    float    measuredTempK() const              { return _tempK; }
+    float    coolingRate() const                { return _history.coolingRateKPerMin(); }
+    float    currentA() const                   { return _currentA; }
+    const OverstrokeDetector& detector() const  { return _detector; }
+    const CooldownEta&        cooldownEta() const { return _eta; }
+    const sched::Scheduler&   scheduler() const { return _scheduler; }
+
+    /** Telemetry frames written by drain() since reset(). */
+    uint32_t framesOut() const { return _framesOut; }
+
+    /** Also append every drained frame to @p out (nullptr to stop). */
+    void captureTo(std::string* out) { _capture = out; }
+
+private:
+    static constexpr uint32_t MS = 1000;   // scheduler periods are in µs
+
+    // dac.cpp's allowance: "dacstep" counts per LOOP_INTERVAL_MS
+    static constexpr uint32_t rampCreditQ8(uint32_t stepPerInterval) {
+        return (stepPerInterval * 256u * DAC_RAMP_INTERVAL_MS) / LOOP_INTERVAL_MS;
+    }
+
+    static Rig*& active() {
+        static Rig* rig = nullptr;
+        return rig;
+    }
+
+    static const rtd::RtdLut& lut() {
+        static constexpr rtd::RtdLut LUT =
+            rtd::makeRtdLut(RTD_CURVE, RTD_RREF, RTD_LUT_MIN_K, RTD_LUT_MAX_K);
+        return LUT;
+    }
+
+    static bool isCooldown(state_machine::State s) {
+        return s == state_machine::State::CoarseCooldown ||
+               s == state_machine::State::FineCooldown;
+    }
+
+    // ---- Jobs (same order, periods and phases as main.cpp) ---------------
+
+    /** rms::readCurrent(): one new window every ACS712_WINDOW_CYCLES calls. */
+    static void currentJob() {
+        Rig& r = *active();
+        if (++r._cycles % ACS712_WINDOW_CYCLES != 0) return;
+        const uint32_t nowMs = r.clock.nowMs();
+        r._currentA = r.sensor.window(r.plant.currentA(), r.plant.params.currentNoiseA,
+                                      r._windowMs, nowMs);
+        r._windowMs = nowMs;
+        const state_machine::State s = r._last.state;
+        r._detector.setSigmaK((isCooldown(s) || s == state_machine::State::Overshoot)
+                                  ? OVERSTROKE_SIGMA_K_COOLDOWN : OVERSTROKE_SIGMA_K_STEADY);
+        r._detector.setDrive(r._dac);
+        r._detector.update(r._currentA, r._currentA, nowMs);
+    }
+
+    /** dac::serviceRamp(). */
+    static void dacJob() {
+        Rig& r = *active();
+        r._slew.setCredit(rampCreditQ8(params::getUint(params::Id::DacMaxStep)));
+        r._dac = r._slew.step(r._dac);
+    }
+
+    /** temperature::read(): MAX31865 code → lookup table → history. */
+    static void rtdJob() {
+        Rig& r = *active();
+        const float  tempK = r.plant.tempK() + r.plant.params.rtdNoiseK * r._rtdNoise.next();
+        const double code  = RTD_CURVE.ohmsAt(tempK) / RTD_RREF * rtd::CODE_FULL_SCALE + 0.5;
+        const uint16_t rtdCode = (code >= 32767.0) ? 32767u : static_cast<uint16_t>(code);
+        r._tempK = static_cast<float>(rtd::lookupMilliK(lut(), rtdCode)) * 0.001f;
+        r._history.push(r.clock.nowMs(), r._tempK);
+        r._eta.update(r.clock.nowMs(), r._tempK, params::get(params::Id::SetpointK) +
+                                                 params::get(params::Id::SetpointToleranceK));
+    }
+
+    /** main.cpp controlJob(). */
+    static void controlJob() {
+        Rig& r = *active();
+        const uint32_t nowMs = r.clock.nowMs();
+
+        // A cooldown entered by start() restarts the window before the
+        // stall check reads it
+        if (isCooldown(r._machine.getState()) && !r._wasCooling) {
+            r._history.restartStallWindow();
+            r._eta.reset();
+            r._wasCooling = true;
+        }
+
+        // rms::read() is not implemented on the hardware yet either (0 V).
+        const bool overstroke = r._detector.pending();
+        r._last = r._machine.update(r._tempK, r._history.coolingRateKPerMin(), 0.0f,
+                                    r._history.stalled(STALL_MIN_DROP_K), nowMs,
+                                    overstroke, r._currentA, r._dac);
+        if (overstroke) r._detector.clear();
+
+        const bool cooling = isCooldown(r._last.state);
+        if (cooling && !r._wasCooling) {
+            r._history.restartStallWindow();
+            r._eta.reset();
+        }
+        r._wasCooling = cooling;
+
+        r._slew.setTarget(r._last.dacTarget > MCP4921_MAX_VALUE ? MCP4921_MAX_VALUE
+                                                                : r._last.dacTarget);
+    }
+
+    /** telemetry::emit() plus the comms core's drain(). */
+    static void telemetryJob() {
+        Rig& r = *active();
+        telemetry::Frame f{};
+        f.state         = r._last.state;
+        f.faultReason   = r._machine.getFaultReason();
+        f.statusText    = r._last.statusText;
+        f.tempK         = r._tempK;
+        f.tempC         = r._tempK - 273.15f;
+        f.ambientTempC  = r.plant.params.ambientK - 273.15f;
+        f.coolingRate   = r._history.coolingRateKPerMin();
+        f.dacTarget     = r._last.dacTarget;
+        f.dacActual     = r._dac;
+        f.relayNormal   = !r._last.bypassRelay;
+        f.alarmRelay    = r._last.alarmRelay;
+        f.onDurationMs  = r._machine.getOnStateDuration();
+        f.cooldownPct   = (AMBIENT_START_K - r._tempK) / (AMBIENT_START_K - SETPOINT_K) * 100.0f;
+        f.timeInStateMs = r._machine.getTimeInState();
+        f.currentA      = r._currentA;
+        f.backoffCount  = r._last.backoffCount;
+        f.ambientAgeMs  = 0;
+        const CooldownEta::Estimate eta = isCooldown(r._last.state)
+            ? r._eta.estimate(r.clock.nowMs()) : CooldownEta::Estimate{-1, 0};
+        f.etaS          = eta.etaS;
+        f.etaConfPct    = eta.confidencePct;
+        telemetry::sample(f);
+
+        r._framesOut += telemetry::drain(r._sink, Print::kCapacity);
+        if (r._capture != nullptr) r._capture->append(r._sink.str());
+        r._sink.reset();
+    }
+
+    static constexpr uint8_t JOB_COUNT = 5;
+    sched::Task _jobs[JOB_COUNT] = {
+        {"current",   currentJob,   CURRENT_READ_INTERVAL_US,        0,                            0, 0, {}},
+        {"dac",       dacJob,       DAC_RAMP_INTERVAL_MS * MS,       0,                            0, 0, {}},
+        {"rtd",       rtdJob,       RTD_READ_INTERVAL_MS * MS,       RTD_READ_PHASE_MS * MS,       0, 0, {}},
+        {"control",   controlJob,   LOOP_INTERVAL_MS * MS,           CONTROL_PHASE_MS * MS,        0, 0, {}},
+        {"telemetry", telemetryJob, TELEMETRY_EMIT_INTERVAL_MS * MS, TELEMETRY_EMIT_PHASE_MS * MS, 0, 0, {}},
+    };
+
+    temperature::ColdHistory _history;
+    CooldownEta              _eta;
+    OverstrokeDetector       _detector;
+    SlewLimiter              _slew;
+    sched::Scheduler         _scheduler;
+    state_machine::Machine   _machine;
+    state_machine::Output    _last{};
+    Print                    _sink;
+    Noise                    _rtdNoise;
+    std::string*             _capture = nullptr;
+
+    uint16_t _dac        = 0;
+    uint32_t _cycles     = 0;
+    uint32_t _windowMs   = 0;
+    float    _currentA   = 0.0f;
+    float    _tempK      = 0.0f;
+    bool     _wasCooling = false;
+    uint32_t _framesOut  = 0;
+};
+
+} // namespace sim
+
+#endif // PLANT_SIM_H
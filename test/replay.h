@@ -0,0 +1,367 @@
+/**
+ * @file replay.h
+ * @brief Fast-forward replay of Serial Studio telemetry captures through
+ *        state_machine::Machine
+ *
+ * A capture is the raw console stream: /*...*\/ Quick-Plot frames (see
+ * telemetry.h) mixed with any other console output.  Each frame's recorded
+ * inputs are fed to a fresh Machine as fast as the host runs, and its
+ * output is compared with what the unit recorded:
+ *
+ *   Parser     one line → Row.  Accepts 19 to 24 columns (older firmware
+ *              stopped at current_a; backoff_count, ambient_age_ms and
+ *              the cooldown ETA came later).  Empty columns — delta mode
+ *              or an unsubscribed column — repeat the last value seen; a
+ *              frame is skipped until every required column has been
+ *              seen once.
+ *   Replayer   time, commands and inputs for each Row:
+ *                time   the recorded on_duration_ms while it advances,
+ *                       otherwise TELEMETRY_EMIT_INTERVAL_MS per frame
+ *                start  recorded state leaves Off / Idle / Fault for a
+ *                       running state (or the capture opens mid-run)
+ *                stop   recorded state enters Idle; off: enters Off
+ *                inputs temp_k, cooling_rate, rms_v, current_a, dac_actual;
+ *                       an overstroke on every backoff_count increment;
+ *                       stall from a ColdHistory over the recorded temps
+ *              The replayed state and dac_target are diffed against the
+ *              recorded ones row by row (Summary).
+ *   forEachLine()  splits an in-memory (e.g. mmap()ed) capture into lines
+ *              without copying.
+ *
+ * Commands are only replayed on recorded edges, so a replay that diverges
+ * (faults earlier, say) stays diverged and shows up in the counts rather
+ * than being resynchronised.  The runtime parameters (params.h) in effect
+ * are whatever the caller set, which is how a changed backoff or
+ * controller policy is evaluated: set it, replay, compare.
+ *
+ * The recorded inputs are rounded (temp_k to 0.01 K, cooling_rate to
+ * 0.001 K/min) and the replay runs open loop, so over hours the rate
+ * loop's integrator drifts away from the recorded dac_target even with
+ * unchanged parameters; treat dac_mismatches late in a long capture as
+ * noise and the state sequence as the signal.
+ *
+ * Native only; used by test/test_native/test_replay.cpp and the file
+ * replay tool in test/test_replay (env:native_replay).
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "state_machine.h"
+#include "temperature.h"
+
+namespace replay {
+
+// ---------------------------------------------------------------------------
+// Capture lines
+// ---------------------------------------------------------------------------
+
+/** Call @p fn(line, len) for every line of @p data (terminator excluded). */
+template <typename Fn>
+inline void forEachLine(const char* data, size_t len, Fn&& fn) {
+    const char* p   = data;
+    const char* end = data + len;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* e  = (nl != nullptr) ? nl : end;
+        fn(p, static_cast<size_t>(e - p));
+        p = (nl != nullptr) ? nl + 1 : end;
+    }
+}
+
+/** Recorded values the replay uses from one frame. */
+struct Row {
+    int8_t   state;
+    float    tempK;
+    float    coolingRate;
+    uint16_t dacTarget;
+    uint16_t dacActual;
+    float    rmsV;
+    uint32_t onDurationMs;
+    float    currentA;       ///< 0 when the capture has no current_a column
+    uint16_t backoffCount;
+    bool     hasBackoff;     ///< capture carries backoff_count
+};
+
+/** Bit for 1-based CSV column @p c in Parser's seen-column mask. */
+constexpr uint32_t columnBit(uint8_t c) { return 1u << c; }
+
+/** Parses Quick-Plot frames, carrying empty columns forward. */
+class Parser {
+public:
+    enum class Status : uint8_t {
+        Ok         = 0,
+        NotAFrame  = 1,   ///< other console output
+        BadColumns = 2,   ///< fewer than 19 or more than 24 columns
+        BadValue   = 3,   ///< a used column is not a number
+        Incomplete = 4,   ///< a used column has not been seen yet
+    };
+
+    static constexpr uint8_t MIN_COLUMNS = 19;
+    static constexpr uint8_t MAX_COLUMNS = 24;
+
+    void reset() { *this = Parser{}; }
+
+    Status parse(const char* line, size_t len, Row& row) {
+        while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == ' ')) --len;
+        const char* open = findOpen(line, len);
+        if (open == nullptr || len < 4 || line[len - 2] != '*' || line[len - 1] != '/') {
+            return Status::NotAFrame;
+        }
+        const char* p   = open + 2;
+        const char* end = line + len - 2;
+
+        const char* col[MAX_COLUMNS + 1];
+        size_t      colLen[MAX_COLUMNS + 1];
+        uint8_t     n = 0;
+        for (;;) {
+            const char* bar = static_cast<const char*>(memchr(p, '|', static_cast<size_t>(end - p)));
+            const char* e   = (bar != nullptr) ? bar : end;
+            if (n == MAX_COLUMNS) return Status::BadColumns;
+            col[n]    = p;
+            colLen[n] = static_cast<size_t>(e - p);
+            ++n;
+            if (bar == nullptr) break;
+            p = bar + 1;
+        }
+        if (n < MIN_COLUMNS) return Status::BadColumns;
+
+        Row next = _last;
+        next.hasBackoff = (n >= 20);
+        bool ok = true;
+        ok = field(col, colLen, 1,  next.state,        ok);
+        ok = field(col, colLen, 4,  next.tempK,        ok);
+        ok = field(col, colLen, 7,  next.coolingRate,  ok);
+        ok = field(col, colLen, 8,  next.dacTarget,    ok);
+        ok = field(col, colLen, 9,  next.dacActual,    ok);
+        ok = field(col, colLen, 10, next.rmsV,         ok);
+        ok = field(col, colLen, 15, next.onDurationMs, ok);
+        ok = field(col, colLen, 19, next.currentA,     ok);
+        if (next.hasBackoff) ok = field(col, colLen, 20, next.backoffCount, ok);
+        if (!ok) return Status::BadValue;
+
+        _last = next;
+        constexpr uint32_t required = columnBit(1) | columnBit(4) | columnBit(7) | columnBit(8) |
+                                      columnBit(9) | columnBit(10) | columnBit(15);
+        if ((_seen & required) != required) return Status::Incomplete;
+        row = next;
+        return Status::Ok;
+    }
+
+private:
+    static const char* findOpen(const char* line, size_t len) {
+        for (size_t i = 0; i + 1 < len; ++i) {
+            if (line[i] == '/' && line[i + 1] == '*') return line + i;
+        }
+        return nullptr;
+    }
+
+    /** Copy column @p c (1-based) into a NUL-terminated scratch buffer. */
+    static bool text(const char* const* col, const size_t* colLen, uint8_t c, char (&buf)[24]) {
+        const size_t len = colLen[c - 1];
+        if (len == 0 || len >= sizeof(buf)) return false;
+        memcpy(buf, col[c - 1], len);
+        buf[len] = '\0';
+        return true;
+    }
+
+    template <typename T>
+    bool field(const char* const* col, const size_t* colLen, uint8_t c, T& value, bool ok) {
+        if (!ok) return false;
+        if (colLen[c - 1] == 0) return true;            // unchanged / unsubscribed
+        char buf[24];
+        if (!text(col, colLen, c, buf)) return false;
+        char* e = nullptr;
+        const double v = strtod(buf, &e);
+        if (e == buf || *e != '\0') return false;
+        value = static_cast<T>(v);
+        _seen |= columnBit(c);
+        return true;
+    }
+
+    Row      _last{};
+    uint32_t _seen = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+/** Row-by-row comparison of a replay against its capture. */
+struct Summary {
+    uint32_t lines;
+    uint32_t frames;                ///< rows replayed
+    uint32_t skipped;               ///< malformed or incomplete frames
+    uint32_t stateMismatches;       ///< rows where the replayed state differs
+    uint32_t dacMismatches;         ///< rows with |Δ dac_target| > tolerance
+    uint16_t maxDacError;
+    uint32_t firstMismatchLine;     ///< 1-based; 0 = none
+    uint32_t recordedTransitions;
+    uint32_t replayedTransitions;
+    uint32_t recordedFaults;
+    uint32_t replayedFaults;
+    uint32_t simulatedMs;           ///< replay clock at the last frame
+};
+
+class Replayer {
+public:
+    /** @param dacTolerance  dac_target difference still counted as a match */
+    explicit Replayer(uint16_t dacTolerance = 64)
+        : _history(STALL_BUCKET_MS, STALL_DETECT_WINDOW_MS), _dacTolerance(dacTolerance) {}
+
+    /** Replay one capture line (frame or not). */
+    void feed(const char* line, size_t len) {
+        ++_sum.lines;
+        Row row;
+        const Parser::Status st = _parser.parse(line, len, row);
+        if (st == Parser::Status::NotAFrame) return;
+        if (st != Parser::Status::Ok) {
+            ++_sum.skipped;
+            return;
+        }
+        step(row);
+    }
+
+    /** Replay every line of an in-memory capture. */
+    void feedAll(const char* data, size_t len) {
+        forEachLine(data, len, [this](const char* l, size_t n) { feed(l, n); });
+    }
+
+    const Summary&                summary() const { return _sum; }
+    const state_machine::Machine& machine() const { return _machine; }
+
+private:
+    using State = state_machine::State;
+
+    static bool isRunning(int8_t s) {
+        return s >= static_cast<int8_t>(State::CoarseCooldown) &&
+               s <= static_cast<int8_t>(State::Operating);
+    }
+
+    static bool isCooldown(State s) {
+        return s == State::CoarseCooldown || s == State::FineCooldown;
+    }
+
+    void advanceClock(const Row& row) {
+        if (!_havePrev) {
+            _nowMs = 1;   // 0 reads as "never" inside Machine
+            return;
+        }
+        const bool onAdvanced = row.onDurationMs > _prev.onDurationMs &&
+                                isRunning(row.state) && isRunning(_prev.state);
+        _nowMs += onAdvanced ? row.onDurationMs - _prev.onDurationMs : TELEMETRY_EMIT_INTERVAL_MS;
+    }
+
+    void replayCommands(const Row& row) {
+        const int8_t prev = _havePrev ? _prev.state : static_cast<int8_t>(State::Off);
+        if (!_havePrev) _machine.init(_nowMs);
+
+        if (isRunning(row.state) && (!_havePrev || !isRunning(prev))) {
+            _machine.start(_nowMs, row.tempK);
+        } else if (row.state == static_cast<int8_t>(State::Idle) && prev != row.state) {
+            _machine.stop(_nowMs);
+        } else if (row.state == static_cast<int8_t>(State::Off) && prev != row.state) {
+            _machine.off(_nowMs);
+        }
+    }
+
+    void step(const Row& row) {
+        advanceClock(row);
+        _history.push(_nowMs, row.tempK);
+        replayCommands(row);
+
+        // As main.cpp: a cooldown entered by start() restarts the stall
+        // window before this step's check
+        if (isCooldown(_machine.getState()) && !_wasCooling) {
+            _history.restartStallWindow();
+            _wasCooling = true;
+        }
+
+        const bool overstroke = _havePrev && row.hasBackoff && _prev.hasBackoff &&
+                                row.backoffCount > _prev.backoffCount;
+        const state_machine::Output out =
+            _machine.update(row.tempK, row.coolingRate, row.rmsV,
+                            _history.stalled(STALL_MIN_DROP_K), _nowMs, overstroke,
+                            row.currentA, row.dacActual);
+
+        const bool cooling = isCooldown(out.state);
+        if (cooling && !_wasCooling) _history.restartStallWindow();
+        _wasCooling = cooling;
+
+        compare(row, out);
+        _prev     = row;
+        _prevOut  = out;
+        _havePrev = true;
+    }
+
+    void compare(const Row& row, const state_machine::Output& out) {
+        ++_sum.frames;
+        _sum.simulatedMs = _nowMs;
+        const int8_t fault = static_cast<int8_t>(State::Fault);
+
+        if (_havePrev && row.state != _prev.state) {
+            ++_sum.recordedTransitions;
+            if (row.state == fault) ++_sum.recordedFaults;
+        }
+        if (_havePrev && out.state != _prevOut.state) {
+            ++_sum.replayedTransitions;
+            if (out.state == State::Fault) ++_sum.replayedFaults;
+        }
+
+        const uint16_t err = (out.dacTarget > row.dacTarget) ? out.dacTarget - row.dacTarget
+                                                             : row.dacTarget - out.dacTarget;
+        if (err > _sum.maxDacError) _sum.maxDacError = err;
+        const bool stateMiss = static_cast<int8_t>(out.state) != row.state;
+        const bool dacMiss   = err > _dacTolerance;
+        if (stateMiss) ++_sum.stateMismatches;
+        if (dacMiss)   ++_sum.dacMismatches;
+        if ((stateMiss || dacMiss) && _sum.firstMismatchLine == 0) {
+            _sum.firstMismatchLine = _sum.lines;
+        }
+    }
+
+    Parser                   _parser;
+    state_machine::Machine   _machine;
+    temperature::ColdHistory _history;
+    uint16_t                 _dacTolerance;
+    Summary                  _sum{};
+    Row                      _prev{};
+    state_machine::Output    _prevOut{};
+    bool                     _havePrev   = false;
+    bool                     _wasCooling = false;
+    uint32_t                 _nowMs      = 0;
+};
+
+/** Line-sink signature for report(), e.g. a printf wrapper. */
+using WriteFn = void (*)(const char* line);
+
+/** One "REPLAY {json}" line for @p s. */
+inline void report(const Summary& s, const char* name, WriteFn write) {
+    char line[384];
+    snprintf(line, sizeof(line),
+             "REPLAY {\"capture\":\"%s\",\"lines\":%lu,\"frames\":%lu,\"skipped\":%lu,"
+             "\"state_mismatches\":%lu,\"dac_mismatches\":%lu,\"max_dac_error\":%u,"
+             "\"first_mismatch_line\":%lu,\"recorded_transitions\":%lu,"
+             "\"replayed_transitions\":%lu,\"recorded_faults\":%lu,\"replayed_faults\":%lu,"
+             "\"simulated_s\":%lu}",
+             name, static_cast<unsigned long>(s.lines), static_cast<unsigned long>(s.frames),
+             static_cast<unsigned long>(s.skipped), static_cast<unsigned long>(s.stateMismatches),
+             static_cast<unsigned long>(s.dacMismatches), static_cast<unsigned>(s.maxDacError),
+             static_cast<unsigned long>(s.firstMismatchLine),
+             static_cast<unsigned long>(s.recordedTransitions),
+             static_cast<unsigned long>(s.replayedTransitions),
+             static_cast<unsigned long>(s.recordedFaults),
+             static_cast<unsigned long>(s.replayedFaults),
+             static_cast<unsigned long>(s.simulatedMs / 1000u));
+    write(line);
+}
+
+} // namespace replay
+
+#endif // REPLAY_H
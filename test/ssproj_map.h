@@ -0,0 +1,205 @@
+/**
+ * @file ssproj_map.h
+ * @brief Generate the Serial Studio column map from telemetry::FIELDS
+ *
+ * "Cryocooler Dashboard.ssproj" has to agree with the firmware in two
+ * places: the JavaScript frameParser that splits a frame into values, and
+ * each dataset's "index" (1-based position in the parser's output).  Both
+ * are derived here from the schema (telemetry_schema.h):
+ *
+ *   frameParser()  the parser: returns the columns in CSV order, numbers
+ *                  parsed and text kept, so index N is CSV column N.  An
+ *                  empty column (delta mode, unsubscribed) repeats the
+ *                  last value seen.
+ *   regenerate()   rewrites a project's frameParser and, for every
+ *                  dataset, its index and units from the FIELDS entry with
+ *                  the same title; everything else (widgets, ranges,
+ *                  layout) is the dashboard author's.
+ *
+ * The project is edited as text rather than parsed: Serial Studio saves it
+ * with sorted keys, so within a dataset "index" comes before "title" and
+ * "title" before "units".  test_native checks that the committed project is
+ * a fixed point of regenerate(); `pio test -e native_ssproj` rewrites it.
+ *
+ * Host only.
+ */
+
+#ifndef SSPROJ_MAP_H
+#define SSPROJ_MAP_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include "telemetry_schema.h"
+
+namespace ssproj {
+
+/** The frameParser script for the current schema. */
+inline std::string frameParser() {
+    using telemetry::FIELDS;
+    using telemetry::FieldKind;
+    using telemetry::SCHEMA_FIELD_COUNT;
+
+    std::string kinds, table;
+    for (const telemetry::FieldSpec& f : FIELDS) {
+        const bool text = f.kind == FieldKind::Text || f.kind == FieldKind::Hms;
+        kinds += text ? 't' : 'n';
+        char row[80];
+        snprintf(row, sizeof(row), " *   %2u  %-15s %s\n",
+                 static_cast<unsigned>(f.column), f.key, f.title);
+        table += row;
+    }
+    const unsigned minColumns = SCHEMA_FIELD_COUNT - 1u;   // loop_us is optional
+
+    std::string js;
+    js += "/**\n"
+          " * Cryocooler Controller Telemetry Parser\n"
+          " *\n"
+          " * GENERATED from telemetry::FIELDS (include/telemetry_schema.h) by\n"
+          " * test/ssproj_map.h; run `pio test -e native_ssproj` after changing the\n"
+          " * schema instead of editing this script.\n"
+          " *\n"
+          " * Input: the pipe-delimited columns of one telemetry frame (Serial\n"
+          " * Studio strips the frame delimiters).  Output: the same columns in\n"
+          " * the same order, numbers parsed and text kept, so dataset index N is\n"
+          " * CSV column N:\n"
+          " *\n";
+    js += table;
+    js += " *\n"
+          " * An empty column (delta mode or an unsubscribed column) repeats the\n"
+          " * last value seen; the perf column may be absent.\n"
+          " */\n"
+          "\n";
+    js += "const KINDS = \"" + kinds + "\";   // n = number, t = text, per column\n";
+    js += "const MIN_COLUMNS = " + std::to_string(minColumns) + ";\n";
+    js += "let last = [];\n"
+          "\n"
+          "function parse(frame) {\n"
+          "    const fields = frame.split(\"|\");\n"
+          "    if (fields.length < MIN_COLUMNS) return [];\n"
+          "\n"
+          "    for (let i = 0; i < KINDS.length; ++i) {\n"
+          "        const s = i < fields.length ? fields[i].trim() : \"\";\n"
+          "        if (s !== \"\") {\n"
+          "            last[i] = KINDS[i] === \"n\" ? parseFloat(s) : s;\n"
+          "        } else if (last[i] === undefined) {\n"
+          "            last[i] = KINDS[i] === \"n\" ? 0 : \"\";\n"
+          "        }\n"
+          "    }\n"
+          "    return last.slice();\n"
+          "}\n";
+    return js;
+}
+
+/** @p s as the body of a JSON string (Qt style: UTF-8 kept, '/' unescaped). */
+inline std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (const char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20u) {
+                    char u[8];
+                    snprintf(u, sizeof(u), "\\u%04x", static_cast<unsigned>(c));
+                    out += u;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+/** Schema entry whose dashboard title is @p title, or nullptr. */
+inline const telemetry::FieldSpec* fieldForTitle(const std::string& title) {
+    for (const telemetry::FieldSpec& f : telemetry::FIELDS) {
+        if (title == f.title) return &f;
+    }
+    return nullptr;
+}
+
+namespace detail {
+
+/** Index one past the closing quote of the JSON string opening at @p open. */
+inline size_t stringEnd(const std::string& s, size_t open) {
+    for (size_t i = open + 1u; i < s.size(); ++i) {
+        if (s[i] == '\\') { ++i; continue; }
+        if (s[i] == '"') return i + 1u;
+    }
+    return std::string::npos;
+}
+
+/** Position of the value after `"key": ` at or after @p from, or npos. */
+inline size_t valueOf(const std::string& s, const char* key, size_t from) {
+    const std::string k = std::string("\"") + key + "\": ";
+    const size_t at = s.find(k, from);
+    return (at == std::string::npos) ? at : at + k.size();
+}
+
+} // namespace detail
+
+/**
+ * Rewrite project text @p in into @p out (see file header).
+ *
+ * @return false, with @p err set, if the project has no frameParser, is not
+ *         laid out as expected, or has a dataset whose title is not in
+ *         FIELDS.
+ */
+inline bool regenerate(const std::string& in, std::string& out, std::string& err) {
+    using detail::stringEnd;
+    using detail::valueOf;
+    out.clear();
+    size_t copied = 0;
+
+    // frameParser: "…" is replaced whole
+    const size_t parser = valueOf(in, "frameParser", 0);
+    const size_t parserEnd = (parser == std::string::npos || in[parser] != '"')
+        ? std::string::npos : stringEnd(in, parser);
+    if (parserEnd == std::string::npos) {
+        err = "no frameParser string";
+        return false;
+    }
+    out += in.substr(0, parser);
+    out += "\"" + jsonEscape(frameParser()) + "\"";
+    copied = parserEnd;
+
+    // Datasets, in file order
+    for (size_t index = valueOf(in, "index", copied); index != std::string::npos;
+         index = valueOf(in, "index", copied)) {
+        const size_t indexEnd = in.find_first_not_of("0123456789", index);
+        const size_t title    = valueOf(in, "title", index);
+        const size_t titleEnd = (title == std::string::npos || in[title] != '"')
+            ? std::string::npos : stringEnd(in, title);
+        const size_t units    = (titleEnd == std::string::npos)
+            ? std::string::npos : valueOf(in, "units", titleEnd);
+        const size_t unitsEnd = (units == std::string::npos || in[units] != '"')
+            ? std::string::npos : stringEnd(in, units);
+        if (indexEnd == index || unitsEnd == std::string::npos ||
+            in.find('}', index) < unitsEnd) {   // title/units of another object
+            err = "dataset at offset " + std::to_string(index) + " lacks index/title/units";
+            return false;
+        }
+
+        const std::string name = in.substr(title + 1u, titleEnd - title - 2u);
+        const telemetry::FieldSpec* f = fieldForTitle(name);
+        if (f == nullptr) {
+            err = "dataset \"" + name + "\" has no column in telemetry::FIELDS";
+            return false;
+        }
+        out += in.substr(copied, index - copied);
+        out += std::to_string(f->column);
+        out += in.substr(indexEnd, units - indexEnd);
+        out += "\"" + jsonEscape(f->units) + "\"";
+        copied = unitsEnd;
+    }
+    out += in.substr(copied);
+    return true;
+}
+
+} // namespace ssproj
+
+#endif // SSPROJ_MAP_H
@@ -0,0 +1,49 @@
+/**
+ * @file test_bench.cpp
+ * @brief Host benchmark suite (native stubs)
+ *
+ * Run with:  pio test -e native_bench
+ *
+ * Each case prints one BENCH line (see bench_cases.h); the Unity assertion
+ * only checks that the case ran.  Timings are wall-clock nanoseconds, so
+ * compare runs from the same machine.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+
+#include "../bench_cases.h"
+
+static void writeLine(const char* line) {
+    printf("%s\n", line);
+}
+
+static void runCase(bench::Result (*fn)()) {
+    const bench::Result r = fn();
+    bench::report(r, writeLine);
+    TEST_ASSERT_TRUE(r.iters > 0);
+}
+
+void bench_fsm_update_trace()   { runCase(bench::fsmUpdateTrace); }
+void bench_temp_to_dac()        { runCase(bench::tempToDac); }
+void bench_rtd_lookup()         { runCase(bench::rtdLookup); }
+void bench_command_dispatch()   { runCase(bench::commandDispatch); }
+void bench_telemetry_csv()      { runCase(bench::telemetryCsv); }
+void bench_telemetry_binary()   { runCase(bench::telemetryBinary); }
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+    RUN_TEST(bench_fsm_update_trace);
+    RUN_TEST(bench_temp_to_dac);
+    RUN_TEST(bench_rtd_lookup);
+    RUN_TEST(bench_command_dispatch);
+    RUN_TEST(bench_telemetry_csv);
+    RUN_TEST(bench_telemetry_binary);
+    return UNITY_END();
+}
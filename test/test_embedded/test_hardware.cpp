@@ -18,6 +18,7 @@
 #include "pin_config.h"
 #include "config.h"
 #include "conversions.h"
+#include "spi_bus.h"
 
 // ── Hardware instances for test use ─────────────────────────────────────────
 static Adafruit_MAX31865 max31865(MAX31865_CS);
@@ -103,7 +104,7 @@ void test_mcp4921_write_midscale(void) {
 void setup() {
     delay(2000);  // Give serial monitor time to connect
 
-    SPI.begin(SPI_CLK, SPI_MISO, SPI_MOSI, -1);
+    spi_bus::init();   // dac.cpp transfers through the bus manager
 
     UNITY_BEGIN();
 
@@ -0,0 +1,49 @@
+/**
+ * @file test_bench.cpp
+ * @brief On-target benchmark suite (ESP32-S3, CPU cycle counts)
+ *
+ * Flash and run with:  pio test -e esp32s3_bench
+ *
+ * Same cases as test/test_bench/, timed with the CPU cycle counter.  Each
+ * prints one BENCH line over Serial (see bench_cases.h).  No peripherals
+ * are touched, so this runs on a bare DevKit.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "../bench_cases.h"
+
+static void writeLine(const char* line) {
+    Serial.println(line);
+}
+
+static void runCase(bench::Result (*fn)()) {
+    const bench::Result r = fn();
+    bench::report(r, writeLine);
+    TEST_ASSERT_TRUE(r.iters > 0);
+}
+
+void bench_fsm_update_trace()   { runCase(bench::fsmUpdateTrace); }
+void bench_temp_to_dac()        { runCase(bench::tempToDac); }
+void bench_rtd_lookup()         { runCase(bench::rtdLookup); }
+void bench_command_dispatch()   { runCase(bench::commandDispatch); }
+void bench_telemetry_csv()      { runCase(bench::telemetryCsv); }
+void bench_telemetry_binary()   { runCase(bench::telemetryBinary); }
+
+void setup() {
+    delay(2000);  // Give serial monitor time to connect
+
+    UNITY_BEGIN();
+    RUN_TEST(bench_fsm_update_trace);
+    RUN_TEST(bench_temp_to_dac);
+    RUN_TEST(bench_rtd_lookup);
+    RUN_TEST(bench_command_dispatch);
+    RUN_TEST(bench_telemetry_csv);
+    RUN_TEST(bench_telemetry_binary);
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing — benchmarks run once in setup()
+}
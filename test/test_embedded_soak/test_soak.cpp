@@ -0,0 +1,256 @@
+/**
+ * @file test_soak.cpp
+ * @brief On-target soak: the production pipeline under a console flood and
+ *        a stalled telemetry host, gated on latency histograms
+ *
+ * Flash and run with:  pio test -e esp32s3_soak
+ *
+ * Needs the full rig: app::init() brings up every peripheral, as setup()
+ * does.  The machine stays Off (no cooldown is started), but every
+ * control-core job runs at its production period.  For SOAK_DURATION_MS:
+ *   - the console is fed SOAK_FLOOD_BYTES_PER_POLL bytes per poll of
+ *     read-only commands, an over-long line and noise
+ *     (serial_commands::setStream()); the responses are discarded;
+ *   - telemetry drains into a sink that never has room
+ *     (telemetry::setOutput()), as a stalled USB host would, so the ring
+ *     fills and emit() keeps dropping.
+ * Each metric then prints one SOAK line and is checked against its config.h
+ * limits:
+ *
+ *   SOAK {"metric":"control_jitter","unit":"us","n":2999,"min":0,"mean":41,
+ *         "p99":310,"max":1020,"limit_p99":1500,"limit_max":5000,
+ *         "hist":[[0,12],[1,340],...]}
+ *
+ * hist lists the non-empty perf.h buckets as [upper edge in µs, count];
+ * p99 is a bucket edge (within 25 %).  The metrics are perf probes, so the
+ * same numbers are visible on a production unit with the "perf" command.
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "app.h"
+#include "config.h"
+#include "perf.h"
+#include "run_log.h"
+#include "scheduler.h"
+#include "serial_commands.h"
+#include "telemetry.h"
+
+// ---------------------------------------------------------------------------
+// Host stand-ins
+// ---------------------------------------------------------------------------
+
+/** Console session that always has a full RX buffer of input waiting. */
+class FloodStream : public Stream {
+public:
+    /** Cycle through @p script (NUL-terminated, kept by the caller). */
+    void begin(const char* script) {
+        _script = script;
+        _pos    = 0;
+    }
+
+    // One burst per service() call: after a burst is drained the next
+    // available() reports empty (ending that call), the one after refills.
+    int available() override {
+        if (_left == 0) {
+            if (!_drained) {
+                _drained = true;
+                return 0;
+            }
+            _drained = false;
+            _left    = SOAK_FLOOD_BYTES_PER_POLL;
+        }
+        return _left;
+    }
+    int read() override {
+        if (_left == 0) return -1;
+        const char c = _script[_pos++];
+        if (_script[_pos] == '\0') _pos = 0;
+        --_left;
+        ++_consumed;
+        return static_cast<unsigned char>(c);
+    }
+    int peek() override { return (_left == 0) ? -1 : static_cast<unsigned char>(_script[_pos]); }
+
+    size_t write(uint8_t) override { ++_answered; return 1; }
+    size_t write(const uint8_t*, size_t n) override { _answered += n; return n; }
+    int availableForWrite() override { return 4096; }
+
+    uint32_t consumed() const { return _consumed; }
+    uint32_t answered() const { return _answered; }
+
+private:
+    const char*       _script   = "\n";
+    uint16_t          _pos      = 0;
+    uint16_t          _left     = 0;
+    bool              _drained  = false;
+    volatile uint32_t _consumed = 0;
+    volatile uint32_t _answered = 0;
+};
+
+/** Telemetry output of a host that has stopped reading. */
+class StalledHost : public Print {
+public:
+    size_t write(uint8_t) override { return 0; }
+    size_t write(const uint8_t*, size_t) override { return 0; }
+    int availableForWrite() override { return 0; }
+};
+
+static FloodStream flood;
+static StalledHost stalled;
+
+// Read-only commands (nothing that moves the machine), an unknown one and a
+// line past MAX_LINE_LEN.
+static char script[512];
+
+static void buildScript() {
+    static const char commands[] =
+        "status\nhelp\ntasks\nperf\nget\ntelemetry config\nspi\nxyzzy plugh\n";
+    size_t n = sizeof(commands) - 1u;
+    memcpy(script, commands, n);
+    while (n < serial_commands::MAX_LINE_LEN + sizeof(commands) + 16u && n + 2u < sizeof(script)) {
+        script[n++] = 'x';
+    }
+    script[n++] = '\n';
+    script[n]   = '\0';
+}
+
+// ---------------------------------------------------------------------------
+// Reporting
+// ---------------------------------------------------------------------------
+
+/** Print @p p as one SOAK line (µs) and check it against the limits. */
+static void checkProbe(const char* metric, perf::Probe p, uint32_t limitP99Us, uint32_t limitMaxUs) {
+    const perf::Histogram& h   = perf::probe(p);
+    const uint32_t         mhz = perf::clockMHz();
+    const uint32_t p99Us = h.percentile(0.99f) / mhz;
+    const uint32_t maxUs = h.max() / mhz;
+
+    char buf[160];
+    snprintf(buf, sizeof(buf),
+             "SOAK {\"metric\":\"%s\",\"unit\":\"us\",\"n\":%lu,\"min\":%lu,\"mean\":%lu,"
+             "\"p99\":%lu,\"max\":%lu,\"limit_p99\":%lu,\"limit_max\":%lu,\"hist\":[",
+             metric, static_cast<unsigned long>(h.count()),
+             static_cast<unsigned long>(h.min() / mhz), static_cast<unsigned long>(h.mean() / mhz),
+             static_cast<unsigned long>(p99Us), static_cast<unsigned long>(maxUs),
+             static_cast<unsigned long>(limitP99Us), static_cast<unsigned long>(limitMaxUs));
+    Serial.print(buf);
+
+    // Buckets narrower than a microsecond share an edge; merge them.
+    bool     first = true;
+    uint32_t edge  = 0, count = 0;
+    for (uint8_t b = 0; b <= perf::HIST_BUCKETS; ++b) {
+        const bool     end = (b == perf::HIST_BUCKETS);
+        const uint32_t e   = end ? UINT32_MAX : perf::bucketUpper(b) / mhz;
+        if ((end || e != edge) && count > 0) {
+            snprintf(buf, sizeof(buf), "%s[%lu,%lu]", first ? "" : ",",
+                     static_cast<unsigned long>(edge), static_cast<unsigned long>(count));
+            Serial.print(buf);
+            first = false;
+            count = 0;
+        }
+        if (end) break;
+        edge   = e;
+        count += h.bin(b);
+    }
+    Serial.println("]}");
+
+    TEST_ASSERT_TRUE_MESSAGE(h.count() > 0, "no samples");
+    TEST_ASSERT_TRUE_MESSAGE(p99Us <= limitP99Us, "p99 over limit");
+    TEST_ASSERT_TRUE_MESSAGE(maxUs <= limitMaxUs, "max over limit");
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+void soak_run() {
+    if (!PERF_ENABLED) TEST_IGNORE_MESSAGE("PERF_ENABLED is false: no probes to check");
+
+    // Let the first releases and the ring fill-up settle, and the run log
+    // finish erasing ahead (the machine is Off, so it does that now; each
+    // erase stalls both cores), then measure
+    delay(2000);
+    const uint32_t eraseStartMs = millis();
+    while (run_log::isMounted() && run_log::getStats().erasedAhead < RUN_LOG_ERASE_AHEAD_SECTORS &&
+           millis() - eraseStartMs < 60000u) {
+        delay(100);
+    }
+    perf::resetAll();
+    app::getScheduler().resetStats();
+    telemetry::resetStats();
+
+    const uint32_t startMs = millis();
+    uint32_t       nextMs  = startMs + 60000u;
+    while (millis() - startMs < SOAK_DURATION_MS) {
+        delay(1000);
+        if (static_cast<int32_t>(millis() - nextMs) >= 0) {
+            nextMs += 60000u;
+            Serial.printf("SOAK progress %lu / %lu s\n",
+                          static_cast<unsigned long>((millis() - startMs) / 1000u),
+                          static_cast<unsigned long>(SOAK_DURATION_MS / 1000u));
+        }
+    }
+    TEST_ASSERT_TRUE_MESSAGE(flood.consumed() > 0, "console never read the flood");
+}
+
+void soak_control_jitter() {
+    checkProbe("control_jitter", perf::Probe::ControlJitter, SOAK_JITTER_P99_US, SOAK_JITTER_MAX_US);
+}
+
+void soak_sensor_to_dac() {
+    checkProbe("sensor_to_dac", perf::Probe::SensorToDac,
+               SOAK_SENSOR_TO_DAC_MAX_US, SOAK_SENSOR_TO_DAC_MAX_US);
+}
+
+void soak_console_service() {
+    checkProbe("console_service", perf::Probe::Console, SOAK_CONSOLE_MAX_US, SOAK_CONSOLE_MAX_US);
+    TEST_ASSERT_TRUE_MESSAGE(flood.answered() > 0, "flooded console produced no responses");
+}
+
+void soak_telemetry_emit() {
+    checkProbe("telemetry_emit", perf::Probe::TelemetryEmit, SOAK_EMIT_P99_US, SOAK_EMIT_MAX_US);
+    // The stall must actually have filled the ring, or emit() was not
+    // measured under it.
+    TEST_ASSERT_TRUE_MESSAGE(telemetry::getStats().dropped > 0, "ring never filled");
+}
+
+void soak_no_missed_releases() {
+    const sched::Scheduler& s = app::getScheduler();
+    for (uint8_t i = 0; i < s.count(); ++i) {
+        const sched::Task& t = s.task(i);
+        Serial.printf("SOAK {\"job\":\"%s\",\"runs\":%lu,\"skipped\":%lu,\"overruns\":%lu,"
+                      "\"max_us\":%lu,\"max_late_us\":%lu}\n",
+                      t.name, static_cast<unsigned long>(t.stats.runs),
+                      static_cast<unsigned long>(t.stats.skipped),
+                      static_cast<unsigned long>(t.stats.overruns),
+                      static_cast<unsigned long>(t.stats.maxUs),
+                      static_cast<unsigned long>(t.stats.maxLateUs));
+        TEST_ASSERT_TRUE_MESSAGE(t.stats.skipped == 0, t.name);
+    }
+}
+
+void setup() {
+    buildScript();
+    flood.begin(script);
+    app::init();   // waits for the USB host, like production
+
+    // Streams swap before the tasks start, so no task sees the change
+    serial_commands::setStream(&flood);
+    telemetry::setOutput(&stalled);
+    app::startTasks();
+
+    UNITY_BEGIN();
+    RUN_TEST(soak_run);
+    RUN_TEST(soak_control_jitter);
+    RUN_TEST(soak_sensor_to_dac);
+    RUN_TEST(soak_console_service);
+    RUN_TEST(soak_telemetry_emit);
+    RUN_TEST(soak_no_missed_releases);
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);   // the firmware tasks keep running; results are already out
+}
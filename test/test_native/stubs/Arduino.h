@@ -12,14 +12,18 @@
 #include <stdint.h>
 #include "Print.h"  // stub Print class (needed by serial_commands.cpp)
 
-// Stub millis() — returns a value set by the test harness
-// Default: 0, override via stub_setMillis() before each test if needed.
+// Stub millis() / micros() — one clock set by the test harness
+// Default: 0, override via stub_setMillis() before each test if needed, or
+// stub_setMicros() for sub-millisecond resolution (the plant simulation's
+// sim::Clock drives it this way).
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 uint32_t millis(void);
+uint32_t micros(void);
 void     stub_setMillis(uint32_t ms);
+void     stub_setMicros(uint64_t us);
 
 #ifdef __cplusplus
 }
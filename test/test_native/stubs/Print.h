@@ -2,9 +2,10 @@
  * @file Print.h
  * @brief Minimal Print stub for native (host-PC) unit tests.
  *
- * Matches the subset of Arduino's Print class used by serial_commands.cpp:
- * print(const char*) and println(const char*).  Output is accumulated in an
- * internal buffer so tests can inspect it via str() / contains().
+ * Matches the subset of Arduino's Print class used by serial_commands.cpp and
+ * telemetry.cpp: print(const char*), println(const char*) and
+ * write(const uint8_t*, size_t).  Output is accumulated in an internal
+ * buffer so tests can inspect it via str() / contains() / data().
  */
 
 #ifndef PRINT_STUB_H
@@ -13,6 +14,7 @@
 #include <cstring>
 #include <cstdio>
 #include <cstddef>
+#include <cstdint>
 
 class Print {
 public:
@@ -29,6 +31,9 @@ public:
     /** Return all captured output as a null-terminated string. */
     const char* str() const { return _buf; }
 
+    /** Raw captured bytes (binary output may contain embedded NULs). */
+    const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(_buf); }
+
     /** Number of bytes captured so far. */
     size_t length() const { return _len; }
 
@@ -50,6 +55,15 @@ public:
         return copy;
     }
 
+    size_t write(const uint8_t* b, size_t n) {
+        const size_t avail = kCapacity - 1 - _len;
+        const size_t copy  = (n < avail) ? n : avail;
+        memcpy(_buf + _len, b, copy);
+        _len += copy;
+        _buf[_len] = '\0';
+        return copy;
+    }
+
     size_t println(const char* s = "") {
         const size_t n = print(s);
         return n + print("\n");
@@ -1,20 +1,28 @@
 /**
  * @file arduino_stub.cpp
- * @brief millis() stub implementation for native unit tests
+ * @brief millis() / micros() stub implementation for native unit tests
  */
 
 #include "Arduino.h"
 
-static uint32_t sStubMillis = 0;
+static uint64_t sStubMicros = 0;   // both counters wrap like the real ones
 
 extern "C" {
 
 uint32_t millis(void) {
-    return sStubMillis;
+    return static_cast<uint32_t>(sStubMicros / 1000u);
+}
+
+uint32_t micros(void) {
+    return static_cast<uint32_t>(sStubMicros);
 }
 
 void stub_setMillis(uint32_t ms) {
-    sStubMillis = ms;
+    sStubMicros = static_cast<uint64_t>(ms) * 1000u;
+}
+
+void stub_setMicros(uint64_t us) {
+    sStubMicros = us;
 }
 
 } // extern "C"
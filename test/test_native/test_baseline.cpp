@@ -0,0 +1,206 @@
+/**
+ * @file test_baseline.cpp
+ * @brief Unit tests for the baseline fingerprint and deviation detector.
+ *
+ * main() lives in test_state_machine.cpp and calls run_baseline_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include "baseline.h"
+
+using baseline::Channel;
+
+static const baseline::ChannelConfig CHANNELS[baseline::CHANNEL_COUNT] = {
+    {70.0f, 80.0f, 0.1f},
+    {0.0f, 4.0f, 0.01f},
+    {0.0f, 4096.0f, 1.0f},
+    {0.0f, 16.0f, 0.01f},
+};
+static const baseline::Limits LIMITS = {4.0f, 0.5f, 5.0f};
+
+static baseline::Sample sampleOf(float t, float a, float d, float v) {
+    return {{t, a, d, v}};
+}
+
+void test_welford_matches_two_pass() {
+    const float xs[] = {2.0f, 4.0f, 4.0f, 4.0f, 5.0f, 5.0f, 7.0f, 9.0f};
+    baseline::RunningStats st;
+    for (float x : xs) st.push(x);
+    TEST_ASSERT_EQUAL_UINT32(8, st.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 5.0f, st.mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 32.0f / 7.0f, st.variance());
+}
+
+void test_welford_stable_with_large_offset() {
+    // Naive Σx² in float would lose all of this variance at 300 K
+    baseline::RunningStats st;
+    for (int i = 0; i < 1000; ++i) st.push(300.0f + ((i & 1) ? 0.01f : -0.01f));
+    TEST_ASSERT_FLOAT_WITHIN(2e-3f, 0.01f, st.stddev());
+}
+
+void test_welford_single_value_has_zero_variance() {
+    baseline::RunningStats st;
+    st.push(3.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, st.variance());
+}
+
+void test_histogram_bins_and_overflow() {
+    baseline::Histogram h;
+    h.reset(0.0f, 16.0f);
+    h.push(-1.0f);
+    h.push(0.0f);
+    h.push(15.99f);
+    h.push(16.0f);
+    h.push(8.5f);
+    TEST_ASSERT_EQUAL_UINT16(1, h.under);
+    TEST_ASSERT_EQUAL_UINT16(1, h.over);
+    TEST_ASSERT_EQUAL_UINT16(1, h.bins[0]);
+    TEST_ASSERT_EQUAL_UINT16(1, h.bins[8]);
+    TEST_ASSERT_EQUAL_UINT16(1, h.bins[baseline::HISTOGRAM_BINS - 1]);
+}
+
+void test_histogram_counts_saturate() {
+    baseline::Histogram h;
+    h.reset(0.0f, 1.0f);
+    for (uint32_t i = 0; i < 70000u; ++i) h.push(2.0f);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, h.over);
+}
+
+void test_engine_ignores_check_until_frozen() {
+    baseline::Engine e;
+    TEST_ASSERT_EQUAL(baseline::Engine::Phase::Idle, e.phase());
+    e.begin(CHANNELS, LIMITS);
+    e.learn(sampleOf(75.0f, 1.0f, 100.0f, 5.0f));
+    TEST_ASSERT_EQUAL_UINT8(0, e.check(sampleOf(0.0f, 0.0f, 0.0f, 0.0f)));
+    TEST_ASSERT_EQUAL(baseline::Engine::Phase::Learning, e.phase());
+}
+
+void test_engine_sigma_floor_and_z() {
+    baseline::Engine e;
+    e.begin(CHANNELS, LIMITS);
+    for (int i = 0; i < 100; ++i) {
+        const float r = (i & 1) ? 1.0f : -1.0f;
+        e.learn(sampleOf(75.0f + 0.001f * r, 1.0f, 100.0f + 10.0f * r, 5.0f));
+    }
+    e.freeze();
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, e.sigma(Channel::TempK));           // floored
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 10.05f, e.sigma(Channel::Dac));     // learnt
+
+    e.check(sampleOf(75.2f, 1.0f, 120.0f, 5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, e.z(Channel::TempK));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 2.0f, e.z(Channel::Dac));
+}
+
+void test_engine_warn_mask_per_channel() {
+    baseline::Engine e;
+    e.begin(CHANNELS, LIMITS);
+    for (int i = 0; i < 10; ++i) e.learn(sampleOf(75.0f, 1.0f, 100.0f, 5.0f));
+    e.freeze();
+    const uint8_t warn = e.check(sampleOf(75.0f, 1.0f, 100.0f, 4.0f));   // -100 σ
+    TEST_ASSERT_EQUAL_UINT8(baseline::Engine::bit(static_cast<uint8_t>(Channel::RmsV)), warn);
+    TEST_ASSERT_EQUAL_UINT8(warn, e.warnMask());
+}
+
+void test_engine_cusum_catches_small_shift_and_latches() {
+    baseline::Engine e;
+    e.begin(CHANNELS, LIMITS);
+    for (int i = 0; i < 10; ++i) e.learn(sampleOf(75.0f, 1.0f, 100.0f, 5.0f));
+    e.freeze();
+
+    // -1.6 σ on temperature: below zWarn, CUSUM g⁻ grows by 1.1 per tick
+    int ticks = 0;
+    while (e.alarmMask() == 0 && ticks < 50) {
+        TEST_ASSERT_EQUAL_UINT8(0, e.check(sampleOf(74.84f, 1.0f, 100.0f, 5.0f)));
+        ++ticks;
+    }
+    TEST_ASSERT_EQUAL_INT(5, ticks);
+    TEST_ASSERT_EQUAL_UINT8(baseline::Engine::bit(static_cast<uint8_t>(Channel::TempK)),
+                            e.alarmMask());
+    TEST_ASSERT_TRUE(e.cusum(Channel::TempK).down > e.cusum(Channel::TempK).up);
+
+    // Latched even after the signal returns to baseline
+    e.check(sampleOf(75.0f, 1.0f, 100.0f, 5.0f));
+    TEST_ASSERT_NOT_EQUAL(0, e.alarmMask());
+    e.begin(CHANNELS, LIMITS);
+    TEST_ASSERT_EQUAL_UINT8(0, e.alarmMask());
+}
+
+void test_engine_cusum_ignores_zero_mean_noise() {
+    baseline::Engine e;
+    e.begin(CHANNELS, LIMITS);
+    for (int i = 0; i < 10; ++i) e.learn(sampleOf(75.0f, 1.0f, 100.0f, 5.0f));
+    e.freeze();
+    for (int i = 0; i < 10000; ++i) {
+        const float r = (i & 1) ? 0.09f : -0.09f;   // ±0.9 σ
+        e.check(sampleOf(75.0f + r, 1.0f, 100.0f, 5.0f));
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, e.alarmMask());
+}
+
+void test_engine_drift_is_least_squares_change() {
+    baseline::Engine e;
+    e.begin(CHANNELS, LIMITS);
+    // Ramp of 0.01 per sample under alternating noise on temperature
+    for (int i = 0; i < 100; ++i) {
+        const float r = (i & 1) ? 0.05f : -0.05f;
+        e.learn(sampleOf(75.0f + 0.01f * static_cast<float>(i) + r, 1.0f, 100.0f, 5.0f));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 1.0f, e.drift(Channel::TempK));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, e.drift(Channel::Dac));
+}
+
+void test_engine_refuses_to_freeze_while_drifting() {
+    baseline::ChannelConfig channels[baseline::CHANNEL_COUNT];
+    for (uint8_t c = 0; c < baseline::CHANNEL_COUNT; ++c) channels[c] = CHANNELS[c];
+    channels[static_cast<uint8_t>(Channel::Dac)].maxDrift = 20.0f;
+
+    baseline::Engine e;
+    e.begin(channels, LIMITS);
+    for (int i = 0; i < 100; ++i) e.learn(sampleOf(75.0f, 1.0f, 100.0f + 0.5f * i, 5.0f));   // +50
+    TEST_ASSERT_FALSE(e.stationary());
+    TEST_ASSERT_FALSE(e.freeze());
+    TEST_ASSERT_EQUAL(baseline::Engine::Phase::Learning, e.phase());
+
+    e.begin(channels, LIMITS);
+    for (int i = 0; i < 100; ++i) e.learn(sampleOf(75.0f, 1.0f, 100.0f + 0.1f * i, 5.0f));   // +10
+    TEST_ASSERT_TRUE(e.freeze());
+    // σ floored at maxDrift / k, above both minSigma and the learnt spread
+    TEST_ASSERT_EQUAL_FLOAT(20.0f / LIMITS.cusumK, e.sigma(Channel::Dac));
+}
+
+void test_engine_cusum_waits_for_warmup() {
+    const baseline::Limits limits = {LIMITS.zWarn, LIMITS.cusumK, LIMITS.cusumH, 20};
+    baseline::Engine e;
+    e.begin(CHANNELS, limits);
+    for (int i = 0; i < 10; ++i) e.learn(sampleOf(75.0f, 1.0f, 100.0f, 5.0f));
+    e.freeze();
+
+    // Same -1.6 σ shift as above: nothing accumulates for 20 checks, then
+    // the alarm takes its usual 5
+    int ticks = 0;
+    while (e.alarmMask() == 0 && ticks < 50) {
+        e.check(sampleOf(74.84f, 1.0f, 100.0f, 5.0f));
+        ++ticks;
+        if (ticks <= 20) TEST_ASSERT_EQUAL_FLOAT(0.0f, e.cusum(Channel::TempK).down);
+    }
+    TEST_ASSERT_EQUAL_INT(25, ticks);
+}
+
+void run_baseline_tests() {
+    RUN_TEST(test_welford_matches_two_pass);
+    RUN_TEST(test_welford_stable_with_large_offset);
+    RUN_TEST(test_welford_single_value_has_zero_variance);
+    RUN_TEST(test_histogram_bins_and_overflow);
+    RUN_TEST(test_histogram_counts_saturate);
+    RUN_TEST(test_engine_ignores_check_until_frozen);
+    RUN_TEST(test_engine_sigma_floor_and_z);
+    RUN_TEST(test_engine_warn_mask_per_channel);
+    RUN_TEST(test_engine_cusum_catches_small_shift_and_latches);
+    RUN_TEST(test_engine_cusum_ignores_zero_mean_noise);
+    RUN_TEST(test_engine_drift_is_least_squares_change);
+    RUN_TEST(test_engine_refuses_to_freeze_while_drifting);
+    RUN_TEST(test_engine_cusum_waits_for_warmup);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_burst_capture.cpp
+ * @brief Unit tests for the pre/post-trigger burst capture ring.
+ *
+ * main() lives in test_state_machine.cpp and calls run_burst_capture_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include "burst_capture.h"
+
+using Capture = BurstCapture<16>;
+
+static void pushRange(Capture& c, uint16_t from, uint16_t count) {
+    for (uint16_t i = 0; i < count; ++i) { c.push(static_cast<uint16_t>(from + i)); }
+}
+
+void test_capture_trigger_refused_until_pre_history_full() {
+    Capture c(4);                       // 12 pre-trigger samples
+    pushRange(c, 0, 11);
+    TEST_ASSERT_FALSE(c.trigger());
+    c.push(11);
+    TEST_ASSERT_TRUE(c.trigger());
+    TEST_ASSERT_EQUAL(Capture::Phase::Triggered, c.phase());
+}
+
+void test_capture_freezes_after_post_samples() {
+    Capture c(4);
+    pushRange(c, 0, 20);                // wraps the ring
+    TEST_ASSERT_TRUE(c.trigger());      // sample 19 is the trigger point
+    pushRange(c, 100, 3);
+    TEST_ASSERT_FALSE(c.isFrozen());
+    c.push(103);
+    TEST_ASSERT_TRUE(c.isFrozen());
+
+    // Window: samples 8..19 then 100..103, oldest first
+    TEST_ASSERT_EQUAL_UINT32(12, c.triggerIndex());
+    TEST_ASSERT_EQUAL_UINT16(8, c.at(0));
+    TEST_ASSERT_EQUAL_UINT16(19, c.at(c.triggerIndex() - 1));
+    TEST_ASSERT_EQUAL_UINT16(100, c.at(c.triggerIndex()));
+    TEST_ASSERT_EQUAL_UINT16(103, c.at(15));
+}
+
+void test_capture_frozen_ignores_push_and_trigger() {
+    Capture c(2);
+    pushRange(c, 0, 16);
+    c.trigger();
+    pushRange(c, 50, 2);
+    TEST_ASSERT_TRUE(c.isFrozen());
+    pushRange(c, 200, 10);
+    TEST_ASSERT_FALSE(c.trigger());
+    TEST_ASSERT_EQUAL_UINT16(51, c.at(15));
+}
+
+void test_capture_rearm_requires_fresh_history() {
+    Capture c(4);
+    pushRange(c, 0, 16);
+    c.trigger();
+    pushRange(c, 0, 4);
+    TEST_ASSERT_TRUE(c.isFrozen());
+
+    c.rearm();
+    TEST_ASSERT_EQUAL(Capture::Phase::Armed, c.phase());
+    TEST_ASSERT_FALSE(c.trigger());     // stale ring contents don't count
+    pushRange(c, 300, 12);
+    TEST_ASSERT_TRUE(c.trigger());
+}
+
+void test_capture_rearm_while_triggered_is_applied_by_producer() {
+    Capture c(4);
+    pushRange(c, 0, 16);
+    TEST_ASSERT_TRUE(c.trigger());
+    pushRange(c, 100, 2);               // two of four post-trigger samples
+
+    c.rearm();                          // consumer: request only
+    TEST_ASSERT_EQUAL(Capture::Phase::Armed, c.phase());
+    pushRange(c, 200, 2);               // would have frozen the old capture
+    TEST_ASSERT_FALSE(c.isFrozen());
+    TEST_ASSERT_FALSE(c.trigger());     // history restarted at the rearm
+    pushRange(c, 202, 10);
+    TEST_ASSERT_TRUE(c.trigger());
+    pushRange(c, 300, 4);
+    TEST_ASSERT_TRUE(c.isFrozen());
+    TEST_ASSERT_EQUAL_UINT16(200, c.at(0));
+}
+
+void test_capture_zero_post_freezes_immediately() {
+    Capture c(0);
+    pushRange(c, 0, 16);
+    TEST_ASSERT_TRUE(c.trigger());
+    TEST_ASSERT_TRUE(c.isFrozen());
+    TEST_ASSERT_EQUAL_UINT16(15, c.at(15));
+}
+
+// ---------------------------------------------------------------------------
+// Entry point called by the shared test runner in test_state_machine.cpp
+// ---------------------------------------------------------------------------
+
+void run_burst_capture_tests() {
+    RUN_TEST(test_capture_trigger_refused_until_pre_history_full);
+    RUN_TEST(test_capture_freezes_after_post_samples);
+    RUN_TEST(test_capture_frozen_ignores_push_and_trigger);
+    RUN_TEST(test_capture_rearm_requires_fresh_history);
+    RUN_TEST(test_capture_rearm_while_triggered_is_applied_by_producer);
+    RUN_TEST(test_capture_zero_post_freezes_immediately);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file test_command_line.cpp
+ * @brief Unit tests for the console tokenizer (command_line.h) and the
+ *        runtime parameter overrides (params.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_command_line_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "command_line.h"
+#include "config.h"
+#include "params.h"
+
+// ---------------------------------------------------------------------------
+// tokenize()
+// ---------------------------------------------------------------------------
+
+void test_tok_splits_on_spaces_and_tabs() {
+    char line[] = "  set\tsetpoint   77.5 ";
+    const cmdline::Tokens t = cmdline::tokenize(line);
+    TEST_ASSERT_EQUAL_UINT8(3, t.count);
+    TEST_ASSERT_FALSE(t.overflow);
+    TEST_ASSERT_EQUAL_STRING("set", t.v[0]);
+    TEST_ASSERT_EQUAL_STRING("setpoint", t.v[1]);
+    TEST_ASSERT_EQUAL_STRING("77.5", t.v[2]);
+}
+
+void test_tok_blank_line_has_no_tokens() {
+    char line[] = " \t ";
+    TEST_ASSERT_EQUAL_UINT8(0, cmdline::tokenize(line).count);
+}
+
+void test_tok_flags_overflow() {
+    char line[80];
+    strcpy(line, "a b c d e f g h i j k l m n o p q r s t u v w x y");   // 25 tokens
+    const cmdline::Tokens t = cmdline::tokenize(line);
+    TEST_ASSERT_EQUAL_UINT8(cmdline::MAX_TOKENS, t.count);
+    TEST_ASSERT_TRUE(t.overflow);
+}
+
+// ---------------------------------------------------------------------------
+// Typed arguments
+// ---------------------------------------------------------------------------
+
+void test_args_parse_numbers_strictly() {
+    const char* v[] = {"42", "0x1F", "77.5", "-3", "5x", "", "1e3"};
+    const cmdline::Args a(v, 7);
+    uint32_t u = 0;
+    float    f = 0.0f;
+    TEST_ASSERT_TRUE(a.uintAt(0, 100, u));   TEST_ASSERT_EQUAL_UINT32(42, u);
+    TEST_ASSERT_TRUE(a.uintAt(1, 100, u));   TEST_ASSERT_EQUAL_UINT32(31, u);
+    TEST_ASSERT_FALSE(a.uintAt(0, 41, u));                  // above max
+    TEST_ASSERT_FALSE(a.uintAt(2, 100, u));                 // not an integer
+    TEST_ASSERT_FALSE(a.uintAt(3, 100, u));                 // negative
+    TEST_ASSERT_TRUE(a.floatAt(2, f));       TEST_ASSERT_FLOAT_WITHIN(1e-6f, 77.5f, f);
+    TEST_ASSERT_TRUE(a.floatAt(3, f));       TEST_ASSERT_FLOAT_WITHIN(1e-6f, -3.0f, f);
+    TEST_ASSERT_FALSE(a.floatAt(4, f));                     // trailing junk
+    TEST_ASSERT_FALSE(a.floatAt(5, f));
+    TEST_ASSERT_TRUE(a.floatAt(6, f));       TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1000.0f, f);
+    TEST_ASSERT_FALSE(a.floatAt(7, f));                     // past the end
+    TEST_ASSERT_EQUAL_STRING("", a[9]);
+}
+
+void test_args_is_matches_single_word_only() {
+    const char* one[] = {"on"};
+    const char* two[] = {"on", "now"};
+    TEST_ASSERT_TRUE(cmdline::Args(one, 1).is("on"));
+    TEST_ASSERT_FALSE(cmdline::Args(one, 1).is("off"));
+    TEST_ASSERT_FALSE(cmdline::Args(two, 2).is("on"));
+}
+
+// ---------------------------------------------------------------------------
+// params
+// ---------------------------------------------------------------------------
+
+void test_params_start_at_config_defaults() {
+    params::resetDefaults();
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, SETPOINT_K, params::get(params::Id::SetpointK));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, COOLDOWN_RATE_TARGET_K_PER_MIN,
+                             params::get(params::Id::CooldownRate));
+    params::Id id;
+    TEST_ASSERT_TRUE(params::find("threshold", id));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Id::CoarseFineK), static_cast<uint8_t>(id));
+    TEST_ASSERT_FALSE(params::find("nope", id));
+}
+
+void test_params_batch_commits_all_or_nothing() {
+    params::resetDefaults();
+    const params::Change ok[] = {
+        {params::Id::SetpointK, 77.5f}, {params::Id::CooldownRate, 0.8f},
+    };
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Ok),
+                            static_cast<uint8_t>(params::apply(ok, 2)));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 77.5f, params::get(params::Id::SetpointK));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, params::get(params::Id::CooldownRate));
+
+    // Second entry out of range: the first is not applied either
+    const params::Change bad[] = {
+        {params::Id::SetpointK, 76.0f}, {params::Id::CooldownRate, 9.0f},
+    };
+    uint8_t at = 0;
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::OutOfRange),
+                            static_cast<uint8_t>(params::apply(bad, 2, &at)));
+    TEST_ASSERT_EQUAL_UINT8(1, at);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 77.5f, params::get(params::Id::SetpointK));
+    params::resetDefaults();
+}
+
+void test_params_reject_setpoint_band_above_threshold() {
+    params::resetDefaults();
+    const params::Change up[] = {{params::Id::SetpointK, COARSE_FINE_THRESHOLD_K}};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Inconsistent),
+                            static_cast<uint8_t>(params::apply(up, 1)));
+
+    // Moving the threshold in the same batch makes it consistent
+    const params::Change both[] = {
+        {params::Id::SetpointK, COARSE_FINE_THRESHOLD_K}, {params::Id::CoarseFineK, 100.0f},
+    };
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Ok),
+                            static_cast<uint8_t>(params::apply(both, 2)));
+    params::resetDefaults();
+}
+
+void test_params_uint_values_must_be_whole() {
+    params::resetDefaults();
+    const params::Change frac[] = {{params::Id::BackoffDacStep, 150.5f}};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::OutOfRange),
+                            static_cast<uint8_t>(params::apply(frac, 1)));
+    const params::Change whole[] = {{params::Id::BackoffDacStep, 150.0f}};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Ok),
+                            static_cast<uint8_t>(params::apply(whole, 1)));
+    TEST_ASSERT_EQUAL_UINT32(150, params::getUint(params::Id::BackoffDacStep));
+    params::resetDefaults();
+}
+
+void test_params_reject_rate_target_above_limit() {
+    params::resetDefaults();
+    const params::Change down[] = {{params::Id::MaxCooldownRate, 0.5f}};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Inconsistent),
+                            static_cast<uint8_t>(params::apply(down, 1)));
+    const params::Change both[] = {
+        {params::Id::MaxCooldownRate, 0.5f}, {params::Id::CooldownRate, 0.45f},
+    };
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Ok),
+                            static_cast<uint8_t>(params::apply(both, 2)));
+    params::resetDefaults();
+}
+
+void run_command_line_tests() {
+    RUN_TEST(test_tok_splits_on_spaces_and_tabs);
+    RUN_TEST(test_tok_blank_line_has_no_tokens);
+    RUN_TEST(test_tok_flags_overflow);
+    RUN_TEST(test_args_parse_numbers_strictly);
+    RUN_TEST(test_args_is_matches_single_word_only);
+    RUN_TEST(test_params_start_at_config_defaults);
+    RUN_TEST(test_params_batch_commits_all_or_nothing);
+    RUN_TEST(test_params_reject_setpoint_band_above_threshold);
+    RUN_TEST(test_params_uint_values_must_be_whole);
+    RUN_TEST(test_params_reject_rate_target_above_limit);
+}
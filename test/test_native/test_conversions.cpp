@@ -139,6 +139,41 @@ void test_tempKToDacValue_customMaxDac(void) {
     TEST_ASSERT_EQUAL_UINT16(255, conversions::tempKToDacValue(78.0f, 295.0f, 78.0f, 255));
 }
 
+// ── interpolate ─────────────────────────────────────────────────────────────
+
+static constexpr float INTERP_XS[] = {10.0f, 20.0f, 40.0f, 80.0f};
+static constexpr float INTERP_YS[] = {1.0f,  3.0f,  4.0f,  12.0f};
+
+void test_interpolate_exactAtBreakpoints(void) {
+    for (size_t i = 0; i < 4; ++i) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, INTERP_YS[i],
+                                 conversions::interpolate(INTERP_XS, INTERP_YS, INTERP_XS[i]));
+    }
+}
+
+void test_interpolate_betweenBreakpoints(void) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f,  conversions::interpolate(INTERP_XS, INTERP_YS, 15.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 3.5f,  conversions::interpolate(INTERP_XS, INTERP_YS, 30.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 10.0f, conversions::interpolate(INTERP_XS, INTERP_YS, 70.0f));
+}
+
+void test_interpolate_clampsOutsideTable(void) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f,  conversions::interpolate(INTERP_XS, INTERP_YS, -5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 12.0f, conversions::interpolate(INTERP_XS, INTERP_YS, 500.0f));
+}
+
+void test_interpolate_twoPointTable(void) {
+    const double xs[] = {0.0, 1.0};
+    const double ys[] = {100.0, 200.0};
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 125.0f, static_cast<float>(conversions::interpolate(xs, ys, 0.25)));
+}
+
+void test_interpolate_isConstexpr(void) {
+    static_assert(conversions::interpolate(INTERP_XS, INTERP_YS, 60.0f) == 8.0f,
+                  "interpolate() must be usable in constant expressions");
+    TEST_ASSERT_EQUAL_FLOAT(8.0f, conversions::interpolate(INTERP_XS, INTERP_YS, 60.0f));
+}
+
 // ── Config sanity checks ─────────────────────────────────────────────────────
 
 void test_config_rref_positive(void) {
@@ -219,6 +254,13 @@ int main(int argc, char **argv) {
     RUN_TEST(test_tempKToDacValue_proportionalIncrease);
     RUN_TEST(test_tempKToDacValue_customMaxDac);
 
+    // interpolate
+    RUN_TEST(test_interpolate_exactAtBreakpoints);
+    RUN_TEST(test_interpolate_betweenBreakpoints);
+    RUN_TEST(test_interpolate_clampsOutsideTable);
+    RUN_TEST(test_interpolate_twoPointTable);
+    RUN_TEST(test_interpolate_isConstexpr);
+
     // Config sanity
     RUN_TEST(test_config_rref_positive);
     RUN_TEST(test_config_rnominal_positive);
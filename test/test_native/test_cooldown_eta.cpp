@@ -0,0 +1,157 @@
+/**
+ * @file test_cooldown_eta.cpp
+ * @brief Unit tests for the online cooldown fit and ETA (cooldown_eta.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_cooldown_eta_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include "cooldown_eta.h"
+#include "config.h"
+#include "../plant_sim.h"
+
+namespace {
+
+constexpr uint32_t SAMPLE_MS   = 10000;
+constexpr uint32_t READ_MS     = 1000;
+constexpr float    TARGET_K    = 80.0f;
+constexpr uint32_t MAX_ETA_S   = 48u * 3600u;
+constexpr uint32_t HOUR_MS     = 3600u * 1000u;
+
+CooldownEta makeEta() { return CooldownEta(SAMPLE_MS, 0.98f, 12, MAX_ETA_S); }
+
+/** Feed T(t) = asymptote + (startK - asymptote)·e^(−t/τ) once per READ_MS until @p untilMs. */
+uint32_t feedExponential(CooldownEta& eta, uint32_t fromMs, uint32_t untilMs,
+                         float startK, float asymptoteK, float tauS) {
+    uint32_t t = fromMs;
+    for (; t < untilMs; t += READ_MS) {
+        const float s = static_cast<float>(t) * 0.001f;
+        eta.update(t, asymptoteK + (startK - asymptoteK) * expf(-s / tauS), TARGET_K);
+    }
+    return t;
+}
+
+/** Seconds from @p nowS until the exponential above crosses TARGET_K. */
+float trueEtaS(float nowS, float startK, float asymptoteK, float tauS) {
+    return tauS * logf((startK - asymptoteK) / (TARGET_K - asymptoteK)) - nowS;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Synthetic curves
+// ---------------------------------------------------------------------------
+
+void test_eta_unknown_before_min_samples() {
+    CooldownEta eta = makeEta();
+    TEST_ASSERT_EQUAL_INT32(-1, eta.estimate(0).etaS);
+    feedExponential(eta, 0, 11u * SAMPLE_MS, 290.0f, 70.0f, 3000.0f);
+    const CooldownEta::Estimate e = eta.estimate(11u * SAMPLE_MS);
+    TEST_ASSERT_EQUAL_INT32(-1, e.etaS);
+    TEST_ASSERT_EQUAL_UINT8(0, e.confidencePct);
+}
+
+void test_eta_tracks_exponential_approach() {
+    const float startK = 290.0f, asymptoteK = 70.0f, tauS = 3000.0f;
+    CooldownEta eta = makeEta();
+    const uint32_t t = feedExponential(eta, 0, 3600u * 1000u, startK, asymptoteK, tauS);
+
+    const float expected = trueEtaS(static_cast<float>(t) * 0.001f, startK, asymptoteK, tauS);
+    const CooldownEta::Estimate e = eta.estimate(t);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f * expected, expected, static_cast<float>(e.etaS));
+    TEST_ASSERT_TRUE(e.confidencePct >= 90);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f * tauS, tauS, eta.tauS());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, asymptoteK - TARGET_K, eta.asymptoteOffsetK());
+}
+
+void test_eta_linear_ramp_gives_linear_eta() {
+    CooldownEta eta = makeEta();
+    const float kPerS = 0.015f;                     // 0.9 K/min, rate limited
+    uint32_t t = 0;
+    for (; t < 2400u * 1000u; t += READ_MS) {
+        eta.update(t, 250.0f - kPerS * static_cast<float>(t) * 0.001f, TARGET_K);
+    }
+    const float tempK    = 250.0f - kPerS * static_cast<float>(t) * 0.001f;
+    const float expected = (tempK - TARGET_K) / kPerS;
+    const CooldownEta::Estimate e = eta.estimate(t);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f * expected, expected, static_cast<float>(e.etaS));
+    TEST_ASSERT_TRUE(e.confidencePct >= 80);   // still settling from the α fit's prior
+}
+
+void test_eta_unknown_when_asymptote_above_target() {
+    CooldownEta eta = makeEta();
+    feedExponential(eta, 0, 1800u * 1000u, 290.0f, 120.0f, 1000.0f);   // stalls at 120 K
+    TEST_ASSERT_EQUAL_INT32(-1, eta.estimate(1800u * 1000u).etaS);
+    TEST_ASSERT_TRUE(eta.asymptoteOffsetK() > 0.0f);
+}
+
+void test_eta_zero_at_target() {
+    CooldownEta eta = makeEta();
+    uint32_t t = 0;
+    for (; t < 300u * 1000u; t += READ_MS) eta.update(t, TARGET_K - 1.0f, TARGET_K);
+    const CooldownEta::Estimate e = eta.estimate(t);
+    TEST_ASSERT_EQUAL_INT32(0, e.etaS);
+    TEST_ASSERT_EQUAL_UINT8(100, e.confidencePct);
+}
+
+void test_eta_ages_between_fits() {
+    CooldownEta eta = makeEta();
+    const uint32_t t = feedExponential(eta, 0, 1800u * 1000u, 290.0f, 70.0f, 3000.0f);
+    const int32_t first = eta.estimate(t).etaS;
+    TEST_ASSERT_EQUAL_INT32(first - 5, eta.estimate(t + 5000u).etaS);
+}
+
+void test_eta_reset_forgets_fit() {
+    CooldownEta eta = makeEta();
+    const uint32_t t = feedExponential(eta, 0, 1800u * 1000u, 290.0f, 70.0f, 3000.0f);
+    TEST_ASSERT_TRUE(eta.estimate(t).etaS > 0);
+    eta.reset();
+    TEST_ASSERT_EQUAL_INT32(-1, eta.estimate(t).etaS);
+    TEST_ASSERT_EQUAL_UINT16(0, eta.steps());
+}
+
+// ---------------------------------------------------------------------------
+// Closed loop
+// ---------------------------------------------------------------------------
+
+/** Late in a simulated cooldown the confident ETAs land near the real arrival. */
+void test_eta_sim_predicts_arrival() {
+    sim::Rig rig;
+    rig.run(5000);
+    rig.start();
+
+    const float targetK = SETPOINT_K + SETPOINT_TOLERANCE_K;
+    uint32_t predictedMs = 0, predictedAtMs = 0;
+    uint32_t nextCheckMs = rig.clock.nowMs() + 2u * HOUR_MS;
+    const bool reached = rig.runUntil([&](const sim::Rig& r) {
+        const uint32_t now = r.clock.nowMs();
+        if (now >= nextCheckMs && predictedMs == 0) {
+            const CooldownEta::Estimate e = r.cooldownEta().estimate(now);
+            if (e.etaS > 0 && e.confidencePct >= 80) {
+                predictedMs   = now + static_cast<uint32_t>(e.etaS) * 1000u;
+                predictedAtMs = now;
+            }
+        }
+        return r.measuredTempK() <= targetK;
+    }, 8 * HOUR_MS);
+
+    TEST_ASSERT_TRUE(reached);
+    TEST_ASSERT_TRUE(predictedMs != 0);
+    const float horizonMs = static_cast<float>(rig.clock.nowMs() - predictedAtMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * horizonMs, static_cast<float>(rig.clock.nowMs()),
+                             static_cast<float>(predictedMs));
+}
+
+void run_cooldown_eta_tests() {
+    RUN_TEST(test_eta_unknown_before_min_samples);
+    RUN_TEST(test_eta_tracks_exponential_approach);
+    RUN_TEST(test_eta_linear_ramp_gives_linear_eta);
+    RUN_TEST(test_eta_unknown_when_asymptote_above_target);
+    RUN_TEST(test_eta_zero_at_target);
+    RUN_TEST(test_eta_ages_between_fits);
+    RUN_TEST(test_eta_reset_forgets_fit);
+    RUN_TEST(test_eta_sim_predicts_arrival);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file test_datagram_pool.cpp
+ * @brief Unit tests for the telemetry datagram pool (datagram_pool.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_datagram_pool_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "datagram_pool.h"
+
+using Pool = DatagramPool<4, 64>;
+
+/** Reserve @p maxLen, write @p text there and commit its length. */
+static bool put(Pool& pool, const char* text, size_t maxLen, uint32_t nowMs) {
+    uint8_t* slot = pool.reserve(maxLen, nowMs);
+    if (slot == nullptr) return false;
+    const size_t n = strlen(text);
+    memcpy(slot, text, n);
+    pool.commit(n);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Batching
+// ---------------------------------------------------------------------------
+
+void test_dgram_packs_frames_back_to_back() {
+    Pool pool(0, 1000);
+    TEST_ASSERT_TRUE(put(pool, "aaaa\n", 20, 0));
+    TEST_ASSERT_TRUE(put(pool, "bb\n", 20, 10));
+    uint8_t i;
+    TEST_ASSERT_FALSE(pool.take(i));                   // still open
+
+    TEST_ASSERT_TRUE(pool.poll(1000));                 // aged from the first frame
+    TEST_ASSERT_TRUE(pool.take(i));
+    const Pool::Buffer& b = pool.buffer(i);
+    TEST_ASSERT_EQUAL_UINT16(8, b.len);
+    TEST_ASSERT_EQUAL_UINT8(2, b.frames);
+    TEST_ASSERT_EQUAL_MEMORY("aaaa\nbb\n", b.data, 8);
+    pool.release(i);
+}
+
+void test_dgram_seals_when_next_frame_might_not_fit() {
+    Pool pool(0, 1000);
+    TEST_ASSERT_TRUE(put(pool, "0123456789012345678901234567890123456789", 40, 0));   // 40 bytes
+    TEST_ASSERT_TRUE(put(pool, "x", 30, 0));           // 24 left < 30: new buffer
+    uint8_t i;
+    TEST_ASSERT_TRUE(pool.take(i));
+    TEST_ASSERT_EQUAL_UINT16(40, pool.buffer(i).len);
+    TEST_ASSERT_FALSE(pool.take(i));
+}
+
+void test_dgram_seals_at_frame_limit() {
+    Pool pool(3, 1000);
+    for (uint8_t k = 0; k < 3; ++k) TEST_ASSERT_TRUE(put(pool, "f\n", 8, 0));
+    uint8_t i;
+    TEST_ASSERT_TRUE(pool.take(i));
+    TEST_ASSERT_EQUAL_UINT8(3, pool.buffer(i).frames);
+    TEST_ASSERT_EQUAL_UINT32(1, pool.stats().sealed);
+}
+
+void test_dgram_poll_ignores_young_or_empty_buffer() {
+    Pool pool(0, 500);
+    TEST_ASSERT_FALSE(pool.poll(10000));               // nothing open
+    TEST_ASSERT_NOT_NULL(pool.reserve(8, 100));
+    pool.commit(0);                                    // formatter failed
+    TEST_ASSERT_FALSE(pool.poll(10000));               // open but empty
+    TEST_ASSERT_TRUE(put(pool, "f", 8, 200));
+    TEST_ASSERT_FALSE(pool.poll(699));                 // first frame at 200
+    TEST_ASSERT_TRUE(pool.poll(700));
+}
+
+// ---------------------------------------------------------------------------
+// Pool exhaustion and reuse
+// ---------------------------------------------------------------------------
+
+void test_dgram_drops_when_every_buffer_is_busy() {
+    Pool pool(1, 1000);
+    for (uint8_t k = 0; k < Pool::capacity(); ++k) TEST_ASSERT_TRUE(put(pool, "f", 8, 0));
+    TEST_ASSERT_FALSE(put(pool, "f", 8, 0));
+    TEST_ASSERT_FALSE(put(pool, "f", 8, 0));
+    TEST_ASSERT_EQUAL_UINT32(Pool::capacity(), pool.stats().frames);
+    TEST_ASSERT_EQUAL_UINT32(2, pool.stats().dropped);
+
+    // One send frees one buffer
+    uint8_t i;
+    TEST_ASSERT_TRUE(pool.take(i));
+    pool.release(i);
+    TEST_ASSERT_TRUE(put(pool, "f", 8, 0));
+}
+
+void test_dgram_rejects_frame_larger_than_buffer() {
+    Pool pool(0, 1000);
+    TEST_ASSERT_NULL(pool.reserve(Pool::bufferSize() + 1u, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, pool.stats().dropped);
+}
+
+void test_dgram_discard_open_keeps_buffer() {
+    Pool pool(0, 1000);
+    TEST_ASSERT_TRUE(put(pool, "stale", 8, 0));
+    pool.discardOpen();
+    TEST_ASSERT_FALSE(pool.poll(5000));                // emptied
+    TEST_ASSERT_TRUE(put(pool, "new", 8, 100));
+    TEST_ASSERT_FALSE(pool.poll(1099));                // aged from "new", not "stale"
+    TEST_ASSERT_TRUE(pool.poll(1100));
+    uint8_t i;
+    TEST_ASSERT_TRUE(pool.take(i));
+    TEST_ASSERT_EQUAL_UINT16(3, pool.buffer(i).len);
+    TEST_ASSERT_EQUAL_MEMORY("new", pool.buffer(i).data, 3);
+}
+
+void run_datagram_pool_tests() {
+    RUN_TEST(test_dgram_packs_frames_back_to_back);
+    RUN_TEST(test_dgram_seals_when_next_frame_might_not_fit);
+    RUN_TEST(test_dgram_seals_at_frame_limit);
+    RUN_TEST(test_dgram_poll_ignores_young_or_empty_buffer);
+    RUN_TEST(test_dgram_drops_when_every_buffer_is_busy);
+    RUN_TEST(test_dgram_rejects_frame_larger_than_buffer);
+    RUN_TEST(test_dgram_discard_open_keeps_buffer);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file test_frame_codec.cpp
+ * @brief Unit tests for the CRC-16 and COBS framing helpers.
+ *
+ * main() lives in test_state_machine.cpp and calls run_frame_codec_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <cstring>
+#include <stdint.h>
+#include "frame_codec.h"
+
+// ---------------------------------------------------------------------------
+// CRC-16/CCITT-FALSE
+// ---------------------------------------------------------------------------
+
+void test_codec_crc16_check_value() {
+    const char* msg = "123456789";
+    TEST_ASSERT_EQUAL_HEX16(0x29B1,
+        codec::crc16(reinterpret_cast<const uint8_t*>(msg), strlen(msg)));
+}
+
+void test_codec_crc16_empty_is_init() {
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, codec::crc16(nullptr, 0));
+}
+
+// ---------------------------------------------------------------------------
+// COBS
+// ---------------------------------------------------------------------------
+
+void test_codec_cobs_known_vector() {
+    // Classic example: 11 22 00 33  →  03 11 22 02 33
+    const uint8_t in[]  = {0x11, 0x22, 0x00, 0x33};
+    const uint8_t exp[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    uint8_t out[8];
+    TEST_ASSERT_EQUAL_UINT32(sizeof(exp), codec::cobsEncode(in, sizeof(in), out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(exp, out, sizeof(exp));
+}
+
+void test_codec_cobs_roundtrip_removes_zeros() {
+    uint8_t in[40];
+    for (uint8_t i = 0; i < sizeof(in); ++i) { in[i] = (i % 5 == 0) ? 0 : i; }
+
+    uint8_t enc[codec::cobsMaxEncoded(sizeof(in))];
+    const size_t n = codec::cobsEncode(in, sizeof(in), enc, sizeof(enc));
+    TEST_ASSERT_GREATER_THAN(0, n);
+    for (size_t i = 0; i < n; ++i) { TEST_ASSERT_NOT_EQUAL(0, enc[i]); }
+
+    uint8_t dec[sizeof(in)];
+    TEST_ASSERT_EQUAL_UINT32(sizeof(in), codec::cobsDecode(enc, n, dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, dec, sizeof(in));
+}
+
+void test_codec_cobs_roundtrip_long_nonzero_run() {
+    // 300 nonzero bytes exercises the 254-byte block split.
+    uint8_t in[300];
+    for (size_t i = 0; i < sizeof(in); ++i) { in[i] = static_cast<uint8_t>(1u + i % 255u); }
+
+    uint8_t enc[codec::cobsMaxEncoded(sizeof(in))];
+    const size_t n = codec::cobsEncode(in, sizeof(in), enc, sizeof(enc));
+    TEST_ASSERT_GREATER_THAN(0, n);
+
+    uint8_t dec[sizeof(in)];
+    TEST_ASSERT_EQUAL_UINT32(sizeof(in), codec::cobsDecode(enc, n, dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(in, dec, sizeof(in));
+}
+
+void test_codec_cobs_encode_rejects_small_buffer() {
+    const uint8_t in[] = {1, 2, 3};
+    uint8_t out[3];
+    TEST_ASSERT_EQUAL_UINT32(0, codec::cobsEncode(in, sizeof(in), out, sizeof(out)));
+}
+
+void test_codec_cobs_decode_rejects_truncated() {
+    const uint8_t bad[] = {0x05, 0x11, 0x22};   // code promises 4 data bytes
+    uint8_t out[8];
+    TEST_ASSERT_EQUAL_UINT32(0, codec::cobsDecode(bad, sizeof(bad), out, sizeof(out)));
+}
+
+// ---------------------------------------------------------------------------
+// Entry point called by the shared test runner in test_state_machine.cpp
+// ---------------------------------------------------------------------------
+
+void run_frame_codec_tests() {
+    RUN_TEST(test_codec_crc16_check_value);
+    RUN_TEST(test_codec_crc16_empty_is_init);
+    RUN_TEST(test_codec_cobs_known_vector);
+    RUN_TEST(test_codec_cobs_roundtrip_removes_zeros);
+    RUN_TEST(test_codec_cobs_roundtrip_long_nonzero_run);
+    RUN_TEST(test_codec_cobs_encode_rejects_small_buffer);
+    RUN_TEST(test_codec_cobs_decode_rejects_truncated);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file test_harmonic_window.cpp
+ * @brief Unit tests for the streaming Goertzel harmonic bins (harmonic_window.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_harmonic_window_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "harmonic_window.h"
+
+static constexpr uint16_t SPC = 32;   // samples per cycle, as ACS712_SAMPLES_PER_CYCLE
+
+/** Feed @p cycles whole cycles of a1·sin(θ) + a2·sin(2θ + φ) + a3·sin(3θ); return the last ratio. */
+static float feed(rms::HarmonicWindow& w, uint32_t cycles, float a1, float a2, float a3,
+                  float phase = 0.0f) {
+    float ratio = -1.0f;
+    for (uint32_t n = 0; n < cycles * SPC; ++n) {
+        const float th = 2.0f * static_cast<float>(M_PI) * static_cast<float>(n) / SPC;
+        const float x  = a1 * sinf(th) + a2 * sinf(2.0f * th + phase) + a3 * sinf(3.0f * th);
+        rms::harmonicWindowPush(w, static_cast<int32_t>(lroundf(x)), ratio);
+    }
+    return ratio;
+}
+
+void test_hw_completes_only_at_window_length() {
+    rms::HarmonicWindow w;
+    rms::harmonicWindowReset(w, 3, SPC);
+    float out = -1.0f;
+    TEST_ASSERT_FALSE(rms::harmonicWindowPush(w, 100, out));
+    TEST_ASSERT_FALSE(rms::harmonicWindowPush(w, 100, out));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, out);
+    TEST_ASSERT_TRUE(rms::harmonicWindowPush(w, 100, out));
+    TEST_ASSERT_EQUAL_UINT32(0, w.count);
+}
+
+void test_hw_clean_sine_has_no_harmonics() {
+    rms::HarmonicWindow w;
+    rms::harmonicWindowReset(w, 4u * SPC, SPC);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, feed(w, 4, 1000.0f, 0.0f, 0.0f));
+}
+
+void test_hw_ratio_is_amplitude_independent() {
+    rms::HarmonicWindow w;
+    rms::harmonicWindowReset(w, 4u * SPC, SPC);
+    const float small = feed(w, 4, 200.0f, 40.0f, 0.0f);
+    const float large = feed(w, 4, 1500.0f, 300.0f, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.2f, small);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.2f, large);
+}
+
+void test_hw_combines_second_and_third() {
+    rms::HarmonicWindow w;
+    rms::harmonicWindowReset(w, 8u * SPC, SPC);
+    // √(0.3² + 0.4²) = 0.5, whatever the 2nd harmonic's phase
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, feed(w, 8, 1000.0f, 300.0f, 400.0f, 1.0f));
+}
+
+void test_hw_clipped_sine_raises_ratio() {
+    rms::HarmonicWindow w;
+    rms::harmonicWindowReset(w, 4u * SPC, SPC);
+    float ratio = 0.0f;
+    for (uint32_t n = 0; n < 4u * SPC; ++n) {
+        float x = 1000.0f * sinf(2.0f * static_cast<float>(M_PI) * static_cast<float>(n) / SPC);
+        if (x > 400.0f) x = 400.0f;                  // one-sided: the piston hits its stop
+        rms::harmonicWindowPush(w, static_cast<int32_t>(x), ratio);
+    }
+    TEST_ASSERT_TRUE(ratio > 0.2f);
+}
+
+void test_hw_no_fundamental_reports_zero() {
+    rms::HarmonicWindow w;
+    rms::harmonicWindowReset(w, SPC, SPC);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, feed(w, 1, 0.0f, 0.0f, 0.0f));
+}
+
+void run_harmonic_window_tests() {
+    RUN_TEST(test_hw_completes_only_at_window_length);
+    RUN_TEST(test_hw_clean_sine_has_no_harmonics);
+    RUN_TEST(test_hw_ratio_is_amplitude_independent);
+    RUN_TEST(test_hw_combines_second_and_third);
+    RUN_TEST(test_hw_clipped_sine_raises_ratio);
+    RUN_TEST(test_hw_no_fundamental_reports_zero);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file test_indicator_pattern.cpp
+ * @brief Unit tests for the timestamp-phased indicator patterns (indicator_pattern.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_indicator_pattern_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include "indicator_pattern.h"
+
+using indicator::Colour;
+using indicator::Mode;
+using indicator::Output;
+using indicator::Pattern;
+
+static constexpr uint32_t FAST_HALF = INDICATOR_FLASH_FAST_PERIOD_MS / 2u;
+static constexpr uint32_t SLOW_HALF = INDICATOR_FLASH_SLOW_PERIOD_MS / 2u;
+
+void test_ip_steady_modes_ignore_time() {
+    TEST_ASSERT_FALSE(indicator::isLit(Mode::Off, 0));
+    TEST_ASSERT_FALSE(indicator::isLit(Mode::Off, 123456));
+    TEST_ASSERT_TRUE(indicator::isLit(Mode::SolidRed, 0));
+    TEST_ASSERT_TRUE(indicator::isLit(Mode::SolidAmber, 987654));
+}
+
+void test_ip_flash_starts_lit_and_toggles_each_half_period() {
+    TEST_ASSERT_TRUE(indicator::isLit(Mode::FlashFastRed, 0));
+    TEST_ASSERT_TRUE(indicator::isLit(Mode::FlashFastRed, FAST_HALF - 1u));
+    TEST_ASSERT_FALSE(indicator::isLit(Mode::FlashFastRed, FAST_HALF));
+    TEST_ASSERT_TRUE(indicator::isLit(Mode::FlashFastRed, 2u * FAST_HALF));
+    TEST_ASSERT_FALSE(indicator::isLit(Mode::FlashSlowGreen, SLOW_HALF));
+    TEST_ASSERT_TRUE(indicator::isLit(Mode::FlashSlowGreen, SLOW_HALF - 1u));
+}
+
+void test_ip_late_evaluation_keeps_phase() {
+    // Edges stay on the grid set by setFault(), however late the reads are
+    Pattern p;
+    p.setFault(Mode::FlashFastRed, 1000);
+    TEST_ASSERT_TRUE(p.evaluate(1000 + 7u).faultOn);
+    TEST_ASSERT_FALSE(p.evaluate(1000 + FAST_HALF + 90u).faultOn);   // one read 90 ms late
+    TEST_ASSERT_TRUE(p.evaluate(1000 + 2u * FAST_HALF).faultOn);     // next edge on time
+    TEST_ASSERT_FALSE(p.evaluate(1000 + 41u * FAST_HALF).faultOn);
+}
+
+void test_ip_same_mode_does_not_restart_phase() {
+    Pattern p;
+    p.setReady(Mode::FlashSlowGreen, 0);
+    p.setReady(Mode::FlashSlowGreen, SLOW_HALF);   // re-sent every control step
+    TEST_ASSERT_FALSE(p.evaluate(SLOW_HALF).readyOn);
+
+    p.setReady(Mode::FlashFastGreen, SLOW_HALF);   // a new mode does restart it
+    TEST_ASSERT_TRUE(p.evaluate(SLOW_HALF).readyOn);
+}
+
+void test_ip_phase_survives_millis_wrap() {
+    Pattern p;
+    p.setFault(Mode::FlashFastRed, 0xFFFFFFFFu - 10u);
+    TEST_ASSERT_TRUE(p.evaluate(5u).faultOn);                 // 16 ms after, across the wrap
+    TEST_ASSERT_FALSE(p.evaluate(FAST_HALF - 11u).faultOn);
+}
+
+void test_ip_colour_blend() {
+    Pattern p;
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(Colour::Black),
+                      static_cast<uint8_t>(p.evaluate(0).colour));
+
+    p.setFault(Mode::SolidRed, 0);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(Colour::Red),
+                      static_cast<uint8_t>(p.evaluate(0).colour));
+
+    p.setReady(Mode::FlashFastGreen, 0);   // both lit → amber
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(Colour::Amber),
+                      static_cast<uint8_t>(p.evaluate(0).colour));
+
+    p.setFault(Mode::Off, 0);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(Colour::Green),
+                      static_cast<uint8_t>(p.evaluate(0).colour));
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(Colour::Black),
+                      static_cast<uint8_t>(p.evaluate(FAST_HALF).colour));
+
+    p.setReady(Mode::SolidAmber, 0);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(Colour::Amber),
+                      static_cast<uint8_t>(p.evaluate(0).colour));
+}
+
+void test_ip_output_changes_only_on_edges() {
+    // What indicator.cpp's tick does: count the frames it would push
+    Pattern p;
+    p.setFault(Mode::FlashFastRed, 0);
+    p.setReady(Mode::SolidGreen, 0);
+    Output shown = {false, false, Colour::Black};
+    uint32_t writes = 0;
+    for (uint32_t t = 0; t < 10u * FAST_HALF; t += INDICATOR_TICK_MS) {
+        const Output o = p.evaluate(t);
+        if (o != shown) { ++writes; shown = o; }
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, writes);   // one per half period, none in between
+}
+
+void run_indicator_pattern_tests() {
+    RUN_TEST(test_ip_steady_modes_ignore_time);
+    RUN_TEST(test_ip_flash_starts_lit_and_toggles_each_half_period);
+    RUN_TEST(test_ip_late_evaluation_keeps_phase);
+    RUN_TEST(test_ip_same_mode_does_not_restart_phase);
+    RUN_TEST(test_ip_phase_survives_millis_wrap);
+    RUN_TEST(test_ip_colour_blend);
+    RUN_TEST(test_ip_output_changes_only_on_edges);
+}
@@ -0,0 +1,261 @@
+/**
+ * @file test_log_store.cpp
+ * @brief Unit tests for the circular flash record log.
+ *
+ * main() lives in test_state_machine.cpp and calls run_log_store_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include <string.h>
+#include "log_store.h"
+
+using run_log::Record;
+using run_log::RECORDS_PER_SECTOR;
+using run_log::RECORDS_PER_PAGE;
+
+// ---------------------------------------------------------------------------
+// RAM NOR flash: erase sets 0xFF, programming can only clear bits.
+// ---------------------------------------------------------------------------
+
+struct RamFlash {
+    static constexpr uint32_t SECTORS = 3;
+    uint8_t  mem[SECTORS * run_log::SECTOR_SIZE];
+    uint32_t writes      = 0;
+    uint32_t erases      = 0;
+    uint32_t overwrites  = 0;   // bytes programmed that were not erased
+    uint32_t lastWriteLen = 0;
+
+    RamFlash() { memset(mem, 0xFF, sizeof(mem)); }
+
+    uint32_t sectorCount() const { return SECTORS; }
+
+    bool read(uint32_t addr, void* dst, uint32_t len) {
+        if (addr + len > sizeof(mem)) return false;
+        memcpy(dst, mem + addr, len);
+        return true;
+    }
+
+    bool write(uint32_t addr, const void* src, uint32_t len) {
+        if (addr + len > sizeof(mem)) return false;
+        const uint8_t* p = static_cast<const uint8_t*>(src);
+        for (uint32_t i = 0; i < len; ++i) {
+            if (mem[addr + i] != 0xFFu) ++overwrites;
+            mem[addr + i] &= p[i];
+        }
+        ++writes;
+        lastWriteLen = len;
+        return true;
+    }
+
+    bool eraseSector(uint32_t sector) {
+        memset(mem + sector * run_log::SECTOR_SIZE, 0xFF, run_log::SECTOR_SIZE);
+        ++erases;
+        return true;
+    }
+};
+
+using Store = run_log::LogStore<RamFlash>;
+
+static Record sample(uint32_t timeMs) {
+    Record r{};
+    r.timeMs = timeMs;
+    r.type   = static_cast<uint8_t>(run_log::RecordType::Sample);
+    r.tempQ  = static_cast<uint16_t>(timeMs);
+    r.dac    = 1234;
+    return r;
+}
+
+static void appendN(Store& s, uint32_t n, uint32_t t0 = 0) {
+    for (uint32_t i = 0; i < n; ++i) TEST_ASSERT_TRUE(s.append(sample(t0 + i)));
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+void test_log_fresh_mount_is_empty() {
+    static RamFlash f;
+    f = RamFlash{};
+    Store s(f);
+    TEST_ASSERT_TRUE(s.mount());
+    TEST_ASSERT_EQUAL_UINT32(0, s.oldestSeq());
+    TEST_ASSERT_EQUAL_UINT32(0, s.nextSeq());
+    TEST_ASSERT_EQUAL_UINT32(2 * RECORDS_PER_SECTOR, s.capacity());
+    TEST_ASSERT_EQUAL_UINT32(0, f.erases);      // already blank
+    Record r;
+    TEST_ASSERT_FALSE(s.read(0, r));
+}
+
+void test_log_batches_records_into_page_writes() {
+    static RamFlash f;
+    f = RamFlash{};
+    Store s(f);
+    s.mount();
+    appendN(s, RECORDS_PER_PAGE - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, f.writes);
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_PAGE - 1, s.pending());
+
+    // Buffered records are readable before they reach flash
+    Record r;
+    TEST_ASSERT_TRUE(s.read(3, r));
+    TEST_ASSERT_EQUAL_UINT32(3, r.timeMs);
+
+    appendN(s, 1, RECORDS_PER_PAGE - 1);
+    TEST_ASSERT_EQUAL_UINT32(1, f.writes);
+    TEST_ASSERT_EQUAL_UINT32(run_log::PAGE_SIZE, f.lastWriteLen);
+    TEST_ASSERT_EQUAL_UINT32(0, s.pending());
+}
+
+void test_log_partial_flush_never_reprograms() {
+    static RamFlash f;
+    f = RamFlash{};
+    Store s(f);
+    s.mount();
+    appendN(s, 5);
+    TEST_ASSERT_TRUE(s.flush());
+    appendN(s, RECORDS_PER_PAGE - 5, 5);        // completes the same page
+    TEST_ASSERT_EQUAL_UINT32(2, f.writes);
+    TEST_ASSERT_EQUAL_UINT32(0, f.overwrites);
+
+    Record r;
+    for (uint32_t seq = 0; seq < RECORDS_PER_PAGE; ++seq) {
+        TEST_ASSERT_TRUE(s.read(seq, r));
+        TEST_ASSERT_EQUAL_UINT32(seq, r.seq);
+        TEST_ASSERT_EQUAL_UINT32(seq, r.timeMs);
+    }
+}
+
+void test_log_remount_resumes_after_newest() {
+    static RamFlash f;
+    f = RamFlash{};
+    {
+        Store s(f);
+        s.mount();
+        appendN(s, 300);
+        s.flush();
+    }
+    Store s(f);
+    TEST_ASSERT_TRUE(s.mount());
+    TEST_ASSERT_EQUAL_UINT32(0, s.oldestSeq());
+    TEST_ASSERT_EQUAL_UINT32(300, s.nextSeq());
+    appendN(s, 1, 300);
+    Record r;
+    TEST_ASSERT_TRUE(s.read(300, r));
+    TEST_ASSERT_EQUAL_UINT32(300, r.timeMs);
+    TEST_ASSERT_TRUE(s.read(299, r));
+    TEST_ASSERT_EQUAL_UINT32(299, r.timeMs);
+}
+
+void test_log_wraps_and_drops_oldest_sector() {
+    static RamFlash f;
+    f = RamFlash{};
+    Store s(f);
+    s.mount();
+    const uint32_t total = 3 * RECORDS_PER_SECTOR + 40;    // one lap plus a bit
+    appendN(s, total);
+    s.flush();
+
+    TEST_ASSERT_EQUAL_UINT32(total, s.nextSeq());
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SECTOR, s.oldestSeq());
+    TEST_ASSERT_EQUAL_UINT32(1, f.erases);                 // sector 0, reused once
+    TEST_ASSERT_EQUAL_UINT32(0, f.overwrites);
+
+    Record r;
+    TEST_ASSERT_FALSE(s.read(RECORDS_PER_SECTOR - 1, r));
+    TEST_ASSERT_TRUE(s.read(RECORDS_PER_SECTOR, r));
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SECTOR, r.timeMs);
+    TEST_ASSERT_TRUE(s.read(total - 1, r));
+    TEST_ASSERT_EQUAL_UINT32(total - 1, r.timeMs);
+
+    // A remount sees the same window
+    Store again(f);
+    TEST_ASSERT_TRUE(again.mount());
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SECTOR, again.oldestSeq());
+    TEST_ASSERT_EQUAL_UINT32(total, again.nextSeq());
+}
+
+void test_log_erase_ahead_keeps_erases_out_of_append() {
+    static RamFlash f;
+    f = RamFlash{};
+    Store s(f);
+    s.mount();
+
+    // Blank sectors ahead are only checked, never erased
+    TEST_ASSERT_TRUE(s.eraseAhead(1));
+    TEST_ASSERT_EQUAL_UINT32(0, f.erases);
+    TEST_ASSERT_FALSE(s.eraseAhead(1));   // one is enough
+
+    // One full lap: the head sits at the end of sector 2
+    f = RamFlash{};
+    Store full(f);
+    full.mount();
+    appendN(full, 3 * RECORDS_PER_SECTOR);
+    TEST_ASSERT_EQUAL_UINT32(0, full.oldestSeq());
+
+    // Sector 0 is erased ahead of need (at most sectorCount − 2 sectors)
+    TEST_ASSERT_TRUE(full.eraseAhead(8));
+    TEST_ASSERT_FALSE(full.eraseAhead(8));
+    TEST_ASSERT_EQUAL_UINT32(1, f.erases);
+    TEST_ASSERT_EQUAL_UINT32(1, full.erasedAhead());
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SECTOR, full.oldestSeq());
+    Record r;
+    TEST_ASSERT_FALSE(full.read(RECORDS_PER_SECTOR - 1, r));
+    TEST_ASSERT_TRUE(full.read(RECORDS_PER_SECTOR, r));
+
+    // Appends fill it without erasing; the next sector is erased as before
+    appendN(full, RECORDS_PER_SECTOR, 3 * RECORDS_PER_SECTOR);
+    TEST_ASSERT_EQUAL_UINT32(1, f.erases);
+    TEST_ASSERT_EQUAL_UINT32(0, full.erasedAhead());
+    TEST_ASSERT_EQUAL_UINT32(0, f.overwrites);
+    appendN(full, 1, 4 * RECORDS_PER_SECTOR);
+    TEST_ASSERT_EQUAL_UINT32(2, f.erases);
+    TEST_ASSERT_EQUAL_UINT32(2 * RECORDS_PER_SECTOR, full.oldestSeq());
+    TEST_ASSERT_TRUE(full.read(4 * RECORDS_PER_SECTOR - 1, r));
+    TEST_ASSERT_EQUAL_UINT32(4 * RECORDS_PER_SECTOR - 1, r.timeMs);
+}
+
+void test_log_torn_record_reads_as_missing() {
+    static RamFlash f;
+    f = RamFlash{};
+    {
+        Store s(f);
+        s.mount();
+        appendN(s, 20);
+        s.flush();
+    }
+    f.mem[19 * run_log::RECORD_SIZE + 4] &= 0x01;      // newest record half-programmed
+    Store s(f);
+    TEST_ASSERT_TRUE(s.mount());
+    TEST_ASSERT_EQUAL_UINT32(20, s.nextSeq());         // slot stays used
+    Record r;
+    TEST_ASSERT_FALSE(s.read(19, r));
+    TEST_ASSERT_TRUE(s.read(18, r));
+    appendN(s, 1, 20);
+    TEST_ASSERT_TRUE(s.read(20, r));
+}
+
+void test_log_record_crc_detects_bit_flip() {
+    Record r = sample(7);
+    r.crc = run_log::recordCrc(r);
+    TEST_ASSERT_TRUE(run_log::isValid(r));
+    r.dac ^= 1;
+    TEST_ASSERT_FALSE(run_log::isValid(r));
+
+    Record blank;
+    memset(&blank, 0xFF, sizeof(blank));
+    TEST_ASSERT_TRUE(run_log::isErased(blank));
+    TEST_ASSERT_FALSE(run_log::isValid(blank));
+}
+
+void run_log_store_tests() {
+    RUN_TEST(test_log_fresh_mount_is_empty);
+    RUN_TEST(test_log_batches_records_into_page_writes);
+    RUN_TEST(test_log_partial_flush_never_reprograms);
+    RUN_TEST(test_log_remount_resumes_after_newest);
+    RUN_TEST(test_log_wraps_and_drops_oldest_sector);
+    RUN_TEST(test_log_erase_ahead_keeps_erases_out_of_append);
+    RUN_TEST(test_log_torn_record_reads_as_missing);
+    RUN_TEST(test_log_record_crc_detects_bit_flip);
+}
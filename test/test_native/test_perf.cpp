@@ -0,0 +1,130 @@
+/**
+ * @file test_perf.cpp
+ * @brief Unit tests for the profiling histograms and probe table.
+ *
+ * main() lives in test_state_machine.cpp and calls run_perf_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include <cstring>
+#include "perf.h"
+
+void test_perf_buckets_exact_below_sixteen() {
+    for (uint32_t v = 0; v < 16; ++v) {
+        TEST_ASSERT_EQUAL_UINT8(v, perf::bucketOf(v));
+        TEST_ASSERT_EQUAL_UINT32(v, perf::bucketUpper(static_cast<uint8_t>(v)));
+    }
+}
+
+void test_perf_buckets_cover_values_contiguously() {
+    // Every bucket's range starts right after the previous one ends.
+    for (uint8_t b = 1; b < perf::HIST_BUCKETS; ++b) {
+        const uint32_t first = perf::bucketUpper(static_cast<uint8_t>(b - 1u)) + 1u;
+        TEST_ASSERT_EQUAL_UINT8(b, perf::bucketOf(first));
+        TEST_ASSERT_EQUAL_UINT8(b, perf::bucketOf(perf::bucketUpper(b)));
+    }
+    TEST_ASSERT_EQUAL_UINT8(perf::HIST_BUCKETS - 1u, perf::bucketOf(0xFFFFFFFFu));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFu, perf::bucketUpper(perf::HIST_BUCKETS - 1u));
+}
+
+void test_perf_bucket_width_within_a_quarter_octave() {
+    for (uint8_t b = 17; b < perf::HIST_BUCKETS; ++b) {
+        const float lo = static_cast<float>(perf::bucketUpper(static_cast<uint8_t>(b - 1u))) + 1.0f;
+        const float hi = static_cast<float>(perf::bucketUpper(b));
+        TEST_ASSERT_TRUE((hi - lo) / lo <= 0.25f);
+    }
+}
+
+void test_perf_histogram_min_mean_max() {
+    perf::Histogram h;
+    h.record(100);
+    h.record(300);
+    h.record(200);
+    TEST_ASSERT_EQUAL_UINT32(3, h.count());
+    TEST_ASSERT_EQUAL_UINT32(100, h.min());
+    TEST_ASSERT_EQUAL_UINT32(300, h.max());
+    TEST_ASSERT_EQUAL_UINT32(200, h.mean());
+}
+
+void test_perf_percentile_finds_the_tail() {
+    perf::Histogram h;
+    for (int i = 0; i < 990; ++i) h.record(1000);
+    for (int i = 0; i < 10; ++i)  h.record(50000);
+
+    // p50 falls in 1000's bucket; p99 is still 1000; p100 is the outlier.
+    TEST_ASSERT_EQUAL_UINT32(perf::bucketUpper(perf::bucketOf(1000)), h.percentile(0.5f));
+    TEST_ASSERT_EQUAL_UINT32(perf::bucketUpper(perf::bucketOf(1000)), h.percentile(0.99f));
+    TEST_ASSERT_EQUAL_UINT32(50000, h.percentile(1.0f));   // clamped to max
+    TEST_ASSERT_EQUAL_UINT32(0, perf::Histogram{}.percentile(0.99f));
+}
+
+void test_perf_saturation_halves_and_keeps_shape() {
+    perf::Histogram h;
+    for (uint32_t i = 0; i < 70000; ++i) h.record(10);
+    for (uint32_t i = 0; i < 1000; ++i)  h.record(5000);
+    TEST_ASSERT_EQUAL_UINT32(71000, h.count());
+    TEST_ASSERT_EQUAL_UINT32(10, h.percentile(0.9f));
+    TEST_ASSERT_EQUAL_UINT32(5000, h.percentile(1.0f));
+}
+
+void test_perf_take_peak_resets() {
+    perf::Histogram h;
+    h.record(40);
+    h.record(90);
+    TEST_ASSERT_EQUAL_UINT32(90, h.takePeak());
+    TEST_ASSERT_EQUAL_UINT32(0, h.takePeak());
+    h.record(20);
+    TEST_ASSERT_EQUAL_UINT32(20, h.takePeak());
+    TEST_ASSERT_EQUAL_UINT32(90, h.max());
+}
+
+void test_perf_scope_records_into_probe() {
+    perf::resetAll();
+    {
+        perf::Scope s(perf::Probe::RtdRead);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, perf::probe(perf::Probe::RtdRead).count());
+    TEST_ASSERT_EQUAL_UINT32(0, perf::probe(perf::Probe::DacRamp).count());
+    // resetAll() is applied by the probe's own next record()
+    perf::resetAll();
+    perf::record(perf::Probe::RtdRead, 7);
+    TEST_ASSERT_EQUAL_UINT32(1, perf::probe(perf::Probe::RtdRead).count());
+    TEST_ASSERT_EQUAL_UINT32(7, perf::probe(perf::Probe::RtdRead).max());
+    perf::resetAll();
+}
+
+void test_perf_reset_request_waits_for_record() {
+    perf::Histogram h;
+    h.record(40);
+    h.record(90);
+    h.requestReset();
+    TEST_ASSERT_EQUAL_UINT32(2, h.count());   // untouched until the recorder runs
+    h.record(20);
+    TEST_ASSERT_EQUAL_UINT32(1, h.count());
+    TEST_ASSERT_EQUAL_UINT32(20, h.min());
+    TEST_ASSERT_EQUAL_UINT32(20, h.max());
+    TEST_ASSERT_EQUAL_UINT32(20, h.percentile(1.0f));
+    h.record(30);
+    TEST_ASSERT_EQUAL_UINT32(2, h.count());   // one request, one clear
+}
+
+void test_perf_every_probe_is_named() {
+    for (uint8_t i = 0; i < perf::PROBE_COUNT; ++i) {
+        TEST_ASSERT_NOT_EQUAL(0, strcmp("?", perf::probeName(static_cast<perf::Probe>(i))));
+    }
+}
+
+void run_perf_tests() {
+    RUN_TEST(test_perf_buckets_exact_below_sixteen);
+    RUN_TEST(test_perf_buckets_cover_values_contiguously);
+    RUN_TEST(test_perf_bucket_width_within_a_quarter_octave);
+    RUN_TEST(test_perf_histogram_min_mean_max);
+    RUN_TEST(test_perf_percentile_finds_the_tail);
+    RUN_TEST(test_perf_saturation_halves_and_keeps_shape);
+    RUN_TEST(test_perf_take_peak_resets);
+    RUN_TEST(test_perf_scope_records_into_probe);
+    RUN_TEST(test_perf_reset_request_waits_for_record);
+    RUN_TEST(test_perf_every_probe_is_named);
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_pid_controller.cpp
+ * @brief Unit tests for the DAC PID / feed-forward controller.
+ *
+ * main() lives in test_state_machine.cpp and calls run_pid_controller_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdint.h>
+#include "pid_controller.h"
+#include "config.h"
+
+static const control::Gains P_ONLY = {10.0f, 0.0f, 0.0f};
+static const control::Gains PI     = {10.0f, 1.0f, 0.0f};
+
+void test_pid_proportional_plus_feedforward() {
+    control::Pid pid;
+    TEST_ASSERT_EQUAL_FLOAT(150.0f, pid.update(P_ONLY, 5.0f, 100.0f, 0.2f, 0.0f, 4095.0f));
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, pid.update(P_ONLY, -5.0f, 100.0f, 0.2f, 0.0f, 4095.0f));
+}
+
+void test_pid_integral_accumulates_with_dt() {
+    control::Pid pid;
+    for (int i = 0; i < 10; ++i) pid.update(PI, 2.0f, 0.0f, 0.5f, -1000.0f, 1000.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 10.0f, pid.integral());      // 1 × 2 × 5 s
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 30.0f, pid.output());
+}
+
+void test_pid_zero_dt_skips_integral_and_derivative() {
+    const control::Gains g = {1.0f, 1.0f, 1.0f};
+    control::Pid pid;
+    pid.update(g, 1.0f, 0.0f, 0.0f, -100.0f, 100.0f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, pid.update(g, 1.0f, 0.0f, 0.0f, -100.0f, 100.0f));
+}
+
+void test_pid_derivative_on_error_change() {
+    const control::Gains g = {0.0f, 0.0f, 2.0f};
+    control::Pid pid;
+    pid.update(g, 1.0f, 0.0f, 0.5f, -100.0f, 100.0f);            // first step: no D
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 4.0f, pid.update(g, 2.0f, 0.0f, 0.5f, -100.0f, 100.0f));
+}
+
+void test_pid_antiwindup_stops_at_limit() {
+    control::Pid pid;
+    for (int i = 0; i < 1000; ++i) pid.update(PI, 50.0f, 0.0f, 1.0f, 0.0f, 100.0f);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, pid.output());
+    TEST_ASSERT_TRUE(pid.saturated());
+    // P alone saturates, so the integrator never started winding up
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid.integral());
+
+    // So the output leaves the limit as soon as the error reverses
+    TEST_ASSERT_TRUE(pid.update(PI, -1.0f, 0.0f, 1.0f, 0.0f, 100.0f) < 1.0f);
+}
+
+void test_pid_integrates_exactly_to_lower_limit() {
+    control::Pid pid;
+    pid.reset(0.0f);
+    pid.update(PI, 0.0f, 0.0f, 0.0f, 0.0f, 100.0f);
+    pid.shift(3.0f);                                             // output 3
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid.update({0.0f, 10.0f, 0.0f}, -1.0f, 0.0f, 1.0f, 0.0f, 100.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, pid.integral());
+}
+
+void test_pid_hold_integral_freezes_integrator() {
+    control::Pid pid;
+    pid.update(PI, 4.0f, 0.0f, 1.0f, -100.0f, 100.0f);
+    const float before = pid.integral();
+    pid.update(PI, 4.0f, 0.0f, 1.0f, -100.0f, 100.0f, true);
+    TEST_ASSERT_EQUAL_FLOAT(before, pid.integral());
+}
+
+void test_pid_retune_is_bumpless() {
+    control::Pid pid;
+    for (int i = 0; i < 20; ++i) pid.update(PI, 3.0f, 200.0f, 1.0f, 0.0f, 4095.0f);
+    const float before = pid.output();
+
+    // New gains, new error definition, no feed-forward: output must not jump
+    const control::Gains hold = {400.0f, 4.0f, 0.0f};
+    pid.retune();
+    const float after = pid.update(hold, -2.0f, 0.0f, 0.0f, 0.0f, 4095.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, before, after);
+}
+
+void test_pid_shift_moves_output_and_sticks() {
+    control::Pid pid;
+    pid.update(PI, 0.0f, 1000.0f, 0.2f, 0.0f, 4095.0f);
+    pid.shift(-200.0f);
+    TEST_ASSERT_EQUAL_FLOAT(800.0f, pid.update(PI, 0.0f, 1000.0f, 0.2f, 0.0f, 4095.0f));
+}
+
+void test_lowpass_first_sample_passes_then_smooths() {
+    control::LowPass lp;
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, lp.update(5.0f, 0.2f, 1.0f));
+    const float v = lp.update(0.0f, 1.0f, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.5f, v);
+    TEST_ASSERT_EQUAL_FLOAT(7.0f, lp.update(7.0f, 0.2f, 0.0f));  // tau 0: pass-through
+}
+
+void test_approach_rate_tapers_to_zero() {
+    TEST_ASSERT_EQUAL_FLOAT(0.9f, control::approachRate(200.0f, 78.0f, 0.9f, 5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.4f, control::approachRate(80.0f, 78.0f, 0.9f, 5.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, control::approachRate(77.0f, 78.0f, 0.9f, 5.0f));
+}
+
+// ---------------------------------------------------------------------------
+// Closed loop against a first-order thermal model
+// ---------------------------------------------------------------------------
+
+// dT/dt = (T_amb − T) / TAU − GAIN × dac: ~2000 counts hold SETPOINT_K.
+static constexpr float PLANT_TAU_S = 3000.0f;
+static constexpr float PLANT_GAIN  = (AMBIENT_START_K - SETPOINT_K) / PLANT_TAU_S / 2000.0f;
+
+struct Plant {
+    float tempK;
+    float dac;      // slewed at dac::serviceRamp()'s limit per tick
+
+    /** Advance one tick toward @p target; return the cooling rate in K/min. */
+    float step(float target, float dtS) {
+        const float maxStep = static_cast<float>(DAC_MAX_STEP_PER_INTERVAL);
+        dac += fmaxf(-maxStep, fminf(maxStep, target - dac));
+        const float dTdt = (AMBIENT_START_K - tempK) / PLANT_TAU_S - PLANT_GAIN * dac;
+        tempK += dTdt * dtS;
+        return -dTdt * 60.0f;
+    }
+};
+
+void test_closed_loop_rate_tracks_target_below_limit() {
+    const control::Gains g = {CTRL_COARSE_KP, CTRL_COARSE_KI, 0.0f};
+    const float dtS = static_cast<float>(LOOP_INTERVAL_MS) * 0.001f;
+    control::Pid     pid;
+    control::LowPass filter;
+    Plant plant{AMBIENT_START_K, 0.0f};
+    float rate = 0.0f;
+    float peak = 0.0f;
+    for (int i = 0; i < 60 * 60 * 5; ++i) {                     // one hour
+        const float r  = filter.update(rate, dtS, CTRL_RATE_FILTER_TAU_S);
+        const float ff = (AMBIENT_START_K - plant.tempK) / (AMBIENT_START_K - SETPOINT_K) * 4095.0f;
+        const bool lag = fabsf(pid.output() - plant.dac) > DAC_MAX_STEP_PER_INTERVAL;
+        const float u  = pid.update(g, COOLDOWN_RATE_TARGET_K_PER_MIN - r, ff, dtS, 0.0f, 4095.0f, lag);
+        rate = plant.step(u, dtS);
+        if (i > 5 * 600) peak = fmaxf(peak, rate);               // after the first 10 min
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, COOLDOWN_RATE_TARGET_K_PER_MIN, rate);
+    TEST_ASSERT_TRUE(peak < MAX_COOLDOWN_RATE_K_PER_MIN);
+}
+
+void test_closed_loop_hold_settles_on_setpoint() {
+    const control::Gains g = {CTRL_HOLD_KP, CTRL_HOLD_KI, CTRL_HOLD_KD};
+    const float dtS = static_cast<float>(LOOP_INTERVAL_MS) * 0.001f;
+    control::Pid pid;
+    Plant plant{SETPOINT_K + 1.5f, 1500.0f};
+    pid.reset(plant.dac);
+    pid.retune();
+    for (int i = 0; i < 60 * 60 * 5; ++i) {
+        const bool lag = fabsf(pid.output() - plant.dac) > DAC_MAX_STEP_PER_INTERVAL;
+        const float u  = pid.update(g, plant.tempK - SETPOINT_K, 0.0f, dtS, 0.0f, 4095.0f, lag);
+        plant.step(u, dtS);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, SETPOINT_K, plant.tempK);
+    TEST_ASSERT_FLOAT_WITHIN(20.0f, 2000.0f, plant.dac);
+}
+
+void run_pid_controller_tests() {
+    RUN_TEST(test_pid_proportional_plus_feedforward);
+    RUN_TEST(test_pid_integral_accumulates_with_dt);
+    RUN_TEST(test_pid_zero_dt_skips_integral_and_derivative);
+    RUN_TEST(test_pid_derivative_on_error_change);
+    RUN_TEST(test_pid_antiwindup_stops_at_limit);
+    RUN_TEST(test_pid_integrates_exactly_to_lower_limit);
+    RUN_TEST(test_pid_hold_integral_freezes_integrator);
+    RUN_TEST(test_pid_retune_is_bumpless);
+    RUN_TEST(test_pid_shift_moves_output_and_sticks);
+    RUN_TEST(test_lowpass_first_sample_passes_then_smooths);
+    RUN_TEST(test_approach_rate_tapers_to_zero);
+    RUN_TEST(test_closed_loop_rate_tracks_target_below_limit);
+    RUN_TEST(test_closed_loop_hold_settles_on_setpoint);
+}
@@ -0,0 +1,190 @@
+/**
+ * @file test_replay.cpp
+ * @brief Unit tests for the telemetry capture replay (test/replay.h)
+ *
+ * main() lives in test_state_machine.cpp and calls run_replay_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+#include "../plant_sim.h"
+#include "../replay.h"
+#include "params.h"
+
+using state_machine::State;
+
+static constexpr uint32_t MINUTE_MS = 60000;
+static constexpr uint32_t HOUR_MS   = 60 * MINUTE_MS;
+
+static replay::Parser::Status parseLine(replay::Parser& p, const char* line, replay::Row& row) {
+    return p.parse(line, strlen(line), row);
+}
+
+// 21-column frame as telemetry::formatFrame() writes it
+static const char* FRAME_21 =
+    "/*2|CoarseCooldown|Cooling; cold stage is above 85K|250.50|-22.65|21.00|0.900|1200|1195|"
+    "0.00|0|0|1|0|60000|00:01:00|19.47|00:01:00|1.25|1|500*/\r";
+
+// ---------------------------------------------------------------------------
+// Parser
+// ---------------------------------------------------------------------------
+
+void test_replay_parses_full_frame() {
+    replay::Parser p;
+    replay::Row    r{};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(replay::Parser::Status::Ok),
+                            static_cast<uint8_t>(parseLine(p, FRAME_21, r)));
+    TEST_ASSERT_EQUAL_INT8(2, r.state);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 250.5f, r.tempK);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.9f, r.coolingRate);
+    TEST_ASSERT_EQUAL_UINT16(1200, r.dacTarget);
+    TEST_ASSERT_EQUAL_UINT16(1195, r.dacActual);
+    TEST_ASSERT_EQUAL_UINT32(60000, r.onDurationMs);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.25f, r.currentA);
+    TEST_ASSERT_TRUE(r.hasBackoff);
+    TEST_ASSERT_EQUAL_UINT16(1, r.backoffCount);
+}
+
+void test_replay_carries_empty_columns_forward() {
+    replay::Parser p;
+    replay::Row    r{};
+    parseLine(p, FRAME_21, r);
+    // Delta frame: slow columns empty, temp_k and dac_target changed
+    const char* delta = "/*2|||250.40|-22.75||0.910|1210|1200|0.00|||||60200||19.51||1.26||*/";
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(replay::Parser::Status::Ok),
+                            static_cast<uint8_t>(parseLine(p, delta, r)));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 250.4f, r.tempK);
+    TEST_ASSERT_EQUAL_UINT16(1210, r.dacTarget);
+    TEST_ASSERT_EQUAL_UINT16(1, r.backoffCount);        // carried
+}
+
+void test_replay_waits_for_required_columns() {
+    replay::Parser p;
+    replay::Row    r{};
+    const char* first = "/*2|||250.40||||1210|1200|0.00|||||60200||||1.26|0|*/";
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(replay::Parser::Status::Incomplete),
+                            static_cast<uint8_t>(parseLine(p, first, r)));
+}
+
+void test_replay_accepts_legacy_19_columns() {
+    replay::Parser p;
+    replay::Row    r{};
+    const char* legacy = "/*3|FineCooldown|x|84.00|-189.15|21.00|0.500|3900|3890|0.00|0|0|1|1|"
+                         "14400000|04:00:00|98.16|00:10:00|1.80*/";
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(replay::Parser::Status::Ok),
+                            static_cast<uint8_t>(parseLine(p, legacy, r)));
+    TEST_ASSERT_FALSE(r.hasBackoff);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.8f, r.currentA);
+}
+
+void test_replay_rejects_noise_and_bad_frames() {
+    replay::Parser p;
+    replay::Row    r{};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(replay::Parser::Status::NotAFrame),
+                            static_cast<uint8_t>(parseLine(p, "[OK] Telemetry enabled", r)));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(replay::Parser::Status::BadColumns),
+                            static_cast<uint8_t>(parseLine(p, "/*1|2|3*/", r)));
+    std::string bad(FRAME_21);
+    bad.replace(bad.find("250.50"), 6, "25O.50");
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(replay::Parser::Status::BadValue),
+                            static_cast<uint8_t>(parseLine(p, bad.c_str(), r)));
+}
+
+void test_replay_splits_lines_without_copying() {
+    const char data[] = "a\r\nbc\n\nd";
+    uint8_t count = 0;
+    size_t  total = 0;
+    replay::forEachLine(data, sizeof(data) - 1, [&](const char*, size_t n) {
+        ++count;
+        total += n;
+    });
+    TEST_ASSERT_EQUAL_UINT8(4, count);
+    TEST_ASSERT_EQUAL(5u, total);                       // "a\r", "bc", "", "d"
+}
+
+// ---------------------------------------------------------------------------
+// Replayer
+// ---------------------------------------------------------------------------
+
+void test_replay_of_simulated_capture_matches() {
+    // Record a cooldown from the plant simulation, then replay it
+    std::string capture;
+    sim::Rig rig;
+    rig.captureTo(&capture);
+    rig.start();
+    TEST_ASSERT_TRUE(rig.runUntil([](const sim::Rig& r) { return r.state() == State::Baseline; },
+                                  6 * HOUR_MS));
+    rig.run(MINUTE_MS);
+    rig.captureTo(nullptr);
+
+    replay::Replayer rep;
+    rep.feedAll(capture.data(), capture.size());
+    const replay::Summary& s = rep.summary();
+
+    TEST_ASSERT_TRUE(s.frames > 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, s.skipped);
+    TEST_ASSERT_EQUAL_UINT32(s.recordedTransitions, s.replayedTransitions);
+    TEST_ASSERT_EQUAL_UINT32(0, s.replayedFaults);
+    TEST_ASSERT_TRUE(s.stateMismatches * 200u < s.frames);   // edge ticks only
+    TEST_ASSERT_EQUAL(static_cast<int>(State::Baseline),
+                      static_cast<int>(rep.machine().getState()));
+}
+
+void test_replay_tracks_recorded_dac_target() {
+    // Open loop, the integrator drifts on the rounded inputs over hours;
+    // over the first half hour the replayed target matches the recording.
+    std::string capture;
+    sim::Rig rig;
+    rig.captureTo(&capture);
+    rig.start();
+    rig.run(30 * MINUTE_MS);
+    rig.captureTo(nullptr);
+
+    replay::Replayer rep;
+    rep.feedAll(capture.data(), capture.size());
+    TEST_ASSERT_EQUAL_UINT32(0, rep.summary().dacMismatches);
+    TEST_ASSERT_EQUAL_UINT32(0, rep.summary().stateMismatches);
+    TEST_ASSERT_EQUAL_UINT32(0, rep.summary().firstMismatchLine);
+}
+
+void test_replay_evaluates_a_changed_policy() {
+    // Recorded backoffs replay as overstrokes; a tighter limit faults
+    std::string capture;
+    sim::Rig rig;
+    rig.captureTo(&capture);
+    rig.start();
+    rig.run(30 * MINUTE_MS);
+    const uint32_t now = rig.clock.nowMs();
+    for (uint8_t i = 0; i < 3; ++i) rig.sensor.inject({now + 1000 + i * 5000u, 100, 3.0f});
+    rig.run(20000);
+    rig.captureTo(nullptr);
+    TEST_ASSERT_EQUAL_UINT16(3, rig.output().backoffCount);
+
+    const params::Change c[] = {{params::Id::BackoffMaxCount, 2.0f}};
+    params::apply(c, 1);
+    replay::Replayer rep;
+    rep.feedAll(capture.data(), capture.size());
+    params::resetDefaults();
+
+    TEST_ASSERT_EQUAL_UINT32(0, rep.summary().recordedFaults);
+    TEST_ASSERT_EQUAL_UINT32(1, rep.summary().replayedFaults);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(state_machine::FaultReason::TooManyBackoffs),
+                      static_cast<uint8_t>(rep.machine().getFaultReason()));
+    TEST_ASSERT_TRUE(rep.summary().firstMismatchLine > 0);
+}
+
+void run_replay_tests() {
+    RUN_TEST(test_replay_parses_full_frame);
+    RUN_TEST(test_replay_carries_empty_columns_forward);
+    RUN_TEST(test_replay_waits_for_required_columns);
+    RUN_TEST(test_replay_accepts_legacy_19_columns);
+    RUN_TEST(test_replay_rejects_noise_and_bad_frames);
+    RUN_TEST(test_replay_splits_lines_without_copying);
+    RUN_TEST(test_replay_of_simulated_capture_matches);
+    RUN_TEST(test_replay_tracks_recorded_dac_target);
+    RUN_TEST(test_replay_evaluates_a_changed_policy);
+}
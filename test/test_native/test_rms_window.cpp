@@ -0,0 +1,96 @@
+/**
+ * @file test_rms_window.cpp
+ * @brief Unit tests for the streaming true-RMS accumulator (rms_window.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_rms_window_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "rms_window.h"
+
+// ---------------------------------------------------------------------------
+// Window bookkeeping
+// ---------------------------------------------------------------------------
+
+void test_rw_completes_only_at_window_length() {
+    rms::RmsWindow w;
+    rms::rmsWindowReset(w, 4);
+    float out = -1.0f;
+    TEST_ASSERT_FALSE(rms::rmsWindowPush(w, 1, out));
+    TEST_ASSERT_FALSE(rms::rmsWindowPush(w, 1, out));
+    TEST_ASSERT_FALSE(rms::rmsWindowPush(w, 1, out));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, out);   // untouched until complete
+    TEST_ASSERT_TRUE(rms::rmsWindowPush(w, 1, out));
+}
+
+void test_rw_restarts_after_each_window() {
+    rms::RmsWindow w;
+    rms::rmsWindowReset(w, 2);
+    float out = 0.0f;
+    rms::rmsWindowPush(w, 10, out);
+    TEST_ASSERT_TRUE(rms::rmsWindowPush(w, 10, out));
+    TEST_ASSERT_EQUAL_UINT32(0, w.count);
+    TEST_ASSERT_FALSE(rms::rmsWindowPush(w, 3, out));
+    TEST_ASSERT_TRUE(rms::rmsWindowPush(w, 3, out));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.0f, out);   // no carry-over from first window
+}
+
+void test_rw_zero_length_is_treated_as_one() {
+    rms::RmsWindow w;
+    rms::rmsWindowReset(w, 0);
+    float out = 0.0f;
+    TEST_ASSERT_TRUE(rms::rmsWindowPush(w, -7, out));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 7.0f, out);
+}
+
+// ---------------------------------------------------------------------------
+// RMS values
+// ---------------------------------------------------------------------------
+
+void test_rw_constant_dc_rms_is_magnitude() {
+    rms::RmsWindow w;
+    rms::rmsWindowReset(w, 32);
+    float out = 0.0f;
+    for (int i = 0; i < 32; ++i) { rms::rmsWindowPush(w, -250, out); }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 250.0f, out);
+}
+
+void test_rw_sine_whole_cycles_rms_is_peak_over_root2() {
+    // 4 cycles × 32 samples per cycle, amplitude 1000 counts.
+    rms::RmsWindow w;
+    rms::rmsWindowReset(w, 128);
+    float out = 0.0f;
+    bool  done = false;
+    for (int i = 0; i < 128; ++i) {
+        const double phase = 2.0 * M_PI * static_cast<double>(i) / 32.0;
+        done = rms::rmsWindowPush(w, static_cast<int32_t>(lround(1000.0 * sin(phase))), out);
+    }
+    TEST_ASSERT_TRUE(done);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 1000.0f / sqrtf(2.0f), out);
+}
+
+void test_rw_full_scale_does_not_overflow() {
+    // 30 cycles × 32 samples at ±4095 counts must not wrap the accumulator.
+    rms::RmsWindow w;
+    rms::rmsWindowReset(w, 960);
+    float out = 0.0f;
+    for (int i = 0; i < 960; ++i) {
+        rms::rmsWindowPush(w, (i & 1) ? 4095 : -4095, out);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 4095.0f, out);
+}
+
+// ---------------------------------------------------------------------------
+// Entry point called by the shared test runner in test_state_machine.cpp
+// ---------------------------------------------------------------------------
+
+void run_rms_window_tests() {
+    RUN_TEST(test_rw_completes_only_at_window_length);
+    RUN_TEST(test_rw_restarts_after_each_window);
+    RUN_TEST(test_rw_zero_length_is_treated_as_one);
+    RUN_TEST(test_rw_constant_dc_rms_is_magnitude);
+    RUN_TEST(test_rw_sine_whole_cycles_rms_is_peak_over_root2);
+    RUN_TEST(test_rw_full_scale_does_not_overflow);
+}
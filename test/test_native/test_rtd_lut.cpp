@@ -0,0 +1,133 @@
+/**
+ * @file test_rtd_lut.cpp
+ * @brief Unit tests for the compile-time RTD code → temperature table and
+ *        the calibration curves it is built from.
+ *
+ * main() lives in test_state_machine.cpp and calls run_rtd_lut_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include "config.h"
+#include "rtd_lut.h"
+
+// Same parameters as temperature.cpp; built by the compiler, not at run time.
+static constexpr rtd::RtdLut LUT =
+    rtd::makeRtdLut(RTD_CURVE, RTD_RREF, RTD_LUT_MIN_K, RTD_LUT_MAX_K);
+
+static_assert(LUT.count <= rtd::LUT_CAPACITY, "LUT overflows its capacity");
+static_assert(LUT.milliK[0] <= 40000, "LUT must start at or below RTD_LUT_MIN_K");
+
+/** Ideal MAX31865 code for an RTD at @p kelvin (float reference path). */
+static uint16_t codeAt(double kelvin) {
+    const double ohms = rtd::cvdResistance(RTD_RNOMINAL, kelvin - 273.15);
+    return static_cast<uint16_t>(ohms / RTD_RREF * rtd::CODE_FULL_SCALE + 0.5);
+}
+
+void test_rtd_cvd_reference_points() {
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 100.0f, static_cast<float>(rtd::cvdResistance(100.0, 0.0)));
+    // IEC 60751 table: 18.52 Ω at −200 °C, 138.51 Ω at 100 °C
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 18.52f, static_cast<float>(rtd::cvdResistance(100.0, -200.0)));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 138.51f, static_cast<float>(rtd::cvdResistance(100.0, 100.0)));
+}
+
+void test_rtd_cvd_inverse_roundtrip() {
+    for (double k = 40.0; k <= 300.0; k += 13.0) {
+        const double ohms = rtd::cvdResistance(100.0, k - 273.15);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, static_cast<float>(k),
+                                 static_cast<float>(rtd::cvdKelvin(100.0, ohms)));
+    }
+}
+
+void test_rtd_lut_matches_float_path() {
+    // Interpolation error across the cryogenic range stays well below the
+    // one-code quantisation of the MAX31865 (~0.03 K near 77 K).
+    for (uint16_t code = codeAt(45.0); code <= codeAt(295.0); code += 7) {
+        const double ohms  = static_cast<double>(code) / rtd::CODE_FULL_SCALE * RTD_RREF;
+        const int32_t ref  = static_cast<int32_t>(rtd::cvdKelvin(RTD_RNOMINAL, ohms) * 1000.0 + 0.5);
+        TEST_ASSERT_INT_WITHIN(5, ref, rtd::lookupMilliK(LUT, code));
+    }
+}
+
+void test_rtd_lut_liquid_nitrogen() {
+    TEST_ASSERT_INT_WITHIN(40, 77350, rtd::lookupMilliK(LUT, codeAt(77.35)));
+}
+
+void test_rtd_lut_clamps_outside_range() {
+    TEST_ASSERT_EQUAL_INT32(LUT.milliK[0], rtd::lookupMilliK(LUT, 0));
+    TEST_ASSERT_EQUAL_INT32(LUT.milliK[LUT.count - 1], rtd::lookupMilliK(LUT, 32767));
+    TEST_ASSERT_TRUE(rtd::lookupMilliK(LUT, 32767) >= 300000);
+}
+
+// ---------------------------------------------------------------------------
+// Calibration curves
+// ---------------------------------------------------------------------------
+
+/** Breakpoint table sampled from the PT100 curve every 20 K (40..300 K). */
+constexpr rtd::TableCurve<14> sampledPt100() {
+    rtd::TableCurve<14> t{};
+    for (size_t i = 0; i < 14; ++i) {
+        const double k = 40.0 + 20.0 * static_cast<double>(i);
+        t.points[i] = {rtd::PT100.ohmsAt(k), k};
+    }
+    return t;
+}
+
+static constexpr rtd::TableCurve<14> TABLE_PT100 = sampledPt100();
+static constexpr rtd::RtdLut TABLE_LUT = rtd::makeRtdLut(TABLE_PT100, RTD_RREF, 40.0, 300.0);
+static constexpr rtd::RtdLut PT1000_LUT = rtd::makeRtdLut(rtd::PT1000, 4300.0, 40.0, 300.0);
+
+void test_rtd_table_curve_hits_breakpoints() {
+    for (const auto& p : TABLE_PT100.points) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, static_cast<float>(p.kelvin),
+                                 static_cast<float>(TABLE_PT100.kelvinAt(p.ohms)));
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, static_cast<float>(p.ohms),
+                                 static_cast<float>(TABLE_PT100.ohmsAt(p.kelvin)));
+    }
+}
+
+void test_rtd_table_curve_clamps() {
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 40.0f, static_cast<float>(TABLE_PT100.kelvinAt(0.0)));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 300.0f, static_cast<float>(TABLE_PT100.kelvinAt(500.0)));
+}
+
+void test_rtd_table_lut_tracks_source_curve() {
+    // Chords 20 K apart sit within ~0.3 K of the CVD curve they sample.
+    for (double k = 45.0; k <= 295.0; k += 10.0) {
+        const int32_t got = rtd::lookupMilliK(TABLE_LUT, codeAt(k));
+        TEST_ASSERT_INT_WITHIN(300, static_cast<int32_t>(k * 1000.0), got);
+    }
+}
+
+void test_rtd_pt1000_lut_matches_pt100_at_same_ratio() {
+    // RREF scales with R0 (430 Ω ↔ 4300 Ω), so the same code means the same temperature.
+    const rtd::RtdLut pt100 = rtd::makeRtdLut(rtd::PT100, 430.0, 40.0, 300.0);
+    for (uint16_t code = 1000; code <= 8000; code += 500) {
+        TEST_ASSERT_INT_WITHIN(2, rtd::lookupMilliK(pt100, code),
+                               rtd::lookupMilliK(PT1000_LUT, code));
+    }
+}
+
+void test_rtd_lut_is_monotonic() {
+    for (uint16_t i = 1; i < LUT.count; ++i) {
+        TEST_ASSERT_TRUE(LUT.milliK[i] > LUT.milliK[i - 1]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Entry point called by the shared test runner in test_state_machine.cpp
+// ---------------------------------------------------------------------------
+
+void run_rtd_lut_tests() {
+    RUN_TEST(test_rtd_cvd_reference_points);
+    RUN_TEST(test_rtd_cvd_inverse_roundtrip);
+    RUN_TEST(test_rtd_lut_matches_float_path);
+    RUN_TEST(test_rtd_lut_liquid_nitrogen);
+    RUN_TEST(test_rtd_lut_clamps_outside_range);
+    RUN_TEST(test_rtd_lut_is_monotonic);
+    RUN_TEST(test_rtd_table_curve_hits_breakpoints);
+    RUN_TEST(test_rtd_table_curve_clamps);
+    RUN_TEST(test_rtd_table_lut_tracks_source_curve);
+    RUN_TEST(test_rtd_pt1000_lut_matches_pt100_at_same_ratio);
+}
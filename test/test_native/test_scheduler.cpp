@@ -0,0 +1,185 @@
+/**
+ * @file test_scheduler.cpp
+ * @brief Unit tests for the cooperative control-core scheduler.
+ *
+ * main() lives in test_state_machine.cpp and calls run_scheduler_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include "scheduler.h"
+
+// ---------------------------------------------------------------------------
+// Fake clock and jobs: each job records its run and may advance the clock
+// to simulate execution time.
+// ---------------------------------------------------------------------------
+
+static uint32_t fakeNowUs = 0;
+static uint32_t fakeClock() { return fakeNowUs; }
+
+static uint32_t runsA = 0, runsB = 0;
+static uint32_t costA = 0;
+static char     order[16];
+static uint8_t  orderLen = 0;
+
+static void jobA() { ++runsA; fakeNowUs += costA; if (orderLen < 15) order[orderLen++] = 'A'; }
+static void jobB() { ++runsB; if (orderLen < 15) order[orderLen++] = 'B'; }
+
+static void resetFakes(uint32_t nowUs) {
+    fakeNowUs = nowUs;
+    runsA = runsB = 0;
+    costA = 0;
+    orderLen = 0;
+    for (char& c : order) c = '\0';
+}
+
+void test_sched_first_release_at_phase() {
+    resetFakes(1000);
+    sched::Task tasks[] = {{"a", jobA, 100, 30, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+
+    TEST_ASSERT_EQUAL_UINT32(30, s.runDue());
+    TEST_ASSERT_EQUAL_UINT32(0, runsA);
+    fakeNowUs = 1030;
+    TEST_ASSERT_EQUAL_UINT32(100, s.runDue());
+    TEST_ASSERT_EQUAL_UINT32(1, runsA);
+}
+
+void test_sched_periods_are_independent() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"a", jobA, 10, 0, 0, 0, {}}, {"b", jobB, 25, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 2, fakeClock);
+    s.start();
+    for (fakeNowUs = 0; fakeNowUs < 100; ++fakeNowUs) s.runDue();
+    TEST_ASSERT_EQUAL_UINT32(10, runsA);
+    TEST_ASSERT_EQUAL_UINT32(4, runsB);
+}
+
+void test_sched_runs_in_table_order() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"b", jobB, 10, 0, 0, 0, {}}, {"a", jobA, 10, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 2, fakeClock);
+    s.start();
+    s.runDue();
+    TEST_ASSERT_EQUAL_STRING("BA", order);
+}
+
+void test_sched_late_start_keeps_grid() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"a", jobA, 100, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+    fakeNowUs = 40;                       // 40 µs late
+    TEST_ASSERT_EQUAL_UINT32(60, s.runDue());
+    TEST_ASSERT_EQUAL_UINT32(100, tasks[0].nextUs);
+    TEST_ASSERT_EQUAL_UINT32(40, tasks[0].stats.maxLateUs);
+    TEST_ASSERT_EQUAL_UINT32(0, tasks[0].stats.skipped);
+}
+
+void test_sched_missed_releases_are_skipped_not_replayed() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"a", jobA, 100, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+    fakeNowUs = 350;                      // releases at 100, 200, 300 missed
+    s.runDue();
+    s.runDue();
+    TEST_ASSERT_EQUAL_UINT32(1, runsA);
+    TEST_ASSERT_EQUAL_UINT32(3, tasks[0].stats.skipped);
+    TEST_ASSERT_EQUAL_UINT32(400, tasks[0].nextUs);
+}
+
+void test_sched_records_wcet_and_overruns() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"a", jobA, 100, 0, 50, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+
+    costA = 20;
+    s.runDue();
+    fakeNowUs = 100; costA = 70;          // over the 50 µs budget
+    s.runDue();
+    fakeNowUs = 200; costA = 30;
+    s.runDue();
+
+    const sched::TaskStats& st = tasks[0].stats;
+    TEST_ASSERT_EQUAL_UINT32(3, st.runs);
+    TEST_ASSERT_EQUAL_UINT32(70, st.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(30, st.lastUs);
+    TEST_ASSERT_EQUAL_UINT64(120, st.totalUs);
+    TEST_ASSERT_EQUAL_UINT32(1, st.overruns);
+}
+
+void test_sched_budget_defaults_to_period() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"a", jobA, 100, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+    costA = 100;
+    s.runDue();
+    TEST_ASSERT_EQUAL_UINT32(0, tasks[0].stats.overruns);
+    fakeNowUs = 200; costA = 101;
+    s.runDue();
+    TEST_ASSERT_EQUAL_UINT32(1, tasks[0].stats.overruns);
+}
+
+void test_sched_survives_clock_wrap() {
+    resetFakes(0xFFFFFFF0u);
+    sched::Task tasks[] = {{"a", jobA, 32, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+    s.runDue();                           // release at 0xFFFFFFF0
+    TEST_ASSERT_EQUAL_UINT32(32, s.runDue());
+    fakeNowUs = 0x10;                     // wrapped; next release due now
+    TEST_ASSERT_EQUAL_UINT32(32, s.runDue());
+    TEST_ASSERT_EQUAL_UINT32(2, runsA);
+    TEST_ASSERT_EQUAL_UINT32(0, tasks[0].stats.skipped);
+}
+
+void test_sched_set_period_takes_effect_after_next_run() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"a", jobA, 100, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+    s.runDue();                           // next at 100
+    s.setPeriod(0, 10);
+    fakeNowUs = 100;
+    TEST_ASSERT_EQUAL_UINT32(10, s.runDue());
+}
+
+void test_sched_reset_stats_is_deferred_to_run_due() {
+    resetFakes(0);
+    sched::Task tasks[] = {{"a", jobA, 100, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, fakeClock);
+    s.start();
+    s.runDue();
+    s.resetStats();
+    TEST_ASSERT_EQUAL_UINT32(1, tasks[0].stats.runs);
+    fakeNowUs = 50;
+    s.runDue();
+    TEST_ASSERT_EQUAL_UINT32(0, tasks[0].stats.runs);
+}
+
+void test_sched_find_by_name() {
+    sched::Task tasks[] = {{"rtd", jobA, 1, 0, 0, 0, {}}, {"rt", jobB, 1, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 2, fakeClock);
+    TEST_ASSERT_EQUAL_UINT8(1, s.find("rt"));
+    TEST_ASSERT_EQUAL_UINT8(0, s.find("rtd"));
+    TEST_ASSERT_EQUAL_UINT8(2, s.find("dac"));
+}
+
+void run_scheduler_tests() {
+    RUN_TEST(test_sched_first_release_at_phase);
+    RUN_TEST(test_sched_periods_are_independent);
+    RUN_TEST(test_sched_runs_in_table_order);
+    RUN_TEST(test_sched_late_start_keeps_grid);
+    RUN_TEST(test_sched_missed_releases_are_skipped_not_replayed);
+    RUN_TEST(test_sched_records_wcet_and_overruns);
+    RUN_TEST(test_sched_budget_defaults_to_period);
+    RUN_TEST(test_sched_survives_clock_wrap);
+    RUN_TEST(test_sched_set_period_takes_effect_after_next_run);
+    RUN_TEST(test_sched_reset_stats_is_deferred_to_run_due);
+    RUN_TEST(test_sched_find_by_name);
+}
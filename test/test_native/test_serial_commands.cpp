@@ -11,6 +11,9 @@
 #include <cstring>
 #include "Print.h"
 #include "serial_commands.h"
+#include "params.h"
+#include "perf.h"
+#include "scheduler.h"
 #include "state_machine.h"
 #include "telemetry.h"
 
@@ -25,6 +28,9 @@ static void resetAll() {
     state_machine::init(0);
     serial_commands::init();
     telemetry::enable();  // always start with telemetry on
+    telemetry::setFormat(telemetry::Format::Csv);
+    telemetry::resetSchedule();
+    params::resetDefaults();
 }
 
 // ---------------------------------------------------------------------------
@@ -258,6 +264,341 @@ void test_sc_telemetry_off_idempotent() {
     TEST_ASSERT_FALSE(telemetry::isEnabled());
 }
 
+void test_sc_telemetry_stats_reports_counters() {
+    resetAll();
+    telemetry::resetStats();
+    Print p;
+    serial_commands::processLine("telemetry stats", p);
+    TEST_ASSERT_TRUE(p.contains("[OK]"));
+    TEST_ASSERT_TRUE(p.contains("dropped 0"));
+    TEST_ASSERT_TRUE(p.contains("high-water"));
+}
+
+void test_sc_telemetry_stats_reset_matches_longer_name() {
+    // "telemetry stats reset" must not be swallowed by "telemetry stats".
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry stats reset", p);
+    TEST_ASSERT_TRUE(p.contains("[OK] Telemetry counters reset"));
+}
+
+void test_sc_telemetry_binary_and_csv_switch_format() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry binary", p);
+    TEST_ASSERT_TRUE(p.contains("[OK]"));
+    TEST_ASSERT_EQUAL(telemetry::Format::Binary, telemetry::getFormat());
+    p.reset();
+    serial_commands::processLine("telemetry csv", p);
+    TEST_ASSERT_TRUE(p.contains("[OK]"));
+    TEST_ASSERT_EQUAL(telemetry::Format::Csv, telemetry::getFormat());
+}
+
+void test_sc_telemetry_descriptor_requires_binary() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry descriptor", p);
+    TEST_ASSERT_TRUE(p.contains("[ERR]"));
+    p.reset();
+    telemetry::setFormat(telemetry::Format::Binary);
+    serial_commands::processLine("telemetry descriptor", p);
+    TEST_ASSERT_TRUE(p.contains("[OK]"));
+    telemetry::setFormat(telemetry::Format::Csv);
+}
+
+void test_sc_telemetry_rate_sets_divisor() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry rate 5", p);
+    TEST_ASSERT_TRUE(p.contains("[OK]"));
+    TEST_ASSERT_EQUAL_UINT8(5, telemetry::getSteadyDivisor());
+}
+
+void test_sc_telemetry_rate_rejects_bad_values() {
+    resetAll();
+    const char* bad[] = {"telemetry rate", "telemetry rate 0", "telemetry rate 256",
+                         "telemetry rate 5x"};
+    for (const char* line : bad) {
+        Print p;
+        serial_commands::processLine(line, p);
+        TEST_ASSERT_TRUE(p.contains("[ERR] Usage"));
+    }
+    TEST_ASSERT_EQUAL_UINT8(TELEMETRY_STEADY_DIVISOR, telemetry::getSteadyDivisor());
+}
+
+void test_sc_telemetry_fields_mask_and_all() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry fields 0x9", p);
+    TEST_ASSERT_TRUE(p.contains("[OK]"));
+    TEST_ASSERT_EQUAL_UINT32(0x9, telemetry::getFieldMask());
+    p.reset();
+    serial_commands::processLine("telemetry fields all", p);
+    TEST_ASSERT_EQUAL_UINT32(telemetry::FIELD_MASK_ALL, telemetry::getFieldMask());
+    p.reset();
+    serial_commands::processLine("telemetry fields 0x1000000", p);  // column 25
+    TEST_ASSERT_TRUE(p.contains("[ERR]"));
+}
+
+void test_sc_telemetry_delta_and_keyframe() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry delta on", p);
+    TEST_ASSERT_TRUE(telemetry::isDeltaMode());
+    serial_commands::processLine("telemetry keyframe 10", p);
+    TEST_ASSERT_EQUAL_UINT16(10, telemetry::getKeyframeInterval());
+    p.reset();
+    serial_commands::processLine("telemetry delta maybe", p);
+    TEST_ASSERT_TRUE(p.contains("[ERR]"));
+    p.reset();
+    serial_commands::processLine("telemetry config", p);
+    TEST_ASSERT_TRUE(p.contains("delta on"));
+    TEST_ASSERT_TRUE(p.contains("keyframe 10"));
+}
+
+// ---------------------------------------------------------------------------
+// capture
+// ---------------------------------------------------------------------------
+
+void test_sc_capture_commands_unavailable_on_native() {
+    // No sampler on the host build: every capture command reports an error
+    // rather than falling through to the shorter "capture" name.
+    resetAll();
+    const char* lines[] = {"capture", "capture dump", "capture rearm"};
+    for (const char* line : lines) {
+        Print p;
+        serial_commands::processLine(line, p);
+        TEST_ASSERT_TRUE(p.contains("[ERR] Capture not available"));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// baseline
+// ---------------------------------------------------------------------------
+
+void test_sc_baseline_reports_every_channel() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("baseline", p);
+    TEST_ASSERT_TRUE(p.contains("[OK] Baseline idle"));
+    TEST_ASSERT_TRUE(p.contains("tempK"));
+    TEST_ASSERT_TRUE(p.contains("currentA"));
+    TEST_ASSERT_TRUE(p.contains("dac"));
+    TEST_ASSERT_TRUE(p.contains("rmsV"));
+    TEST_ASSERT_TRUE(p.contains("hist"));
+}
+
+// ---------------------------------------------------------------------------
+// tasks
+// ---------------------------------------------------------------------------
+
+static uint32_t scFakeUs = 0;
+static uint32_t scClock() { return scFakeUs; }
+static void     scJob()   { scFakeUs += 42; }
+
+void test_sc_tasks_without_scheduler_errors() {
+    serial_commands::setScheduler(nullptr);
+    Print p;
+    serial_commands::processLine("tasks", p);
+    TEST_ASSERT_TRUE(p.contains("[ERR] No scheduler"));
+}
+
+void test_sc_tasks_reports_and_resets_stats() {
+    sched::Task tasks[] = {{"rtd", scJob, 1000, 0, 0, 0, {}}};
+    sched::Scheduler s(tasks, 1, scClock);
+    scFakeUs = 0;
+    s.start();
+    s.runDue();
+    serial_commands::setScheduler(&s);
+
+    Print p;
+    serial_commands::processLine("tasks", p);
+    TEST_ASSERT_TRUE(p.contains("[OK] Tasks"));
+    TEST_ASSERT_TRUE(p.contains("rtd"));
+    TEST_ASSERT_TRUE(p.contains("|    42 |"));   // last = one job run
+
+    Print r;
+    serial_commands::processLine("tasks reset", r);
+    TEST_ASSERT_TRUE(r.contains("[OK] Task statistics reset"));
+    s.runDue();
+    TEST_ASSERT_EQUAL_UINT32(0, tasks[0].stats.runs);
+
+    serial_commands::setScheduler(nullptr);
+}
+
+// ---------------------------------------------------------------------------
+// perf
+// ---------------------------------------------------------------------------
+
+void test_sc_perf_reports_probes_and_resets() {
+    perf::resetAll();
+    perf::record(perf::Probe::RtdRead, 12000);   // 12 us at the native 1000 "MHz"
+
+    Print p;
+    serial_commands::processLine("perf", p);
+    TEST_ASSERT_TRUE(p.contains("[OK] Perf"));
+    TEST_ASSERT_TRUE(p.contains("rtd"));
+    TEST_ASSERT_TRUE(p.contains("12.0"));
+
+    Print r;
+    serial_commands::processLine("perf reset", r);
+    TEST_ASSERT_TRUE(r.contains("[OK] Perf probes reset"));
+    // Cleared by the recorder at its next sample
+    perf::record(perf::Probe::RtdRead, 3000);
+    TEST_ASSERT_EQUAL_UINT32(1, perf::probe(perf::Probe::RtdRead).count());
+    TEST_ASSERT_EQUAL_UINT32(3000, perf::probe(perf::Probe::RtdRead).max());
+}
+
+// ---------------------------------------------------------------------------
+// spi
+// ---------------------------------------------------------------------------
+
+void test_sc_spi_not_available_natively() {
+    const char* lines[] = {"spi", "spi reset"};
+    for (const char* line : lines) {
+        Print p;
+        serial_commands::processLine(line, p);
+        TEST_ASSERT_TRUE(p.contains("[ERR] SPI bus not available"));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tokenized dispatch
+// ---------------------------------------------------------------------------
+
+void test_sc_extra_blanks_between_words_still_match() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry \t  rate   5", p);
+    TEST_ASSERT_TRUE(p.contains("[OK]"));
+    TEST_ASSERT_EQUAL_UINT8(5, telemetry::getSteadyDivisor());
+}
+
+void test_sc_longest_command_name_wins() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry stats reset", p);
+    TEST_ASSERT_TRUE(p.contains("[OK] Telemetry counters reset"));
+}
+
+void test_sc_extra_argument_is_rejected() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("telemetry rate 5 6", p);
+    TEST_ASSERT_TRUE(p.contains("[ERR] Usage: telemetry rate"));
+}
+
+void test_sc_overlong_line_is_reported() {
+    resetAll();
+    char line[300];
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    Print p;
+    serial_commands::processLine(line, p);
+    TEST_ASSERT_TRUE(p.contains("[ERR] Line too long"));
+}
+
+void test_sc_help_filters_by_word() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("help capture", p);
+    TEST_ASSERT_TRUE(p.contains("capture dump"));
+    TEST_ASSERT_FALSE(p.contains("telemetry"));
+}
+
+// ---------------------------------------------------------------------------
+// set / get
+// ---------------------------------------------------------------------------
+
+void test_sc_set_applies_typed_values() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("set setpoint 77.5 rate 0.8", p);
+    TEST_ASSERT_TRUE(p.contains("[OK] setpoint"));
+    TEST_ASSERT_TRUE(p.contains("77.500"));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 77.5f, params::get(params::Id::SetpointK));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, params::get(params::Id::CooldownRate));
+
+    p.reset();
+    serial_commands::processLine("get rate", p);
+    TEST_ASSERT_TRUE(p.contains("0.800"));
+}
+
+void test_sc_set_rejects_whole_batch_on_error() {
+    resetAll();
+    const char* lines[] = {
+        "set setpoint 77.5 rate 9",          // out of range
+        "set setpoint 77.5 rate fast",       // not a number
+        "set setpoint 77.5 bogus 1",         // unknown name
+        "set setpoint",                      // missing value
+        "set setpoint 84",                   // band reaches the threshold
+    };
+    for (const char* line : lines) {
+        Print p;
+        serial_commands::processLine(line, p);
+        TEST_ASSERT_TRUE(p.contains("[ERR]"));
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, SETPOINT_K, params::get(params::Id::SetpointK));
+    }
+}
+
+void test_sc_get_profile_round_trips_through_set() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("set setpoint 77.25 debounce 1500 backoff 150", p);
+    p.reset();
+    serial_commands::processLine("get profile", p);
+    TEST_ASSERT_TRUE(p.contains("set setpoint 77.2500 "));
+    TEST_ASSERT_TRUE(p.contains(" debounce 1500 "));
+
+    // Replaying the line on a unit at defaults reproduces the profile
+    char line[300];
+    strncpy(line, p.str(), sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    line[strcspn(line, "\r\n")] = '\0';
+    params::resetDefaults();
+    p.reset();
+    serial_commands::processLine(line, p);
+    TEST_ASSERT_FALSE(p.contains("[ERR]"));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 77.25f, params::get(params::Id::SetpointK));
+    TEST_ASSERT_EQUAL_UINT32(1500, params::getUint(params::Id::OverstrokeDebounceMs));
+    TEST_ASSERT_EQUAL_UINT32(150, params::getUint(params::Id::BackoffDacStep));
+}
+
+void test_sc_set_rejects_fractional_counts() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("set backoff 150.5", p);
+    TEST_ASSERT_TRUE(p.contains("[ERR] backoff must be a whole number 1 .. 1000"));
+    TEST_ASSERT_EQUAL_UINT32(BACKOFF_DAC_STEP, params::getUint(params::Id::BackoffDacStep));
+}
+
+void test_sc_set_defaults_and_get_all() {
+    resetAll();
+    Print p;
+    serial_commands::processLine("set tolerance 1", p);
+    serial_commands::processLine("set defaults", p);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, SETPOINT_TOLERANCE_K,
+                             params::get(params::Id::SetpointToleranceK));
+    p.reset();
+    serial_commands::processLine("get", p);
+    for (uint8_t i = 0; i < params::COUNT; ++i) {
+        TEST_ASSERT_TRUE(p.contains(params::descriptor(static_cast<params::Id>(i)).name));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// log
+// ---------------------------------------------------------------------------
+
+void test_sc_log_not_available_natively() {
+    const char* lines[] = {"log", "log dump", "log dump 100"};
+    for (const char* line : lines) {
+        Print p;
+        serial_commands::processLine(line, p);
+        TEST_ASSERT_TRUE(p.contains("[ERR] Run log not available"));
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Entry point called by the shared test runner in test_state_machine.cpp
 // ---------------------------------------------------------------------------
@@ -300,4 +641,45 @@ void run_serial_command_tests() {
     RUN_TEST(test_sc_telemetry_off_disables);
     RUN_TEST(test_sc_telemetry_on_enables);
     RUN_TEST(test_sc_telemetry_off_idempotent);
+    RUN_TEST(test_sc_telemetry_stats_reports_counters);
+    RUN_TEST(test_sc_telemetry_stats_reset_matches_longer_name);
+    RUN_TEST(test_sc_telemetry_binary_and_csv_switch_format);
+    RUN_TEST(test_sc_telemetry_descriptor_requires_binary);
+    RUN_TEST(test_sc_telemetry_rate_sets_divisor);
+    RUN_TEST(test_sc_telemetry_rate_rejects_bad_values);
+    RUN_TEST(test_sc_telemetry_fields_mask_and_all);
+    RUN_TEST(test_sc_telemetry_delta_and_keyframe);
+
+    // capture
+    RUN_TEST(test_sc_capture_commands_unavailable_on_native);
+
+    // baseline
+    RUN_TEST(test_sc_baseline_reports_every_channel);
+
+    // tasks
+    RUN_TEST(test_sc_tasks_without_scheduler_errors);
+    RUN_TEST(test_sc_tasks_reports_and_resets_stats);
+
+    // perf
+    RUN_TEST(test_sc_perf_reports_probes_and_resets);
+
+    // spi
+    RUN_TEST(test_sc_spi_not_available_natively);
+
+    // log
+    RUN_TEST(test_sc_log_not_available_natively);
+
+    // Tokenized dispatch
+    RUN_TEST(test_sc_extra_blanks_between_words_still_match);
+    RUN_TEST(test_sc_longest_command_name_wins);
+    RUN_TEST(test_sc_extra_argument_is_rejected);
+    RUN_TEST(test_sc_overlong_line_is_reported);
+    RUN_TEST(test_sc_help_filters_by_word);
+
+    // set / get
+    RUN_TEST(test_sc_set_applies_typed_values);
+    RUN_TEST(test_sc_set_rejects_whole_batch_on_error);
+    RUN_TEST(test_sc_get_profile_round_trips_through_set);
+    RUN_TEST(test_sc_set_rejects_fractional_counts);
+    RUN_TEST(test_sc_set_defaults_and_get_all);
 }
@@ -0,0 +1,337 @@
+/**
+ * @file test_simulation.cpp
+ * @brief Closed-loop runs of the control core against the simulated plant
+ *        (test/plant_sim.h), plus the shared slew and overstroke parts.
+ *
+ * main() lives in test_state_machine.cpp and calls run_simulation_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+
+#include "../plant_sim.h"
+
+using state_machine::State;
+
+static constexpr uint32_t MINUTE_MS = 60000;
+static constexpr uint32_t HOUR_MS   = 60 * MINUTE_MS;
+
+static bool inState(const sim::Rig& r, State s) { return r.state() == s; }
+
+// ---------------------------------------------------------------------------
+// SlewLimiter
+// ---------------------------------------------------------------------------
+
+void test_slew_spreads_allowance_over_calls() {
+    SlewLimiter s(128);                     // half a count per call
+    s.setTarget(10);
+    uint16_t v = 0;
+    v = s.step(v);
+    TEST_ASSERT_EQUAL_UINT16(0, v);
+    v = s.step(v);
+    TEST_ASSERT_EQUAL_UINT16(1, v);
+    for (int i = 0; i < 18; ++i) v = s.step(v);
+    TEST_ASSERT_EQUAL_UINT16(10, v);
+}
+
+void test_slew_drops_credit_when_settled() {
+    SlewLimiter s(3 * 256);
+    s.setTarget(2);
+    TEST_ASSERT_EQUAL_UINT16(2, s.step(0));     // gap smaller than allowance
+    for (int i = 0; i < 5; ++i) s.step(2);      // settled: nothing banked
+    s.setTarget(0);
+    TEST_ASSERT_EQUAL_UINT16(0, s.step(2));
+    s.setTarget(100);
+    TEST_ASSERT_EQUAL_UINT16(3, s.step(0));
+}
+
+// ---------------------------------------------------------------------------
+// OverstrokeDetector
+// ---------------------------------------------------------------------------
+
+static void primeDetector(OverstrokeDetector& d, float a, uint32_t& nowMs) {
+    for (uint8_t i = 0; i < OVERSTROKE_PRIME_READINGS; ++i) {
+        nowMs += 100;
+        TEST_ASSERT_FALSE(d.update(a, a, nowMs));
+    }
+    TEST_ASSERT_TRUE(d.primed());
+}
+
+void test_detector_ignores_spikes_while_priming() {
+    OverstrokeDetector d;
+    TEST_ASSERT_FALSE(d.update(1.0f, 10.0f, 5000));
+    TEST_ASSERT_FALSE(d.pending());
+}
+
+void test_detector_latches_and_debounces() {
+    OverstrokeDetector d;
+    uint32_t now = 0;
+    primeDetector(d, 1.0f, now);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, d.baselineA());
+
+    now += 100;
+    TEST_ASSERT_TRUE(d.update(1.0f, 1.0f + OVERSTROKE_CURRENT_THRESHOLD_A + 0.5f, now));
+    TEST_ASSERT_TRUE(d.pending());
+    d.clear();
+
+    now += OVERSTROKE_DEBOUNCE_MS - 100;          // still inside the debounce
+    TEST_ASSERT_FALSE(d.update(1.0f, 5.0f, now));
+    now += 100;
+    TEST_ASSERT_TRUE(d.update(1.0f, 5.0f, now));
+}
+
+void test_detector_quiet_baseline_catches_small_stroke() {
+    OverstrokeDetector d;
+    uint32_t now = 0;
+    primeDetector(d, 1.0f, now);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f + OVERSTROKE_MIN_EXCESS_A, d.thresholdA());   // σ = 0: floor
+
+    now += 100;
+    TEST_ASSERT_FALSE(d.update(1.0f, 1.0f + 0.5f * OVERSTROKE_MIN_EXCESS_A, now));
+    now += 100;
+    TEST_ASSERT_TRUE(d.update(1.0f, 1.8f, now));   // well below the 2 A limit
+}
+
+void test_detector_threshold_scales_with_noise() {
+    OverstrokeDetector d;
+    d.setSigmaK(OVERSTROKE_SIGMA_K_STEADY);
+    sim::Noise noise;
+    uint32_t now = 0;
+    float maxNoise = 0.0f;
+    for (int i = 0; i < 500; ++i) {
+        const float a = 1.0f + 0.2f * noise.next();   // ±0.2 A
+        now += 67;
+        TEST_ASSERT_FALSE(d.update(a, a, now));
+        if (a - 1.0f > maxNoise) maxNoise = a - 1.0f;
+    }
+    const float excess = d.thresholdA() - d.baselineA();
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, OVERSTROKE_SIGMA_K_STEADY * 0.2f / sqrtf(3.0f), excess);
+    TEST_ASSERT_TRUE(excess > maxNoise);
+
+    d.setLimits(0.5f, OVERSTROKE_DEBOUNCE_MS);     // the limit caps k·σ
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, d.baselineA() + 0.5f, d.thresholdA());
+}
+
+void test_detector_spike_does_not_raise_its_own_threshold() {
+    OverstrokeDetector d;
+    uint32_t now = 0;
+    primeDetector(d, 1.0f, now);
+    const float before = d.thresholdA();
+    for (int i = 0; i < 5; ++i) {
+        now += 100;
+        d.update(4.0f, 4.0f, now);
+    }
+    TEST_ASSERT_TRUE(d.thresholdA() - before < 0.5f);
+}
+
+void test_detector_drive_step_reprimes() {
+    OverstrokeDetector d;
+    uint32_t now = 0;
+    d.setDrive(1000);
+    primeDetector(d, 1.0f, now);
+
+    // A backoff recovery steps the drive; the current follows it by 2.5 A.
+    d.setDrive(1000 + OVERSTROKE_REPRIME_DAC_COUNTS);
+    TEST_ASSERT_FALSE(d.primed());
+    for (uint8_t i = 0; i < OVERSTROKE_REPRIME_READINGS; ++i) {
+        now += 100;
+        TEST_ASSERT_FALSE(d.update(3.5f, 3.5f, now));
+    }
+    TEST_ASSERT_TRUE(d.primed());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.5f, d.baselineA());
+    now += 100;
+    TEST_ASSERT_FALSE(d.update(3.5f, 3.6f, now));
+    TEST_ASSERT_EQUAL_UINT32(1, d.reprimes());
+
+    d.setDrive(1000 + OVERSTROKE_REPRIME_DAC_COUNTS - 1);   // small move: keep armed
+    TEST_ASSERT_TRUE(d.primed());
+}
+
+void test_detector_harmonic_check_qualifies_spike() {
+    OverstrokeDetector d;
+    d.setHarmonicLimit(0.15f);
+    uint32_t now = 0;
+    primeDetector(d, 1.0f, now);
+    now += OVERSTROKE_DEBOUNCE_MS;
+    TEST_ASSERT_FALSE(d.update(1.0f, 4.0f, now, 0.05f));   // clean sinusoid: more drive
+    TEST_ASSERT_TRUE(d.update(1.0f, 4.0f, now, 0.30f));
+    d.clear();
+    now += OVERSTROKE_DEBOUNCE_MS;
+    TEST_ASSERT_TRUE(d.update(1.0f, 4.0f, now, OverstrokeDetector::NO_HARMONICS));
+}
+
+// ---------------------------------------------------------------------------
+// Closed loop
+// ---------------------------------------------------------------------------
+
+void test_sim_cooldown_within_rate_limit_then_holds_operating() {
+    sim::Rig rig;
+    rig.run(5000);
+    rig.start();
+    rig.run(LOOP_INTERVAL_MS);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::CoarseCooldown), static_cast<int>(rig.state()));
+
+    // True plant rate over each minute; the measured rate is only a few
+    // RTD codes per history span, so it is far noisier than this.
+    float    peakRate = 0.0f;
+    float    minuteK  = rig.plant.tempK();
+    uint32_t minuteMs = rig.clock.nowMs();
+    bool     faulted  = false;
+    const bool reached = rig.runUntil([&](const sim::Rig& r) {
+        if (r.clock.nowMs() - minuteMs >= MINUTE_MS) {
+            const float rate = minuteK - r.plant.tempK();
+            if (r.clock.nowMs() > 20 * MINUTE_MS && rate > peakRate) peakRate = rate;
+            minuteK  = r.plant.tempK();
+            minuteMs = r.clock.nowMs();
+        }
+        faulted = faulted || inState(r, State::Fault);
+        return inState(r, State::Baseline) || faulted;
+    }, 8 * HOUR_MS);
+
+    TEST_ASSERT_TRUE(reached);
+    TEST_ASSERT_FALSE(faulted);
+    TEST_ASSERT_TRUE(peakRate < MAX_COOLDOWN_RATE_K_PER_MIN);
+    TEST_ASSERT_TRUE(peakRate > 0.8f * COOLDOWN_RATE_TARGET_K_PER_MIN);
+    // ~217 K at just under 0.9 K/min, plus the fine approach and Settle
+    TEST_ASSERT_TRUE(rig.clock.nowMs() > 3 * HOUR_MS + 30 * MINUTE_MS);
+    TEST_ASSERT_TRUE(rig.clock.nowMs() < 5 * HOUR_MS);
+    TEST_ASSERT_FLOAT_WITHIN(SETPOINT_TOLERANCE_K, SETPOINT_K, rig.plant.tempK());
+    TEST_ASSERT_EQUAL_UINT16(0, rig.output().backoffCount);
+    TEST_ASSERT_TRUE(rig.framesOut() > 0);
+
+    // Baseline freezes (re-learning while the loop still trends) ...
+    TEST_ASSERT_TRUE(rig.runUntil([](const sim::Rig& r) {
+        return !inState(r, State::Baseline);
+    }, HOUR_MS));
+    TEST_ASSERT_EQUAL(static_cast<int>(State::Operating), static_cast<int>(rig.state()));
+
+    // ... and the hold stays quiet for hours: no fault, no CUSUM alarm
+    float   worstK = 0.0f;
+    bool    left   = false;
+    uint8_t alarms = 0;
+    rig.runUntil([&](const sim::Rig& r) {
+        const float errK = fabsf(r.plant.tempK() - SETPOINT_K);
+        if (errK > worstK) worstK = errK;
+        alarms |= r.machine().getBaseline().alarmMask();
+        left = !inState(r, State::Operating);
+        return left;
+    }, 6 * HOUR_MS);
+    TEST_ASSERT_FALSE(left);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::Operating), static_cast<int>(rig.state()));
+    TEST_ASSERT_EQUAL(static_cast<int>(state_machine::FaultReason::None),
+                      static_cast<int>(rig.machine().getFaultReason()));
+    TEST_ASSERT_EQUAL_UINT8(0, alarms);
+    TEST_ASSERT_TRUE(worstK < SETPOINT_TOLERANCE_K);
+    TEST_ASSERT_EQUAL_UINT16(0, rig.output().backoffCount);
+}
+
+void test_sim_dac_ramp_follows_runtime_step() {
+    // The simulated ramp honours "dacstep" as dac.cpp does
+    const params::Change c[] = {{params::Id::DacMaxStep, 5.0f}};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Ok),
+                            static_cast<uint8_t>(params::apply(c, 1)));
+    sim::Rig rig;
+    rig.start();
+    rig.run(10 * LOOP_INTERVAL_MS);
+    TEST_ASSERT_TRUE(rig.output().dacTarget > 100u);
+    TEST_ASSERT_TRUE(rig.dacActual() > 0u);
+    TEST_ASSERT_TRUE(rig.dacActual() <= 5u * 11u);
+    params::resetDefaults();
+}
+
+void test_sim_runs_far_faster_than_real_time() {
+    sim::Rig rig;
+    rig.start();
+    const auto t0 = std::chrono::steady_clock::now();
+    rig.run(2 * HOUR_MS);
+    const double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    TEST_ASSERT_TRUE(wallS * 1000.0 < 2.0 * 3600.0);     // > 1000× real time
+}
+
+void test_sim_spike_backs_off_once() {
+    sim::Rig rig;
+    rig.start();
+    rig.run(30 * MINUTE_MS);
+    const uint32_t now = rig.clock.nowMs();
+
+    // Two windows above threshold 500 ms apart: one event (debounce)
+    rig.sensor.inject({now + 1000, 100, 3.0f});
+    rig.sensor.inject({now + 1500, 100, 3.0f});
+    rig.run(5000);
+
+    TEST_ASSERT_EQUAL_UINT16(1, rig.output().backoffCount);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::CoarseCooldown), static_cast<int>(rig.state()));
+    TEST_ASSERT_FALSE(rig.detector().pending());
+}
+
+void test_sim_repeated_spikes_fault_on_backoff_limit() {
+    sim::Rig rig;
+    rig.start();
+    rig.run(30 * MINUTE_MS);
+    const uint32_t now = rig.clock.nowMs();
+    for (uint8_t i = 0; i < BACKOFF_MAX_COUNT; ++i) {
+        rig.sensor.inject({now + 1000 + i * 5000u, 100, 3.0f});
+    }
+    rig.run(BACKOFF_MAX_COUNT * 5000u + 2000u);
+
+    TEST_ASSERT_EQUAL(static_cast<int>(State::Fault), static_cast<int>(rig.state()));
+    TEST_ASSERT_EQUAL(static_cast<int>(state_machine::FaultReason::TooManyBackoffs),
+                      static_cast<int>(rig.machine().getFaultReason()));
+}
+
+void test_sim_compressor_failure_faults_on_stall() {
+    sim::Rig rig;
+    rig.start();
+    rig.run(30 * MINUTE_MS);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::CoarseCooldown), static_cast<int>(rig.state()));
+
+    rig.plant.params.liftAtSetpointW = 0.0f;        // compressor stops lifting
+    rig.plant.params.liftSlopeWPerK  = 0.0f;
+    const uint32_t failMs = rig.clock.nowMs();
+    TEST_ASSERT_TRUE(rig.runUntil([](const sim::Rig& r) { return inState(r, State::Fault); },
+                                  2 * STALL_DETECT_WINDOW_MS));
+    TEST_ASSERT_EQUAL(static_cast<int>(state_machine::FaultReason::TemperatureStall),
+                      static_cast<int>(rig.machine().getFaultReason()));
+    TEST_ASSERT_TRUE(rig.clock.nowMs() - failMs <= STALL_DETECT_WINDOW_MS + STALL_BUCKET_MS * 2);
+}
+
+void test_sim_start_after_long_idle_does_not_stall() {
+    // The boot-wait-start path: a full flat stall window before Start
+    sim::Rig rig;
+    rig.run(STALL_DETECT_WINDOW_MS + MINUTE_MS);
+    rig.start();
+    bool faulted = false;
+    rig.runUntil([&](const sim::Rig& r) {
+        faulted = faulted || inState(r, State::Fault);
+        return faulted;
+    }, STALL_DETECT_WINDOW_MS);
+
+    TEST_ASSERT_FALSE(faulted);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::CoarseCooldown), static_cast<int>(rig.state()));
+    TEST_ASSERT_EQUAL(static_cast<int>(state_machine::FaultReason::None),
+                      static_cast<int>(rig.machine().getFaultReason()));
+}
+
+void run_simulation_tests() {
+    RUN_TEST(test_slew_spreads_allowance_over_calls);
+    RUN_TEST(test_slew_drops_credit_when_settled);
+
+    RUN_TEST(test_detector_ignores_spikes_while_priming);
+    RUN_TEST(test_detector_latches_and_debounces);
+    RUN_TEST(test_detector_quiet_baseline_catches_small_stroke);
+    RUN_TEST(test_detector_threshold_scales_with_noise);
+    RUN_TEST(test_detector_spike_does_not_raise_its_own_threshold);
+    RUN_TEST(test_detector_drive_step_reprimes);
+    RUN_TEST(test_detector_harmonic_check_qualifies_spike);
+
+    RUN_TEST(test_sim_cooldown_within_rate_limit_then_holds_operating);
+    RUN_TEST(test_sim_dac_ramp_follows_runtime_step);
+    RUN_TEST(test_sim_runs_far_faster_than_real_time);
+    RUN_TEST(test_sim_spike_backs_off_once);
+    RUN_TEST(test_sim_repeated_spikes_fault_on_backoff_limit);
+    RUN_TEST(test_sim_compressor_failure_faults_on_stall);
+    RUN_TEST(test_sim_start_after_long_idle_does_not_stall);
+}
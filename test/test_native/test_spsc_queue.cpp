@@ -0,0 +1,81 @@
+/**
+ * @file test_spsc_queue.cpp
+ * @brief Unit tests for the lock-free SPSC queue (spsc_queue.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_spsc_queue_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include "spsc_queue.h"
+
+// ---------------------------------------------------------------------------
+// Basic push / pop
+// ---------------------------------------------------------------------------
+
+void test_spsc_new_queue_is_empty() {
+    SpscQueue<int, 4> q;
+    int v = 42;
+    TEST_ASSERT_TRUE(q.empty());
+    TEST_ASSERT_FALSE(q.pop(v));
+    TEST_ASSERT_EQUAL_INT(42, v);   // untouched on empty pop
+}
+
+void test_spsc_is_fifo() {
+    SpscQueue<int, 4> q;
+    q.push(1);
+    q.push(2);
+    q.push(3);
+    int v = 0;
+    TEST_ASSERT_TRUE(q.pop(v)); TEST_ASSERT_EQUAL_INT(1, v);
+    TEST_ASSERT_TRUE(q.pop(v)); TEST_ASSERT_EQUAL_INT(2, v);
+    TEST_ASSERT_TRUE(q.pop(v)); TEST_ASSERT_EQUAL_INT(3, v);
+    TEST_ASSERT_TRUE(q.empty());
+}
+
+void test_spsc_all_slots_usable_then_rejects() {
+    SpscQueue<int, 4> q;
+    for (int i = 0; i < 4; ++i) { TEST_ASSERT_TRUE(q.push(i)); }
+    TEST_ASSERT_EQUAL_UINT32(4, q.size());
+    TEST_ASSERT_FALSE(q.push(99));   // full: newest item rejected
+    int v = -1;
+    q.pop(v);
+    TEST_ASSERT_EQUAL_INT(0, v);     // oldest item preserved
+}
+
+void test_spsc_wraps_around_many_times() {
+    SpscQueue<uint32_t, 8> q;
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        TEST_ASSERT_TRUE(q.push(i));
+        if (i % 3 == 2) {
+            // Drain in bursts so head/tail wrap at different offsets.
+            uint32_t v;
+            while (q.pop(v)) { TEST_ASSERT_EQUAL_UINT32(expected++, v); }
+        }
+    }
+    uint32_t v;
+    while (q.pop(v)) { TEST_ASSERT_EQUAL_UINT32(expected++, v); }
+    TEST_ASSERT_EQUAL_UINT32(1000, expected);
+}
+
+void test_spsc_reset_discards_items() {
+    SpscQueue<int, 2> q;
+    q.push(1);
+    q.push(2);
+    q.reset();
+    TEST_ASSERT_TRUE(q.empty());
+    TEST_ASSERT_TRUE(q.push(3));
+}
+
+// ---------------------------------------------------------------------------
+// Entry point called by the shared test runner in test_state_machine.cpp
+// ---------------------------------------------------------------------------
+
+void run_spsc_queue_tests() {
+    RUN_TEST(test_spsc_new_queue_is_empty);
+    RUN_TEST(test_spsc_is_fifo);
+    RUN_TEST(test_spsc_all_slots_usable_then_rejects);
+    RUN_TEST(test_spsc_wraps_around_many_times);
+    RUN_TEST(test_spsc_reset_discards_items);
+}
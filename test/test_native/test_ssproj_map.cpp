@@ -0,0 +1,85 @@
+/**
+ * @file test_ssproj_map.cpp
+ * @brief The dashboard column map agrees with the telemetry schema
+ *        (telemetry_schema.h, ssproj_map.h).
+ *
+ * main() lives in test_state_machine.cpp and calls run_ssproj_map_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "telemetry.h"
+#include "../ssproj_map.h"
+
+/** The committed project, located relative to this source file. */
+static bool readProject(std::string& text) {
+    std::string dir = __FILE__;
+    const size_t slash = dir.find_last_of('/');
+    dir = (slash == std::string::npos) ? std::string(".") : dir.substr(0, slash);
+    for (const std::string& path : {dir + "/../../Cryocooler Dashboard.ssproj",
+                                    std::string("Cryocooler Dashboard.ssproj")}) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.good()) continue;
+        std::stringstream s;
+        s << in.rdbuf();
+        text = s.str();
+        return true;
+    }
+    return false;
+}
+
+/** Minimal project: a parser and one dataset titled @p title at @p index. */
+static std::string miniProject(const char* title, int index) {
+    return std::string("{\n    \"frameParser\": \"old\",\n    \"groups\": [\n        {\n"
+                       "            \"datasets\": [\n                {\n"
+                       "                    \"index\": ") + std::to_string(index) + ",\n"
+           "                    \"title\": \"" + title + "\",\n"
+           "                    \"units\": \"x\",\n"
+           "                    \"widget\": \"\"\n                }\n            ],\n"
+           "            \"title\": \"G\"\n        }\n    ]\n}\n";
+}
+
+void test_ssproj_committed_project_is_current() {
+    std::string text, out, err;
+    if (!readProject(text)) TEST_IGNORE_MESSAGE("Cryocooler Dashboard.ssproj not found");
+    TEST_ASSERT_TRUE_MESSAGE(ssproj::regenerate(text, out, err), err.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(out == text, "stale column map: run pio test -e native_ssproj");
+}
+
+void test_ssproj_index_and_units_follow_title() {
+    std::string out, err;
+    TEST_ASSERT_TRUE(ssproj::regenerate(miniProject("Cooling Rate", 3), out, err));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, out.find("\"index\": 7,"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, out.find("\"units\": \"K/min\","));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, out.find("\"title\": \"Cooling Rate\","));
+    TEST_ASSERT_EQUAL(std::string::npos, out.find("\"old\""));
+}
+
+void test_ssproj_unknown_title_rejected() {
+    std::string out, err;
+    TEST_ASSERT_FALSE(ssproj::regenerate(miniProject("Flux Capacitor", 1), out, err));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, err.find("Flux Capacitor"));
+}
+
+void test_ssproj_parser_covers_every_column() {
+    const std::string js = ssproj::frameParser();
+    for (const telemetry::FieldSpec& f : telemetry::FIELDS) {
+        TEST_ASSERT_TRUE_MESSAGE(js.find(f.key) != std::string::npos, f.key);
+    }
+    const size_t k = js.find("const KINDS = \"");
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, k);
+    const size_t open = k + 15u;
+    TEST_ASSERT_EQUAL_UINT32(telemetry::SCHEMA_FIELD_COUNT, js.find('"', open) - open);
+    // No key or title closes the header comment early
+    TEST_ASSERT_EQUAL(std::string::npos, js.find("*/", js.find("*/") + 2u));
+}
+
+void run_ssproj_map_tests() {
+    RUN_TEST(test_ssproj_committed_project_is_current);
+    RUN_TEST(test_ssproj_index_and_units_follow_title);
+    RUN_TEST(test_ssproj_unknown_title_rejected);
+    RUN_TEST(test_ssproj_parser_covers_every_column);
+}
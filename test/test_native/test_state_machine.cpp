@@ -15,6 +15,7 @@
 #include "state_machine.h"
 #include "indicator.h"
 #include "config.h"
+#include "params.h"
 
 // Stub millis() control (provided by stubs/arduino_stub.cpp)
 extern "C" void stub_setMillis(uint32_t ms);
@@ -22,6 +23,66 @@ extern "C" void stub_setMillis(uint32_t ms);
 // Serial command tests (defined in test_serial_commands.cpp)
 void run_serial_command_tests();
 
+// RMS accumulator tests (defined in test_rms_window.cpp)
+void run_rms_window_tests();
+
+// SPSC queue tests (defined in test_spsc_queue.cpp)
+void run_spsc_queue_tests();
+
+// Telemetry ring / formatter tests (defined in test_telemetry.cpp)
+void run_telemetry_tests();
+
+// CRC / COBS framing tests (defined in test_frame_codec.cpp)
+void run_frame_codec_tests();
+
+// Burst capture ring tests (defined in test_burst_capture.cpp)
+void run_burst_capture_tests();
+
+// RTD lookup table tests (defined in test_rtd_lut.cpp)
+void run_rtd_lut_tests();
+
+// Temperature history tests (defined in test_temp_history.cpp)
+void run_temp_history_tests();
+
+// Baseline statistics tests (defined in test_baseline.cpp)
+void run_baseline_tests();
+
+// DAC controller tests (defined in test_pid_controller.cpp)
+void run_pid_controller_tests();
+
+// Control-core scheduler tests (defined in test_scheduler.cpp)
+void run_scheduler_tests();
+
+// Profiling probe tests (defined in test_perf.cpp)
+void run_perf_tests();
+
+// Closed-loop plant simulation tests (defined in test_simulation.cpp)
+void run_simulation_tests();
+
+// Flash run-log store tests (defined in test_log_store.cpp)
+void run_log_store_tests();
+
+// Console tokenizer / parameter override tests (defined in test_command_line.cpp)
+void run_command_line_tests();
+
+// Capture replay tests (defined in test_replay.cpp)
+void run_replay_tests();
+
+// Telemetry datagram pool tests (defined in test_datagram_pool.cpp)
+void run_datagram_pool_tests();
+
+// Cooldown ETA tests (defined in test_cooldown_eta.cpp)
+void run_cooldown_eta_tests();
+
+// Goertzel harmonic bin tests (defined in test_harmonic_window.cpp)
+void run_harmonic_window_tests();
+
+// Dashboard column map tests (defined in test_ssproj_map.cpp)
+void run_ssproj_map_tests();
+
+// Indicator pattern tests (defined in test_indicator_pattern.cpp)
+void run_indicator_pattern_tests();
+
 // ---------------------------------------------------------------------------
 // Helper: fast-forward the state machine by skipping time
 // ---------------------------------------------------------------------------
@@ -85,6 +146,7 @@ static uint32_t initStartAndStop() {
 
 void setUp(void) {
     stub_setMillis(0);
+    params::resetDefaults();
     state_machine::init(0);
 }
 
@@ -270,6 +332,22 @@ void test_fine_transitions_to_overshoot_below_setpoint(void) {
     auto out = state_machine::update(overshootTemp, 0.5f, 0.0f, false, tStart + 3);
     TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Overshoot),
                       static_cast<int8_t>(out.state));
+
+    // The temperature loop backs the drive off from where FineCooldown left
+    // it rather than dropping straight to 0, and reaches 0 if it stays cold.
+    const uint16_t atEntry = out.dacTarget;
+    TEST_ASSERT_GREATER_THAN(0, atEntry);
+    uint32_t t = tStart + 3;
+    uint16_t prev = atEntry;
+    uint16_t dac  = atEntry;   // follows the target at dac::serviceRamp()'s limit
+    for (int i = 0; i < 3000; ++i) {
+        t += LOOP_INTERVAL_MS;
+        out = state_machine::update(overshootTemp, 0.0f, 0.0f, false, t, false, 0.0f, dac);
+        TEST_ASSERT_TRUE(out.dacTarget <= prev);
+        prev = out.dacTarget;
+        dac  = (dac > out.dacTarget + DAC_MAX_STEP_PER_INTERVAL)
+                   ? static_cast<uint16_t>(dac - DAC_MAX_STEP_PER_INTERVAL) : out.dacTarget;
+    }
     TEST_ASSERT_EQUAL_UINT16(0, out.dacTarget);
 }
 
@@ -478,6 +556,93 @@ void test_start_inband_enters_settle(void) {
     TEST_ASSERT_FALSE(out.alarmRelay);
 }
 
+void test_settle_waits_for_dac_to_stop_moving(void) {
+    // In band the whole time, but the loop is still slewing the DAC
+    state_machine::init(0);
+    state_machine::start(100, SETPOINT_K);
+    uint32_t nowMs = 100;
+    uint16_t dac   = 1000;
+    state_machine::Output out{};
+    for (; nowMs < 100 + 2u * SETTLE_DURATION_MS; nowMs += LOOP_INTERVAL_MS) {
+        dac = static_cast<uint16_t>(dac + 2u);   // 10 counts/s
+        out = state_machine::update(SETPOINT_K, 0.0f, 0.0f, false, nowMs, false, 0.0f, dac);
+        TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Settle),
+                          static_cast<int8_t>(out.state));
+    }
+
+    // DAC holds: a full window from here, not from entering the band
+    const uint32_t steadyMs = nowMs;
+    while (out.state == state_machine::State::Settle && nowMs < steadyMs + 2u * SETTLE_DURATION_MS) {
+        nowMs += LOOP_INTERVAL_MS;
+        out = state_machine::update(SETPOINT_K, 0.0f, 0.0f, false, nowMs, false, 0.0f, dac);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Baseline),
+                      static_cast<int8_t>(out.state));
+    // (the last window opened at most one DAC span of ramp before the hold)
+    TEST_ASSERT_TRUE(nowMs - steadyMs <= SETTLE_DURATION_MS);
+    TEST_ASSERT_TRUE(nowMs - steadyMs + (SETTLE_MAX_DAC_SPAN / 2u) * LOOP_INTERVAL_MS >=
+                     SETTLE_DURATION_MS);
+}
+
+void test_settle_waits_for_temperature_to_stop_drifting(void) {
+    // Creeping 0.15 K/min toward the band edge: in band, never settled
+    state_machine::init(0);
+    state_machine::start(100, SETPOINT_K);
+    auto out = state_machine::update(SETPOINT_K, 0.0f, 0.0f, false, 100);
+    for (uint32_t i = 1; i <= 3u * SETTLE_DURATION_MS / LOOP_INTERVAL_MS; ++i) {
+        const float tempK = SETPOINT_K - 0.0005f * static_cast<float>(i);
+        out = state_machine::update(tempK, 0.0f, 0.0f, false, 100 + i * LOOP_INTERVAL_MS,
+                                    false, 0.0f, out.dacTarget);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Settle),
+                      static_cast<int8_t>(out.state));
+}
+
+void test_dac_lag_follows_runtime_step(void) {
+    // The integrator is frozen only while the DAC trails the loop by more
+    // than the "dacstep" parameter, as dac.cpp's ramp does.
+    auto slope = [](float step) {
+        const params::Change c[] = {{params::Id::DacMaxStep, step}};
+        params::apply(c, 1);
+        state_machine::init(0);
+        state_machine::start(100, SETPOINT_K);
+        state_machine::Output out{};
+        uint16_t first = 0;
+        for (uint32_t i = 1; i <= 20; ++i) {
+            const uint16_t lagging = (out.dacTarget > 20u) ? out.dacTarget - 20u : 0u;
+            out = state_machine::update(SETPOINT_K + 1.0f, 0.0f, 0.0f, false,
+                                        100 + i * LOOP_INTERVAL_MS, false, 0.0f, lagging);
+            if (i == 2) first = out.dacTarget;
+        }
+        return static_cast<int>(out.dacTarget) - static_cast<int>(first);
+    };
+    TEST_ASSERT_EQUAL_INT(0, slope(5.0f));    // 20 counts behind a 5-count ramp: hold
+    TEST_ASSERT_TRUE(slope(50.0f) > 0);       // within a 50-count ramp: integrate
+    params::resetDefaults();
+}
+
+void test_cooldown_over_max_rate_never_adds_drive(void) {
+    // 1.2 K/min measured while the feed-forward climbs with falling
+    // temperature: over "maxrate" the DAC target may only come down.
+    auto rise = [](float maxRate) {
+        const params::Change c[] = {{params::Id::MaxCooldownRate, maxRate}};
+        params::apply(c, 1);
+        state_machine::init(0);
+        state_machine::start(100, 200.0f);
+        state_machine::Output out{};
+        uint16_t first = 0;
+        for (uint32_t i = 1; i <= 20; ++i) {
+            out = state_machine::update(200.0f - 0.5f * i, 1.2f, 0.0f, false,
+                                        100 + i * LOOP_INTERVAL_MS, false, 0.0f, out.dacTarget);
+            if (i == 2) first = out.dacTarget;
+        }
+        return static_cast<int>(out.dacTarget) - static_cast<int>(first);
+    };
+    TEST_ASSERT_TRUE(rise(MAX_COOLDOWN_RATE_K_PER_MIN) <= 0);
+    TEST_ASSERT_TRUE(rise(5.0f) > 0);   // limit out of reach: ff wins
+    params::resetDefaults();
+}
+
 void test_start_overshot_enters_overshoot(void) {
     // 1 K below the tolerance band (< SETPOINT_K - SETPOINT_TOLERANCE_K = 76 K)
     // → Overshoot; DAC target must be 0.
@@ -566,6 +731,334 @@ void test_backoff_count_resets_on_start(void) {
     TEST_ASSERT_EQUAL_UINT16(0, out.backoffCount);
 }
 
+// ---------------------------------------------------------------------------
+// Baseline fingerprint → Operating deviation check
+// ---------------------------------------------------------------------------
+
+/**
+ * Start in the setpoint band and run Settle + Baseline with a small
+ * alternating ripple on every channel.
+ *
+ * @return  nowMs of the first Operating tick.
+ */
+static uint32_t runToOperating() {
+    state_machine::init(0);
+    state_machine::start(100, SETPOINT_K);
+    uint32_t nowMs = 100;
+    for (uint32_t i = 0; ; ++i) {
+        nowMs += LOOP_INTERVAL_MS;
+        const float r = (i & 1u) ? 0.01f : -0.01f;
+        const auto out = state_machine::update(SETPOINT_K + r, 0.0f, 10.0f + r, false, nowMs,
+                                               false, 1.0f + r, 100);
+        if (out.state == state_machine::State::Operating) return nowMs;
+        if (i > 10000u) return 0;
+    }
+}
+
+void test_baseline_learns_then_operates(void) {
+    const uint32_t t = runToOperating();
+    TEST_ASSERT_NOT_EQUAL(0, t);
+
+    const baseline::Engine& b = state_machine::getBaseline();
+    TEST_ASSERT_EQUAL(baseline::Engine::Phase::Monitoring, b.phase());
+    const uint32_t expected = BASELINE_DURATION_MS / LOOP_INTERVAL_MS;
+    TEST_ASSERT_UINT32_WITHIN(2, expected, b.stats(baseline::Channel::TempK).n);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, SETPOINT_K, b.stats(baseline::Channel::TempK).mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, b.stats(baseline::Channel::Dac).mean);
+    // Ripple is below the σ floor, so the drift floor applies
+    TEST_ASSERT_EQUAL_FLOAT(BASELINE_DRIFT_TEMP_K / BASELINE_CUSUM_K, b.sigma(baseline::Channel::TempK));
+}
+
+void test_baseline_relearns_while_drifting(void) {
+    state_machine::init(0);
+    state_machine::start(100, SETPOINT_K);
+    uint32_t nowMs = 100;
+    uint32_t baselineMs = 0;
+    state_machine::Output out{};
+    // Settle on a flat signal, then drift 2 × BASELINE_DRIFT_TEMP_K per
+    // learning window (inside the band) through Baseline
+    while (state_machine::getState() != state_machine::State::Baseline && nowMs < 3600000u) {
+        nowMs += LOOP_INTERVAL_MS;
+        out = state_machine::update(SETPOINT_K, 0.0f, 10.0f, false, nowMs, false, 1.0f, 100);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Baseline),
+                      static_cast<int8_t>(out.state));
+    baselineMs = nowMs;
+    const float perTick = 2.0f * BASELINE_DRIFT_TEMP_K * LOOP_INTERVAL_MS / BASELINE_DURATION_MS;
+    float tempK = SETPOINT_K - BASELINE_DRIFT_TEMP_K;
+    while (nowMs - baselineMs < BASELINE_DURATION_MS + 10u * LOOP_INTERVAL_MS) {
+        nowMs += LOOP_INTERVAL_MS;
+        tempK += perTick;
+        out = state_machine::update(tempK, 0.0f, 10.0f, false, nowMs, false, 1.0f, 100);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Baseline),
+                      static_cast<int8_t>(out.state));
+    // The window restarted: it holds only the samples since
+    TEST_ASSERT_TRUE(state_machine::getBaseline().stats(baseline::Channel::TempK).n < 20u);
+
+    // Once the signal holds still, the next window freezes
+    while (out.state == state_machine::State::Baseline &&
+           nowMs - baselineMs < 3u * BASELINE_DURATION_MS) {
+        nowMs += LOOP_INTERVAL_MS;
+        out = state_machine::update(tempK, 0.0f, 10.0f, false, nowMs, false, 1.0f, 100);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Operating),
+                      static_cast<int8_t>(out.state));
+}
+
+void test_operating_steady_has_no_deviation(void) {
+    uint32_t t = runToOperating();
+    state_machine::Output out{};
+    for (int i = 0; i < 2000; ++i) {
+        t += LOOP_INTERVAL_MS;
+        const float r = (i & 1) ? 0.01f : -0.01f;
+        out = state_machine::update(SETPOINT_K + r, 0.0f, 10.0f + r, false, t, false, 1.0f + r, 100);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Operating),
+                      static_cast<int8_t>(out.state));
+    TEST_ASSERT_EQUAL_UINT8(0, out.deviationMask);
+}
+
+void test_operating_spike_sets_warning_only(void) {
+    uint32_t t = runToOperating();
+    // One 1 A current spike: far beyond BASELINE_WARN_Z, but a single tick
+    t += LOOP_INTERVAL_MS;
+    auto out = state_machine::update(SETPOINT_K, 0.0f, 10.0f, false, t, false, 2.0f, 100);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Operating),
+                      static_cast<int8_t>(out.state));
+    TEST_ASSERT_EQUAL_UINT8(baseline::Engine::bit(static_cast<uint8_t>(baseline::Channel::CurrentA)),
+                            out.deviationMask);
+    t += LOOP_INTERVAL_MS;
+    out = state_machine::update(SETPOINT_K, 0.0f, 10.0f, false, t, false, 1.0f, 100);
+    TEST_ASSERT_EQUAL_UINT8(0, out.deviationMask);
+}
+
+void test_operating_sustained_drift_alarms_after_warmup(void) {
+    uint32_t t = runToOperating();
+    // +0.4 K (2σ at the drift floor) is never a warning, but CUSUM
+    // accumulates it once the warm-up is over
+    state_machine::Output out{};
+    uint32_t ticks = 0;
+    do {
+        t += LOOP_INTERVAL_MS;
+        out = state_machine::update(SETPOINT_K + 0.4f, 0.0f, 10.0f, false, t, false, 1.0f, 100);
+        TEST_ASSERT_EQUAL_UINT8(0, out.deviationMask);
+        ++ticks;
+    } while (state_machine::getBaseline().alarmMask() == 0 && ticks < BASELINE_WARMUP_CHECKS + 100u);
+
+    TEST_ASSERT_NOT_EQUAL(0, state_machine::getBaseline().alarmMask());
+    TEST_ASSERT_TRUE(ticks > BASELINE_WARMUP_CHECKS);
+    TEST_ASSERT_TRUE(ticks < BASELINE_WARMUP_CHECKS + 20u);
+    // Warning-only by default: the alarm is reported, the cooler keeps running
+    TEST_ASSERT_FALSE(BASELINE_DEVIATION_FAULT);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Operating),
+                      static_cast<int8_t>(out.state));
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(state_machine::FaultReason::None),
+                      static_cast<uint8_t>(state_machine::getFaultReason()));
+}
+
+// ---------------------------------------------------------------------------
+// Runtime parameter overrides (params.h)
+// ---------------------------------------------------------------------------
+
+void test_setpoint_override_moves_the_band(void) {
+    // 90 K is far above the default band; with setpoint 90 it is in band
+    const params::Change c[] = {
+        {params::Id::SetpointK, 90.0f}, {params::Id::CoarseFineK, 100.0f},
+    };
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Ok),
+                            static_cast<uint8_t>(params::apply(c, 2)));
+    state_machine::init(0);
+    state_machine::start(100, 90.0f);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Settle),
+                      static_cast<int8_t>(state_machine::getState()));
+
+    // 95 K: below the moved threshold, above the band → FineCooldown
+    state_machine::init(0);
+    state_machine::start(100, 95.0f);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::FineCooldown),
+                      static_cast<int8_t>(state_machine::getState()));
+    params::resetDefaults();
+}
+
+void test_backoff_limit_override_faults_sooner(void) {
+    const params::Change c[] = {{params::Id::BackoffMaxCount, 3.0f}};
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(params::Result::Ok),
+                            static_cast<uint8_t>(params::apply(c, 1)));
+    const uint32_t tStart = initAndStart();
+    state_machine::Output out{};
+    for (uint8_t i = 0; i < 3; ++i) {
+        out = state_machine::update(200.0f, 0.5f, 0.0f, false, tStart + 1u + i, true);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Fault),
+                      static_cast<int8_t>(out.state));
+    TEST_ASSERT_EQUAL_UINT16(3, out.backoffCount);
+    params::resetDefaults();
+}
+
+// ---------------------------------------------------------------------------
+// Warm restart: snapshot() / resume()
+// ---------------------------------------------------------------------------
+
+void test_resume_continues_settle_where_it_stopped(void) {
+    // 40 s into the 60 s settle window with one backoff, then "reboot"
+    state_machine::init(0);
+    state_machine::start(100, SETPOINT_K);
+    uint32_t nowMs = 100;
+    state_machine::update(SETPOINT_K, 0.0f, 0.0f, false, nowMs, true);   // timer starts
+    const uint32_t settledMs = SETTLE_DURATION_MS - 20000u;
+    for (nowMs = 100; nowMs < 100 + settledMs; nowMs += LOOP_INTERVAL_MS) {
+        state_machine::update(SETPOINT_K, 0.0f, 0.0f, false, nowMs);
+    }
+    const state_machine::Snapshot snap = state_machine::snapshot(nowMs);
+    TEST_ASSERT_TRUE(snap.running);
+    TEST_ASSERT_TRUE(snap.settleTimerActive);
+
+    const uint32_t bootMs = 1500;          // millis() restarts
+    state_machine::init(0);
+    TEST_ASSERT_TRUE(state_machine::resume(snap, bootMs));
+    TEST_ASSERT_TRUE(state_machine::isRunning());
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Settle),
+                      static_cast<int8_t>(state_machine::getState()));
+    stub_setMillis(bootMs);
+    TEST_ASSERT_EQUAL_UINT32(snap.timeInStateMs, state_machine::getTimeInState());
+
+    auto out = state_machine::update(SETPOINT_K, 0.0f, 0.0f, false, bootMs);
+    TEST_ASSERT_EQUAL_UINT16(1, out.backoffCount);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Settle),
+                      static_cast<int8_t>(out.state));
+
+    // Only the remaining ~20 s of settling is needed, not a full window
+    out = state_machine::update(SETPOINT_K, 0.0f, 0.0f, false, bootMs + 20000u);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Baseline),
+                      static_cast<int8_t>(out.state));
+}
+
+void test_resume_keeps_dac_loop_output(void) {
+    const uint32_t tStart = initAndStart();
+    state_machine::Output out{};
+    for (uint32_t i = 1; i <= 50; ++i) {
+        out = state_machine::update(200.0f, 0.5f, 0.0f, false, tStart + i * LOOP_INTERVAL_MS,
+                                    false, 0.0f, out.dacTarget);
+    }
+    const uint32_t tSnap = tStart + 50 * LOOP_INTERVAL_MS;
+    const state_machine::Snapshot snap = state_machine::snapshot(tSnap);
+
+    state_machine::init(0);
+    TEST_ASSERT_TRUE(state_machine::resume(snap, 1000));
+    const auto next = state_machine::update(200.0f, 0.5f, 0.0f, false, 1000 + LOOP_INTERVAL_MS,
+                                            false, 0.0f, out.dacTarget);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::CoarseCooldown),
+                      static_cast<int8_t>(next.state));
+    // Continues from the loop output rather than ramping up from zero
+    TEST_ASSERT_TRUE(next.dacTarget + DAC_MAX_STEP_PER_INTERVAL >= out.dacTarget);
+    TEST_ASSERT_TRUE(out.dacTarget > 0);
+}
+
+void test_resume_rejects_stopped_or_faulted_snapshot(void) {
+    initStartAndStop();
+    const state_machine::Snapshot idle = state_machine::snapshot(2000);
+    TEST_ASSERT_FALSE(idle.running);
+
+    const uint32_t tStart = initAndStart();
+    state_machine::update(200.0f, 0.5f, RMS_MAX_VOLTAGE_VDC + 1.0f, false, tStart + 1);
+    const state_machine::Snapshot fault = state_machine::snapshot(tStart + 2);
+
+    state_machine::init(0);
+    TEST_ASSERT_FALSE(state_machine::resume(idle, 100));
+    TEST_ASSERT_FALSE(state_machine::resume(fault, 100));
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Off),
+                      static_cast<int8_t>(state_machine::getState()));
+    TEST_ASSERT_FALSE(state_machine::isRunning());
+}
+
+// ---------------------------------------------------------------------------
+// Transition hook (run-log journal)
+// ---------------------------------------------------------------------------
+
+struct HookCall {
+    state_machine::State       from;
+    state_machine::State       to;
+    state_machine::FaultReason reason;
+    uint32_t                   nowMs;
+};
+
+static HookCall hookCalls[8];
+static uint8_t  hookCount = 0;
+
+static void recordTransition(state_machine::State from, state_machine::State to,
+                             state_machine::FaultReason reason, uint32_t nowMs) {
+    if (hookCount < 8) hookCalls[hookCount] = {from, to, reason, nowMs};
+    ++hookCount;
+}
+
+void test_transition_hook_reports_changes_and_fault_reason(void) {
+    hookCount = 0;
+    state_machine::setTransitionHook(recordTransition);
+    const uint32_t tStart = initAndStart();
+    state_machine::update(200.0f, 0.5f, 0.0f, false, tStart + 1);       // no change
+    state_machine::update(200.0f, 0.5f, RMS_MAX_VOLTAGE_VDC + 1.0f, false, tStart + 2);
+    state_machine::setTransitionHook(nullptr);
+
+    TEST_ASSERT_EQUAL_UINT8(2, hookCount);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Off),
+                      static_cast<int8_t>(hookCalls[0].from));
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::CoarseCooldown),
+                      static_cast<int8_t>(hookCalls[0].to));
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(state_machine::FaultReason::None),
+                      static_cast<uint8_t>(hookCalls[0].reason));
+    TEST_ASSERT_EQUAL_UINT32(tStart, hookCalls[0].nowMs);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Fault),
+                      static_cast<int8_t>(hookCalls[1].to));
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(state_machine::FaultReason::RmsOvervoltage),
+                      static_cast<uint8_t>(hookCalls[1].reason));
+    TEST_ASSERT_EQUAL_UINT32(tStart + 2, hookCalls[1].nowMs);
+}
+
+// ---------------------------------------------------------------------------
+// Independent Machine instances (fleet channels)
+// ---------------------------------------------------------------------------
+
+void test_machines_keep_independent_state(void) {
+    state_machine::Machine a;
+    state_machine::Machine b;
+    a.init(0);
+    b.init(0);
+    state_machine::init(0);
+
+    a.start(100, 200.0f);
+    b.start(100, 80.0f);
+    a.update(200.0f, 0.5f, RMS_MAX_VOLTAGE_VDC + 1.0f, false, 101);   // only a faults
+    const state_machine::Output outB = b.update(78.5f, 0.0f, 0.0f, false, 101);
+
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Fault),
+                      static_cast<int8_t>(a.getState()));
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(state_machine::FaultReason::RmsOvervoltage),
+                      static_cast<uint8_t>(a.getFaultReason()));
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Settle),
+                      static_cast<int8_t>(outB.state));
+    TEST_ASSERT_TRUE(b.isRunning());
+
+    // The free functions drive primary(), which neither run touched
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::Off),
+                      static_cast<int8_t>(state_machine::getState()));
+    TEST_ASSERT_FALSE(state_machine::isRunning());
+}
+
+void test_transition_hook_is_per_machine(void) {
+    hookCount = 0;
+    state_machine::Machine a;
+    state_machine::Machine b;
+    a.init(0);
+    b.init(0);
+    a.setTransitionHook(recordTransition);
+    a.start(10, 200.0f);
+    b.start(10, 200.0f);
+    TEST_ASSERT_EQUAL_UINT8(1, hookCount);
+    TEST_ASSERT_EQUAL(static_cast<int8_t>(state_machine::State::CoarseCooldown),
+                      static_cast<int8_t>(hookCalls[0].to));
+}
+
 // ---------------------------------------------------------------------------
 // stateName helper
 // ---------------------------------------------------------------------------
@@ -644,6 +1137,10 @@ int main(int argc, char **argv) {
     RUN_TEST(test_start_above_threshold_enters_coarse_cooldown);
     RUN_TEST(test_start_below_threshold_enters_fine_cooldown);
     RUN_TEST(test_start_inband_enters_settle);
+    RUN_TEST(test_settle_waits_for_dac_to_stop_moving);
+    RUN_TEST(test_settle_waits_for_temperature_to_stop_drifting);
+    RUN_TEST(test_dac_lag_follows_runtime_step);
+    RUN_TEST(test_cooldown_over_max_rate_never_adds_drive);
     RUN_TEST(test_start_overshot_enters_overshoot);
     RUN_TEST(test_start_resume_fine_no_stall_fault);
 
@@ -654,11 +1151,94 @@ int main(int argc, char **argv) {
     RUN_TEST(test_overstroke_ignored_when_not_running);
     RUN_TEST(test_backoff_count_resets_on_start);
 
+    // Baseline fingerprint
+    RUN_TEST(test_baseline_learns_then_operates);
+    RUN_TEST(test_baseline_relearns_while_drifting);
+    RUN_TEST(test_operating_steady_has_no_deviation);
+    RUN_TEST(test_operating_spike_sets_warning_only);
+    RUN_TEST(test_operating_sustained_drift_alarms_after_warmup);
+
+    // Runtime parameters
+    RUN_TEST(test_setpoint_override_moves_the_band);
+    RUN_TEST(test_backoff_limit_override_faults_sooner);
+
+    // Warm restart
+    RUN_TEST(test_resume_continues_settle_where_it_stopped);
+    RUN_TEST(test_resume_keeps_dac_loop_output);
+    RUN_TEST(test_resume_rejects_stopped_or_faulted_snapshot);
+
+    // Transition hook
+    RUN_TEST(test_transition_hook_reports_changes_and_fault_reason);
+
+    // Independent Machine instances
+    RUN_TEST(test_machines_keep_independent_state);
+    RUN_TEST(test_transition_hook_is_per_machine);
+
     // Helpers
     RUN_TEST(test_stateName_returns_non_null);
 
     // Serial command handler
     run_serial_command_tests();
 
+    // Streaming RMS accumulator
+    run_rms_window_tests();
+
+    // Lock-free SPSC queue
+    run_spsc_queue_tests();
+
+    // Telemetry frame ring
+    run_telemetry_tests();
+
+    // Binary telemetry framing
+    run_frame_codec_tests();
+
+    // Overstroke burst capture
+    run_burst_capture_tests();
+
+    // RTD code → temperature table
+    run_rtd_lut_tests();
+
+    // Cooling-rate / stall history
+    run_temp_history_tests();
+
+    // Baseline statistics / deviation detector
+    run_baseline_tests();
+
+    // DAC PID / feed-forward controller
+    run_pid_controller_tests();
+
+    // Cooperative scheduler
+    run_scheduler_tests();
+
+    // Profiling histograms
+    run_perf_tests();
+
+    // Closed loop against the simulated plant
+    run_simulation_tests();
+
+    // Circular flash run log
+    run_log_store_tests();
+
+    // Console tokenizer and runtime parameters
+    run_command_line_tests();
+
+    // Telemetry capture replay
+    run_replay_tests();
+
+    // Network telemetry datagram pool
+    run_datagram_pool_tests();
+
+    // Online cooldown fit and ETA
+    run_cooldown_eta_tests();
+
+    // Overstroke harmonic check
+    run_harmonic_window_tests();
+
+    // Dashboard column map
+    run_ssproj_map_tests();
+
+    // Indicator flash patterns
+    run_indicator_pattern_tests();
+
     return UNITY_END();
 }
@@ -0,0 +1,517 @@
+/**
+ * @file test_telemetry.cpp
+ * @brief Unit tests for the telemetry frame ring and formatter.
+ *
+ * Frames are built by hand and pushed through submit() / drain() with a
+ * stub Print, so ring accounting and TX-space gating can be checked without
+ * Serial.  main() lives in test_state_machine.cpp and calls
+ * run_telemetry_tests() defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <cstring>
+#include <math.h>
+#include <string>
+#include <stdint.h>
+#include "Print.h"
+#include "config.h"
+#include "telemetry.h"
+#include "frame_codec.h"
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static telemetry::Frame makeFrame(uint32_t onDurationMs) {
+    telemetry::Frame f{};
+    f.state         = state_machine::State::Operating;
+    f.statusText    = "Operating normally";
+    f.tempK         = 77.25f;
+    f.tempC         = -195.9f;
+    f.ambientTempC  = 21.5f;
+    f.coolingRate   = 0.125f;
+    f.dacTarget     = 1234;
+    f.dacActual     = 1200;
+    f.rmsV          = 10.5f;
+    f.relayNormal   = true;
+    f.alarmRelay    = false;
+    f.redLed        = false;
+    f.greenLed      = true;
+    f.onDurationMs  = onDurationMs;
+    f.cooldownPct   = 100.0f;
+    f.timeInStateMs = 61000;
+    f.currentA      = 1.25f;
+    f.backoffCount  = 3;
+    f.ambientAgeMs  = -1;
+    f.etaS          = -1;
+    f.etaConfPct    = 0;
+    return f;
+}
+
+/** Empty the ring (and any held frame), select CSV and zero the counters. */
+static void resetRing() {
+    telemetry::setFormat(telemetry::Format::Csv);
+    telemetry::resetSchedule();
+    Print sink;
+    while (telemetry::drain(sink, SIZE_MAX) > 0) { sink.reset(); }
+    telemetry::resetStats();
+}
+
+// ---------------------------------------------------------------------------
+// formatFrame
+// ---------------------------------------------------------------------------
+
+void test_tel_format_frame_layout() {
+    char buf[telemetry::MAX_FRAME_LEN];
+    const size_t n = telemetry::formatFrame(makeFrame(3723000), buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_UINT32(strlen(buf), n);
+    TEST_ASSERT_EQUAL_INT(0, strncmp(buf, "/*7|Operating|Operating normally|77.25|", 38));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "|3723000|01:02:03|100.00|00:01:01|1.25|3|-1|-1|0*/\r\n"));
+}
+
+void test_tel_format_frame_too_small_returns_zero() {
+    char buf[16];
+    TEST_ASSERT_EQUAL_UINT32(0, telemetry::formatFrame(makeFrame(0), buf, sizeof(buf)));
+}
+
+/** Column @p n (1-based) of the Quick-Plot line in @p buf. */
+static std::string column(const char* buf, uint8_t n) {
+    const char* p = buf + 2;   // past "/*"
+    for (uint8_t i = 1; i < n; ++i) p = strchr(p, '|') + 1;
+    return std::string(p, strcspn(p, "|*"));
+}
+
+void test_tel_fixed_point_rendering() {
+    char buf[telemetry::MAX_FRAME_LEN];
+    telemetry::Frame f = makeFrame(0);
+    f.tempK        = 9.996f;      // rounds up into the next integer
+    f.tempC        = -0.004f;     // rounds to zero: no "-0.00"
+    f.ambientTempC = NAN;
+    f.coolingRate  = -1.2346f;
+    f.rmsV         = INFINITY;
+    f.currentA     = 0.05f;
+    telemetry::formatFrame(f, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("10.00", column(buf, 4).c_str());
+    TEST_ASSERT_EQUAL_STRING("0.00", column(buf, 5).c_str());
+    TEST_ASSERT_EQUAL_STRING("nan", column(buf, 6).c_str());
+    TEST_ASSERT_EQUAL_STRING("-1.235", column(buf, 7).c_str());
+    TEST_ASSERT_EQUAL_STRING("inf", column(buf, 10).c_str());
+    TEST_ASSERT_EQUAL_STRING("0.05", column(buf, 19).c_str());
+}
+
+void test_tel_integer_and_hms_rendering() {
+    char buf[telemetry::MAX_FRAME_LEN];
+    telemetry::Frame f = makeFrame(360000000u);   // 100 h
+    f.ambientAgeMs = -2147483647 - 1;
+    f.etaS         = 0;
+    telemetry::formatFrame(f, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("360000000", column(buf, 15).c_str());
+    TEST_ASSERT_EQUAL_STRING("100:00:00", column(buf, 16).c_str());
+    TEST_ASSERT_EQUAL_STRING("-2147483648", column(buf, 21).c_str());
+    TEST_ASSERT_EQUAL_STRING("0", column(buf, 22).c_str());
+}
+
+void test_tel_text_column_follows_new_string() {
+    char buf[telemetry::MAX_FRAME_LEN];
+    telemetry::Frame f = makeFrame(0);
+    telemetry::formatFrame(f, buf, sizeof(buf));
+    f.state      = state_machine::State::Fault;
+    f.statusText = "FAULT";
+    telemetry::formatFrame(f, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(0, strncmp(buf, "/*8|Fault|FAULT|77.25|", 22));
+    f.statusText = nullptr;
+    telemetry::formatFrame(f, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("", column(buf, 3).c_str());
+}
+
+// ---------------------------------------------------------------------------
+// Ring accounting
+// ---------------------------------------------------------------------------
+
+void test_tel_submit_drain_counts() {
+    resetRing();
+    TEST_ASSERT_TRUE(telemetry::submit(makeFrame(1000)));
+    TEST_ASSERT_TRUE(telemetry::submit(makeFrame(2000)));
+
+    Print p;
+    TEST_ASSERT_EQUAL_UINT32(2, telemetry::drain(p, SIZE_MAX));
+    TEST_ASSERT_TRUE(p.contains("|1000|00:00:01|"));
+    TEST_ASSERT_TRUE(p.contains("|2000|00:00:02|"));
+
+    const telemetry::Stats st = telemetry::getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, st.submitted);
+    TEST_ASSERT_EQUAL_UINT32(2, st.sent);
+    TEST_ASSERT_EQUAL_UINT32(0, st.dropped);
+    TEST_ASSERT_EQUAL_UINT32(2, st.highWater);
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_RING_DEPTH, st.capacity);
+}
+
+void test_tel_full_ring_drops_newest() {
+    resetRing();
+    for (uint32_t i = 0; i < TELEMETRY_RING_DEPTH; ++i) {
+        TEST_ASSERT_TRUE(telemetry::submit(makeFrame(i * 1000u)));
+    }
+    TEST_ASSERT_FALSE(telemetry::submit(makeFrame(999999)));
+
+    const telemetry::Stats st = telemetry::getStats();
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_RING_DEPTH + 1u, st.submitted);
+    TEST_ASSERT_EQUAL_UINT32(1, st.dropped);
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_RING_DEPTH, st.highWater);
+
+    // The oldest frames survive; the rejected one never appears.
+    Print p;
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_RING_DEPTH, telemetry::drain(p, SIZE_MAX));
+    TEST_ASSERT_TRUE(p.contains("|0|00:00:00|"));
+    TEST_ASSERT_FALSE(p.contains("|999999|"));
+}
+
+void test_tel_drain_respects_tx_space() {
+    resetRing();
+    char buf[telemetry::MAX_FRAME_LEN];
+    const size_t frameLen = telemetry::formatFrame(makeFrame(1000), buf, sizeof(buf));
+    telemetry::submit(makeFrame(1000));
+    telemetry::submit(makeFrame(1000));
+
+    // Not enough room for one whole frame: nothing is written.
+    Print p;
+    TEST_ASSERT_EQUAL_UINT32(0, telemetry::drain(p, frameLen - 1));
+    TEST_ASSERT_EQUAL_UINT32(0, p.length());
+
+    // Room for exactly one: the held frame goes out, the second waits.
+    TEST_ASSERT_EQUAL_UINT32(1, telemetry::drain(p, frameLen));
+    TEST_ASSERT_EQUAL_UINT32(frameLen, p.length());
+
+    TEST_ASSERT_EQUAL_UINT32(1, telemetry::drain(p, SIZE_MAX));
+    TEST_ASSERT_EQUAL_UINT32(2, telemetry::getStats().sent);
+}
+
+static uint32_t tappedFrames = 0;
+static uint32_t tappedLastOnMs = 0;
+
+static void countingTap(const telemetry::Frame& f) {
+    ++tappedFrames;
+    tappedLastOnMs = f.onDurationMs;
+}
+
+void test_tel_tap_sees_each_sample_once() {
+    resetRing();
+    tappedFrames = 0;
+    telemetry::setTap(countingTap);
+    telemetry::submit(makeFrame(1000));
+    telemetry::submit(makeFrame(2000));
+
+    // The first frame is popped (and tapped) even though it cannot be written
+    Print p;
+    TEST_ASSERT_EQUAL_UINT32(0, telemetry::drain(p, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, tappedFrames);
+    TEST_ASSERT_EQUAL_UINT32(0, telemetry::drain(p, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, tappedFrames);          // held, not re-tapped
+
+    TEST_ASSERT_EQUAL_UINT32(2, telemetry::drain(p, SIZE_MAX));
+    TEST_ASSERT_EQUAL_UINT32(2, tappedFrames);
+    TEST_ASSERT_EQUAL_UINT32(2000, tappedLastOnMs);
+    telemetry::setTap(nullptr);
+}
+
+void test_tel_reset_stats_keeps_capacity() {
+    resetRing();
+    telemetry::submit(makeFrame(0));
+    telemetry::resetStats();
+    const telemetry::Stats st = telemetry::getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, st.submitted);
+    TEST_ASSERT_EQUAL_UINT32(0, st.highWater);
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_RING_DEPTH, st.capacity);
+    resetRing();
+}
+
+void test_tel_reset_stats_is_applied_by_each_side() {
+    resetRing();
+    telemetry::submit(makeFrame(0));
+    telemetry::submit(makeFrame(1000));
+    Print p;
+    telemetry::drain(p, SIZE_MAX);
+    telemetry::submit(makeFrame(2000));
+    telemetry::resetStats();
+
+    // The producer restarts its counts at the next submit()...
+    telemetry::submit(makeFrame(3000));
+    telemetry::Stats st = telemetry::getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, st.submitted);
+    TEST_ASSERT_EQUAL_UINT32(2, st.highWater);   // 2000 and 3000 still queued
+    TEST_ASSERT_EQUAL_UINT32(0, st.sent);        // consumer reset still pending
+
+    // ... and the consumer at the next drain()
+    TEST_ASSERT_EQUAL_UINT32(2, telemetry::drain(p, SIZE_MAX));
+    st = telemetry::getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, st.sent);
+    resetRing();
+}
+
+// ---------------------------------------------------------------------------
+// Scheduling: decimation, field mask, delta mode, keyframes
+// ---------------------------------------------------------------------------
+
+/** Count the '|'-separated columns of a CSV line that are non-empty. */
+static uint8_t filledColumns(const char* line) {
+    const char* p = strstr(line, "/*");
+    if (!p) return 0;
+    p += 2;
+    uint8_t filled = 0;
+    bool    any    = false;
+    for (; *p && !(p[0] == '*' && p[1] == '/'); ++p) {
+        if (*p == '|') { filled += any ? 1 : 0; any = false; }
+        else           { any = true; }
+    }
+    return static_cast<uint8_t>(filled + (any ? 1 : 0));
+}
+
+void test_tel_steady_state_is_decimated() {
+    resetRing();
+    telemetry::setSteadyDivisor(5);
+    uint8_t queued = 0;
+    for (uint8_t i = 0; i < 20; ++i) {                  // Operating = steady
+        queued += telemetry::sample(makeFrame(i * 200u)) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_UINT8(4, queued);                 // first + every 5th
+    resetRing();
+}
+
+void test_tel_cooldown_is_not_decimated() {
+    resetRing();
+    telemetry::setSteadyDivisor(5);
+    telemetry::Frame f = makeFrame(0);
+    f.state = state_machine::State::CoarseCooldown;
+    uint8_t queued = 0;
+    for (uint8_t i = 0; i < 10; ++i) { queued += telemetry::sample(f) ? 1 : 0; }
+    TEST_ASSERT_EQUAL_UINT8(10, queued);
+    resetRing();
+}
+
+void test_tel_state_change_bypasses_divisor() {
+    resetRing();
+    telemetry::setSteadyDivisor(10);
+    telemetry::Frame f = makeFrame(0);
+    TEST_ASSERT_TRUE(telemetry::sample(f));              // first frame
+    TEST_ASSERT_FALSE(telemetry::sample(f));
+    f.state = state_machine::State::Baseline;
+    TEST_ASSERT_TRUE(telemetry::sample(f));              // transition
+    resetRing();
+}
+
+void test_tel_field_mask_blanks_columns() {
+    char buf[telemetry::MAX_FRAME_LEN];
+    const uint32_t mask = telemetry::fieldBit(1) | telemetry::fieldBit(4);
+    telemetry::formatFrame(makeFrame(0), buf, sizeof(buf), mask);
+    TEST_ASSERT_EQUAL_STRING("/*7|||77.25|||||||||||||||||||*/\r\n", buf);
+}
+
+void test_tel_delta_omits_unchanged_slow_fields() {
+    char buf[telemetry::MAX_FRAME_LEN];
+    const telemetry::Frame prev = makeFrame(1000);
+    telemetry::Frame cur        = makeFrame(1500);      // same whole second
+    cur.tempK = 77.5f;
+    telemetry::formatFrame(cur, buf, sizeof(buf), telemetry::FIELD_MASK_ALL, &prev);
+    TEST_ASSERT_EQUAL_INT(0, strncmp(buf, "/*7|||77.50|", 12));
+    TEST_ASSERT_NOT_NULL(strstr(buf, "|1500||100.00||1.25||-1|-1|0*/"));
+
+    cur.backoffCount = 4;
+    telemetry::formatFrame(cur, buf, sizeof(buf), telemetry::FIELD_MASK_ALL, &prev);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "|1.25|4|-1|-1|0*/"));
+}
+
+void test_tel_delta_keyframe_interval() {
+    resetRing();
+    telemetry::setDeltaMode(true);
+    telemetry::setKeyframeInterval(3);
+    Print out;
+    uint8_t filled[6];
+    for (uint8_t i = 0; i < 6; ++i) {
+        telemetry::submit(makeFrame(0));
+        out.reset();
+        telemetry::drain(out, SIZE_MAX);
+        filled[i] = filledColumns(out.str());
+    }
+    // Keyframe, delta, delta, keyframe, delta, delta
+    TEST_ASSERT_EQUAL_UINT8(telemetry::FIELD_COUNT, filled[0]);
+    TEST_ASSERT_LESS_THAN(telemetry::FIELD_COUNT, filled[1]);
+    TEST_ASSERT_LESS_THAN(telemetry::FIELD_COUNT, filled[2]);
+    TEST_ASSERT_EQUAL_UINT8(telemetry::FIELD_COUNT, filled[3]);
+    TEST_ASSERT_LESS_THAN(telemetry::FIELD_COUNT, filled[4]);
+    resetRing();
+}
+
+// ---------------------------------------------------------------------------
+// Binary format
+// ---------------------------------------------------------------------------
+
+/** Strip the delimiter, COBS-decode and CRC-check one wire frame. */
+static size_t decodeWire(const uint8_t* wire, size_t n, uint8_t* payload, size_t cap) {
+    if (n < 2 || wire[n - 1] != 0x00) return 0;
+    const size_t m = codec::cobsDecode(wire, n - 1, payload, cap);
+    if (m < 3) return 0;
+    const uint16_t crc = static_cast<uint16_t>(payload[m - 2] | (payload[m - 1] << 8));
+    if (crc != codec::crc16(payload, m - 2)) return 0;
+    return m - 2;
+}
+
+static uint16_t le16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+static uint32_t le32(const uint8_t* p) { return le16(p) | (static_cast<uint32_t>(le16(p + 2)) << 16); }
+
+void test_tel_binary_frame_layout() {
+    telemetry::Frame f = makeFrame(3723000);
+    f.seq         = 0x1234;
+    f.faultReason = state_machine::FaultReason::TemperatureStall;
+
+    uint8_t wire[telemetry::MAX_FRAME_LEN];
+    const size_t n = telemetry::formatBinaryFrame(f, wire, sizeof(wire));
+    TEST_ASSERT_EQUAL_UINT32(telemetry::SAMPLE_PAYLOAD_LEN + 4u, n);   // CRC + COBS + 0x00
+    for (size_t i = 0; i + 1 < n; ++i) { TEST_ASSERT_NOT_EQUAL(0, wire[i]); }
+
+    uint8_t p[64];
+    TEST_ASSERT_EQUAL_UINT32(telemetry::SAMPLE_PAYLOAD_LEN, decodeWire(wire, n, p, sizeof(p)));
+    TEST_ASSERT_EQUAL_HEX8(telemetry::FRAME_TYPE_SAMPLE, p[0]);
+    TEST_ASSERT_EQUAL_UINT8(telemetry::BINARY_VERSION, p[1]);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, le16(&p[2]));
+    TEST_ASSERT_EQUAL_INT8(7, static_cast<int8_t>(p[4]));
+    TEST_ASSERT_EQUAL_UINT8(2, p[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x01 | 0x08, p[6]);                 // relay_normal, green, no ambient
+    TEST_ASSERT_EQUAL_UINT16(7725, le16(&p[7]));               // 77.25 K
+    TEST_ASSERT_EQUAL_INT16(2150, static_cast<int16_t>(le16(&p[9])));
+    TEST_ASSERT_EQUAL_INT16(125, static_cast<int16_t>(le16(&p[11])));
+    TEST_ASSERT_EQUAL_UINT16(1234, le16(&p[13]));
+    TEST_ASSERT_EQUAL_UINT16(1200, le16(&p[15]));
+    TEST_ASSERT_EQUAL_UINT16(1050, le16(&p[17]));
+    TEST_ASSERT_EQUAL_UINT16(1250, le16(&p[19]));
+    TEST_ASSERT_EQUAL_UINT16(10000, le16(&p[21]));
+    TEST_ASSERT_EQUAL_UINT16(3, le16(&p[23]));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, le16(&p[25]));
+    TEST_ASSERT_EQUAL_UINT32(3723000, le32(&p[27]));
+    TEST_ASSERT_EQUAL_UINT32(61000, le32(&p[31]));
+    TEST_ASSERT_EQUAL_INT32(-1, static_cast<int32_t>(le32(&p[35])));   // ETA unknown
+    TEST_ASSERT_EQUAL_UINT8(0, p[39]);
+}
+
+void test_tel_binary_saturates_out_of_range() {
+    telemetry::Frame f = makeFrame(0);
+    f.coolingRate = 1000.0f;
+    f.tempK       = -5.0f;
+    uint8_t wire[telemetry::MAX_FRAME_LEN];
+    uint8_t p[64];
+    const size_t n = telemetry::formatBinaryFrame(f, wire, sizeof(wire));
+    TEST_ASSERT_EQUAL_UINT32(telemetry::SAMPLE_PAYLOAD_LEN, decodeWire(wire, n, p, sizeof(p)));
+    TEST_ASSERT_EQUAL_UINT16(0, le16(&p[7]));
+    TEST_ASSERT_EQUAL_INT16(32767, static_cast<int16_t>(le16(&p[11])));
+}
+
+void test_tel_binary_descriptor_precedes_samples() {
+    resetRing();
+    telemetry::setFormat(telemetry::Format::Binary);
+    telemetry::submit(makeFrame(0));
+
+    Print out;
+    TEST_ASSERT_EQUAL_UINT32(1, telemetry::drain(out, SIZE_MAX));   // samples only
+
+    // Walk the 0x00-delimited stream: DESCRIPTOR_COUNT descriptors, then one sample.
+    const uint8_t* w = out.data();
+    size_t start = 0;
+    uint8_t frames = 0;
+    for (size_t i = 0; i < out.length(); ++i) {
+        if (w[i] != 0x00) continue;
+        uint8_t p[128];
+        const size_t m = decodeWire(&w[start], i - start + 1, p, sizeof(p));
+        TEST_ASSERT_GREATER_THAN(0, m);
+        if (frames < telemetry::DESCRIPTOR_COUNT) {
+            TEST_ASSERT_EQUAL_HEX8(telemetry::FRAME_TYPE_DESCRIPTOR, p[0]);
+            TEST_ASSERT_EQUAL_UINT8(frames, p[2]);
+        } else {
+            TEST_ASSERT_EQUAL_HEX8(telemetry::FRAME_TYPE_SAMPLE, p[0]);
+        }
+        if (frames == 0) {
+            // Entry 0 is State::Off
+            TEST_ASSERT_EQUAL_UINT8(0, p[4]);
+            TEST_ASSERT_EQUAL_INT8(-1, static_cast<int8_t>(p[5]));
+            TEST_ASSERT_EQUAL_UINT8(3, p[6]);
+            TEST_ASSERT_EQUAL_INT(0, memcmp(&p[7], "Off", 3));
+        }
+        ++frames;
+        start = i + 1;
+    }
+    TEST_ASSERT_EQUAL_UINT8(telemetry::DESCRIPTOR_COUNT + 1u, frames);
+    resetRing();
+}
+
+void test_tel_descriptor_fault_entries() {
+    uint8_t wire[telemetry::MAX_FRAME_LEN];
+    uint8_t p[128];
+    const uint8_t idx = state_machine::STATE_COUNT + 3u;   // TooManyBackoffs
+    const size_t n = telemetry::formatDescriptor(idx, wire, sizeof(wire));
+    const size_t m = decodeWire(wire, n, p, sizeof(p));
+    TEST_ASSERT_GREATER_THAN(0, m);
+    TEST_ASSERT_EQUAL_UINT8(1, p[4]);
+    TEST_ASSERT_EQUAL_INT8(3, static_cast<int8_t>(p[5]));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&p[7], "TooManyBackoffs", p[6]));
+
+    TEST_ASSERT_EQUAL_UINT32(0, telemetry::formatDescriptor(telemetry::DESCRIPTOR_COUNT,
+                                                            wire, sizeof(wire)));
+}
+
+void test_tel_submit_assigns_sequence_including_drops() {
+    resetRing();
+    telemetry::setFormat(telemetry::Format::Binary);
+    Print out;
+    telemetry::drain(out, SIZE_MAX);   // flush descriptor set
+    out.reset();
+
+    for (uint32_t i = 0; i <= TELEMETRY_RING_DEPTH; ++i) { telemetry::submit(makeFrame(0)); }
+    telemetry::drain(out, SIZE_MAX);
+    telemetry::submit(makeFrame(0));
+    const size_t before = out.length();
+    telemetry::drain(out, SIZE_MAX);
+
+    // First queued and post-drop frames are DEPTH + 1 apart: one seq was lost.
+    uint8_t p0[64], p1[64];
+    const size_t frameLen = telemetry::SAMPLE_PAYLOAD_LEN + 4u;
+    TEST_ASSERT_GREATER_THAN(0, decodeWire(out.data(), frameLen, p0, sizeof(p0)));
+    TEST_ASSERT_GREATER_THAN(0, decodeWire(out.data() + before, frameLen, p1, sizeof(p1)));
+    TEST_ASSERT_EQUAL_UINT16(TELEMETRY_RING_DEPTH + 1u,
+                             static_cast<uint16_t>(le16(&p1[2]) - le16(&p0[2])));
+    resetRing();
+}
+
+void test_tel_descriptor_request_ignored_in_csv() {
+    resetRing();
+    telemetry::requestDescriptor();
+    Print out;
+    TEST_ASSERT_EQUAL_UINT32(0, telemetry::drain(out, SIZE_MAX));
+    TEST_ASSERT_EQUAL_UINT32(0, out.length());
+}
+
+// ---------------------------------------------------------------------------
+// Entry point called by the shared test runner in test_state_machine.cpp
+// ---------------------------------------------------------------------------
+
+void run_telemetry_tests() {
+    RUN_TEST(test_tel_format_frame_layout);
+    RUN_TEST(test_tel_format_frame_too_small_returns_zero);
+    RUN_TEST(test_tel_fixed_point_rendering);
+    RUN_TEST(test_tel_integer_and_hms_rendering);
+    RUN_TEST(test_tel_text_column_follows_new_string);
+    RUN_TEST(test_tel_submit_drain_counts);
+    RUN_TEST(test_tel_full_ring_drops_newest);
+    RUN_TEST(test_tel_drain_respects_tx_space);
+    RUN_TEST(test_tel_tap_sees_each_sample_once);
+    RUN_TEST(test_tel_reset_stats_keeps_capacity);
+    RUN_TEST(test_tel_reset_stats_is_applied_by_each_side);
+    RUN_TEST(test_tel_steady_state_is_decimated);
+    RUN_TEST(test_tel_cooldown_is_not_decimated);
+    RUN_TEST(test_tel_state_change_bypasses_divisor);
+    RUN_TEST(test_tel_field_mask_blanks_columns);
+    RUN_TEST(test_tel_delta_omits_unchanged_slow_fields);
+    RUN_TEST(test_tel_delta_keyframe_interval);
+    RUN_TEST(test_tel_binary_frame_layout);
+    RUN_TEST(test_tel_binary_saturates_out_of_range);
+    RUN_TEST(test_tel_binary_descriptor_precedes_samples);
+    RUN_TEST(test_tel_descriptor_fault_entries);
+    RUN_TEST(test_tel_submit_assigns_sequence_including_drops);
+    RUN_TEST(test_tel_descriptor_request_ignored_in_csv);
+}
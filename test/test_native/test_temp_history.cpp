@@ -0,0 +1,205 @@
+/**
+ * @file test_temp_history.cpp
+ * @brief Unit tests for the compact sample ring and the two-resolution
+ *        temperature history built on it.
+ *
+ * main() lives in test_state_machine.cpp and calls run_temp_history_tests()
+ * defined at the bottom of this file.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include "temp_history.h"
+#include "config.h"
+
+// 1 s buckets over a 10 s window → 11 buckets span it exactly.
+using History = TempHistory<5, 11>;
+
+/** Push samples every @p stepMs from @p t0 with temperature falling at @p kPerS. */
+static uint32_t feedRamp(History& h, uint32_t t0, uint32_t durationMs, uint32_t stepMs,
+                         float startK, float kPerS) {
+    uint32_t t = t0;
+    for (uint32_t e = 0; e < durationMs; e += stepMs, t += stepMs) {
+        h.push(t, startK - kPerS * static_cast<float>(e) * 0.001f);
+    }
+    return t;
+}
+
+// ---------------------------------------------------------------------------
+// SampleRing
+// ---------------------------------------------------------------------------
+
+using Ring = SampleRing<4>;
+
+void test_ring_is_four_bytes_per_entry() {
+    TEST_ASSERT_TRUE(sizeof(SampleRing<256>) <= 256u * 4u + 16u);
+}
+
+void test_ring_quantizes_to_lsb() {
+    TEST_ASSERT_EQUAL_UINT16(15440, quantizeTempK(77.2f));
+    TEST_ASSERT_FLOAT_WITHIN(TEMP_LSB_K * 0.5f, 77.2f, dequantizeTempK(quantizeTempK(77.2f)));
+    TEST_ASSERT_FLOAT_WITHIN(TEMP_LSB_K * 0.5f, 295.123f, dequantizeTempK(quantizeTempK(295.123f)));
+    TEST_ASSERT_EQUAL_UINT16(0, quantizeTempK(-3.0f));
+    TEST_ASSERT_EQUAL_UINT16(65535, quantizeTempK(400.0f));
+}
+
+void test_ring_iterates_oldest_to_newest() {
+    Ring r;
+    r.push(1000, 300.0f);
+    r.push(1200, 299.0f);
+    r.push(1500, 298.0f);
+
+    const uint32_t ts[] = {1000, 1200, 1500};
+    const float    ks[] = {300.0f, 299.0f, 298.0f};
+    uint16_t i = 0;
+    for (const TempSample s : r) {
+        TEST_ASSERT_EQUAL_UINT32(ts[i], s.timestampMs);
+        TEST_ASSERT_FLOAT_WITHIN(TEMP_LSB_K, ks[i], s.tempK);
+        ++i;
+    }
+    TEST_ASSERT_EQUAL_UINT16(3, i);
+    TEST_ASSERT_EQUAL_UINT32(500, r.spanMs());
+}
+
+void test_ring_wrap_keeps_span_and_timestamps() {
+    Ring r;
+    for (uint32_t k = 0; k < 10; ++k) {
+        r.push(100 * k * k, 200.0f + static_cast<float>(k));   // uneven spacing
+    }
+    TEST_ASSERT_EQUAL_UINT16(4, r.size());
+    TEST_ASSERT_EQUAL_UINT32(3600, r.oldest().timestampMs);
+    TEST_ASSERT_EQUAL_UINT32(8100, r.newest().timestampMs);
+    TEST_ASSERT_EQUAL_UINT32(8100 - 3600, r.spanMs());
+    TEST_ASSERT_FLOAT_WITHIN(TEMP_LSB_K, 206.0f, r.oldest().tempK);
+
+    uint32_t expect = 6;
+    for (const TempSample s : r) {
+        TEST_ASSERT_EQUAL_UINT32(100 * expect * expect, s.timestampMs);
+        ++expect;
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, expect);
+}
+
+void test_ring_empty_iterates_nothing() {
+    Ring r;
+    r.push(5, 1.0f);
+    r.clear();
+    TEST_ASSERT_TRUE(r.empty());
+    TEST_ASSERT_FALSE(r.begin() != r.end());
+}
+
+void test_ring_delta_saturates() {
+    Ring r;
+    r.push(0, 1.0f);
+    r.push(100000, 1.0f);               // gap > 65.535 s
+    TEST_ASSERT_EQUAL_UINT32(65535, r.spanMs());
+    TEST_ASSERT_EQUAL_UINT32(100000, r.newest().timestampMs);
+}
+
+// ---------------------------------------------------------------------------
+// TempHistory
+// ---------------------------------------------------------------------------
+
+void test_history_rate_needs_two_samples() {
+    History h(1000, 10000);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, h.coolingRateKPerMin());
+    h.push(0, 300.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, h.coolingRateKPerMin());
+    h.push(0, 299.0f);                  // zero elapsed time
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, h.coolingRateKPerMin());
+}
+
+void test_history_rate_spans_fine_ring_only() {
+    History h(1000, 10000);
+    // 1 K/s for 2 s, then flat: once five flat samples fill the ring the rate is 0
+    uint32_t t = feedRamp(h, 0, 2000, 200, 300.0f, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 60.0f, h.coolingRateKPerMin());
+    for (int i = 0; i < 5; ++i, t += 200) { h.push(t, 250.0f); }
+    TEST_ASSERT_EQUAL_UINT16(5, h.fine().size());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, h.coolingRateKPerMin());
+}
+
+void test_history_rate_sign_warming_is_negative() {
+    History h(1000, 10000);
+    h.push(0, 100.0f);
+    h.push(60000, 102.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -2.0f, h.coolingRateKPerMin());
+}
+
+void test_history_not_stalled_before_full_window() {
+    History h(1000, 10000);
+    feedRamp(h, 0, 9000, 200, 300.0f, 0.0f);   // flat, but only 9 s of it
+    TEST_ASSERT_FALSE(h.stalled(2.0f));
+}
+
+void test_history_flat_window_is_stalled() {
+    History h(1000, 10000);
+    feedRamp(h, 0, 12000, 200, 300.0f, 0.0f);
+    TEST_ASSERT_EQUAL_UINT16(11, h.coarse().size());
+    TEST_ASSERT_TRUE(h.stalled(2.0f));
+}
+
+void test_history_cooling_window_is_not_stalled() {
+    History h(1000, 10000);
+    feedRamp(h, 0, 30000, 200, 300.0f, 0.5f);  // 5 K per window
+    TEST_ASSERT_FALSE(h.stalled(2.0f));
+    TEST_ASSERT_TRUE(h.stalled(6.0f));
+}
+
+void test_history_stall_follows_recent_window() {
+    History h(1000, 10000);
+    uint32_t t = feedRamp(h, 0, 20000, 200, 300.0f, 0.5f);
+    TEST_ASSERT_FALSE(h.stalled(2.0f));
+    feedRamp(h, t, 12000, 200, 290.0f, 0.0f);  // cooling stops
+    TEST_ASSERT_TRUE(h.stalled(2.0f));
+}
+
+void test_history_restart_clears_stall_only() {
+    History h(1000, 10000);
+    uint32_t t = feedRamp(h, 0, 12000, 200, 300.0f, 0.0f);
+    TEST_ASSERT_TRUE(h.stalled(2.0f));
+    h.restartStallWindow();
+    TEST_ASSERT_FALSE(h.stalled(2.0f));
+    TEST_ASSERT_EQUAL_UINT16(5, h.fine().size());
+    t = feedRamp(h, t, 9000, 200, 300.0f, 0.0f);
+    TEST_ASSERT_FALSE(h.stalled(2.0f));
+    feedRamp(h, t, 3000, 200, 300.0f, 0.0f);
+    TEST_ASSERT_TRUE(h.stalled(2.0f));
+}
+
+void test_history_survives_millis_wrap() {
+    History h(1000, 10000);
+    feedRamp(h, 0xFFFFF000u, 12000, 200, 300.0f, 0.0f);
+    TEST_ASSERT_TRUE(h.stalled(2.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, h.coolingRateKPerMin());
+}
+
+void test_history_window_clipped_to_coarse_span() {
+    History h(1000, 60000);
+    TEST_ASSERT_EQUAL_UINT32(10000, h.windowMs());
+}
+
+void test_history_config_spans_stall_window() {
+    TEST_ASSERT_TRUE((STALL_HISTORY_BUCKETS - 1u) * STALL_BUCKET_MS >= STALL_DETECT_WINDOW_MS);
+    TEST_ASSERT_TRUE(STALL_HISTORY_BUCKETS <= 256);   // bounded RAM: ~8 bytes per bucket
+}
+
+void run_temp_history_tests() {
+    RUN_TEST(test_ring_is_four_bytes_per_entry);
+    RUN_TEST(test_ring_quantizes_to_lsb);
+    RUN_TEST(test_ring_iterates_oldest_to_newest);
+    RUN_TEST(test_ring_wrap_keeps_span_and_timestamps);
+    RUN_TEST(test_ring_empty_iterates_nothing);
+    RUN_TEST(test_ring_delta_saturates);
+    RUN_TEST(test_history_rate_needs_two_samples);
+    RUN_TEST(test_history_rate_spans_fine_ring_only);
+    RUN_TEST(test_history_rate_sign_warming_is_negative);
+    RUN_TEST(test_history_not_stalled_before_full_window);
+    RUN_TEST(test_history_flat_window_is_stalled);
+    RUN_TEST(test_history_cooling_window_is_not_stalled);
+    RUN_TEST(test_history_stall_follows_recent_window);
+    RUN_TEST(test_history_restart_clears_stall_only);
+    RUN_TEST(test_history_survives_millis_wrap);
+    RUN_TEST(test_history_window_clipped_to_coarse_span);
+    RUN_TEST(test_history_config_spans_stall_window);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file test_replay.cpp
+ * @brief Replay recorded Serial Studio captures through the state machine
+ *
+ * Run with:
+ *   REPLAY_CSV=run1.csv:run2.csv pio test -e native_replay
+ *   REPLAY_CSV=run1.csv REPLAY_PARAMS=backoffs=2,rate=0.8 pio test -e native_replay
+ *
+ * Each capture is mmap()ed and replayed in place (see replay.h), printing
+ * one REPLAY line per file.  REPLAY_PARAMS applies a parameter batch
+ * (console names, see params.h) before every replay, so a changed policy
+ * can be compared against the recording.  Without REPLAY_CSV the test is
+ * ignored.
+ */
+
+#include <unity.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../replay.h"
+#include "params.h"
+
+static void writeLine(const char* line) {
+    printf("%s\n", line);
+}
+
+/** Apply "name=value,name=value" from REPLAY_PARAMS; false on any bad entry. */
+static bool applyParams(const char* spec) {
+    params::Change changes[params::COUNT];
+    uint8_t        n = 0;
+    char           buf[256];
+    strncpy(buf, spec, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    char* save = nullptr;
+    for (char* item = strtok_r(buf, ",", &save); item != nullptr;
+         item = strtok_r(nullptr, ",", &save)) {
+        char* eq = strchr(item, '=');
+        if (eq == nullptr || n == params::COUNT) return false;
+        *eq = '\0';
+        params::Id id;
+        char*      end = nullptr;
+        const float v  = strtof(eq + 1, &end);
+        if (!params::find(item, id) || end == eq + 1 || *end != '\0') return false;
+        changes[n++] = {id, v};
+    }
+    return params::apply(changes, n) == params::Result::Ok;
+}
+
+static bool replayFile(const char* path) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    const size_t len  = static_cast<size_t>(st.st_size);
+    void*        data = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    replay::Replayer rep;
+    rep.feedAll(static_cast<const char*>(data), len);
+    munmap(data, len);
+    replay::report(rep.summary(), path, writeLine);
+    return rep.summary().frames > 0;
+}
+
+void test_replay_captures() {
+    const char* list = getenv("REPLAY_CSV");
+    if (list == nullptr || *list == '\0') TEST_IGNORE_MESSAGE("REPLAY_CSV not set");
+    const char* spec = getenv("REPLAY_PARAMS");
+
+    char paths[1024];
+    strncpy(paths, list, sizeof(paths) - 1);
+    paths[sizeof(paths) - 1] = '\0';
+    char* save = nullptr;
+    for (char* path = strtok_r(paths, ":", &save); path != nullptr;
+         path = strtok_r(nullptr, ":", &save)) {
+        params::resetDefaults();
+        if (spec != nullptr && *spec != '\0') {
+            TEST_ASSERT_TRUE_MESSAGE(applyParams(spec), "bad REPLAY_PARAMS");
+        }
+        TEST_ASSERT_TRUE_MESSAGE(replayFile(path), path);
+    }
+    params::resetDefaults();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_replay_captures);
+    return UNITY_END();
+}
@@ -0,0 +1,57 @@
+/**
+ * @file test_ssproj.cpp
+ * @brief Regenerate the dashboard's column map from telemetry::FIELDS
+ *
+ * Run with:
+ *   pio test -e native_ssproj
+ *   SSPROJ="other.ssproj" pio test -e native_ssproj
+ *
+ * Rewrites the project's frameParser and dataset indices/units in place
+ * (see ssproj_map.h) and prints one SSPROJ line saying whether the file
+ * changed.  Fails, leaving the file alone, if a dataset's title is not a
+ * schema title; rename the dataset or add the column first.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../ssproj_map.h"
+
+static const char* projectPath() {
+    const char* path = getenv("SSPROJ");
+    return (path != nullptr && *path != '\0') ? path : "Cryocooler Dashboard.ssproj";
+}
+
+void test_ssproj_regenerate() {
+    const char* path = projectPath();
+    std::ifstream in(path, std::ios::binary);
+    TEST_ASSERT_TRUE_MESSAGE(in.good(), path);
+    std::stringstream text;
+    text << in.rdbuf();
+    in.close();
+
+    std::string out, err;
+    TEST_ASSERT_TRUE_MESSAGE(ssproj::regenerate(text.str(), out, err), err.c_str());
+    const bool changed = (out != text.str());
+    if (changed) {
+        std::ofstream o(path, std::ios::binary | std::ios::trunc);
+        o << out;
+        TEST_ASSERT_TRUE_MESSAGE(o.good(), path);
+    }
+    printf("SSPROJ {\"file\":\"%s\",\"changed\":%s}\n", path, changed ? "true" : "false");
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_ssproj_regenerate);
+    return UNITY_END();
+}